@@ -2,6 +2,9 @@
 
 #include "resources/light_block.glsl"
 #include "resources/camera_block.glsl"
+#include "resources/cascades_block.glsl"
+#include "resources/point_shadow_block.glsl"
+#include "resources/raytraced_shadow_block.glsl"
 #include "lib/pbr.glsl"
 #include "lib/color.glsl"
 #include "lib/shadow.glsl"
@@ -36,11 +39,39 @@ layout (set = 3, binding = 7) uniform sampler2D t_BrdfLUT;
 layout (set = 3, binding = 8) uniform samplerCube t_IrradianceMap;
 layout (set = 3, binding = 9) uniform samplerCube t_PrefilteredEnvMap;
 
+// Cascaded shadow maps (directional light)
+layout (set = 3, binding = 10) uniform sampler2DArrayShadow t_CascadedShadowMaps;
+
+// Point light shadow atlas (six layers per slot)
+layout (set = 3, binding = 11) uniform sampler2DArrayShadow t_PointShadowMaps;
+
+// Ray traced shadow mask (full resolution, denoised), see raytraced_shadow_block.glsl
+layout (set = 3, binding = 12) uniform sampler2D t_RayTracedShadowMask;
+
 layout(push_constant) uniform PushConstants {
     int enableAreaLight;
     int enableIBL;
 } pc;
 
+float calPointShadow(int lightIndex, vec3 fragPos, vec3 normal) {
+    const int channel = getRayTracedShadowChannel(lightIndex);
+    if (channel > 0) {
+        return 1.0 - texture(t_RayTracedShadowMask, v_TexCoord)[channel];
+    }
+
+    const int slot = getPointShadowSlot(lightIndex);
+    if (slot < 0) {
+        return 0.0;
+    }
+
+    // Offset the receiver along the normal by a few texels at its distance from the light
+    const vec3  lightPos  = u_PointShadows.slotPositions[slot].xyz;
+    const float texelSize = u_PointShadows.texelScale * length(fragPos - lightPos);
+    const vec3  offsetPos = fragPos + normal * u_PointShadows.normalBias * texelSize;
+    const int   layer     = slot * 6 + selectCubeFace(offsetPos - lightPos);
+    return layeredShadowPCF(u_PointShadows.faceViewProjections[layer] * vec4(offsetPos, 1.0), t_PointShadowMaps, layer);
+}
+
 void main() {
 	// Retrieve depth from the scene's depth texture at the current fragment
     const float depth = getDepth(t_GDepth, v_TexCoord);
@@ -101,7 +132,7 @@ void main() {
     int pointCount = getPointLightCount();
     for (int i = 0; i < pointCount; ++i) {
         PointLight pl = getPointLight(i);
-        Lo_point += calPointLight(pl, F0, normal, viewDir, material, fragPos);
+        Lo_point += (1.0 - calPointShadow(i, fragPos, normal)) * calPointLight(pl, F0, normal, viewDir, material, fragPos);
     }
 
     // Accumulate area lights contribution using LTC
@@ -148,8 +179,23 @@ void main() {
         Lo_ambient += calIBLAmbient(diffuseColor, F0, normal, viewDir, material, t_BrdfLUT, t_IrradianceMap, t_PrefilteredEnvMap);
     }
 
-    // vec4 fragPosLightSpace = biasMat * getLightSpaceMatrix() * vec4(fragPos, 1.0);
-    float shadow = 0.0; // No shadow for now, TODO: Cascaded Shadow Maps
+    float shadow = 0.0;
+    if (isUsingDirectionalLight() == 1 && hasRayTracedDirectionalShadow()) {
+        shadow = 1.0 - texture(t_RayTracedShadowMask, v_TexCoord).r;
+    } else if (isUsingDirectionalLight() == 1 && getCascadeCount() > 0) {
+        const float viewDepth = -fragPosViewSpace.z;
+        const int   cascade   = selectCascade(viewDepth);
+        if (cascade >= 0) {
+            // Offset the receiver along the normal by a few texels of the selected cascade to fight acne
+            const vec3 offsetPos         = fragPos + normal * u_Cascades.normalBias * u_Cascades.texelSizes[cascade];
+            const vec4 fragPosLightSpace = u_Cascades.viewProjections[cascade] * vec4(offsetPos, 1.0);
+            shadow = layeredShadowPCF(fragPosLightSpace, t_CascadedShadowMaps, cascade);
+
+            // Fade out towards the end of the last cascade
+            const float shadowDistance = u_Cascades.splitDepths[getCascadeCount() - 1];
+            shadow *= 1.0 - smoothstep(shadowDistance * 0.9, shadowDistance, viewDepth);
+        }
+    }
 
     vec3 finalColor = material.emissive + Lo_ambient + (1.0 - shadow) * Lo_dir + Lo_point + Lo_area;
 
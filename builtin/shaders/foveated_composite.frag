@@ -0,0 +1,29 @@
+#version 460 core
+
+// Blends the full resolution inset rendered around the gaze point over the low resolution periphery.
+// The inset fades out over a feathered band at its edge to hide the change in resolution.
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Periphery;
+layout(set = 3, binding = 1) uniform sampler2D t_Inset;
+
+layout(push_constant) uniform PushConstants {
+    vec4  insetRect; // xy = min uv, zw = max uv
+    float feather;   // Blend band, in inset uv units
+};
+
+void main() {
+    const vec4 periphery = texture(t_Periphery, v_TexCoord);
+    const vec2 insetUV   = (v_TexCoord - insetRect.xy) / (insetRect.zw - insetRect.xy);
+
+    if (any(lessThan(insetUV, vec2(0.0))) || any(greaterThan(insetUV, vec2(1.0)))) {
+        FragColor = periphery;
+        return;
+    }
+
+    const vec2  edge   = min(insetUV, 1.0 - insetUV);
+    const float weight = smoothstep(0.0, max(feather, 1e-4), min(edge.x, edge.y));
+    FragColor          = mix(periphery, texture(t_Inset, insetUV), weight);
+}
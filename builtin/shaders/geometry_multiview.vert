@@ -0,0 +1,6 @@
+#version 460 core
+#extension GL_EXT_multiview : require
+
+// Stereo variant: both eyes are rendered in one pass, the camera is picked by gl_ViewIndex.
+#define MULTIVIEW
+#include "lib/geometry.glsl"
\ No newline at end of file
@@ -39,4 +39,26 @@ float simpleShadowWithPCF(vec4 fragPosLightSpace, sampler2D shadowMap) {
     return shadow;
 }
 
+// 3x3 hardware PCF on one layer of a layered shadow map (a cascade, or a cube face of a point light slot).
+// fragPosLightSpace is the output of the layer's view projection (depth in [0, 1]).
+// Returns 1 for fully shadowed, 0 for lit.
+float layeredShadowPCF(vec4 fragPosLightSpace, sampler2DArrayShadow shadowMaps, int layer) {
+    const vec3 projCoords = fragPosLightSpace.xyz / fragPosLightSpace.w;
+    const vec2 uv         = projCoords.xy * 0.5 + 0.5;
+
+    if (any(lessThan(uv, vec2(0.0))) || any(greaterThan(uv, vec2(1.0))) || projCoords.z > 1.0) {
+        return 0.0;
+    }
+
+    const vec2 texelSize = vec2(1.0) / vec2(textureSize(shadowMaps, 0).xy);
+
+    float visibility = 0.0;
+    for (int x = -1; x <= 1; ++x) {
+        for (int y = -1; y <= 1; ++y) {
+            visibility += texture(shadowMaps, vec4(uv + vec2(x, y) * texelSize, float(layer), projCoords.z));
+        }
+    }
+    return 1.0 - visibility / 9.0;
+}
+
 #endif
\ No newline at end of file
@@ -0,0 +1,20 @@
+#version 460 core
+#extension GL_ARB_shader_viewport_layer_array : require
+
+// Position-only depth render of all six cube faces of a point light in a single pass.
+// Drawn with six instances, each instance is routed to its face layer of the atlas.
+
+#include "resources/point_shadow_block.glsl"
+
+layout (location = 0) in vec3 a_Position;
+
+layout (push_constant) uniform _PointShadowConstants {
+    mat4 modelMatrix;
+    uint slot;
+} c_PointShadow;
+
+void main() {
+    const int layer = int(c_PointShadow.slot) * 6 + gl_InstanceIndex;
+    gl_Position     = u_PointShadows.faceViewProjections[layer] * c_PointShadow.modelMatrix * vec4(a_Position, 1.0);
+    gl_Layer        = layer;
+}
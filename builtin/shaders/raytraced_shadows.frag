@@ -0,0 +1,110 @@
+#version 460 core
+#extension GL_EXT_ray_query : require
+
+// Ray query shadow mask, one ray per pixel and light, rendered at half resolution.
+// Rays are jittered over the solid angle of the light (sun disk, spherical point light); the temporal and
+// spatial passes turn the per-frame noise into soft penumbrae.
+// Output: r = directional light visibility, gba = visibility of the point lights listed in pointLights.
+
+#include "resources/camera_block.glsl"
+#include "resources/light_block.glsl"
+#include "lib/depth.glsl"
+#include "lib/math.glsl"
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform accelerationStructureEXT t_TLAS;
+layout(set = 3, binding = 1) uniform sampler2D t_GDepth;
+layout(set = 3, binding = 2) uniform sampler2D t_GNormal;
+
+layout(push_constant) uniform PushConstants {
+    ivec4 pointLights;            // Point light traced into g, b, a (xyz), -1 when unused
+    float sunAngularRadius;       // Radians
+    float pointLightSourceRadius; // World units
+    uint  frameIndex;
+    int   traceDirectional;
+};
+
+// Interleaved gradient noise (Jimenez 2014), rotated per frame.
+float interleavedGradientNoise(vec2 pixel, uint frame) {
+    pixel += 5.588238 * float(frame % 64u);
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
+
+// Uniformly distributed direction inside the cone around axis.
+vec3 sampleCone(vec3 axis, float cosThetaMax, vec2 xi) {
+    const float cosTheta = mix(1.0, cosThetaMax, xi.x);
+    const float sinTheta = sqrt(max(0.0, 1.0 - cosTheta * cosTheta));
+    const float phi      = TWO_PI * xi.y;
+    return generateTBN(axis) * vec3(cos(phi) * sinTheta, sin(phi) * sinTheta, cosTheta);
+}
+
+// Any hit is enough: alpha is ignored and the traversal stops at the first intersection.
+float traceVisibility(vec3 origin, vec3 direction, float tMax) {
+    rayQueryEXT rayQuery;
+    rayQueryInitializeEXT(rayQuery,
+                          t_TLAS,
+                          gl_RayFlagsOpaqueEXT | gl_RayFlagsTerminateOnFirstHitEXT,
+                          0xFF,
+                          origin,
+                          0.0,
+                          direction,
+                          tMax);
+    while (rayQueryProceedEXT(rayQuery)) {
+    }
+    return rayQueryGetIntersectionTypeEXT(rayQuery, true) == gl_RayQueryCommittedIntersectionNoneEXT ? 1.0 : 0.0;
+}
+
+void main() {
+    const float depth   = textureLod(t_GDepth, v_TexCoord, 0.0).r;
+    const vec3  gNormal = textureLod(t_GNormal, v_TexCoord, 0.0).rgb;
+
+    // Sky and emissive-only (area light) texels are never shadowed.
+    if (depth >= 1.0 || length(gNormal) < 1e-5) {
+        FragColor = vec4(1.0);
+        return;
+    }
+
+    const vec3 positionVS = viewPositionFromDepth(depth, v_TexCoord, u_Camera.inversedProjection);
+    const vec3 position   = (u_Camera.inversedView * vec4(positionVS, 1.0)).xyz;
+    const vec3 N          = normalize(gNormal);
+    const vec3 origin     = position + N * (0.01 + 0.001 * -positionVS.z);
+
+    // One noise value per pixel, decorrelated per light with the R2 sequence.
+    const float noise = interleavedGradientNoise(gl_FragCoord.xy, frameIndex);
+    const vec2  r2    = vec2(0.7548776662, 0.5698402910);
+
+    vec4 visibility = vec4(1.0);
+
+    if (traceDirectional != 0) {
+        const vec3 L = -normalize(getLightDirection());
+        visibility.r = dot(N, L) > 0.0 ?
+                           traceVisibility(origin, sampleCone(L, cos(sunAngularRadius), fract(noise + r2)), 1e4) :
+                           0.0;
+    }
+
+    for (int c = 0; c < 3; ++c) {
+        const int lightIndex = pointLights[c];
+        if (lightIndex < 0) {
+            continue;
+        }
+
+        const PointLight pl       = getPointLight(lightIndex);
+        const vec3       toLight  = pl.posIntensity.xyz - origin;
+        const float      distance = length(toLight);
+        if (distance >= pl.colorRadius.a || distance <= pointLightSourceRadius) {
+            continue;
+        }
+
+        // Cone subtended by the spherical light source
+        const vec3  L           = toLight / distance;
+        const float sinThetaMax = pointLightSourceRadius / distance;
+        const vec2  xi          = fract(noise + r2 * float(c + 2));
+        const vec3  direction   = sampleCone(L, sqrt(1.0 - sinThetaMax * sinThetaMax), xi);
+        const float tMax        = distance - pointLightSourceRadius;
+        visibility[c + 1]       = dot(N, L) > 0.0 ? traceVisibility(origin, direction, tMax) : 0.0;
+    }
+
+    FragColor = visibility;
+}
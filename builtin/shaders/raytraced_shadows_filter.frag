@@ -0,0 +1,64 @@
+#version 460 core
+
+// Spatial filter of the accumulated ray traced shadow mask, fused with the upsample to full resolution.
+// Gaussian weights over the half resolution neighbourhood, rejecting taps on other surfaces
+// (relative view depth and normal differences).
+
+#include "resources/camera_block.glsl"
+#include "lib/depth.glsl"
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Accumulated;
+layout(set = 3, binding = 1) uniform sampler2D t_Geometry;
+layout(set = 3, binding = 2) uniform sampler2D t_GDepth;
+layout(set = 3, binding = 3) uniform sampler2D t_GNormal;
+
+layout(push_constant) uniform PushConstants {
+    int   radius;          // In half resolution texels
+    float depthThreshold;  // Relative view depth difference
+    float normalThreshold; // Minimum cosine between normals
+};
+
+void main() {
+    const float depth   = textureLod(t_GDepth, v_TexCoord, 0.0).r;
+    const vec3  gNormal = textureLod(t_GNormal, v_TexCoord, 0.0).rgb;
+    if (depth >= 1.0 || length(gNormal) < 1e-5) {
+        FragColor = vec4(1.0);
+        return;
+    }
+
+    const float viewDepth = -viewPositionFromDepth(depth, v_TexCoord, u_Camera.inversedProjection).z;
+    const vec3  N         = normalize(gNormal);
+
+    const ivec2 size   = textureSize(t_Accumulated, 0);
+    const ivec2 center = clamp(ivec2(v_TexCoord * vec2(size)), ivec2(0), size - 1);
+    const float sigma  = max(float(radius), 1.0) * 0.5;
+
+    vec4  sum       = vec4(0.0);
+    float weightSum = 0.0;
+    for (int y = -radius; y <= radius; ++y) {
+        for (int x = -radius; x <= radius; ++x) {
+            const ivec2 coord    = clamp(center + ivec2(x, y), ivec2(0), size - 1);
+            const vec4  geometry = texelFetch(t_Geometry, coord, 0);
+            if (geometry.w <= 0.0) {
+                continue;
+            }
+
+            const float depthDelta = abs(geometry.w - viewDepth) / (depthThreshold * viewDepth);
+            const float cosNormal  = dot(geometry.xyz, N);
+            if (depthDelta > 1.0 || cosNormal < normalThreshold) {
+                continue;
+            }
+
+            const float weight = exp(-float(x * x + y * y) / (2.0 * sigma * sigma)) * (1.0 - depthDelta) *
+                                 smoothstep(normalThreshold, 1.0, cosNormal);
+            sum += texelFetch(t_Accumulated, coord, 0) * weight;
+            weightSum += weight;
+        }
+    }
+
+    // No compatible neighbour (thin features), fall back to the nearest texel.
+    FragColor = weightSum > 1e-4 ? sum / weightSum : texelFetch(t_Accumulated, center, 0);
+}
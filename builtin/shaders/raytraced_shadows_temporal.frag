@@ -0,0 +1,70 @@
+#version 460 core
+
+// Temporal accumulation of the ray traced shadow mask (half resolution).
+// History is reprojected through the surface position and rejected when the previous frame saw a different
+// surface there (view depth or normal mismatch). Also writes this frame's geometry for the next frame and for
+// the spatial filter: xyz = world normal, w = linear view depth (0 for sky).
+
+#include "resources/camera_block.glsl"
+#include "lib/depth.glsl"
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+layout(location = 1) out vec4 FragGeometry;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Trace;
+layout(set = 3, binding = 1) uniform sampler2D t_History;
+layout(set = 3, binding = 2) uniform sampler2D t_HistoryGeometry;
+layout(set = 3, binding = 3) uniform sampler2D t_GDepth;
+layout(set = 3, binding = 4) uniform sampler2D t_GNormal;
+
+layout(push_constant) uniform PushConstants {
+    mat4  prevViewProjection;
+    vec4  historyMask; // Per channel, 0 when the channel traced a different light last frame
+    float temporalWeight;
+    float depthThreshold;  // Relative view depth difference
+    float normalThreshold; // Minimum cosine between normals
+    uint  historyValid;
+};
+
+void main() {
+    const vec4  current = texelFetch(t_Trace, ivec2(gl_FragCoord.xy), 0);
+    const float depth   = textureLod(t_GDepth, v_TexCoord, 0.0).r;
+    const vec3  gNormal = textureLod(t_GNormal, v_TexCoord, 0.0).rgb;
+
+    if (depth >= 1.0 || length(gNormal) < 1e-5) {
+        FragColor    = current;
+        FragGeometry = vec4(0.0);
+        return;
+    }
+
+    const vec3 positionVS = viewPositionFromDepth(depth, v_TexCoord, u_Camera.inversedProjection);
+    const vec3 position   = (u_Camera.inversedView * vec4(positionVS, 1.0)).xyz;
+    const vec3 N          = normalize(gNormal);
+
+    FragGeometry = vec4(N, -positionVS.z);
+
+    if (historyValid == 0) {
+        FragColor = current;
+        return;
+    }
+
+    const vec4 prevClip = prevViewProjection * vec4(position, 1.0);
+    const vec2 prevUV   = prevClip.xy / prevClip.w * 0.5 + 0.5;
+    if (prevClip.w <= 0.0 || any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) {
+        FragColor = current;
+        return;
+    }
+
+    // Clip w is the view depth the previous camera saw this surface at.
+    const vec4 prevGeometry = textureLod(t_HistoryGeometry, prevUV, 0.0);
+    const bool sameSurface  = abs(prevGeometry.w - prevClip.w) < depthThreshold * prevClip.w &&
+                              dot(prevGeometry.xyz, N) > normalThreshold;
+    if (!sameSurface) {
+        FragColor = current;
+        return;
+    }
+
+    const vec4 history = textureLod(t_History, prevUV, 0.0);
+    FragColor          = mix(current, history, temporalWeight * historyMask);
+}
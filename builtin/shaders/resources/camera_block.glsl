@@ -17,7 +17,13 @@ struct Camera {
     vec4  frustumPlanes[6];
 };
 
+#ifdef MULTIVIEW
+// One camera per view, requires GL_EXT_multiview.
+layout (set = 1, binding = 0, std140) uniform _CameraBlock { Camera u_Cameras[2]; };
+#define u_Camera u_Cameras[gl_ViewIndex]
+#else
 layout (set = 1, binding = 0, std140) uniform _CameraBlock { Camera u_Camera; };
+#endif
 
 vec3 getCameraPosition() { return u_Camera.inversedView[3].xyz; }
 
@@ -0,0 +1,26 @@
+#ifndef CASCADES_BLOCK_GLSL
+#define CASCADES_BLOCK_GLSL
+
+#define MAX_CASCADES 4
+
+layout (set = 1, binding = 2, std140) uniform _CascadesBlock {
+    vec4 splitDepths; // View-space far distance of each cascade
+    vec4 texelSizes;  // World-space texel size of each cascade
+    mat4 viewProjections[MAX_CASCADES];
+    int  cascadeCount;
+    float normalBias; // In texels
+} u_Cascades;
+
+int getCascadeCount() { return u_Cascades.cascadeCount; }
+
+// Returns -1 when the view-space depth lies beyond the last cascade.
+int selectCascade(float viewDepth) {
+    for (int i = 0; i < u_Cascades.cascadeCount; ++i) {
+        if (viewDepth < u_Cascades.splitDepths[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif
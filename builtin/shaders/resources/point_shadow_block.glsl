@@ -0,0 +1,30 @@
+#ifndef POINT_SHADOW_BLOCK_GLSL
+#define POINT_SHADOW_BLOCK_GLSL
+
+#define MAX_POINT_SHADOWS 8
+#define MAX_POINT_LIGHTS 32
+
+// Cube faces are stored as consecutive layers of a 2D array atlas: slot * 6 + face,
+// faces ordered +X, -X, +Y, -Y, +Z, -Z.
+layout (set = 1, binding = 3, std140) uniform _PointShadowBlock {
+    mat4  faceViewProjections[MAX_POINT_SHADOWS * 6];
+    vec4  slotPositions[MAX_POINT_SHADOWS]; // xyz = light position the slot was rendered from, w = radius
+    ivec4 lightSlots[MAX_POINT_LIGHTS / 4]; // Atlas slot of each point light, -1 when not shadowed
+    float texelScale;                       // World-space texel size at unit distance
+    float normalBias;                       // In texels
+} u_PointShadows;
+
+int getPointShadowSlot(int lightIndex) { return u_PointShadows.lightSlots[lightIndex / 4][lightIndex % 4]; }
+
+int selectCubeFace(vec3 v) {
+    const vec3 a = abs(v);
+    if (a.x >= a.y && a.x >= a.z) {
+        return v.x > 0.0 ? 0 : 1;
+    }
+    if (a.y >= a.z) {
+        return v.y > 0.0 ? 2 : 3;
+    }
+    return v.z > 0.0 ? 4 : 5;
+}
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef RAYTRACED_SHADOW_BLOCK_GLSL
+#define RAYTRACED_SHADOW_BLOCK_GLSL
+
+// Describes the content of the ray traced shadow mask: r = directional light, gba = point lights.
+layout (set = 1, binding = 4, std140) uniform _RayTracedShadowBlock {
+    ivec4 pointLights; // Point light index stored in g, b, a (xyz), -1 when unused
+    int   directional; // 1 when r holds the directional light visibility
+} u_RayTracedShadows;
+
+bool hasRayTracedDirectionalShadow() { return u_RayTracedShadows.directional != 0; }
+
+// Mask channel (1..3) holding the visibility of the given point light, -1 when it is not traced.
+int getRayTracedShadowChannel(int lightIndex) {
+    for (int c = 0; c < 3; ++c) {
+        if (u_RayTracedShadows.pointLights[c] == lightIndex) {
+            return c + 1;
+        }
+    }
+    return -1;
+}
+
+#endif
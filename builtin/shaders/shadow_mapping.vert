@@ -1,10 +1,15 @@
 #version 460 core
 
-#include "resources/light_block.glsl"
-#include "resources/mesh_constants.glsl"
+// Position-only depth render for shadow maps. The light space matrix is pushed per cascade (or per face),
+// the model matrix per draw.
 
 layout (location = 0) in vec3 a_Position;
 
+layout (push_constant) uniform _ShadowConstants {
+    mat4 modelMatrix;
+    mat4 lightSpaceMatrix;
+} c_Shadow;
+
 void main() {
-    gl_Position = getLightSpaceMatrix() * getModelMatrix() * vec4(a_Position, 1.0);
-}
\ No newline at end of file
+    gl_Position = c_Shadow.lightSpaceMatrix * c_Shadow.modelMatrix * vec4(a_Position, 1.0);
+}
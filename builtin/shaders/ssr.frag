@@ -1,138 +1,204 @@
 #version 460 core
 
+// Hi-Z traced screen space reflections, rendered at half resolution.
+// Rays that move away from the camera walk the min-depth pyramid (Uludag, GPU Pro 5),
+// rays that move towards the camera fall back to a short linear march on the finest level.
+// Output: rgb = reflected radiance weighted by Fresnel, a = confidence (hit ratio * fades).
+
 #include "resources/camera_block.glsl"
 #include "lib/depth.glsl"
-#include "lib/math.glsl"
+#include "lib/importance_sampling.glsl"
 
-layout(location = 0) in vec2 v_TexCoords;
+layout(location = 0) in vec2 v_TexCoord;
 layout(location = 0) out vec4 FragColor;
 
-// G-Buffer inputs
-layout(set = 3, binding = 0) uniform sampler2D t_GDepth;
-layout(set = 3, binding = 1) uniform sampler2D t_GNormal;
-layout(set = 3, binding = 2) uniform sampler2D t_GMetallicRoughnessAO;
-layout(set = 3, binding = 3) uniform sampler2D t_SceneColor;
+layout(set = 3, binding = 0) uniform sampler2D t_HiZ;
+layout(set = 3, binding = 1) uniform sampler2D t_GDepth;
+layout(set = 3, binding = 2) uniform sampler2D t_GNormal;
+layout(set = 3, binding = 3) uniform sampler2D t_GAlbedo;
+layout(set = 3, binding = 4) uniform sampler2D t_GMetallicRoughnessAO;
+layout(set = 3, binding = 5) uniform sampler2D t_SceneColor;
 
 layout(push_constant) uniform PushConstants {
-    float reflectionFactor; // Global reflection intensity multiplier
-    float maxRayDistance;
-    int maxSteps;
-    int maxBinarySteps;
+    float intensity;
+    float maxRoughness;   // Pixels rougher than this are skipped entirely
+    float thickness;      // View-space depth tolerance of a hit
+    float maxDistance;    // View-space ray length
+    uint  maxRayCount;    // Rays per pixel at maxRoughness, mirrors always use one
+    uint  maxIterations;
+    uint  frameIndex;
 };
 
-// Fresnel Schlick approximation
-vec3 fresnelSchlick(vec3 F0, float cosTheta) {
-    return F0 + (1.0 - F0) * pow(1.0 - cosTheta, 5.0);
+vec3 projectToScreen(vec3 positionVS) {
+    const vec4 clip = u_Camera.projection * vec4(positionVS, 1.0);
+    return vec3(clip.xy / clip.w * 0.5 + 0.5, clip.z / clip.w);
 }
 
-// Convert screen-space UV and depth to view-space position
-vec3 uvDepthToViewSpace(vec2 uv, float depth) {
-    return viewPositionFromDepth(depth, uv, u_Camera.inversedProjection);
+bool isOffscreen(vec3 p) {
+    return any(lessThan(p.xy, vec2(0.0))) || any(greaterThan(p.xy, vec2(1.0))) || p.z < 0.0 || p.z >= 1.0;
 }
 
-void main() {
-    // 1. Get current fragment depth from G-Buffer
-    float depth = texture(t_GDepth, v_TexCoords).r;
-    if (depth >= 1.0) {
-        discard; // Skip sky pixels
-    }
+// -- Hi-Z helpers (ray parameterized by depth: p(t) = o + d * t, d.z == 1)
 
-    // 2. Get view-space position and normal
-    vec3 fragPosVS = uvDepthToViewSpace(v_TexCoords, depth);
-    vec3 normalVS = normalize(mat3(u_Camera.view) * texture(t_GNormal, v_TexCoords).rgb);
+vec2 getCellCount(int level) { return vec2(textureSize(t_HiZ, level)); }
+vec2 getCell(vec2 p, vec2 cellCount) { return floor(p * cellCount); }
 
-    // 3. View direction (camera is at origin in view-space)
-    vec3 viewDirVS = normalize(-fragPosVS);
+float getMinimumDepthPlane(vec2 cell, int level, vec2 cellCount) {
+    return texelFetch(t_HiZ, ivec2(clamp(cell, vec2(0.0), cellCount - 1.0)), level).r;
+}
 
-    // 4. Reflection vector in view-space
-    vec3 reflDirVS = normalize(reflect(-viewDirVS, normalVS));
+vec3 intersectDepthPlane(vec3 o, vec3 d, float t) { return o + d * t; }
 
-    // 5. Fetch material properties
-    vec3 gBufferMR = texture(t_GMetallicRoughnessAO, v_TexCoords).rgb;
-    float roughness = clamp(gBufferMR.g, 0.0, 1.0);
-    float metallic  = clamp(gBufferMR.r, 0.0, 1.0);
+vec3 intersectCellBoundary(vec3 o, vec3 d, vec2 cell, vec2 cellCount, vec2 crossStep, vec2 crossOffset) {
+    const vec2 boundary = (cell + crossStep) / cellCount + crossOffset;
+    const vec2 delta    = (boundary - o.xy) / d.xy;
+    return intersectDepthPlane(o, d, min(delta.x, delta.y));
+}
 
-    // Early exit for very rough or non-metallic surfaces
-    if (roughness > 0.9 || metallic < 0.1) {
-        discard;
-    }
+bool crossedCellBoundary(vec2 a, vec2 b) { return any(notEqual(a, b)); }
+
+bool traceHiZ(vec3 start, vec3 dir, out vec3 hit) {
+    const int maxLevel = textureQueryLevels(t_HiZ) - 1;
+
+    vec2 crossStep          = vec2(dir.x >= 0.0 ? 1.0 : -1.0, dir.y >= 0.0 ? 1.0 : -1.0);
+    const vec2 crossOffset  = crossStep / getCellCount(0) / 128.0;
+    crossStep               = clamp(crossStep, 0.0, 1.0);
+
+    // Keep the boundary intersection well defined for axis aligned rays.
+    vec3 d = dir / dir.z;
+    d.xy   = mix(d.xy, sign(crossStep - 0.5) * 1e-7, lessThan(abs(d.xy), vec2(1e-7)));
 
-    // 6. Ray marching in view-space
-    float stepLength = mix(0.3, 1.0, 1.0 - roughness); // Shorter steps for smooth surfaces
-    vec3 rayPosVS = fragPosVS;
-    vec3 hitColor = vec3(0.0);
-    bool hit = false;
+    const vec3 o = intersectDepthPlane(start, d, -start.z);
 
-    for (int i = 0; i < maxSteps; ++i) {
-        rayPosVS += reflDirVS * stepLength;
+    // Step out of the starting cell to avoid self intersection.
+    vec2 cellCount = getCellCount(0);
+    vec3 ray       = intersectCellBoundary(o, d, getCell(start.xy, cellCount), cellCount, crossStep, crossOffset);
 
-        // Stop if ray exceeds max distance
-        if (length(rayPosVS - fragPosVS) > maxRayDistance) {
-            break;
+    int  level      = 0;
+    uint iterations = 0;
+    while (level >= 0 && iterations < maxIterations) {
+        if (isOffscreen(ray)) {
+            return false;
         }
 
-        // Project ray position to screen space
-        vec4 clipPos = u_Camera.projection * vec4(rayPosVS, 1.0);
-        vec3 ndc = clipPos.xyz / clipPos.w;
-        vec2 uv = ndc.xy * 0.5 + 0.5;
+        cellCount          = getCellCount(level);
+        const vec2 oldCell = getCell(ray.xy, cellCount);
+        const float minZ   = getMinimumDepthPlane(oldCell, level, cellCount);
 
-        // Stop if outside screen bounds
-        if (uv.x < 0.0 || uv.x > 1.0 || uv.y < 0.0 || uv.y > 1.0) {
-            break;
+        vec3 tmpRay = intersectDepthPlane(o, d, max(ray.z, minZ));
+        if (crossedCellBoundary(oldCell, getCell(tmpRay.xy, cellCount))) {
+            tmpRay = intersectCellBoundary(o, d, oldCell, cellCount, crossStep, crossOffset);
+            level  = min(maxLevel, level + 2);
         }
 
-        // Sample scene depth at current UV
-        float sceneDepth = texture(t_GDepth, uv).r;
-        vec3 scenePosVS = uvDepthToViewSpace(uv, sceneDepth);
-
-        // Check if ray is behind the geometry
-        if (scenePosVS.z >= rayPosVS.z) {
-            // Binary search refinement
-            vec3 start = rayPosVS - reflDirVS * stepLength;
-            vec3 end = rayPosVS;
-            for (int j = 0; j < maxBinarySteps; ++j) {
-                vec3 mid = (start + end) * 0.5;
-                vec4 midClip = u_Camera.projection * vec4(mid, 1.0);
-                vec3 midNdc = midClip.xyz / midClip.w;
-                vec2 midUV = midNdc.xy * 0.5 + 0.5;
-
-                float midDepth = texture(t_GDepth, midUV).r;
-                vec3 midPosVS = uvDepthToViewSpace(midUV, midDepth);
-
-                if (midPosVS.z >= mid.z) {
-                    end = mid;
-                } else {
-                    start = mid;
-                }
-            }
-
-            // Sample color at refined hit point
-            vec4 hitClip = u_Camera.projection * vec4(end, 1.0);
-            vec3 hitNdc = hitClip.xyz / hitClip.w;
-            vec2 hitUV = hitNdc.xy * 0.5 + 0.5;
-            hitColor = textureLod(t_SceneColor, hitUV, roughness * 5.0).rgb;
-            hit = true;
-            break;
+        ray = tmpRay;
+        --level;
+        ++iterations;
+    }
+
+    hit = ray;
+    return level < 0 && !isOffscreen(ray);
+}
+
+bool traceLinear(vec3 start, vec3 dir, float jitter, out vec3 hit) {
+    const vec2 cellCount = getCellCount(0);
+
+    // Advance roughly two Hi-Z texels per step.
+    const float texels = max(abs(dir.x) * cellCount.x, abs(dir.y) * cellCount.y);
+    if (texels < 1e-4) {
+        return false;
+    }
+    const vec3 stepVector = dir * (2.0 / texels);
+
+    vec3 ray = start + stepVector * (1.0 + jitter);
+    for (uint i = 0; i < maxIterations; ++i) {
+        if (isOffscreen(ray)) {
+            return false;
+        }
+        const float sceneZ = texelFetch(t_HiZ, ivec2(ray.xy * cellCount), 0).r;
+        if (ray.z >= sceneZ) {
+            hit = ray;
+            return true;
         }
+        ray += stepVector;
     }
+    return false;
+}
+
+// Interleaved gradient noise (Jimenez 2014), rotated per frame.
+float interleavedGradientNoise(vec2 pixel, uint frame) {
+    pixel += 5.588238 * float(frame % 64u);
+    return fract(52.9829189 * fract(dot(pixel, vec2(0.06711056, 0.00583715))));
+}
 
-    if (!hit) {
-        discard; // No reflection hit
+void main() {
+    const float depth = texture(t_GDepth, v_TexCoord).r;
+    const vec3  gNormal = texture(t_GNormal, v_TexCoord).rgb;
+    const vec3  mrao    = texture(t_GMetallicRoughnessAO, v_TexCoord).rgb;
+    const float metallic  = clamp01(mrao.r);
+    const float roughness = clamp01(mrao.g);
+
+    // Sky, empty G-Buffer texels and rough surfaces do not trace at all.
+    if (depth >= 1.0 || length(gNormal) < 1e-5 || roughness > maxRoughness) {
+        FragColor = vec4(0.0);
+        return;
     }
 
-    // 7. Fresnel term for reflectivity
-    vec3 albedo = texture(t_SceneColor, v_TexCoords).rgb;
-    vec3 F0 = mix(vec3(0.04), albedo, metallic);
-    float NdotV = clamp(dot(normalVS, viewDirVS), 0.0, 1.0);
-    vec3 F = fresnelSchlick(F0, NdotV);
+    const vec3 positionVS = viewPositionFromDepth(depth, v_TexCoord, u_Camera.inversedProjection);
+    const vec3 N          = normalize(mat3(u_Camera.view) * gNormal);
+    const vec3 V          = normalize(-positionVS);
+    const vec3 start      = vec3(v_TexCoord, depth);
+
+    const uint  rayCount = clamp(uint(ceil(roughness / max(maxRoughness, 1e-4) * float(maxRayCount))), 1u, maxRayCount);
+    const float noise    = interleavedGradientNoise(gl_FragCoord.xy, frameIndex);
+
+    vec3  radiance   = vec3(0.0);
+    float confidence = 0.0;
+
+    for (uint i = 0; i < rayCount; ++i) {
+        const vec2 xi = fract(hammersley2d(i, rayCount) + vec2(noise, fract(noise * 7.0)));
+        const vec3 H  = roughness < 0.05 ? N : importanceSampleGGX(xi, N, V, roughness).xyz;
+        const vec3 R  = reflect(-V, H);
+        if (dot(R, N) <= 0.0) {
+            continue;
+        }
+
+        // Clip the ray against the near plane before projecting its end point.
+        float rayLength = maxDistance;
+        if (positionVS.z + R.z * rayLength > -u_Camera.near) {
+            rayLength = (-u_Camera.near - positionVS.z) / R.z * 0.99;
+        }
+        const vec3 dir = projectToScreen(positionVS + R * rayLength) - start;
+
+        vec3 hit;
+        const bool found = dir.z > 0.0 ? traceHiZ(start, dir, hit) : traceLinear(start, dir, noise, hit);
+        if (!found) {
+            continue;
+        }
+
+        // Reject hits behind thin geometry.
+        const float sceneZ = texelFetch(t_HiZ, ivec2(hit.xy * getCellCount(0)), 0).r;
+        if (linearizeDepth(hit.z) - linearizeDepth(sceneZ) > thickness) {
+            continue;
+        }
+
+        const vec2  edge      = smoothstep(0.0, 0.1, hit.xy) * smoothstep(0.0, 0.1, 1.0 - hit.xy);
+        const vec3  hitVS     = viewPositionFromDepth(hit.z, hit.xy, u_Camera.inversedProjection);
+        const float distFade  = 1.0 - clamp01(length(hitVS - positionVS) / maxDistance);
+        const float weight    = edge.x * edge.y * distFade;
+
+        radiance += textureLod(t_SceneColor, hit.xy, 0.0).rgb * weight;
+        confidence += weight;
+    }
 
-    // 8. Distance-based fading
-    float distFade = exp(-length(rayPosVS - fragPosVS) * 0.02);
+    radiance /= float(rayCount);
+    confidence /= float(rayCount);
 
-    // 9. Screen edge fade
-    vec2 edgeFade = smoothstep(0.0, 0.1, v_TexCoords) * smoothstep(0.0, 0.1, 1.0 - v_TexCoords);
-    float screenFade = edgeFade.x * edgeFade.y;
+    const vec3  albedo = texture(t_GAlbedo, v_TexCoord).rgb;
+    const vec3  F0     = mix(vec3(0.04), albedo, metallic);
+    const vec3  F      = FresnelSchlick(clamp01(dot(N, V)), F0);
+    // Fade out towards the roughness cut-off so the skipped region has no visible edge.
+    const float roughnessFade = 1.0 - smoothstep(maxRoughness * 0.75, maxRoughness, roughness);
 
-    // 10. Final reflection color
-    FragColor = vec4(hitColor * F * distFade * screenFade * reflectionFactor, 1.0);
+    FragColor = vec4(radiance * F * roughnessFade * intensity, confidence * roughnessFade);
 }
@@ -0,0 +1,55 @@
+#version 460 core
+
+// Temporal resolve for the half resolution SSR trace.
+// History is reprojected through the surface position (not the reflected one) and clamped
+// against the 3x3 neighbourhood of the current trace to limit ghosting.
+
+#include "resources/camera_block.glsl"
+#include "lib/depth.glsl"
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Trace;
+layout(set = 3, binding = 1) uniform sampler2D t_History;
+layout(set = 3, binding = 2) uniform sampler2D t_GDepth;
+
+layout(push_constant) uniform PushConstants {
+    mat4  prevViewProjection;
+    float temporalWeight;
+    uint  historyValid;
+};
+
+void main() {
+    const ivec2 coord   = ivec2(gl_FragCoord.xy);
+    const ivec2 size    = textureSize(t_Trace, 0);
+    const vec4  current = texelFetch(t_Trace, coord, 0);
+
+    vec4 minColor = current;
+    vec4 maxColor = current;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            const vec4 s = texelFetch(t_Trace, clamp(coord + ivec2(x, y), ivec2(0), size - 1), 0);
+            minColor     = min(minColor, s);
+            maxColor     = max(maxColor, s);
+        }
+    }
+
+    const float depth = texture(t_GDepth, v_TexCoord).r;
+    if (historyValid == 0 || depth >= 1.0) {
+        FragColor = current;
+        return;
+    }
+
+    const vec4 worldPos = u_Camera.inversedViewProjection * vec4(v_TexCoord * 2.0 - 1.0, depth, 1.0);
+    const vec4 prevClip = prevViewProjection * vec4(worldPos.xyz / worldPos.w, 1.0);
+    const vec2 prevUV   = prevClip.xy / prevClip.w * 0.5 + 0.5;
+
+    if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) {
+        FragColor = current;
+        return;
+    }
+
+    const vec4 history = clamp(texture(t_History, prevUV), minColor, maxColor);
+    FragColor          = mix(current, history, temporalWeight);
+}
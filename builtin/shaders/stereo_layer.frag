@@ -0,0 +1,16 @@
+#version 460 core
+
+// Copies one view of a multiview (2 layer) target into a regular 2D target,
+// so the per eye screen space passes can keep sampling plain sampler2D inputs.
+
+layout(set = 3, binding = 0) uniform sampler2DArray t_Source;
+
+layout(push_constant) uniform PushConstants {
+    uint layer;
+};
+
+layout(location = 0) out vec4 FragColor;
+
+void main() {
+    FragColor = texelFetch(t_Source, ivec3(gl_FragCoord.xy, layer), 0);
+}
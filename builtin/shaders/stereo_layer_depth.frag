@@ -0,0 +1,13 @@
+#version 460 core
+
+// Depth variant of stereo_layer.frag.
+
+layout(set = 3, binding = 0) uniform sampler2DArray t_Source;
+
+layout(push_constant) uniform PushConstants {
+    uint layer;
+};
+
+void main() {
+    gl_FragDepth = texelFetch(t_Source, ivec3(gl_FragCoord.xy, layer), 0).r;
+}
@@ -0,0 +1,48 @@
+#version 460 core
+
+// Catmull-Rom upscale of the dynamic resolution scene color to the output resolution.
+// The 4x4 filter is evaluated with 9 bilinear taps (Jimenez, "Filmic SMAA", SIGGRAPH 2016);
+// the negative lobes keep edges sharper than a plain bilinear upscale.
+
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Source;
+
+void main() {
+    const vec2 sourceSize = vec2(textureSize(t_Source, 0));
+    const vec2 texelSize  = 1.0 / sourceSize;
+
+    const vec2 samplePos = v_TexCoord * sourceSize;
+    const vec2 texPos1   = floor(samplePos - 0.5) + 0.5;
+    const vec2 f         = samplePos - texPos1;
+
+    const vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    const vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    const vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    const vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    // The two middle taps are merged into one bilinear fetch.
+    const vec2 w12      = w1 + w2;
+    const vec2 offset12 = w2 / w12;
+
+    const vec2 texPos0  = (texPos1 - 1.0) * texelSize;
+    const vec2 texPos3  = (texPos1 + 2.0) * texelSize;
+    const vec2 texPos12 = (texPos1 + offset12) * texelSize;
+
+    vec4 result = vec4(0.0);
+    result += textureLod(t_Source, vec2(texPos0.x, texPos0.y), 0.0) * w0.x * w0.y;
+    result += textureLod(t_Source, vec2(texPos12.x, texPos0.y), 0.0) * w12.x * w0.y;
+    result += textureLod(t_Source, vec2(texPos3.x, texPos0.y), 0.0) * w3.x * w0.y;
+
+    result += textureLod(t_Source, vec2(texPos0.x, texPos12.y), 0.0) * w0.x * w12.y;
+    result += textureLod(t_Source, vec2(texPos12.x, texPos12.y), 0.0) * w12.x * w12.y;
+    result += textureLod(t_Source, vec2(texPos3.x, texPos12.y), 0.0) * w3.x * w12.y;
+
+    result += textureLod(t_Source, vec2(texPos0.x, texPos3.y), 0.0) * w0.x * w3.y;
+    result += textureLod(t_Source, vec2(texPos12.x, texPos3.y), 0.0) * w12.x * w3.y;
+    result += textureLod(t_Source, vec2(texPos3.x, texPos3.y), 0.0) * w3.x * w3.y;
+
+    // The negative lobes can overshoot, LDR input stays in [0, 1].
+    FragColor = max(result, vec4(0.0));
+}
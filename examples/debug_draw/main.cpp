@@ -25,7 +25,7 @@ class DebugDrawApp final : public ImGuiApp
 public:
     explicit DebugDrawApp(const std::span<char*>& args) :
         ImGuiApp(args, {.title = "Debug Draw Example"}, {.enableDocking = false}),
-        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat())
+        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat(), m_FrameController.size())
     {
         // Setup scene
 
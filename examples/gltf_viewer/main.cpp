@@ -21,7 +21,7 @@ class GLTFViewerApp final : public ImGuiApp
 public:
     explicit GLTFViewerApp(const std::span<char*>& args) :
         ImGuiApp(args, {.title = "GLTF Viewer", .vSyncConfig = rhi::VerticalSync::eEnabled}, {.enableDocking = false}),
-        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat())
+        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat(), m_FrameController.size())
     {
         // Setup scene
 
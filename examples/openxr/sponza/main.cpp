@@ -29,7 +29,8 @@ public:
         m_Renderer(*m_RenderDevice,
                    m_Headset.getSwapchainPixelFormat() == rhi::PixelFormat::eRGBA8_sRGB ?
                        rhi::Swapchain::Format::esRGB :
-                       rhi::Swapchain::Format::eLinear)
+                       rhi::Swapchain::Format::eLinear,
+                   m_FrameController.size())
     {
         // Setup scene
 
@@ -169,11 +170,22 @@ public:
     {
         m_Renderer.beginFrame(cb);
 
+        // Foveated rendering follows the gaze when tracked, and falls back to fixed foveation otherwise
+        const auto* eyeTracker = m_CommonAction.getEyeTracker();
+        if (eyeTracker && eyeTracker->isGazeValid())
+        {
+            m_Renderer.setXrGazeDirection(xrutils::toQuat(eyeTracker->getGazePose().orientation) *
+                                          glm::vec3(0, 0, -1));
+        }
+        else
+        {
+            m_Renderer.setXrGazeDirection(std::nullopt);
+        }
+
         auto& [leftRTV, rightRTV] = xrRenderTargetView;
         m_Renderer.renderXR(cb, &leftRTV, &rightRTV, dt);
 
         // Render Eye Tracker Circle in screen space
-        const auto* eyeTracker = m_CommonAction.getEyeTracker();
         if (eyeTracker)
         {
             auto& leftEyeCamera  = m_LogicScene.getXrCamera(true).getComponent<XrCameraComponent>();
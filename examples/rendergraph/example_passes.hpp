@@ -1,46 +1,326 @@
 #pragma once
 
-#include "pass_registry.hpp"
+#include <vultra/core/rhi/command_buffer.hpp>
+#include <vultra/core/rhi/render_pass.hpp>
+#include <vultra/function/framegraph/framegraph_resource_access.hpp>
+#include <vultra/function/framegraph/framegraph_texture.hpp>
+#include <vultra/function/framegraph/graph_pass.hpp>
+#include <vultra/function/renderer/builtin/passes/blit_pass.hpp>
+#include <vultra/function/renderer/renderer_render_context.hpp>
+
+#include <fg/FrameGraph.hpp>
+
+#include <optional>
+
+using namespace vultra;
+
+// Passed to GraphRuntime::getFrameGraph as user data, updated every frame.
+struct ExampleFrameInfo
+{
+    rhi::Extent2D extent;
+    float         time {0.0f};
+};
+
+const auto* const fullscreenVertCode = R"(
+layout(location = 0) out vec2 v_TexCoord;
+
+void main() {
+  v_TexCoord  = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+  gl_Position = vec4(v_TexCoord * 2.0 - 1.0, 0.0, 1.0);
+})";
+
+// Fullscreen triangle with a custom fragment shader, writing to fixed color formats.
+class FullscreenProgram final : public rhi::RenderPass<FullscreenProgram>
+{
+    friend class BasePass;
+
+public:
+    FullscreenProgram(rhi::RenderDevice& rd, const char* fragCode, std::vector<rhi::PixelFormat> colorFormats) :
+        rhi::RenderPass<FullscreenProgram>(rd), m_FragCode {fragCode}, m_ColorFormats {std::move(colorFormats)}
+    {}
+
+    // Textures read by the pass are expected at set = 3, binding = 0..numTextures-1.
+    void draw(gfx::RendererRenderContext& rc, const uint32_t numTextures, const std::optional<float> time = {})
+    {
+        auto& [cb, framebufferInfo, sets, samplers] = rc;
+
+        const auto* pipeline = getPipeline();
+        if (!pipeline)
+            return;
+
+        cb.bindPipeline(*pipeline);
+        for (uint32_t i = 0; i < numTextures; ++i)
+            rc.overrideSampler(sets[3][i], samplers["bilinear"]);
+        rc.bindDescriptorSets(*pipeline);
+        if (time)
+            cb.pushConstants(rhi::ShaderStages::eFragment, 0, &*time);
+        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+        rc.endRendering();
+    }
+
+private:
+    [[nodiscard]] rhi::GraphicsPipeline createPipeline() const
+    {
+        auto builder = rhi::GraphicsPipeline::Builder {};
+        builder.setColorFormats(m_ColorFormats)
+            .setInputAssembly({})
+            .addShader(rhi::ShaderType::eVertex, {.code = fullscreenVertCode})
+            .addShader(rhi::ShaderType::eFragment, {.code = m_FragCode})
+            .setDepthStencil({
+                .depthTest  = false,
+                .depthWrite = false,
+            })
+            .setRasterizer({
+                .polygonMode = rhi::PolygonMode::eFill,
+                .cullMode    = rhi::CullMode::eNone,
+            });
+        for (uint32_t i = 0; i < m_ColorFormats.size(); ++i)
+            builder.setBlending(i, {.enabled = false});
+        return builder.build(getRenderDevice());
+    }
+
+private:
+    const char*                   m_FragCode;
+    std::vector<rhi::PixelFormat> m_ColorFormats;
+};
+
+inline FrameGraphResource createColorTarget(FrameGraph::Builder&   builder,
+                                            const std::string_view name,
+                                            const rhi::Extent2D    extent,
+                                            const rhi::PixelFormat format,
+                                            const uint32_t         index)
+{
+    auto target = builder.create<framegraph::FrameGraphTexture>(
+        name,
+        {
+            .extent     = extent,
+            .format     = format,
+            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+        });
+    return builder.write(target,
+                         framegraph::Attachment {
+                             .index       = index,
+                             .imageAspect = rhi::ImageAspect::eColor,
+                             .clearValue  = framegraph::ClearValue::eOpaqueBlack,
+                         });
+}
+
+inline void readTexture(FrameGraph::Builder& builder, const FrameGraphResource texture, const uint32_t binding)
+{
+    builder.read(texture,
+                 framegraph::TextureRead {
+                     .binding =
+                         {
+                             .location      = {.set = 3, .binding = binding},
+                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                         },
+                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                     .imageAspect = rhi::ImageAspect::eColor,
+                 });
+}
 
 // GBuffer -------------------------------------------------
-class GBufferPass : public RenderPass
+// Procedural "scene": a rotating checkerboard with a radial pseudo depth.
+class GBufferPass final : public framegraph::GraphPass
 {
 public:
-    const char*    getName() const override { return "GBuffer"; }
-    PassReflection reflect() const override
+    explicit GBufferPass(rhi::RenderDevice& rd) :
+        m_Program {rd, fragCode, {rhi::PixelFormat::eRGBA8_UNorm, rhi::PixelFormat::eR32F}}
+    {}
+
+    static framegraph::GraphPassReflection reflect()
     {
         return {{}, // no inputs
                 {{"GBufferColor", "Texture"}, {"GBufferDepth", "Texture"}}};
     }
+
+    void addToGraph(framegraph::GraphPassContext& ctx) override
+    {
+        const auto& info = *static_cast<const ExampleFrameInfo*>(ctx.userData);
+
+        struct Data
+        {
+            FrameGraphResource color;
+            FrameGraphResource depth;
+        };
+        const auto& data = ctx.fg.addCallbackPass<Data>(
+            "GBufferPass",
+            [&info](FrameGraph::Builder& builder, Data& data) {
+                data.color = createColorTarget(builder, "GBufferColor", info.extent, rhi::PixelFormat::eRGBA8_UNorm, 0);
+                data.depth = createColorTarget(builder, "GBufferDepth", info.extent, rhi::PixelFormat::eR32F, 1);
+            },
+            [this, &info](const Data&, FrameGraphPassResources&, void* ctx) {
+                auto& rc = *static_cast<gfx::RendererRenderContext*>(ctx);
+                RHI_GPU_ZONE(rc.commandBuffer, "GBufferPass");
+                m_Program.draw(rc, 0, info.time);
+            });
+
+        ctx.setOutput("GBufferColor", data.color);
+        ctx.setOutput("GBufferDepth", data.depth);
+    }
+
+private:
+    static constexpr auto fragCode = R"(
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 GBufferColor;
+layout(location = 1) out float GBufferDepth;
+
+layout(push_constant) uniform PushConstants { float time; };
+
+void main() {
+  const vec2  p       = v_TexCoord * 2.0 - 1.0;
+  const float s       = sin(time * 0.25), c = cos(time * 0.25);
+  const vec2  q       = mat2(c, -s, s, c) * p * 8.0;
+  const float checker = mod(floor(q.x) + floor(q.y), 2.0);
+  GBufferColor        = vec4(mix(vec3(0.9, 0.5, 0.2), vec3(0.2, 0.5, 0.9), checker), 1.0);
+  GBufferDepth        = clamp(length(p), 0.0, 1.0);
+})";
+
+    FullscreenProgram m_Program;
 };
-REGISTER_PASS(GBufferPass);
+VULTRA_REGISTER_GRAPH_PASS(GBufferPass);
 
 // Lighting -------------------------------------------------
-class LightingPass : public RenderPass
+// Treats the pseudo depth as a height field and lights it with a single directional light.
+class LightingPass final : public framegraph::GraphPass
 {
 public:
-    const char*    getName() const override { return "Lighting"; }
-    PassReflection reflect() const override
+    explicit LightingPass(rhi::RenderDevice& rd) : m_Program {rd, fragCode, {rhi::PixelFormat::eRGBA8_UNorm}} {}
+
+    static framegraph::GraphPassReflection reflect()
     {
         return {{{"GBufferColor", "Texture"}, {"GBufferDepth", "Texture"}}, {{"LightingResult", "Texture"}}};
     }
+
+    void addToGraph(framegraph::GraphPassContext& ctx) override
+    {
+        const auto color = ctx.getInput("GBufferColor");
+        const auto depth = ctx.getInput("GBufferDepth");
+        if (!color || !depth)
+            return;
+
+        const auto extent = ctx.fg.getDescriptor<framegraph::FrameGraphTexture>(*color).extent;
+
+        struct Data
+        {
+            FrameGraphResource lit;
+        };
+        const auto& data = ctx.fg.addCallbackPass<Data>(
+            "LightingPass",
+            [&](FrameGraph::Builder& builder, Data& data) {
+                readTexture(builder, *color, 0);
+                readTexture(builder, *depth, 1);
+                data.lit = createColorTarget(builder, "LightingResult", extent, rhi::PixelFormat::eRGBA8_UNorm, 0);
+            },
+            [this](const Data&, FrameGraphPassResources&, void* ctx) {
+                auto& rc = *static_cast<gfx::RendererRenderContext*>(ctx);
+                RHI_GPU_ZONE(rc.commandBuffer, "LightingPass");
+                m_Program.draw(rc, 2);
+            });
+
+        ctx.setOutput("LightingResult", data.lit);
+    }
+
+private:
+    static constexpr auto fragCode = R"(
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_GBufferColor;
+layout(set = 3, binding = 1) uniform sampler2D t_GBufferDepth;
+
+void main() {
+  const vec2  texel  = 1.0 / vec2(textureSize(t_GBufferDepth, 0));
+  const float dx     = texture(t_GBufferDepth, v_TexCoord + vec2(texel.x, 0.0)).r -
+                       texture(t_GBufferDepth, v_TexCoord - vec2(texel.x, 0.0)).r;
+  const float dy     = texture(t_GBufferDepth, v_TexCoord + vec2(0.0, texel.y)).r -
+                       texture(t_GBufferDepth, v_TexCoord - vec2(0.0, texel.y)).r;
+  const vec3  N      = normalize(vec3(-dx * 64.0, -dy * 64.0, 1.0));
+  const float NdotL  = max(dot(N, normalize(vec3(0.4, 0.6, 0.7))), 0.0);
+  const vec3  albedo = texture(t_GBufferColor, v_TexCoord).rgb;
+  FragColor          = vec4(albedo * (0.2 + 0.8 * NdotL), 1.0);
+})";
+
+    FullscreenProgram m_Program;
 };
-REGISTER_PASS(LightingPass);
+VULTRA_REGISTER_GRAPH_PASS(LightingPass);
 
 // PostFX -------------------------------------------------
-class PostFXPass : public RenderPass
+class PostFXPass final : public framegraph::GraphPass
 {
 public:
-    const char*    getName() const override { return "PostFX"; }
-    PassReflection reflect() const override { return {{{"LightingResult", "Texture"}}, {{"FinalColor", "Texture"}}}; }
+    explicit PostFXPass(rhi::RenderDevice& rd) : m_Program {rd, fragCode, {rhi::PixelFormat::eRGBA8_UNorm}} {}
+
+    static framegraph::GraphPassReflection reflect()
+    {
+        return {{{"LightingResult", "Texture"}}, {{"FinalColor", "Texture"}}};
+    }
+
+    void addToGraph(framegraph::GraphPassContext& ctx) override
+    {
+        const auto input = ctx.getInput("LightingResult");
+        if (!input)
+            return;
+
+        const auto extent = ctx.fg.getDescriptor<framegraph::FrameGraphTexture>(*input).extent;
+
+        struct Data
+        {
+            FrameGraphResource output;
+        };
+        const auto& data = ctx.fg.addCallbackPass<Data>(
+            "PostFXPass",
+            [&](FrameGraph::Builder& builder, Data& data) {
+                readTexture(builder, *input, 0);
+                data.output = createColorTarget(builder, "FinalColor", extent, rhi::PixelFormat::eRGBA8_UNorm, 0);
+            },
+            [this](const Data&, FrameGraphPassResources&, void* ctx) {
+                auto& rc = *static_cast<gfx::RendererRenderContext*>(ctx);
+                RHI_GPU_ZONE(rc.commandBuffer, "PostFXPass");
+                m_Program.draw(rc, 1);
+            });
+
+        ctx.setOutput("FinalColor", data.output);
+    }
+
+private:
+    // Vignette.
+    static constexpr auto fragCode = R"(
+layout(location = 0) in vec2 v_TexCoord;
+layout(location = 0) out vec4 FragColor;
+
+layout(set = 3, binding = 0) uniform sampler2D t_Input;
+
+void main() {
+  const vec2 p = v_TexCoord * 2.0 - 1.0;
+  FragColor    = vec4(texture(t_Input, v_TexCoord).rgb * (1.0 - 0.4 * dot(p, p)), 1.0);
+})";
+
+    FullscreenProgram m_Program;
 };
-REGISTER_PASS(PostFXPass);
+VULTRA_REGISTER_GRAPH_PASS(PostFXPass);
 
 // Present -------------------------------------------------
-class PresentPass : public RenderPass
+// Copies the final color to the back buffer, which is left unlinked and bound from the runtime imports.
+class PresentPass final : public framegraph::GraphPass
 {
 public:
-    const char*    getName() const override { return "Present"; }
-    PassReflection reflect() const override { return {{{"FinalColor", "Texture"}}, {}}; }
+    explicit PresentPass(rhi::RenderDevice& rd) : m_BlitPass {rd} {}
+
+    static framegraph::GraphPassReflection reflect()
+    {
+        return {{{"FinalColor", "Texture"}, {"Backbuffer", "Texture"}}, {}};
+    }
+
+    void addToGraph(framegraph::GraphPassContext& ctx) override
+    {
+        const auto finalColor = ctx.getInput("FinalColor");
+        const auto backBuffer = ctx.getInput("Backbuffer");
+        if (finalColor && backBuffer)
+            m_BlitPass.blit(ctx.fg, *finalColor, *backBuffer);
+    }
+
+private:
+    gfx::BlitPass m_BlitPass;
 };
-REGISTER_PASS(PresentPass);
\ No newline at end of file
+VULTRA_REGISTER_GRAPH_PASS(PresentPass);
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "fg_panel.hpp"
-#include "pass_registry.hpp"
+
+#include <vultra/function/framegraph/graph_pass.hpp>
 
 #include <nlohmann/json.hpp>
 
@@ -145,7 +146,7 @@ void FrameGraphEditorPanel::drawContextMenus()
 
     if (ImGui::BeginPopup("CreateNodeMenu"))
     {
-        for (auto& [name, entry] : PassRegistry::instance().getEntries())
+        for (auto& [name, entry] : vultra::framegraph::GraphPassRegistry::instance().getEntries())
         {
             if (ImGui::MenuItem(name.c_str()))
             {
@@ -190,11 +191,10 @@ void FrameGraphEditorPanel::createPassNode(const std::string& passType, ImVec2 p
     n.displayName  = passType;
     n.position     = pos;
 
-    auto it = PassRegistry::instance().getEntries().find(passType);
-    if (it != PassRegistry::instance().getEntries().end())
+    auto it = vultra::framegraph::GraphPassRegistry::instance().getEntries().find(passType);
+    if (it != vultra::framegraph::GraphPassRegistry::instance().getEntries().end())
     {
-        auto pass    = it->second.factory();
-        auto reflect = pass->reflect();
+        const auto& reflect = it->second.reflection;
 
         auto typeFromString = [](const std::string& s) -> ResourceType {
             if (s == "Texture")
@@ -343,11 +343,10 @@ void FrameGraphEditorPanel::loadGraphFromFile(const std::string& path)
             return ResourceType::eUnknown;
         };
 
-        auto it = PassRegistry::instance().getEntries().find(n.passType);
-        if (it != PassRegistry::instance().getEntries().end())
+        auto it = vultra::framegraph::GraphPassRegistry::instance().getEntries().find(n.passType);
+        if (it != vultra::framegraph::GraphPassRegistry::instance().getEntries().end())
         {
-            auto pass    = it->second.factory();
-            auto reflect = pass->reflect();
+            const auto& reflect = it->second.reflection;
             for (auto& in : reflect.inputs)
                 n.pins.push_back({ed::PinId(m_NextPinId++), in.name, typeFromString(in.type), ed::PinKind::Input});
             for (auto& out : reflect.outputs)
@@ -2,24 +2,53 @@
 #include "fg_panel.hpp"
 
 #include <vultra/core/base/common_context.hpp>
+#include <vultra/core/base/hash.hpp>
 #include <vultra/function/app/imgui_app.hpp>
+#include <vultra/function/framegraph/framegraph_import.hpp>
+#include <vultra/function/framegraph/graph_runtime.hpp>
+#include <vultra/function/framegraph/transient_resources.hpp>
+#include <vultra/function/renderer/builtin/builtin_graph_passes.hpp>
 #include <vultra/function/renderer/imgui_renderer.hpp>
 
+#include <fg/FrameGraph.hpp>
+
 #include <imgui.h>
 #include <imgui_node_editor/imgui_node_editor.h>
 
 using namespace vultra;
 
+constexpr auto kClearColor = glm::vec4 {0.1f, 0.1f, 0.1f, 1.0f};
+
 class RenderGraphExampleApp final : public ImGuiApp
 {
 public:
     explicit RenderGraphExampleApp(const std::span<char*>& args) :
-        ImGuiApp(args,
-                 {.title = "RenderGraph Example", .vSyncConfig = rhi::VerticalSync::eEnabled},
-                 {},
-                 glm::vec4 {0.1f, 0.1f, 0.1f, 1.0f})
+        ImGuiApp(args, {.title = "RenderGraph Example", .vSyncConfig = rhi::VerticalSync::eEnabled}, {}, kClearColor),
+        m_TransientResources(*m_RenderDevice), m_Runtime(*m_RenderDevice)
     {
+        gfx::registerBuiltinGraphPasses(framegraph::GraphPassRegistry::instance());
+
+        m_Samplers["bilinear"] = m_RenderDevice->getSampler({
+            .magFilter  = rhi::TexelFilter::eLinear,
+            .minFilter  = rhi::TexelFilter::eLinear,
+            .mipmapMode = rhi::MipmapMode::eNearest,
+
+            .addressModeS = rhi::SamplerAddressMode::eClampToEdge,
+            .addressModeT = rhi::SamplerAddressMode::eClampToEdge,
+            .addressModeR = rhi::SamplerAddressMode::eClampToEdge,
+        });
+        m_Samplers["point"]    = m_RenderDevice->getSampler({
+            .magFilter  = rhi::TexelFilter::eNearest,
+            .minFilter  = rhi::TexelFilter::eNearest,
+            .mipmapMode = rhi::MipmapMode::eNearest,
+
+            .addressModeS = rhi::SamplerAddressMode::eClampToEdge,
+            .addressModeT = rhi::SamplerAddressMode::eClampToEdge,
+            .addressModeR = rhi::SamplerAddressMode::eClampToEdge,
+        });
+
         m_Editor.initialize();
+        m_Runtime.load("graph.vfg");
     }
 
     ~RenderGraphExampleApp() override { m_Editor.shutdown(); }
@@ -27,7 +56,12 @@ public:
     void onImGui() override
     {
         ImGui::Begin("Render Graph Example");
-        ImGui::Text("Hello, world!");
+        ImGui::Text("Save the graph to apply it, the runtime reloads graph.vfg when it changes.");
+        ImGui::Text("Graph version: %llu", static_cast<unsigned long long>(m_Runtime.getVersion()));
+        if (!m_Runtime.getError().empty())
+        {
+            ImGui::TextColored(ImVec4 {1.0f, 0.3f, 0.3f, 1.0f}, "%s", m_Runtime.getError().c_str());
+        }
 #ifdef VULTRA_ENABLE_RENDERDOC
         ImGui::Button("Capture One Frame");
         if (ImGui::IsItemClicked())
@@ -43,11 +77,54 @@ public:
     void onRender(rhi::CommandBuffer& cb, const rhi::RenderTargetView rtv, const fsec dt) override
     {
         const auto& [frameIndex, target] = rtv;
+
+        m_Time += dt.count();
+        m_Runtime.reloadIfChanged();
+
+        // The GUI is drawn on top of the graph output, clear only if there is nothing to show.
+        m_ClearColor = std::nullopt;
+        if (m_Runtime.isValid())
+        {
+            // Read by the compiled graph when it executes.
+            m_BackBuffer = &target;
+            m_FrameInfo  = {.extent = target.getExtent(), .time = m_Time};
+
+            // The graph is compiled once per version of the description and target, then only executed.
+            std::size_t key {0};
+            hashCombine(key, m_FrameInfo.extent.width, m_FrameInfo.extent.height, target.getPixelFormat());
+            auto& fg = m_Runtime.getFrameGraph(
+                key,
+                [this](FrameGraph& graph) {
+                    return framegraph::GraphPassResources {
+                        {"Backbuffer", framegraph::importTexture(graph, "Backbuffer", &m_BackBuffer)},
+                    };
+                },
+                &m_FrameInfo);
+
+            gfx::RendererRenderContext rc {cb, m_Samplers};
+            FG_GPU_ZONE(rc.commandBuffer);
+            fg.execute(&rc, &m_TransientResources);
+
+            m_TransientResources.update();
+        }
+        else
+        {
+            m_ClearColor = kClearColor;
+        }
+
         ImGuiApp::onRender(cb, rtv, dt);
     }
 
 private:
+    framegraph::TransientResources m_TransientResources;
+    framegraph::Samplers           m_Samplers;
+    framegraph::GraphRuntime       m_Runtime;
+
     FrameGraphEditorPanel m_Editor;
+
+    rhi::Texture*    m_BackBuffer {nullptr};
+    ExampleFrameInfo m_FrameInfo {};
+    float            m_Time {0.0f};
 };
 
 CONFIG_MAIN(RenderGraphExampleApp)
\ No newline at end of file
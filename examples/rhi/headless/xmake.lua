@@ -0,0 +1,7 @@
+target("example-rhi-headless")
+    set_kind("binary")
+    add_files("main.cpp")
+    add_deps("vultra")
+
+    -- set target directory
+    set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/example-rhi-headless")
\ No newline at end of file
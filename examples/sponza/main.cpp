@@ -17,6 +17,7 @@ using namespace vultra;
 const char* MODEL_ENTITY_NAME = "Sponza";
 const char* MODEL_PATH        = "resources/models/Sponza/Sponza.gltf";
 const char* ENV_MAP_PATH      = "resources/textures/environment_maps/citrus_orchard_puresky_1k.hdr";
+const char* PIPELINE_MANIFEST = "sponza_pipelines.bin";
 
 class SponzaApp final : public ImGuiApp
 {
@@ -27,12 +28,15 @@ public:
                   .renderDeviceFeatureFlag =
                       rhi::RenderDeviceFeatureFlagBits::eRayTracing | rhi::RenderDeviceFeatureFlagBits::eMeshShader},
                  {.enableDocking = false}),
-        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat())
+        m_Renderer(*m_RenderDevice, m_Swapchain.getFormat(), m_FrameController.size())
     {
         // Render Settings
         // As the Sponza scene is in-door, we disable IBL by default
         m_Renderer.getSettings().enableIBL = false;
 
+        // Compile the pipelines of the previous run while the scene loads
+        m_Renderer.warmUpPipelines(PIPELINE_MANIFEST);
+
         // Setup scene
 
         // Main Camera
@@ -88,6 +92,8 @@ public:
         // Set camera far plane based on model's AABB
         auto& rawMesh     = model.getComponent<RawMeshComponent>().mesh;
         camComponent.zFar = rawMesh->aabb.getRadius() * 2.0f;
+
+        m_RenderDevice->getPipelineCompiler().waitIdle();
     }
 
     void onImGui() override
@@ -38,6 +38,7 @@ rule_end()
 
 includes("window")
 includes("rhi/triangle")
+includes("rhi/headless")
 includes("imgui")
 includes("framegraph/triangle")
 includes("openxr/triangle")
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <optional>
+
+namespace vultra
+{
+    // Sub-allocates [0, capacity) with a best fit free list, adjacent free ranges are merged back on free.
+    // Hands out offsets only, the memory itself lives elsewhere (see rhi::GeometryPool). Not thread-safe.
+    class RangeAllocator final
+    {
+    public:
+        explicit RangeAllocator(uint64_t capacity = 0);
+
+        // The offset is a multiple of the alignment, which does not have to be a power of two (vertex strides).
+        [[nodiscard]] std::optional<uint64_t> allocate(uint64_t size, uint64_t alignment = 1);
+        // Of a range returned by allocate.
+        void free(uint64_t offset, uint64_t size);
+
+        [[nodiscard]] uint64_t getCapacity() const;
+        [[nodiscard]] uint64_t getUsedSize() const;
+        [[nodiscard]] uint64_t getLargestFreeRange() const;
+        [[nodiscard]] uint32_t getNumFreeRanges() const;
+
+        [[nodiscard]] bool empty() const;
+
+    private:
+        void addFreeRange(uint64_t offset, uint64_t size);
+        void removeFreeRange(std::map<uint64_t, uint64_t>::iterator);
+
+    private:
+        uint64_t m_Capacity {0};
+        uint64_t m_UsedSize {0};
+
+        std::map<uint64_t, uint64_t>      m_FreeByOffset; // offset -> size
+        std::multimap<uint64_t, uint64_t> m_FreeBySize;   // size -> offset
+    };
+} // namespace vultra
\ No newline at end of file
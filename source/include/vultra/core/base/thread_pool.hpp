@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vultra
+{
+    // Fixed set of worker threads for fork-join jobs (see parallelFor).
+    // The calling thread takes part in every job as thread 0.
+    class ThreadPool final
+    {
+    public:
+        // 0: one worker per hardware thread, minus the calling one.
+        explicit ThreadPool(uint32_t numWorkers = 0);
+        ThreadPool(const ThreadPool&)     = delete;
+        ThreadPool(ThreadPool&&) noexcept = delete;
+        ~ThreadPool();
+
+        ThreadPool& operator=(const ThreadPool&)     = delete;
+        ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+        // Including the calling thread.
+        [[nodiscard]] uint32_t getNumThreads() const;
+
+        using Task = std::function<void(uint32_t taskIndex, uint32_t threadIndex)>;
+
+        // Runs the task for every index in [0, numTasks) and blocks until all of them are done.
+        // threadIndex is in [0, getNumThreads()) and unique among the tasks running at the same time.
+        // Not reentrant, tasks must not throw.
+        void parallelFor(uint32_t numTasks, const Task&);
+
+    private:
+        void workerLoop(uint32_t threadIndex);
+        void runTasks(uint32_t threadIndex);
+
+    private:
+        std::vector<std::thread> m_Workers;
+
+        std::mutex              m_Mutex;
+        std::condition_variable m_WorkAvailable;
+        std::condition_variable m_WorkDone;
+
+        const Task*           m_Task {nullptr};
+        uint32_t              m_NumTasks {0};
+        std::atomic<uint32_t> m_NextTask {0};
+        uint32_t              m_NumBusyWorkers {0};
+        uint64_t              m_Generation {0}; // Bumped per job, wakes the workers
+        bool                  m_Quit {false};
+    };
+} // namespace vultra
\ No newline at end of file
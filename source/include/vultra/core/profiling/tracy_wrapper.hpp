@@ -13,4 +13,6 @@ using TracyVkCtx = void*;
 #define TracyVkZone(x, y, z)
 #define TracyVkCollect(x, y)
 #define FrameMark
+#define TracyPlot(name, value)
+#define TracyPlotConfig(name, type, step, fill, color)
 #endif
\ No newline at end of file
@@ -3,6 +3,8 @@
 #include "vultra/core/rhi/barrier_scope.hpp"
 #include "vultra/core/rhi/image_layout.hpp"
 
+#include <functional>
+#include <optional>
 #include <vector>
 
 namespace vultra
@@ -33,6 +35,14 @@ namespace vultra
         public:
             [[nodiscard]] bool isEffective() const;
 
+            // Per Builder, between resetStats() calls.
+            struct Stats
+            {
+                uint32_t numRequested {0}; // memory/buffer/imageBarrier calls
+                uint32_t numSkipped {0};   // Requests already satisfied by the tracked state
+                uint32_t numEmitted {0};   // Barriers recorded, after merging
+            };
+
             class Builder
             {
                 friend class CommandBuffer;
@@ -46,6 +56,8 @@ namespace vultra
                 Builder& operator=(const Builder&)     = delete;
                 Builder& operator=(Builder&&) noexcept = default;
 
+                // Barriers are merged until the next flush: consecutive transitions of a subresource are folded, and
+                // compatible transitions of adjacent mip levels/layers are widened into a single range.
                 Builder& memoryBarrier(const BarrierScope& src, const BarrierScope& dst);
 
                 struct BufferInfo
@@ -66,28 +78,76 @@ namespace vultra
                                                                 0u,
                                                                 vk::RemainingArrayLayers};
                 };
+                // The state (layout and last scope) is tracked per mip level and layer once a partial range diverges.
                 Builder& imageBarrier(ImageInfo info, const BarrierScope& dst);
 
+                // -- Queue family ownership (exclusive images shared between queues):
+
+                struct QueueOwnership
+                {
+                    // Family the command buffer is submitted to.
+                    uint32_t queueFamilyIndex {vk::QueueFamilyIgnored};
+                    // Owner of images that were never transferred.
+                    uint32_t defaultQueueFamilyIndex {vk::QueueFamilyIgnored};
+                    // Called (by the frame graph) before an image owned by another family is accessed.
+                    std::function<void(const Texture&)> onForeignAccess;
+                };
+                // Recorded acquire, the matching release has to be submitted to the source queue before it.
+                struct OwnershipTransfer
+                {
+                    const Texture*            image {nullptr};
+                    uint32_t                  srcQueueFamilyIndex {vk::QueueFamilyIgnored};
+                    uint32_t                  dstQueueFamilyIndex {vk::QueueFamilyIgnored};
+                    BarrierScope              srcScope;
+                    ImageLayout               oldLayout {ImageLayout::eUndefined};
+                    ImageLayout               newLayout {ImageLayout::eUndefined};
+                    vk::ImageSubresourceRange subresourceRange;
+                };
+
+                // While tracked, imageBarrier acquires images owned by another family (contents of undefined
+                // images are discarded instead).
+                Builder& trackQueueOwnership(std::optional<QueueOwnership>);
+                [[nodiscard]] const std::optional<QueueOwnership>& getQueueOwnership() const;
+                [[nodiscard]] bool                                 isForeign(const Texture&) const;
+
+                Builder& releaseOwnership(const OwnershipTransfer&);
+                [[nodiscard]] std::vector<OwnershipTransfer> takeOwnershipTransfers();
+
+                // The Barrier points to the storage of the builder, it is valid until the next call.
                 [[nodiscard]] Barrier build();
 
+                [[nodiscard]] const Stats& getStats() const;
+                void                       resetStats();
+
             private:
-                Builder& imageBarrier(vk::Image,
-                                      const BarrierScope&,
-                                      const BarrierScope&,
-                                      ImageLayout,
-                                      ImageLayout,
-                                      const vk::ImageSubresourceRange&);
+                // Folded into a pending barrier of the same subresource range (if any), returns the recorded one.
+                vk::ImageMemoryBarrier2& imageBarrier(vk::Image,
+                                                      const BarrierScope&,
+                                                      const BarrierScope&,
+                                                      ImageLayout,
+                                                      ImageLayout,
+                                                      const vk::ImageSubresourceRange&,
+                                                      uint32_t srcQueueFamilyIndex = vk::QueueFamilyIgnored,
+                                                      uint32_t dstQueueFamilyIndex = vk::QueueFamilyIgnored);
+
+                [[nodiscard]] uint32_t getOwner(const Texture&) const;
+
+                // Keeps the capacity for the next flush.
+                void clear();
 
             private:
                 Dependencies m_Dependencies;
+                Stats        m_Stats;
+
+                std::optional<QueueOwnership>  m_QueueOwnership;
+                std::vector<OwnershipTransfer> m_OwnershipTransfers;
             };
 
         private:
-            explicit Barrier(Dependencies&&);
+            explicit Barrier(const Dependencies&);
 
         private:
             vk::DependencyInfo m_Info;
-            Dependencies       m_Dependencies;
         };
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
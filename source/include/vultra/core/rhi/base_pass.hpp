@@ -1,10 +1,15 @@
 #pragma once
 
 #include "vultra/core/base/base.hpp"
+#include "vultra/core/base/common_context.hpp"
 #include "vultra/core/base/hash.hpp"
 #include "vultra/core/rhi/base_pipeline.hpp"
+#include "vultra/core/rhi/pipeline_compiler.hpp"
 
+#include <atomic>
 #include <memory>
+#include <tuple>
+#include <typeinfo>
 #include <unordered_map>
 
 namespace vultra
@@ -18,10 +23,17 @@ namespace vultra
         class BasePass
         {
         public:
-            explicit BasePass(RenderDevice& rd) : m_RenderDevice {rd} {}
-            BasePass(const BasePass&)     = delete;
-            BasePass(BasePass&&) noexcept = default;
-            ~BasePass()                   = default;
+            explicit BasePass(RenderDevice& rd) : m_RenderDevice {rd}, m_PipelineCompiler {&getPipelineCompiler(rd)} {}
+            BasePass(const BasePass&) = delete;
+            BasePass(BasePass&& other) noexcept :
+                m_RenderDevice {other.m_RenderDevice}, m_PipelineCompiler {other.m_PipelineCompiler}
+            {
+                // The jobs point to the pass they were queued by.
+                other.waitForPendingPipelines();
+                m_Pipelines = std::move(other.m_Pipelines);
+                m_Pending   = std::move(other.m_Pending);
+            }
+            ~BasePass() { waitForPendingPipelines(); }
 
             BasePass& operator=(const BasePass&) noexcept = delete;
             BasePass& operator=(BasePass&&) noexcept      = default;
@@ -29,32 +41,190 @@ namespace vultra
             RenderDevice& getRenderDevice() const { return m_RenderDevice; }
 
             [[nodiscard]] auto count() const { return static_cast<uint32_t>(m_Pipelines.size()); }
-            void               clear() { m_Pipelines.clear(); }
+            void               clear()
+            {
+                waitForPendingPipelines();
+                m_Pipelines.clear();
+                m_Pending.clear();
+            }
+
+            // Queues every pipeline of this pass found in the manifest (see PipelineManifest) on the
+            // PipelineCompiler, call while loading. Only for passes that declare their createPipeline arguments:
+            //   using PipelineKey = std::tuple<...>; // Serializable with cereal
+            // Returns the number of new pipelines (compiled in place if the compiler is disabled).
+            uint32_t warmUpPipelines()
+            {
+                if constexpr (requires { typename TargetPass::PipelineKey; })
+                {
+                    uint32_t numQueued {0};
+                    for (const auto& blob : m_PipelineCompiler->getManifest().getKeys(getManifestName()))
+                    {
+                        typename TargetPass::PipelineKey key {};
+                        if (!PipelineManifest::decode(blob, key))
+                        {
+                            VULTRA_CORE_WARN("[PipelineManifest] Skipping an unreadable key of {}", getManifestName());
+                            continue;
+                        }
+                        const auto numKnown = m_Pipelines.size() + m_Pending.size();
+                        std::apply([this](const auto&... args) { getPipelineAsync(args...); }, key);
+                        if (m_Pipelines.size() + m_Pending.size() > numKnown)
+                            ++numQueued;
+                    }
+                    return numQueued;
+                }
+                else
+                {
+                    return 0;
+                }
+            }
 
         protected:
             template<typename... Args>
             PipelineType* getPipeline(Args&&... args)
             {
-                std::size_t hash {0};
-                (hashCombine(hash, args), ...);
+                const auto hash = makeKey(args...);
 
                 if (const auto it = m_Pipelines.find(hash); it != m_Pipelines.cend())
                 {
-                    return it->second.get();
+                    return upgradePipeline(it->second.get());
+                }
+                // Requested asynchronously before, no point in compiling it twice.
+                if (const auto it = m_Pending.find(hash); it != m_Pending.cend())
+                {
+                    it->second->ready.wait(false, std::memory_order_acquire);
+                    return resolve(it);
                 }
 
-                auto pipeline = static_cast<TargetPass*>(this)->createPipeline(std::forward<Args>(args)...);
+                recordKey(args...);
+
+                const auto begin    = PipelineCompiler::Clock::now();
+                auto       pipeline = static_cast<TargetPass*>(this)->createPipeline(std::forward<Args>(args)...);
+                m_PipelineCompiler->reportCompiled(PipelineCompiler::Clock::now() - begin, false);
+
                 const auto& [inserted, _] =
                     m_Pipelines.emplace(hash, pipeline ? std::make_unique<PipelineType>(std::move(pipeline)) : nullptr);
                 return inserted->second.get();
             }
 
+            // Same as getPipeline, except that a new pipeline is created on the PipelineCompiler threads:
+            // returns nullptr until it is ready, draw with a fallback pipeline (or skip the draw) meanwhile.
+            // The arguments are copied into the job, createPipeline must only read the pass (const).
+            template<typename... Args>
+            PipelineType* getPipelineAsync(Args&&... args)
+            {
+                const auto hash = makeKey(args...);
+
+                if (const auto it = m_Pipelines.find(hash); it != m_Pipelines.cend())
+                {
+                    return upgradePipeline(it->second.get());
+                }
+                if (const auto it = m_Pending.find(hash); it != m_Pending.cend())
+                {
+                    return it->second->ready.load(std::memory_order_acquire) ? resolve(it) : nullptr;
+                }
+                if (!m_PipelineCompiler->isEnabled())
+                {
+                    return getPipeline(std::forward<Args>(args)...);
+                }
+
+                recordKey(args...);
+
+                auto pending = std::make_shared<PendingPipeline>();
+                m_Pending.emplace(hash, pending);
+                const auto* pass = static_cast<const TargetPass*>(this);
+                m_PipelineCompiler->enqueue([pending, pass, key = std::make_tuple(args...)] {
+                    try
+                    {
+                        pending->pipeline =
+                            std::apply([pass](const auto&... a) { return pass->createPipeline(a...); }, key);
+                    }
+                    catch (const std::exception& e)
+                    {
+                        VULTRA_CORE_ERROR("[PipelineCompiler] Failed to create pipeline: {}", e.what());
+                    }
+                    pending->ready.store(true, std::memory_order_release);
+                    pending->ready.notify_all();
+                });
+                return nullptr;
+            }
+
+        private:
+            struct PendingPipeline
+            {
+                PipelineType                        pipeline;
+                PipelineCompiler::Clock::time_point requested {PipelineCompiler::Clock::now()};
+                std::atomic<bool>                   ready {false};
+            };
+            using PendingPipelines = std::unordered_map<std::size_t, std::shared_ptr<PendingPipeline>>;
+
+            // Swaps in the optimized link of a graphics pipeline once the PipelineCompiler finished it.
+            static PipelineType* upgradePipeline(PipelineType* pipeline)
+            {
+                if constexpr (requires { pipeline->upgrade(); })
+                {
+                    if (pipeline)
+                        pipeline->upgrade();
+                }
+                return pipeline;
+            }
+
+            template<typename... Args>
+            [[nodiscard]] static std::size_t makeKey(const Args&... args)
+            {
+                std::size_t hash {0};
+                (hashCombine(hash, args), ...);
+                return hash;
+            }
+
+            [[nodiscard]] static const std::string& getManifestName()
+            {
+                static const std::string kName {typeid(TargetPass).name()};
+                return kName;
+            }
+
+            template<typename... Args>
+            void recordKey(const Args&... args)
+            {
+                if constexpr (requires { typename TargetPass::PipelineKey; })
+                {
+                    using Key = typename TargetPass::PipelineKey;
+                    // Calls relying on default arguments are not recorded, pass them explicitly.
+                    if constexpr (std::is_same_v<std::tuple<std::decay_t<Args>...>, Key>)
+                    {
+                        m_PipelineCompiler->getManifest().record(getManifestName(),
+                                                                 PipelineManifest::encode(Key {args...}));
+                    }
+                }
+            }
+
+            PipelineType* resolve(typename PendingPipelines::iterator it)
+            {
+                auto& pending = *it->second;
+                m_PipelineCompiler->reportCompiled(PipelineCompiler::Clock::now() - pending.requested, true);
+
+                auto        pipeline      = std::move(pending.pipeline);
+                const auto& [inserted, _] = m_Pipelines.emplace(
+                    it->first, pipeline ? std::make_unique<PipelineType>(std::move(pipeline)) : nullptr);
+                m_Pending.erase(it);
+                return inserted->second.get();
+            }
+
+            void waitForPendingPipelines()
+            {
+                for (auto& [_, pending] : m_Pending)
+                {
+                    pending->ready.wait(false, std::memory_order_acquire);
+                }
+            }
+
         private:
-            RenderDevice& m_RenderDevice;
+            RenderDevice&     m_RenderDevice;
+            PipelineCompiler* m_PipelineCompiler {nullptr};
 
             // Key = Hashed args passed to _createPipeline.
             using PipelineCache = std::unordered_map<std::size_t, Scope<PipelineType>>;
-            PipelineCache m_Pipelines;
+            PipelineCache    m_Pipelines;
+            PendingPipelines m_Pending; // Being compiled by the PipelineCompiler, same keys
         };
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
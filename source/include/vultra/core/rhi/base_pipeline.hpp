@@ -37,6 +37,9 @@ namespace vultra
         protected:
             BasePipeline(const vk::Device, PipelineLayout&&, const vk::Pipeline);
 
+            // For pipelines replaced in place (see GraphicsPipeline::upgrade), returns the previous handle.
+            vk::Pipeline exchangeHandle(const vk::Pipeline);
+
         private:
             void destroy() noexcept;
 
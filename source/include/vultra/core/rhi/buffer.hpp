@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vultra/core/rhi/barrier_scope.hpp"
+#include "vultra/core/rhi/memory_stats.hpp"
 
 #include <vk_mem_alloc.hpp>
 
@@ -31,6 +32,12 @@ namespace vultra
 
             [[nodiscard]] vk::Buffer     getHandle() const;
             [[nodiscard]] vk::DeviceSize getSize() const;
+            // See generateResourceId().
+            [[nodiscard]] uint64_t getId() const;
+
+            [[nodiscard]] MemoryCategory getMemoryCategory() const;
+            // Moves the allocation to another category of the memory stats (see trackMemory()).
+            Buffer& setMemoryCategory(MemoryCategory);
 
             void*   map();
             Buffer& unmap();
@@ -42,7 +49,8 @@ namespace vultra
                    vk::DeviceSize size,
                    vk::BufferUsageFlags,
                    vma::AllocationCreateFlags,
-                   vma::MemoryUsage);
+                   vma::MemoryUsage,
+                   MemoryCategory = MemoryCategory::eOther);
 
             void destroy() noexcept;
 
@@ -54,6 +62,8 @@ namespace vultra
 
             vk::DeviceSize m_Size {0};
             void*          m_MappedMemory {nullptr};
+            uint64_t       m_Id {0};
+            MemoryCategory m_MemoryCategory {MemoryCategory::eOther};
         };
 
     } // namespace rhi
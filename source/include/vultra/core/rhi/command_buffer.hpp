@@ -4,11 +4,13 @@
 #include "vultra/core/base/scoped_enum_flags.hpp"
 #include "vultra/core/rhi/barrier.hpp"
 #include "vultra/core/rhi/debug_marker.hpp"
-#include "vultra/core/rhi/descriptorset_allocator.hpp"
 #include "vultra/core/rhi/descriptorset_builder.hpp"
+#include "vultra/core/rhi/descriptorset_cache.hpp"
 #include "vultra/core/rhi/framebuffer_info.hpp"
 #include "vultra/core/rhi/geometry_info.hpp"
+#include "vultra/core/rhi/gpu_zone.hpp"
 #include "vultra/core/rhi/image_aspect.hpp"
+#include "vultra/core/rhi/queue_type.hpp"
 #include "vultra/core/rhi/rect2d.hpp"
 #include "vultra/core/rhi/shader_type.hpp"
 #include "vultra/core/rhi/texel_filter.hpp"
@@ -34,10 +36,12 @@ namespace vultra
         class BasePipeline;
         class ComputePipeline;
         class ShaderBindingTable;
+        class QueryPool;
 
         class CommandBuffer final
         {
             friend class RenderDevice;
+            friend class CommandPool;
             friend class DebugMarker;
             friend class imgui::ImGuiRenderer;
 
@@ -79,11 +83,17 @@ namespace vultra
 
             [[nodiscard]] vk::CommandBuffer getHandle() const;
             [[nodiscard]] TracyVkCtx        getTracyContext() const;
+            [[nodiscard]] QueueType         getQueueType() const;
+            [[nodiscard]] bool              isInsideRenderPass() const;
+            [[nodiscard]] bool              isSecondary() const;
 
             Barrier::Builder&                  getBarrierBuilder();
             [[nodiscard]] DescriptorSetBuilder createDescriptorSetBuilder();
 
             CommandBuffer& begin();
+            // Secondary command buffers only, continues the render pass of the given framebuffer
+            // (see beginRendering with secondary contents).
+            CommandBuffer& begin(const FramebufferInfo&);
             CommandBuffer& end();
             CommandBuffer& reset();
 
@@ -97,6 +107,10 @@ namespace vultra
             CommandBuffer& traceRays(const ShaderBindingTable& sbt, const glm::uvec3& extent);
 
             CommandBuffer& bindDescriptorSet(const DescriptorSetIndex, const vk::DescriptorSet);
+            // Requires a push descriptor set (of the bound pipeline), see DescriptorSetBuilder::push.
+            CommandBuffer& pushDescriptorSet(const DescriptorSetIndex,
+                                             std::span<const vk::DescriptorUpdateTemplateEntry>,
+                                             const void* data);
 
             CommandBuffer&
             pushConstants(const ShaderStages, const uint32_t offset, const uint32_t size, const void* data);
@@ -110,9 +124,13 @@ namespace vultra
             // ---
 
             // Does not insert barriers for attachments.
-            CommandBuffer& beginRendering(const FramebufferInfo&);
+            // secondaryContents: the render pass is recorded in secondary command buffers (executeCommands only).
+            CommandBuffer& beginRendering(const FramebufferInfo&, const bool secondaryContents = false);
             CommandBuffer& endRendering();
 
+            // Secondary command buffers in the executable state, any bound state is lost afterwards.
+            CommandBuffer& executeCommands(std::span<CommandBuffer* const>);
+
             CommandBuffer& setViewport(const Rect2D&);
             CommandBuffer& setScissor(const Rect2D&);
 
@@ -120,6 +138,9 @@ namespace vultra
             CommandBuffer& drawFullScreenTriangle();
             CommandBuffer& drawCube();
             CommandBuffer& drawMeshTask(const glm::uvec3& numTaskGroups);
+            // Clears layers [baseLayer, baseLayer + layerCount) of the current depth attachment.
+            CommandBuffer&
+            clearDepthAttachment(const Rect2D&, const float depth, const uint32_t baseLayer, const uint32_t layerCount);
 
             // ---
 
@@ -140,20 +161,38 @@ namespace vultra
 
             CommandBuffer& generateMipmaps(Texture&, const TexelFilter = TexelFilter::eLinear);
 
+            // ---
+
+            CommandBuffer& resetQueryPool(QueryPool&, const uint32_t first, const uint32_t count);
+            // Outside of a render pass only (flushes pending barriers first).
+            CommandBuffer& writeTimestamp(QueryPool&, const uint32_t query, const PipelineStages);
+            // Pipeline statistics (or occlusion) queries, begin and end on the same side of a render pass.
+            CommandBuffer& beginQuery(QueryPool&, const uint32_t query);
+            CommandBuffer& endQuery(QueryPool&, const uint32_t query);
+
             // ---
             CommandBuffer& flushBarriers();
 
+            // Adds a semaphore wait to the next submission of this command buffer (value is for timeline semaphores).
+            CommandBuffer& addWaitSemaphore(const vk::Semaphore,
+                                            const uint64_t value,
+                                            const vk::PipelineStageFlags2 = vk::PipelineStageFlagBits2::eAllCommands);
+
         private:
             CommandBuffer(const vk::Device,
                           const vk::CommandPool,
                           const vk::CommandBuffer,
                           TracyVkCtx,
                           const vk::Fence,
-                          const bool enableRaytracing = false);
+                          DescriptorSetCache*,
+                          const QueueType              = QueueType::eGeneric,
+                          const vk::CommandBufferLevel = vk::CommandBufferLevel::ePrimary);
 
             [[nodiscard]] bool invariant(const State requiredState, const InvariantFlags = InvariantFlags::eNone) const;
 
             void destroy() noexcept;
+            // After the owning pool has been reset (secondary command buffers).
+            void recycle();
 
             void chunkedUpdate(const vk::Buffer, vk::DeviceSize offset, vk::DeviceSize size, const void* data) const;
 
@@ -169,13 +208,16 @@ namespace vultra
 
             State m_State {State::eInvalid};
 
-            vk::CommandBuffer m_Handle {VK_NULL_HANDLE};
-            TracyVkCtx        m_TracyContext {nullptr};
+            vk::CommandBuffer      m_Handle {VK_NULL_HANDLE};
+            vk::CommandBufferLevel m_Level {vk::CommandBufferLevel::ePrimary};
+            TracyVkCtx             m_TracyContext {nullptr};
 
             vk::Fence m_Fence {VK_NULL_HANDLE};
+            QueueType m_QueueType {QueueType::eGeneric};
+
+            std::vector<vk::SemaphoreSubmitInfo> m_WaitSemaphores;
 
-            DescriptorSetAllocator m_DescriptorSetAllocator;
-            DescriptorSetCache     m_DescriptorSetCache;
+            DescriptorSetCache* m_DescriptorSetCache {nullptr}; // Owned by the RenderDevice
 
             Barrier::Builder m_BarrierBuilder;
 
@@ -224,6 +266,7 @@ struct HasFlags<vultra::rhi::CommandBuffer::InvariantFlags> : std::true_type
 #define TRACKY_GPU_ZONE(CommandBuffer, Label) TRACKY_VK_SCOPE(CommandBuffer, Label, GPU)
 
 #define RHI_GPU_ZONE(CommandBuffer, Label) \
+    RHI_GPU_PROFILE_ZONE(CommandBuffer, Label); \
     RHI_NAMED_DEBUG_MARKER(CommandBuffer, Label); \
     TRACY_GPU_TRANSIENT_ZONE(CommandBuffer, Label) \
     TRACKY_GPU_ZONE(CommandBuffer, Label)
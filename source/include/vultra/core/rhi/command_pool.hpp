@@ -0,0 +1,59 @@
+#pragma once
+
+#include "vultra/core/rhi/command_buffer.hpp"
+
+#include <deque>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        // Owns secondary command buffers, so that they can be recorded on threads other than the one owning the
+        // frame command buffer. Externally synchronized: one thread records from a pool at a time.
+        class CommandPool final
+        {
+            friend class RenderDevice;
+
+        public:
+            CommandPool()                   = default;
+            CommandPool(const CommandPool&) = delete;
+            CommandPool(CommandPool&&) noexcept;
+            ~CommandPool();
+
+            CommandPool& operator=(const CommandPool&) = delete;
+            CommandPool& operator=(CommandPool&&) noexcept;
+
+            [[nodiscard]] explicit operator bool() const;
+
+            [[nodiscard]] vk::CommandPool getHandle() const;
+            [[nodiscard]] QueueType       getQueueType() const;
+            // Acquired since the last reset.
+            [[nodiscard]] uint32_t getNumAcquired() const;
+
+            // In the initial state, allocated on demand and reused after reset().
+            [[nodiscard]] CommandBuffer& acquireSecondary();
+
+            // Recycles every acquired command buffer at once, the GPU must be done with all of them.
+            void reset();
+
+        private:
+            CommandPool(const vk::Device,
+                        const vk::CommandPool,
+                        TracyVkCtx,
+                        DescriptorSetCache*,
+                        const QueueType queueType);
+
+            void destroy() noexcept;
+
+        private:
+            vk::Device          m_Device {nullptr};
+            vk::CommandPool     m_Handle {nullptr};
+            TracyVkCtx          m_TracyContext {nullptr};
+            DescriptorSetCache* m_DescriptorSetCache {nullptr};
+            QueueType           m_QueueType {QueueType::eGeneric};
+
+            std::deque<CommandBuffer> m_CommandBuffers; // Stable addresses
+            uint32_t                  m_NumAcquired {0};
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
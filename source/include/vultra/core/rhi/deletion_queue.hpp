@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        // Keeps released resources (Buffer, Texture, pipelines, ...) alive until the GPU is done with the frame that
+        // released them, so they can be replaced mid-session without RenderDevice::waitIdle.
+        // A resource pushed during frame N is destroyed by nextFrame, once the fence of frame N has been waited on
+        // (see FrameController::acquireNextFrame), or by flush on an idle device.
+        // Thread-safe.
+        class DeletionQueue final
+        {
+        public:
+            DeletionQueue()                     = default;
+            DeletionQueue(const DeletionQueue&) = delete;
+            DeletionQueue(DeletionQueue&&)      = delete;
+            ~DeletionQueue();
+
+            DeletionQueue& operator=(const DeletionQueue&) = delete;
+            DeletionQueue& operator=(DeletionQueue&&)      = delete;
+
+            // Takes the ownership of the resource (the moved-from object is left empty).
+            template<typename T>
+            void push(T&& resource)
+            {
+                static_assert(!std::is_lvalue_reference_v<T>, "Move the resource into the queue");
+                using Type = std::remove_cvref_t<T>;
+
+                Resource ptr {new Type(std::move(resource)), [](void* p) { delete static_cast<Type*>(p); }};
+
+                std::lock_guard lock {m_Mutex};
+                m_Entries.push_back({m_FrameNumber, std::move(ptr)});
+            }
+
+            // Call once per frame, after waiting for the fence of the frame that is numFramesInFlight frames old.
+            void nextFrame(const uint32_t numFramesInFlight);
+            // Destroys everything, the device must be idle.
+            void flush();
+
+            // Of resources waiting for their frame to retire.
+            [[nodiscard]] std::size_t size() const;
+
+        private:
+            using Resource = std::unique_ptr<void, void (*)(void*)>;
+
+            struct Entry
+            {
+                uint64_t frameNumber {0};
+                Resource resource;
+            };
+
+            mutable std::mutex m_Mutex;
+            std::deque<Entry>  m_Entries; // In push (hence frame) order.
+            uint64_t           m_FrameNumber {0};
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
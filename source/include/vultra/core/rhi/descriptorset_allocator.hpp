@@ -2,27 +2,81 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <shared_mutex>
+#include <span>
+#include <unordered_map>
+
 namespace vultra
 {
     namespace rhi
     {
-        class CommandBuffer;
+        class DescriptorSetCache;
+
+        // Descriptor usage (per type) of every descriptor set layout created by the RenderDevice, i.e. of the
+        // reflected shaders. Pools are sized from it instead of fixed per-type ratios.
+        class DescriptorPoolSizer final
+        {
+        public:
+            void add(const vk::DescriptorSetLayout, std::span<const vk::DescriptorSetLayoutBinding>);
+
+            // Bumped by every add(), pools sized with an older generation are recreated.
+            [[nodiscard]] uint64_t getGeneration() const;
+
+            // Room for numSets sets of the average registered layout, and for at least one set of the largest
+            // one (per type). Empty until a layout has been added.
+            [[nodiscard]] std::vector<vk::DescriptorPoolSize> getPoolSizes(uint32_t numSets) const;
+            // Exactly one set of the given layout (empty for unknown layouts).
+            [[nodiscard]] std::vector<vk::DescriptorPoolSize> getSetSizes(const vk::DescriptorSetLayout) const;
+
+        private:
+            struct Usage
+            {
+                uint64_t total {0};     // Over all layouts
+                uint32_t maxPerSet {0}; // Largest single layout
+            };
+
+            mutable std::shared_mutex m_Mutex;
+
+            std::unordered_map<vk::DescriptorType, Usage>                                  m_Usage;
+            std::unordered_map<VkDescriptorSetLayout, std::vector<vk::DescriptorPoolSize>> m_Layouts;
+            uint64_t                                                                       m_Generation {0};
+        };
 
         struct DescriptorPool
         {
             vk::DescriptorPool handle {nullptr};
+            uint32_t           maxSets {0};
             uint32_t           numAllocatedSets {0};
+            uint64_t           generation {0}; // Of the DescriptorPoolSizer, when the pool was created
+            uint32_t           numIdleResets {0};
+            bool               exhausted {false}; // An allocation failed since the last reset
+            vk::DeviceSize     estimatedSize {0}; // See s_kEstimatedDescriptorSize
 
-            const static uint32_t s_kSetsPerPool;
+            vk::DescriptorSetLayout dedicatedLayout {nullptr}; // Pool for a single set of that layout
 
-            explicit DescriptorPool(vk::DescriptorPool h) : handle(h), numAllocatedSets(0) {}
+            const static uint32_t s_kSetsPerPool;
+            // A pool that stays empty for that many resets is destroyed.
+            const static uint32_t s_kMaxIdleResets;
+            // Pools live in driver memory that VMA does not see, the memory stats (MemoryCategory::eDescriptor)
+            // count them at that many bytes per descriptor (an upper bound on common desktop GPUs).
+            const static vk::DeviceSize s_kEstimatedDescriptorSize;
         };
 
         class DescriptorSetAllocator final
         {
-            friend class CommandBuffer;
+            friend class DescriptorSetCache;
 
         public:
+            struct Stats
+            {
+                uint32_t numAllocatedSets {0}; // Since the last reset
+                uint32_t numPools {0};         // Alive
+                // Since creation:
+                uint32_t numPoolsCreated {0};
+                uint32_t numPoolsDestroyed {0};
+                uint32_t numFailedAllocations {0}; // Out of pool memory or fragmented pool
+            };
+
             DescriptorSetAllocator()                              = default;
             DescriptorSetAllocator(const DescriptorSetAllocator&) = delete;
             DescriptorSetAllocator(DescriptorSetAllocator&&) noexcept;
@@ -32,23 +86,32 @@ namespace vultra
             DescriptorSetAllocator& operator=(DescriptorSetAllocator&&) noexcept;
 
             [[nodiscard]] vk::DescriptorSet allocate(const vk::DescriptorSetLayout, uint32_t);
-            void                            reset();
+            // The GPU must be done with every allocated set (the owning command buffer has completed).
+            // Trims pools that have been idle for a while or were sized for an older set of layouts.
+            void reset();
+
+            [[nodiscard]] Stats getStats() const;
 
         private:
-            explicit DescriptorSetAllocator(const vk::Device, bool raytracing = false);
+            DescriptorSetAllocator(const vk::Device, const DescriptorPoolSizer*, bool raytracing = false);
 
             void destroy() noexcept;
 
             [[nodiscard]] DescriptorPool&   createPool();
             [[nodiscard]] DescriptorPool&   getPool();
-            [[nodiscard]] vk::DescriptorSet allocate(DescriptorPool&, const vk::DescriptorSetLayout, uint32_t) const;
+            // Dedicated to a single set that does not fit into a regular pool.
+            [[nodiscard]] DescriptorPool&   getPool(const vk::DescriptorSetLayout);
+            [[nodiscard]] vk::DescriptorSet allocate(DescriptorPool&, const vk::DescriptorSetLayout, uint32_t);
 
         private:
-            vk::Device m_Device {nullptr};
+            vk::Device                 m_Device {nullptr};
+            const DescriptorPoolSizer* m_PoolSizer {nullptr};
 
             std::vector<DescriptorPool> m_DescriptorPools;
             int32_t                     m_LastPoolIndex {-1};
             bool                        m_EnableRaytracing {false};
+
+            Stats m_Stats;
         };
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
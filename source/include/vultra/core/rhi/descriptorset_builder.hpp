@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <map>
 #include <unordered_map>
 #include <variant>
 
@@ -12,14 +13,12 @@ namespace vultra
 {
     namespace rhi
     {
-        class DescriptorSetAllocator;
+        class DescriptorSetCache;
+        class CommandBuffer;
         class Buffer;
         class Texture;
         class AccelerationStructure;
 
-        // Key = Hash.
-        using DescriptorSetCache = std::unordered_map<std::size_t, vk::DescriptorSet>;
-
         namespace bindings
         {
             struct SeparateSampler
@@ -82,7 +81,7 @@ namespace vultra
         {
         public:
             DescriptorSetBuilder() = delete;
-            DescriptorSetBuilder(const vk::Device, DescriptorSetAllocator&, DescriptorSetCache&);
+            explicit DescriptorSetBuilder(DescriptorSetCache&);
             DescriptorSetBuilder(const DescriptorSetBuilder&)     = delete;
             DescriptorSetBuilder(DescriptorSetBuilder&&) noexcept = delete;
 
@@ -100,37 +99,46 @@ namespace vultra
             DescriptorSetBuilder& bind(const BindingIndex, const bindings::AccelerationStructureKHR&);
 
             [[nodiscard]] vk::DescriptorSet build(const vk::DescriptorSetLayout);
+            // Writes the bindings straight into the command buffer (to a set of the bound pipeline that has been
+            // created as a push descriptor set, see PipelineLayout::isPushDescriptorSet).
+            void push(CommandBuffer&, const DescriptorSetIndex);
 
         private:
-            void clear();
+            // Fills m_TemplateEntries/m_TemplateData, returns the variable descriptor count.
+            // @param hash Optional, combined with every bound descriptor.
+            uint32_t pack(std::size_t* hash);
+            void     clear();
 
             void addImage(const vk::ImageView, const vk::ImageLayout);
             void addSampler(const vk::Sampler);
             void addCombinedImageSampler(const vk::ImageView, const vk::ImageLayout, const vk::Sampler);
             void addAccelerationStructure(const vk::AccelerationStructureKHR&);
 
-            DescriptorSetBuilder& bindBuffer(const BindingIndex, const vk::DescriptorType, vk::DescriptorBufferInfo&&);
+            DescriptorSetBuilder&
+            bindBuffer(const BindingIndex, const vk::DescriptorType, vk::DescriptorBufferInfo&&, uint64_t resourceId);
 
         private:
-            vk::Device              m_Device {nullptr};
-            DescriptorSetAllocator& m_DescriptorSetAllocator;
-            DescriptorSetCache&     m_DescriptorSetCache;
+            DescriptorSetCache& m_DescriptorSetCache;
 
             struct BindingInfo
             {
                 vk::DescriptorType type;
                 uint32_t           count {0};
-                int32_t            descriptorId {-1}; // Index to m_Descriptors
+                int32_t            descriptorId {-1}; // Index to m_ImageInfos/m_BufferInfos/m_AccelerationStructures
+                // Of Texture/Buffer::getId(), the handles alone are not unique (see generateResourceId()).
+                std::size_t resourceHash {0};
             };
 
-            // layout(binding = index)
-            std::unordered_map<BindingIndex, BindingInfo> m_Bindings;
+            // layout(binding = index), ordered so that the same bindings always give the same update template.
+            std::map<BindingIndex, BindingInfo> m_Bindings;
 
-            std::vector<vk::DescriptorImageInfo>                        m_ImageInfos;
-            std::vector<vk::DescriptorBufferInfo>                       m_BufferInfos;
-            std::vector<vk::WriteDescriptorSetAccelerationStructureKHR> m_ASInfos;
+            std::vector<vk::DescriptorImageInfo>      m_ImageInfos;
+            std::vector<vk::DescriptorBufferInfo>     m_BufferInfos;
+            std::vector<vk::AccelerationStructureKHR> m_AccelerationStructures;
 
-            std::vector<vk::AccelerationStructureKHR> m_AccelerationStructures; // To keep the handles alive.
+            // Reused by build() and push().
+            std::vector<vk::DescriptorUpdateTemplateEntry> m_TemplateEntries;
+            std::vector<std::byte>                         m_TemplateData;
         };
 
         [[nodiscard]] std::string_view toString(const ResourceBinding&);
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "vultra/core/rhi/descriptorset_allocator.hpp"
+#include "vultra/core/rhi/resource_indices.hpp"
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+
+        // Descriptor sets shared by every command buffer and kept across frames. A set is keyed by its layout and all
+        // of the bound resources, so once written (through a vk::DescriptorUpdateTemplate) it never changes.
+        // The hash only selects the entry, a hit also compares the layout, the template entries and the packed data.
+        // Sets live in one of two allocators (generations). A hit on a set of the older generation rewrites it into
+        // the current one, and every s_kFramesPerGeneration frames the older allocator is reset, dropping the sets
+        // that have not been used since (an approximate LRU).
+        // Thread-safe (command buffers might be recorded in parallel): hits only take a shared lock, a miss allocates
+        // and writes its set outside of it, under the lock of the allocator of the current generation.
+        class DescriptorSetCache final
+        {
+            friend class RenderDevice;
+
+        public:
+            struct Stats
+            {
+                uint32_t numSets {0};
+                uint32_t numPools {0};             // Of both generations
+                uint32_t numFailedAllocations {0}; // Since creation, see DescriptorSetAllocator::Stats
+                // During the previous frame:
+                uint32_t numHits {0};
+                uint32_t numMisses {0};
+            };
+
+            DescriptorSetCache()                          = delete;
+            DescriptorSetCache(const DescriptorSetCache&) = delete;
+            DescriptorSetCache(DescriptorSetCache&&)      = delete;
+            ~DescriptorSetCache();
+
+            DescriptorSetCache& operator=(const DescriptorSetCache&) = delete;
+            DescriptorSetCache& operator=(DescriptorSetCache&&)      = delete;
+
+            // @param hash Of the layout and every bound resource.
+            // @param entries Describe the (packed) data.
+            [[nodiscard]] vk::DescriptorSet get(std::size_t hash,
+                                                const vk::DescriptorSetLayout,
+                                                uint32_t variableDescriptorCount,
+                                                std::span<const vk::DescriptorUpdateTemplateEntry> entries,
+                                                std::span<const std::byte>                         data);
+
+            // For vkCmdPushDescriptorSetWithTemplateKHR, created once per layout/set/entries.
+            [[nodiscard]] vk::DescriptorUpdateTemplate
+            getPushTemplate(const vk::PipelineBindPoint,
+                            const vk::PipelineLayout,
+                            const DescriptorSetIndex,
+                            std::span<const vk::DescriptorUpdateTemplateEntry>);
+
+            // Call once per frame (the GPU must be done with frames older than s_kFramesPerGeneration).
+            void nextFrame();
+
+            [[nodiscard]] Stats getStats() const;
+
+            const static uint32_t s_kFramesPerGeneration;
+
+        private:
+            DescriptorSetCache(const vk::Device, const DescriptorPoolSizer*, bool raytracing);
+
+            // Of either vk::DescriptorUpdateTemplateType, locks m_TemplateMutex.
+            [[nodiscard]] vk::DescriptorUpdateTemplate
+            getUpdateTemplate(vk::DescriptorUpdateTemplateCreateInfo,
+                              std::span<const vk::DescriptorUpdateTemplateEntry>);
+
+        private:
+            vk::Device m_Device {nullptr};
+
+            mutable std::shared_mutex m_Mutex; // Of m_DescriptorSets and the generations
+
+            struct Entry
+            {
+                vk::DescriptorSet descriptorSet {nullptr};
+                uint32_t          generation {0}; // Index to m_Allocators
+
+                // What the set was written with, to tell hash collisions apart.
+                vk::DescriptorSetLayout                        layout {nullptr};
+                std::vector<vk::DescriptorUpdateTemplateEntry> templateEntries;
+                std::vector<std::byte>                         data;
+            };
+            // Key = Hash.
+            std::unordered_map<std::size_t, Entry> m_DescriptorSets;
+
+            std::mutex                                                    m_TemplateMutex;
+            std::unordered_map<std::size_t, vk::DescriptorUpdateTemplate> m_UpdateTemplates;
+
+            std::array<DescriptorSetAllocator, 2> m_Allocators;
+            mutable std::array<std::mutex, 2>     m_AllocatorMutexes; // Per generation
+            uint32_t                              m_CurrentGeneration {0};
+            uint32_t                              m_NumFrames {0}; // Since the last switch of generations
+
+            // During the current frame:
+            std::atomic<uint32_t> m_NumHits {0};
+            std::atomic<uint32_t> m_NumMisses {0};
+
+            Stats m_LastFrameStats;
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "vultra/core/rhi/command_buffer.hpp"
 #include "vultra/core/rhi/rendertarget_view.hpp"
+#include "vultra/core/rhi/texture.hpp"
 
 namespace vultra
 {
@@ -11,11 +12,14 @@ namespace vultra
         class Swapchain;
 
         // Simplifies usage of frames in flight.
+        // Either presents to a Swapchain, or (offscreen) renders into a ring of owned images, one per frame in flight.
         class FrameController final
         {
         public:
             FrameController() = default;
             FrameController(RenderDevice&, Swapchain&, const FrameIndex::ValueType numFramesInFlight);
+            // Offscreen, for headless rendering. Targets are usable as render target, sampled image and copy source.
+            FrameController(RenderDevice&, Extent2D, PixelFormat, const FrameIndex::ValueType numFramesInFlight);
             FrameController(const FrameController&) = delete;
             FrameController(FrameController&&) noexcept;
             ~FrameController();
@@ -25,8 +29,16 @@ namespace vultra
 
             [[nodiscard]] explicit operator bool() const;
 
+            [[nodiscard]] bool isOffscreen() const;
+
             [[nodiscard]] FrameIndex::ValueType size() const;
             [[nodiscard]] RenderTargetView      getCurrentTarget() const;
+            [[nodiscard]] Extent2D              getExtent() const;
+            [[nodiscard]] PixelFormat           getPixelFormat() const;
+
+            // Offscreen only. The target of the frame presented last, its content is final once the controller
+            // cycles back to that slot (or after RenderDevice::waitIdle).
+            [[nodiscard]] const Texture& getPreviousTarget() const;
 
             CommandBuffer&   beginFrame();
             bool             acquireNextFrame();
@@ -35,9 +47,12 @@ namespace vultra
             void present();
 
             void recreate();
+            // Offscreen only, a Swapchain follows its window instead.
+            void resize(Extent2D);
 
         private:
             void create(const FrameIndex::ValueType numFramesInFlight);
+            void createTargets(Extent2D, PixelFormat);
             void destroy() noexcept;
 
         private:
@@ -53,6 +68,9 @@ namespace vultra
             std::vector<PerFrameData> m_Frames;
             FrameIndex                m_FrameIndex;
 
+            // Offscreen targets, indexed like m_Frames.
+            std::vector<Scope<Texture>> m_Targets;
+
             bool m_ImageAcquired {false};
             bool m_ImageAcquireAttempted {false};
         };
@@ -27,12 +27,17 @@ namespace vultra
             std::optional<uint32_t>   layer;
             std::optional<CubeFace>   face;
             std::optional<ClearValue> clearValue;
+            // Ignored when cleared. False: the previous contents are not needed (VK_ATTACHMENT_LOAD_OP_DONT_CARE).
+            bool loadContents {true};
+            // False: the contents are not needed after the pass (VK_ATTACHMENT_STORE_OP_DONT_CARE).
+            bool storeContents {true};
         };
 
         struct FramebufferInfo
         {
             Rect2D                        area;
             uint32_t                      layers {1};
+            uint32_t                      viewMask {0}; // Multiview, ignores layers when non-zero
             std::optional<AttachmentInfo> depthAttachment {std::nullopt};
             bool                          depthReadOnly {false};
             std::optional<AttachmentInfo> stencilAttachment {std::nullopt};
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "vultra/core/base/base.hpp"
+#include "vultra/core/base/range_allocator.hpp"
+#include "vultra/core/rhi/buffer.hpp"
+
+#include <array>
+#include <mutex>
+#include <span>
+#include <unordered_set>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+        class VertexBuffer;
+        class IndexBuffer;
+        class GeometryPool;
+        struct GeometryPage;
+
+        enum class GeometryRegion : uint8_t
+        {
+            eVertex = 0, // Any vertex format, ranges are aligned to the stride
+            eIndex,      // IndexType::eUInt32
+            eMeshlet,    // Storage buffer, accessed through device addresses
+        };
+
+        // A range of one of the GeometryPool buffers, returned to the pool once the frames in flight are done with it.
+        class GeometryAllocation final
+        {
+            friend class GeometryPool;
+
+        public:
+            GeometryAllocation(const GeometryAllocation&)     = delete;
+            GeometryAllocation(GeometryAllocation&&) noexcept = delete;
+            ~GeometryAllocation();
+
+            GeometryAllocation& operator=(const GeometryAllocation&)     = delete;
+            GeometryAllocation& operator=(GeometryAllocation&&) noexcept = delete;
+
+            [[nodiscard]] GeometryRegion getRegion() const;
+
+            // In bytes, within getBuffer().
+            [[nodiscard]] vk::DeviceSize getOffset() const;
+            [[nodiscard]] vk::DeviceSize getSize() const;
+
+            [[nodiscard]] const Buffer&       getBuffer() const;
+            [[nodiscard]] const VertexBuffer& getVertexBuffer() const;
+            [[nodiscard]] const IndexBuffer&  getIndexBuffer() const;
+            // Of getOffset(), 0 without buffer device addresses (neither ray tracing nor mesh shading).
+            // @param relocatable The caller rebuilds whatever baked the address once getVersion() changes (see
+            // Mesh::refreshRenderMesh), otherwise GeometryPool::defragment leaves the range where it is from now on.
+            [[nodiscard]] uint64_t getDeviceAddress(bool relocatable = false) const;
+
+            // Bumped whenever GeometryPool::defragment moves the range.
+            [[nodiscard]] uint32_t getVersion() const;
+
+        private:
+            GeometryAllocation(GeometryPool&,
+                               GeometryPage&,
+                               vk::DeviceSize offset,
+                               vk::DeviceSize size,
+                               vk::DeviceSize alignment);
+
+        private:
+            GeometryPool*  m_Pool {nullptr};
+            GeometryPage*  m_Page {nullptr};
+            vk::DeviceSize m_Offset {0};
+            vk::DeviceSize m_Size {0};
+            vk::DeviceSize m_Alignment {1};
+            uint32_t       m_Version {0};
+            mutable bool   m_Pinned {false}; // See getDeviceAddress
+        };
+
+        // Sub-allocates the geometry of every mesh from a few large device local buffers (pages) per region, so that
+        // draws of different meshes share their vertex/index buffer bindings.
+        // Pages are never resized (device addresses stay valid), a new one is added once the others are full.
+        // Thread-safe.
+        class GeometryPool final
+        {
+            friend class GeometryAllocation;
+
+        public:
+            explicit GeometryPool(RenderDevice&);
+            GeometryPool(const GeometryPool&)     = delete;
+            GeometryPool(GeometryPool&&) noexcept = delete;
+            // Every GeometryAllocation must have been released (and the DeletionQueue flushed).
+            ~GeometryPool();
+
+            GeometryPool& operator=(const GeometryPool&)     = delete;
+            GeometryPool& operator=(GeometryPool&&) noexcept = delete;
+
+            // @param alignment In bytes, the vertex stride for GeometryRegion::eVertex (see Mesh::getBaseVertex).
+            [[nodiscard]] Ref<GeometryAllocation>
+            allocate(GeometryRegion, vk::DeviceSize size, vk::DeviceSize alignment);
+
+            struct Upload
+            {
+                const GeometryAllocation* allocation {nullptr};
+                vk::DeviceSize            offset {0}; // Within the allocation
+                const void*               data {nullptr};
+                vk::DeviceSize            size {0};
+            };
+            // Through a single staging buffer and submission (blocking).
+            GeometryPool& upload(std::span<const Upload>);
+
+            // Moves the ranges of pages at most maxOccupancy full into the other pages of their region, the emptied
+            // pages are released once the frames in flight are done with them.
+            // Draws pick up the new offsets. Ranges whose device address was taken without relocatable stay in place,
+            // the owners of the other ones must rebuild what baked their address (RenderMesh, BLAS) before the next
+            // frame is recorded (see GeometryAllocation::getVersion, Mesh::refreshRenderMesh).
+            // @return The number of moved ranges.
+            uint32_t defragment(float maxOccupancy = 0.5f);
+
+            struct Stats
+            {
+                uint32_t       numPages {0};
+                uint32_t       numAllocations {0};
+                uint32_t       numFreeRanges {0};
+                vk::DeviceSize capacity {0};
+                vk::DeviceSize usedSize {0};
+            };
+            [[nodiscard]] Stats getStats(GeometryRegion) const;
+
+            // Of a new page, larger allocations get a page of their own.
+            static const std::array<vk::DeviceSize, 3> s_kPageSizes;
+
+        private:
+            [[nodiscard]] GeometryPage& createPage(GeometryRegion, vk::DeviceSize capacity);
+
+            void release(GeometryAllocation&);
+            // Deferred part of release (see DeletionQueue).
+            void free(GeometryPage&, vk::DeviceSize offset, vk::DeviceSize size);
+
+            class PendingFree;
+
+        private:
+            RenderDevice& m_RenderDevice;
+
+            mutable std::mutex                              m_Mutex;
+            std::array<std::vector<Scope<GeometryPage>>, 3> m_Pages; // Per GeometryRegion
+        };
+
+        // One of the buffers of a GeometryPool.
+        struct GeometryPage
+        {
+            GeometryRegion region {GeometryRegion::eVertex};
+            Scope<Buffer>  buffer; // VertexBuffer, IndexBuffer or StorageBuffer
+            uint64_t       deviceAddress {0};
+            RangeAllocator allocator;
+            // Allocations still referencing the page, ranges waiting in the DeletionQueue are not in there.
+            std::unordered_set<GeometryAllocation*> allocations;
+            // Emptied by defragment, takes no new allocations and is destroyed once its last range is freed.
+            bool retired {false};
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string_view>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class CommandBuffer;
+
+        // Receives the RHI_GPU_ZONE scopes recorded on the thread it is installed on (see setGPUZoneListener),
+        // nested zones included.
+        class GPUZoneListener
+        {
+        public:
+            virtual ~GPUZoneListener() = default;
+
+            virtual void onZoneBegin(CommandBuffer&, const std::string_view label) = 0;
+            virtual void onZoneEnd(CommandBuffer&)                                = 0;
+        };
+
+        // Per thread, nullptr removes the listener.
+        void             setGPUZoneListener(GPUZoneListener*);
+        GPUZoneListener* getGPUZoneListener();
+
+        class GPUZone final
+        {
+        public:
+            GPUZone() = delete;
+            GPUZone(CommandBuffer&, const std::string_view label);
+            GPUZone(const GPUZone&) = delete;
+            GPUZone(GPUZone&&)      = delete;
+            ~GPUZone();
+
+            GPUZone& operator=(const GPUZone&)     = delete;
+            GPUZone& operator=(GPUZone&&) noexcept = delete;
+
+        private:
+            CommandBuffer&   m_CommandBuffer;
+            GPUZoneListener* m_Listener {nullptr};
+        };
+    } // namespace rhi
+} // namespace vultra
+
+#define RHI_GPU_PROFILE_ZONE_ID(Name, ID) _RHI_GPU_PROFILE_ZONE_ID(Name, ID)
+#define _RHI_GPU_PROFILE_ZONE_ID(Name, ID) Name##ID
+
+#define RHI_GPU_PROFILE_ZONE(CommandBuffer, Label) \
+    const ::vultra::rhi::GPUZone RHI_GPU_PROFILE_ZONE_ID(_gpu_zone, __LINE__) { CommandBuffer, Label }
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include "vultra/core/rhi/vertex_attributes.hpp"
 
 #include <limits>
+#include <memory>
 #include <optional>
 #include <span>
 #include <unordered_map>
@@ -189,6 +190,12 @@ namespace vultra
 
             constexpr vk::PipelineBindPoint getBindPoint() const override { return vk::PipelineBindPoint::eGraphics; }
 
+            // Replaces a fast-linked pipeline with its link time optimized version once that is ready
+            // (see GraphicsPipelineLibrary::setOptimizedLinkEnabled), the old one is released through the
+            // DeletionQueue. Call where the pipeline is looked up for recording (BasePass does), not while
+            // another thread records with it. Returns true if the handle changed.
+            bool upgrade();
+
             class Builder
             {
             public:
@@ -206,6 +213,8 @@ namespace vultra
                 // @param Can be empty
                 Builder& setColorFormats(std::initializer_list<PixelFormat>);
                 Builder& setColorFormats(std::span<const PixelFormat>);
+                // Bit i renders view i (gl_ViewIndex) into array layer i, 0 disables multiview.
+                Builder& setViewMask(const uint32_t);
 
                 // Do not omit vertex attributes that your shader does not use
                 // (in that case use kIgnoreVertexAttribute as an offset).
@@ -213,6 +222,8 @@ namespace vultra
                 Builder& setTopology(const PrimitiveTopology);
 
                 Builder& setPipelineLayout(PipelineLayout);
+                // For a reflected layout only, see PipelineLayoutInfo::pushDescriptorSet.
+                Builder& setPushDescriptorSet(const DescriptorSetIndex);
                 // If a shader of a given type is already specified, then its content will
                 // be overwritten with the given code.
                 Builder& addShader(const ShaderType, const ShaderStageInfo&);
@@ -223,12 +234,15 @@ namespace vultra
                 Builder& setBlending(const AttachmentIndex, const BlendState&);
                 Builder& setDynamicState(std::initializer_list<vk::DynamicState>);
 
+                // Linked from cached parts when the device supports VK_EXT_graphics_pipeline_library
+                // (vertex, geometry and fragment shaders only), monolithic otherwise.
                 [[nodiscard]] GraphicsPipeline build(RenderDevice&);
 
             private:
                 vk::Format              m_DepthFormat {vk::Format::eUndefined};
                 vk::Format              m_StencilFormat {vk::Format::eUndefined};
                 std::vector<vk::Format> m_ColorAttachmentFormats;
+                uint32_t                m_ViewMask {0};
 
                 vk::VertexInputBindingDescription                m_VertexInput;
                 std::vector<vk::VertexInputAttributeDescription> m_VertexInputAttributes;
@@ -237,6 +251,7 @@ namespace vultra
                 std::unordered_map<ShaderType, ShaderStageInfo> m_ShaderStages;
                 std::unordered_map<ShaderType, SPIRV>           m_BuiltinShaderStages;
                 PipelineLayout                                  m_PipelineLayout;
+                std::optional<DescriptorSetIndex>               m_PushDescriptorSet;
 
                 vk::PipelineDepthStencilStateCreateInfo            m_DepthStencilState;
                 vk::PipelineRasterizationStateCreateInfo           m_RasterizerState;
@@ -246,6 +261,10 @@ namespace vultra
 
         private:
             GraphicsPipeline(const vk::Device, PipelineLayout&&, const vk::Pipeline);
+
+        private:
+            struct OptimizedLink;
+            std::shared_ptr<OptimizedLink> m_OptimizedLink; // Being built by the PipelineCompiler
         };
     } // namespace rhi
 } // namespace vultra
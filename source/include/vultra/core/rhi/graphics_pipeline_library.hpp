@@ -0,0 +1,75 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        // The four parts of a graphics pipeline (VK_EXT_graphics_pipeline_library), compiled once and shared by every
+        // permutation that has the same state for that part. GraphicsPipeline::Builder::build fast-links them,
+        // which is much cheaper than compiling a monolithic pipeline. Only created by the RenderDevice when the
+        // extension is supported (see RenderDeviceFeatureReportFlagBits::eGraphicsPipelineLibrary). Thread-safe.
+        class GraphicsPipelineLibrary final
+        {
+        public:
+            GraphicsPipelineLibrary(const vk::Device, const vk::PipelineCache);
+            GraphicsPipelineLibrary(const GraphicsPipelineLibrary&)     = delete;
+            GraphicsPipelineLibrary(GraphicsPipelineLibrary&&) noexcept = delete;
+            ~GraphicsPipelineLibrary();
+
+            GraphicsPipelineLibrary& operator=(const GraphicsPipelineLibrary&)     = delete;
+            GraphicsPipelineLibrary& operator=(GraphicsPipelineLibrary&&) noexcept = delete;
+
+            enum class Part : uint8_t
+            {
+                eVertexInput = 0,
+                ePreRasterization,
+                eFragmentShader,
+                eFragmentOutput,
+            };
+            static constexpr auto kNumParts = 4u;
+
+            using Libraries = std::array<vk::Pipeline, kNumParts>;
+
+            // Returns the library of the given part, created from the info on a miss (only the state of that part
+            // is read). The hash must cover that state, including the pipeline layout and the shader code.
+            [[nodiscard]] vk::Pipeline getOrCreate(const Part, const std::size_t hash, vk::GraphicsPipelineCreateInfo);
+
+            // Fast link, or link time optimized (slower to build, as fast as a monolithic pipeline to draw with).
+            [[nodiscard]] vk::Pipeline link(const Libraries&, const vk::PipelineLayout, const bool optimized);
+
+            // When enabled, fast-linked pipelines are also linked with optimizations on the PipelineCompiler threads
+            // and replaced once that is done (see GraphicsPipeline::upgrade).
+            void               setOptimizedLinkEnabled(const bool);
+            [[nodiscard]] bool isOptimizedLinkEnabled() const;
+
+            struct Stats
+            {
+                uint32_t numLibraries {0};
+                uint64_t numHits {0}; // Library lookups
+                uint64_t numFastLinks {0};
+                uint64_t numOptimizedLinks {0};
+            };
+            [[nodiscard]] Stats getStats() const;
+
+        private:
+            vk::Device        m_Device {nullptr};
+            vk::PipelineCache m_PipelineCache {nullptr};
+
+            mutable std::shared_mutex                      m_Mutex;
+            std::unordered_map<std::size_t, vk::Pipeline> m_Libraries; // Key = hash of the state and the part
+
+            std::atomic<bool>     m_OptimizedLinkEnabled {true};
+            std::atomic<uint64_t> m_NumHits {0};
+            std::atomic<uint64_t> m_NumFastLinks {0};
+            std::atomic<uint64_t> m_NumOptimizedLinks {0};
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -17,6 +17,9 @@ namespace vultra
             eStorage      = BIT(2),
             eRenderTarget = BIT(3),
             eSampled      = BIT(4),
+            // Contents never leave a render pass (e.g. MSAA color, depth of a single pass). Backed by lazily
+            // allocated memory where available (tile memory). Only valid together with eRenderTarget.
+            eTransient = BIT(5),
         };
 
         [[nodiscard]] std::string_view toString(ImageUsage);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        // Which subsystem owns an allocation, see trackMemory().
+        enum class MemoryCategory : uint8_t
+        {
+            eOther = 0,             // Uniform/storage buffers and anything untagged
+            eMesh,                  // Vertex/index buffers
+            eTexture,               // Textures (render targets included, unless transient)
+            eTransient,             // Pooled by TransientResources (RenderGraph)
+            eStaging,               // Host visible upload buffers
+            eAccelerationStructure, // AS storage, scratch, instance/transform buffers, SBT
+            eDescriptor,            // Descriptor pools (estimated) and bindless tables
+        };
+        constexpr uint32_t kNumMemoryCategories = static_cast<uint32_t>(MemoryCategory::eDescriptor) + 1;
+
+        [[nodiscard]] const char* toString(MemoryCategory);
+
+        struct MemoryCategoryStats
+        {
+            vk::DeviceSize current {0};
+            vk::DeviceSize peak {0};
+            uint32_t       numAllocations {0};
+        };
+
+        struct MemoryHeapStats
+        {
+            vk::MemoryHeapFlags flags;
+            vk::DeviceSize      budget {0}; // Estimated by the driver with VK_EXT_memory_budget, heap size otherwise
+            vk::DeviceSize      usage {0};  // Process-wide, not only the VMA allocations
+            vk::DeviceSize      peakUsage {0};
+
+            [[nodiscard]] float getBudgetFraction() const
+            {
+                return budget > 0 ? static_cast<float>(usage) / static_cast<float>(budget) : 0.0f;
+            }
+        };
+
+        struct MemoryStats
+        {
+            std::vector<MemoryHeapStats>                          heaps;
+            std::array<MemoryCategoryStats, kNumMemoryCategories> categories {};
+
+            [[nodiscard]] const MemoryCategoryStats& operator[](const MemoryCategory category) const
+            {
+                return categories[static_cast<uint32_t>(category)];
+            }
+        };
+
+        // Process-wide (like generateResourceId()), resources do not hold a RenderDevice.
+        // A negative delta releases memory.
+        void trackMemory(MemoryCategory, int64_t delta);
+
+        [[nodiscard]] MemoryCategoryStats getMemoryCategoryStats(MemoryCategory);
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
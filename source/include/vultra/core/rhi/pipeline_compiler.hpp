@@ -0,0 +1,104 @@
+#pragma once
+
+#include "vultra/core/rhi/pipeline_manifest.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+
+        // Background threads for pipeline creation (see BasePass::getPipelineAsync).
+        // vkCreate*Pipelines is free-threaded and every job goes through the RenderDevice's vk::PipelineCache,
+        // so work done here also warms the cache for the blocking path. Thread-safe.
+        class PipelineCompiler final
+        {
+        public:
+            // 0: a quarter of the hardware threads (at least one), the rest is left to the frame.
+            explicit PipelineCompiler(uint32_t numWorkers = 0);
+            PipelineCompiler(const PipelineCompiler&)     = delete;
+            PipelineCompiler(PipelineCompiler&&) noexcept = delete;
+            ~PipelineCompiler();
+
+            PipelineCompiler& operator=(const PipelineCompiler&)     = delete;
+            PipelineCompiler& operator=(PipelineCompiler&&) noexcept = delete;
+
+            using Clock    = std::chrono::steady_clock;
+            using Duration = std::chrono::duration<float, std::milli>;
+
+            // Jobs must not throw.
+            using Job = std::function<void()>;
+
+            // When disabled, BasePass::getPipelineAsync compiles in place (e.g. for reproducible frames).
+            void               setEnabled(bool);
+            [[nodiscard]] bool isEnabled() const;
+
+            void enqueue(Job);
+            // Blocks until the queue is drained.
+            void waitIdle();
+
+            [[nodiscard]] uint32_t getNumWorkers() const;
+            // Queued or running.
+            [[nodiscard]] uint32_t getNumPending() const;
+
+            struct Stats
+            {
+                uint64_t numBlocking {0}; // Compiled on the requesting thread
+                uint64_t numAsync {0};
+
+                // Request to ready. For async pipelines that includes the time spent in the queue and until
+                // the pass asked again, i.e. how long it has been drawn with a fallback (or not at all).
+                Duration totalLatency {0};
+                Duration maxLatency {0};
+                Duration lastLatency {0};
+                // Blocking time of the render thread, the hitches this class is meant to get rid of.
+                Duration totalBlocking {0};
+
+                [[nodiscard]] uint64_t getNumCompiled() const { return numBlocking + numAsync; }
+                [[nodiscard]] Duration getAverageLatency() const
+                {
+                    const auto n = getNumCompiled();
+                    return n > 0 ? totalLatency / static_cast<float>(n) : Duration {0};
+                }
+            };
+            void                reportCompiled(Duration latency, bool async);
+            [[nodiscard]] Stats getStats() const;
+
+            // Pipelines created by the passes, see BasePass::warmUpPipelines.
+            [[nodiscard]] PipelineManifest& getManifest();
+
+        private:
+            void workerLoop();
+
+        private:
+            std::vector<std::thread> m_Workers;
+
+            mutable std::mutex      m_Mutex;
+            std::condition_variable m_WorkAvailable;
+            std::condition_variable m_WorkDone;
+            std::deque<Job>         m_Jobs;
+            uint32_t                m_NumRunning {0};
+            bool                    m_Quit {false};
+
+            std::atomic<bool> m_Enabled {true};
+
+            mutable std::mutex m_StatsMutex;
+            Stats              m_Stats;
+
+            PipelineManifest m_Manifest;
+        };
+
+        // For BasePass, which only has a forward declaration of the RenderDevice.
+        [[nodiscard]] PipelineCompiler& getPipelineCompiler(RenderDevice&);
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -4,6 +4,8 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <optional>
+
 namespace vultra
 {
     namespace rhi
@@ -22,6 +24,9 @@ namespace vultra
             using DescriptorSetBindings = std::vector<DescriptorSetLayoutBindingEx>;
             std::array<DescriptorSetBindings, kMinNumDescriptorSets> descriptorSets;
             std::vector<vk::PushConstantRange>                       pushConstantRanges;
+            // Written into the command buffer instead of being bound (VK_KHR_push_descriptor), meant for small
+            // per-draw sets. Ignored when the device can not push it (see RenderDevice::createPipelineLayout).
+            std::optional<DescriptorSetIndex> pushDescriptorSet;
         };
 
         class RenderDevice;
@@ -43,6 +48,7 @@ namespace vultra
 
             [[nodiscard]] vk::PipelineLayout      getHandle() const;
             [[nodiscard]] vk::DescriptorSetLayout getDescriptorSet(const DescriptorSetIndex) const;
+            [[nodiscard]] bool                    isPushDescriptorSet(const DescriptorSetIndex) const;
 
             class Builder
             {
@@ -89,6 +95,7 @@ namespace vultra
 
                 Builder& addResource(const DescriptorSetIndex, DescriptorSetLayoutBindingEx);
                 Builder& addPushConstantRange(vk::PushConstantRange);
+                Builder& setPushDescriptorSet(const DescriptorSetIndex);
 
                 [[nodiscard]] PipelineLayout build(RenderDevice&) const;
 
@@ -97,16 +104,21 @@ namespace vultra
             };
 
         private:
-            PipelineLayout(const vk::PipelineLayout, std::vector<vk::DescriptorSetLayout>&&);
+            PipelineLayout(const vk::PipelineLayout,
+                           std::vector<vk::DescriptorSetLayout>&&,
+                           std::optional<DescriptorSetIndex> pushDescriptorSet);
 
         private:
             vk::PipelineLayout                   m_Handle {nullptr}; // Non-owning.
             std::vector<vk::DescriptorSetLayout> m_DescriptorSetLayouts;
+            std::optional<DescriptorSetIndex>    m_PushDescriptorSet;
         };
 
         struct ShaderReflection;
 
-        [[nodiscard]] PipelineLayout reflectPipelineLayout(RenderDevice&, const ShaderReflection&);
+        [[nodiscard]] PipelineLayout reflectPipelineLayout(RenderDevice&,
+                                                           const ShaderReflection&,
+                                                           std::optional<DescriptorSetIndex> pushDescriptorSet = {});
 
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
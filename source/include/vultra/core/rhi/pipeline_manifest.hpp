@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/tuple.hpp>
+
+#include <filesystem>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        // Every pipeline key created during a session, per pass type (see BasePass::warmUpPipelines).
+        // Saved on shutdown and replayed on the PipelineCompiler threads while loading the next session,
+        // so that the first frames do not stall on (or draw fallbacks for) pipelines seen before.
+        // Keys are opaque binary blobs, only the pass that recorded them can decode them. Thread-safe.
+        class PipelineManifest final
+        {
+        public:
+            PipelineManifest()                            = default;
+            PipelineManifest(const PipelineManifest&)     = delete;
+            PipelineManifest(PipelineManifest&&) noexcept = delete;
+            ~PipelineManifest()                           = default;
+
+            PipelineManifest& operator=(const PipelineManifest&)     = delete;
+            PipelineManifest& operator=(PipelineManifest&&) noexcept = delete;
+
+            // Returns false if the key is known already.
+            bool record(const std::string& pass, std::string key);
+
+            [[nodiscard]] std::vector<std::string> getKeys(const std::string& pass) const;
+            [[nodiscard]] uint32_t                 size() const;
+            void                                   clear();
+
+            // Merges the entries of the file with the recorded ones, a missing or outdated file is ignored.
+            bool load(const std::filesystem::path&);
+            bool save(const std::filesystem::path&) const;
+
+            template<typename Tuple>
+            [[nodiscard]] static std::string encode(const Tuple& key)
+            {
+                std::ostringstream stream;
+                {
+                    cereal::BinaryOutputArchive archive {stream};
+                    archive(key);
+                }
+                return std::move(stream).str();
+            }
+            template<typename Tuple>
+            [[nodiscard]] static bool decode(const std::string& blob, Tuple& key)
+            {
+                try
+                {
+                    std::istringstream         stream {blob};
+                    cereal::BinaryInputArchive archive {stream};
+                    archive(key);
+                    return true;
+                }
+                catch (const std::exception&)
+                {
+                    return false;
+                }
+            }
+
+        private:
+            struct Entry
+            {
+                std::string pass;
+                std::string key;
+
+                bool operator==(const Entry&) const = default;
+
+                template<class Archive>
+                void serialize(Archive& archive)
+                {
+                    archive(pass, key);
+                }
+            };
+            struct EntryHash
+            {
+                std::size_t operator()(const Entry&) const noexcept;
+            };
+
+            mutable std::mutex                   m_Mutex;
+            std::unordered_set<Entry, EntryHash> m_Entries;
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <vulkan/vulkan.hpp>
+
+#include <span>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class QueryPool final
+        {
+            friend class RenderDevice;
+
+        public:
+            QueryPool()                 = default;
+            QueryPool(const QueryPool&) = delete;
+            QueryPool(QueryPool&&) noexcept;
+            ~QueryPool();
+
+            QueryPool& operator=(const QueryPool&) = delete;
+            QueryPool& operator=(QueryPool&&) noexcept;
+
+            [[nodiscard]] explicit operator bool() const;
+
+            [[nodiscard]] vk::QueryPool getHandle() const;
+            [[nodiscard]] vk::QueryType getType() const;
+            [[nodiscard]] uint32_t      getCount() const;
+            // Values written per query (one per enabled statistic for pipeline statistics queries, otherwise 1).
+            [[nodiscard]] uint32_t getNumValuesPerQuery() const;
+
+            // Non-blocking, returns false (and leaves results untouched) when any query in
+            // [first, first + results.size() / getNumValuesPerQuery()) is not available yet.
+            [[nodiscard]] bool getResults(const uint32_t first, std::span<uint64_t> results) const;
+
+            // Host side reset (Vulkan 1.2 hostQueryReset), the queries must not be in use by the GPU.
+            void reset(const uint32_t first, const uint32_t count);
+
+        private:
+            QueryPool(const vk::Device,
+                      const vk::QueryPool,
+                      const vk::QueryType,
+                      const uint32_t count,
+                      const vk::QueryPipelineStatisticFlags = {});
+
+            void destroy() noexcept;
+
+        private:
+            vk::Device    m_Device {nullptr};
+            vk::QueryPool m_Handle {nullptr};
+            vk::QueryType m_Type {vk::QueryType::eTimestamp};
+            uint32_t      m_Count {0};
+
+            vk::QueryPipelineStatisticFlags m_PipelineStatistics {};
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace vultra
+{
+    namespace rhi
+    {
+        enum class QueueType
+        {
+            eGeneric = 0,
+            // Dedicated compute queue family, work submitted to it may overlap with the generic queue.
+            eAsyncCompute,
+        };
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -31,6 +31,9 @@ namespace vultra
 
             [[nodiscard]] AccelerationStructureBuffer* getBuffer();
 
+            // Of the backing buffer, see generateResourceId().
+            [[nodiscard]] uint64_t getId() const;
+
         private:
             friend class RenderDevice;
             AccelerationStructure(vk::Device,
@@ -3,10 +3,18 @@
 #include "vultra/core/base/base.hpp"
 #include "vultra/core/base/scoped_enum_flags.hpp"
 #include "vultra/core/rhi/buffer.hpp"
+#include "vultra/core/rhi/command_pool.hpp"
 #include "vultra/core/rhi/compute_pipeline.hpp"
+#include "vultra/core/rhi/deletion_queue.hpp"
+#include "vultra/core/rhi/geometry_pool.hpp"
+#include "vultra/core/rhi/graphics_pipeline_library.hpp"
 #include "vultra/core/rhi/image_aspect.hpp"
 #include "vultra/core/rhi/index_buffer.hpp"
+#include "vultra/core/rhi/memory_stats.hpp"
+#include "vultra/core/rhi/pipeline_compiler.hpp"
 #include "vultra/core/rhi/pipeline_layout.hpp"
+#include "vultra/core/rhi/query_pool.hpp"
+#include "vultra/core/rhi/queue_type.hpp"
 #include "vultra/core/rhi/raytracing/acceleration_structure.hpp"
 #include "vultra/core/rhi/raytracing/raytracing_instance.hpp"
 #include "vultra/core/rhi/raytracing/raytracing_pipeline.hpp"
@@ -27,6 +35,7 @@
 #include <glm/fwd.hpp>
 
 #include <functional>
+#include <mutex>
 #include <set>
 #include <string>
 #include <unordered_map>
@@ -58,6 +67,8 @@ namespace vultra
             eRayTracingPipeline = BIT(1),
             eMeshShader         = BIT(2),
             eOpenXR             = BIT(3),
+            // No window system, skips the surface/swapchain extensions. Render through an offscreen FrameController.
+            eHeadless = BIT(4),
 
             eRayTracing = eRayQuery | eRayTracingPipeline,
             eAll        = eNormal | eRayQuery | eRayTracingPipeline | eMeshShader | eOpenXR,
@@ -65,14 +76,22 @@ namespace vultra
 
         enum class RenderDeviceFeatureReportFlagBits : uint64_t
         {
-            eNone                  = 0,
-            eOpenXR                = BIT(0),
-            eRayTracingPipeline    = BIT(1),
-            eRayQuery              = BIT(2),
-            eAccelerationStructure = BIT(3),
-            eMeshShader            = BIT(4),
-            eBufferDeviceAddress   = BIT(5),
-            eDescriptorIndexing    = BIT(6),
+            eNone                    = 0,
+            eOpenXR                  = BIT(0),
+            eRayTracingPipeline      = BIT(1),
+            eRayQuery                = BIT(2),
+            eAccelerationStructure   = BIT(3),
+            eMeshShader              = BIT(4),
+            eBufferDeviceAddress     = BIT(5),
+            eDescriptorIndexing      = BIT(6),
+            eShaderOutputLayer       = BIT(7),
+            eMultiview               = BIT(8),
+            eTimelineSemaphore       = BIT(9),
+            eHostQueryReset          = BIT(10),
+            ePipelineStatistics      = BIT(11),
+            ePushDescriptor          = BIT(12),
+            eMemoryBudget            = BIT(13),
+            eGraphicsPipelineLibrary = BIT(14),
         };
 
         struct RenderDeviceFeatureReport
@@ -102,6 +121,9 @@ namespace vultra
             vk::Semaphore           wait {nullptr};
             vk::PipelineStageFlags2 waitStage {vk::PipelineStageFlagBits2::eAllCommands};
             vk::Semaphore           signal {nullptr};
+            // Payloads for timeline semaphores, ignored for binary ones.
+            uint64_t waitValue {0};
+            uint64_t signalValue {0};
         };
 
         enum class AllocationHints
@@ -130,6 +152,7 @@ namespace vultra
 
             [[nodiscard]] RenderDeviceFeatureFlagBits getFeatureFlag() const;
             [[nodiscard]] RenderDeviceFeatureReport   getFeatureReport() const;
+            [[nodiscard]] bool                        isHeadless() const;
 
             [[nodiscard]] std::string getName() const;
 
@@ -146,6 +169,19 @@ namespace vultra
 
             [[nodiscard]] vk::Fence     createFence(bool signaled = true) const;
             [[nodiscard]] vk::Semaphore createSemaphore();
+            // Requires RenderDeviceFeatureReportFlagBits::eTimelineSemaphore.
+            [[nodiscard]] vk::Semaphore createTimelineSemaphore(uint64_t initialValue = 0);
+
+            // True when the device exposes a dedicated compute queue family (see QueueType::eAsyncCompute).
+            [[nodiscard]] bool     hasAsyncComputeQueue() const;
+            [[nodiscard]] uint32_t getQueueFamilyIndex(QueueType = QueueType::eGeneric) const;
+
+            // Pipeline statistics pools require RenderDeviceFeatureReportFlagBits::ePipelineStatistics.
+            [[nodiscard]] QueryPool createQueryPool(vk::QueryType,
+                                                    uint32_t count,
+                                                    vk::QueryPipelineStatisticFlags = {}) const;
+            // Nanoseconds per timestamp tick, 0 when the generic queue does not support timestamps.
+            [[nodiscard]] float getTimestampPeriod() const;
 
             [[nodiscard]] Buffer createStagingBuffer(vk::DeviceSize size, const void* data = nullptr) const;
 
@@ -161,9 +197,31 @@ namespace vultra
             [[nodiscard]] StorageBuffer createStorageBuffer(vk::DeviceSize size,
                                                             AllocationHints = AllocationHints::eNone) const;
 
+            // @param pushDescriptor Requires RenderDeviceFeatureReportFlagBits::ePushDescriptor.
             [[nodiscard]] std::pair<std::size_t, vk::DescriptorSetLayout>
-            createDescriptorSetLayout(const std::vector<DescriptorSetLayoutBindingEx>&);
-
+            createDescriptorSetLayout(const std::vector<DescriptorSetLayoutBindingEx>&, bool pushDescriptor = false);
+            // Shared by every command buffer (see CommandBuffer::createDescriptorSetBuilder).
+            [[nodiscard]] DescriptorSetCache& getDescriptorSetCache();
+            // Replaces waitIdle when releasing resources mid-session, flushed by waitIdle.
+            [[nodiscard]] DeletionQueue& getDeletionQueue();
+            // Vertex, index and meshlet ranges of every mesh (see Mesh::buildGeometry).
+            [[nodiscard]] GeometryPool& getGeometryPool();
+            // Background pipeline creation (see BasePass::getPipelineAsync).
+            [[nodiscard]] PipelineCompiler& getPipelineCompiler();
+            // Null without RenderDeviceFeatureReportFlagBits::eGraphicsPipelineLibrary (monolithic pipelines only).
+            [[nodiscard]] GraphicsPipelineLibrary* getGraphicsPipelineLibrary();
+
+            // Per heap budget/usage (driver estimates with VK_EXT_memory_budget) and per MemoryCategory accounting.
+            [[nodiscard]] MemoryStats getMemoryStats() const;
+            // Once per frame (see FrameController): refreshes the heap peaks, plots and the budget warning.
+            RenderDevice& updateMemoryStats();
+
+            using MemoryBudgetCallback = std::function<void(const MemoryStats&, uint32_t heapIndex)>;
+            // Invoked when the usage of a heap exceeds fraction * budget, once until it drops below again.
+            // Without a callback a warning with the per category breakdown is logged.
+            RenderDevice& setMemoryBudgetWarning(float fraction, MemoryBudgetCallback = {});
+
+            // PipelineLayoutInfo::pushDescriptorSet falls back to a regular set when the device can not push it.
             [[nodiscard]] PipelineLayout createPipelineLayout(const PipelineLayoutInfo&);
 
             [[nodiscard]] Texture
@@ -204,7 +262,9 @@ namespace vultra
             RenderDevice& destroy(vk::Fence&);
             RenderDevice& destroy(vk::Semaphore&);
 
-            [[nodiscard]] CommandBuffer createCommandBuffer() const;
+            [[nodiscard]] CommandBuffer createCommandBuffer(QueueType = QueueType::eGeneric) const;
+            // For secondary command buffers, one pool per recording thread.
+            [[nodiscard]] CommandPool createCommandPool(QueueType = QueueType::eGeneric) const;
             // Blocking.
             RenderDevice& execute(const std::function<void(CommandBuffer&)>&, bool oneTime = false);
             RenderDevice& execute(CommandBuffer&, const JobInfo& = {}, bool oneTime = false);
@@ -277,13 +337,16 @@ namespace vultra
             void findGenericQueue();
             void createLogicalDevice();
             void createMemoryAllocator();
-            void createCommandPool();
+            void createCommandPools();
             void createPipelineCache();
             void createDefaultDescriptorPool();
+            void createDescriptorSetCache();
             void createTracyContext();
             void createTracky();
 
-            vk::CommandBuffer allocateCommandBuffer() const;
+            void findAsyncComputeQueue();
+
+            vk::CommandBuffer allocateCommandBuffer(vk::CommandPool) const;
             vk::Sampler       createSampler(const SamplerInfo&) const;
 
             [[nodiscard]] AccelerationStructureBuffer
@@ -311,19 +374,45 @@ namespace vultra
             vk::PipelineCache          m_PipelineCache {nullptr};
             vk::DescriptorPool         m_DefaultDescriptorPool {nullptr};
 
+            // Optional dedicated compute queue (-1 when the device has none)
+            int             m_AsyncComputeQueueFamilyIndex {-1};
+            vk::Queue       m_AsyncComputeQueue {nullptr};
+            vk::CommandPool m_AsyncComputeCommandPool {nullptr};
+
             // Raytracing properties and features
             vk::PhysicalDeviceRayTracingPipelinePropertiesKHR  m_RayTracingPipelineProperties;
             vk::PhysicalDeviceAccelerationStructureFeaturesKHR m_AccelerationStructureFeatures;
 
+            // Of VK_KHR_push_descriptor (0 when unsupported)
+            uint32_t m_MaxPushDescriptors {0};
+
             TracyVkCtx m_TracyContext {nullptr};
+            TracyVkCtx m_AsyncComputeTracyContext {nullptr};
 
             template<typename T>
             using Cache = std::unordered_map<size_t, T>;
 
-            Cache<vk::Sampler>             m_Samplers;
+            Cache<vk::Sampler> m_Samplers;
+            // Guards the layout caches, pipelines are also built by the PipelineCompiler threads.
+            std::recursive_mutex           m_LayoutMutex;
             Cache<vk::DescriptorSetLayout> m_DescriptorSetLayouts;
+            DescriptorPoolSizer            m_DescriptorPoolSizer; // Usage of m_DescriptorSetLayouts
+            Scope<DescriptorSetCache>      m_DescriptorSetCache;
             Cache<vk::PipelineLayout>      m_PipelineLayouts;
 
+            Scope<DeletionQueue> m_DeletionQueue {createScope<DeletionQueue>()};
+            Scope<GeometryPool>  m_GeometryPool {createScope<GeometryPool>(*this)};
+
+            Scope<PipelineCompiler>        m_PipelineCompiler {createScope<PipelineCompiler>()};
+            Scope<GraphicsPipelineLibrary> m_GraphicsPipelineLibrary;
+
+            // Memory telemetry (see updateMemoryStats)
+            uint32_t                    m_MemoryFrameIndex {0};
+            std::vector<vk::DeviceSize> m_HeapPeakUsage;
+            uint32_t                    m_OverBudgetHeaps {0}; // Bitmask, VK_MAX_MEMORY_HEAPS = 16
+            float                       m_MemoryBudgetFraction {0.9f};
+            MemoryBudgetCallback        m_MemoryBudgetCallback;
+
             ShaderCompiler m_ShaderCompiler;
 
             openxr::XRDevice* m_XRDevice {nullptr};
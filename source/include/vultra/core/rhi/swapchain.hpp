@@ -12,6 +12,8 @@ namespace vultra
 
     namespace rhi
     {
+        class DeletionQueue;
+
         enum class VerticalSync
         {
             eDisabled,
@@ -57,7 +59,7 @@ namespace vultra
             bool acquireNextImage(vk::Semaphore imageAcquired = nullptr);
 
         private:
-            Swapchain(vk::Instance, vk::PhysicalDevice, vk::Device, os::Window*, Format, VerticalSync);
+            Swapchain(vk::Instance, vk::PhysicalDevice, vk::Device, DeletionQueue*, os::Window*, Format, VerticalSync);
 
             void createSurface();
 
@@ -71,6 +73,7 @@ namespace vultra
             vk::Instance       m_Instance {nullptr};
             vk::PhysicalDevice m_PhysicalDevice {nullptr};
             vk::Device         m_Device {nullptr};
+            DeletionQueue*     m_DeletionQueue {nullptr}; // Owned by the RenderDevice
 
             vk::SurfaceKHR   m_Surface {nullptr};
             vk::SwapchainKHR m_Handle {nullptr};
@@ -5,6 +5,7 @@
 #include "vultra/core/rhi/extent2d.hpp"
 #include "vultra/core/rhi/image_layout.hpp"
 #include "vultra/core/rhi/image_usage.hpp"
+#include "vultra/core/rhi/memory_stats.hpp"
 #include "vultra/core/rhi/pixel_format.hpp"
 #include "vultra/core/rhi/texture_type.hpp"
 
@@ -86,6 +87,13 @@ namespace vultra
 
             [[nodiscard]] vk::Sampler getSampler() const;
 
+            // See generateResourceId().
+            [[nodiscard]] uint64_t getId() const;
+
+            [[nodiscard]] MemoryCategory getMemoryCategory() const;
+            // Moves the allocation to another category of the memory stats (see trackMemory()).
+            Texture& setMemoryCategory(MemoryCategory);
+
             class Builder
             {
             public:
@@ -157,6 +165,7 @@ namespace vultra
             {
                 vma::Allocation allocation {nullptr};
                 vk::Image       handle {nullptr};
+                vk::DeviceSize  size {0};
 
                 auto operator<=>(const AllocatedImage&) const = default;
             };
@@ -167,6 +176,18 @@ namespace vultra
 
             mutable ImageLayout  m_Layout {ImageLayout::eUndefined};
             mutable BarrierScope m_LastScope {kInitialBarrierScope};
+            struct SubresourceState
+            {
+                ImageLayout  layout {ImageLayout::eUndefined};
+                BarrierScope lastScope;
+
+                bool operator==(const SubresourceState&) const = default;
+            };
+            // [layer * numMipLevels + mipLevel], only while the subresources diverge. m_Layout and m_LastScope then
+            // describe the last transitioned range (see Barrier::Builder).
+            mutable std::vector<SubresourceState> m_SubresourceStates;
+            // Owning queue family, QueueFamilyIgnored stands for the default one (see Barrier::Builder).
+            mutable uint32_t     m_QueueFamilyIndex {vk::QueueFamilyIgnored};
 
             std::unordered_map<uint32_t, AspectData> m_Aspects;
 
@@ -179,6 +200,9 @@ namespace vultra
             uint32_t    m_NumLayers {0u};  // 0 = Non-layered.
             uint32_t    m_LayerFaces {0u}; // Internal use.
             ImageUsage  m_UsageFlags {ImageUsage::eSampled};
+
+            uint64_t       m_Id {0};
+            MemoryCategory m_MemoryCategory {MemoryCategory::eTexture};
         };
 
         [[nodiscard]] bool                 isFormatSupported(const RenderDevice&, PixelFormat, ImageUsage);
@@ -19,5 +19,8 @@ namespace vultra
                     const bool                           generateMipmaps = false);
 
         uint32_t alignedSize(const uint32_t size, const uint32_t alignment);
+
+        // Unique for the lifetime of the application, unlike Vulkan handles (which might be recycled).
+        [[nodiscard]] uint64_t generateResourceId();
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "vultra/function/app/base_app.hpp"
+
+namespace vultra
+{
+    struct HeadlessConfig
+    {
+        uint64_t numFrames {0}; // 0 = until close().
+        // Every frame advances time by exactly this much, so runs are reproducible regardless of the device speed.
+        fsec fixedDeltaTime {1.0f / 60.0f};
+    };
+
+    // Runs without a window or display: renders into the offscreen targets of a FrameController.
+    // AppConfig::swapchainFormat picks the format of the targets (RGBA8), vSyncConfig is ignored.
+    class HeadlessApp
+    {
+    public:
+        HeadlessApp(std::span<char*> args, const AppConfig& appConfig, const HeadlessConfig& headlessConfig = {});
+        HeadlessApp(const HeadlessApp&)     = delete;
+        HeadlessApp(HeadlessApp&&) noexcept = delete;
+        virtual ~HeadlessApp()              = default;
+
+        HeadlessApp& operator=(const HeadlessApp&)     = delete;
+        HeadlessApp& operator=(HeadlessApp&&) noexcept = delete;
+
+        [[nodiscard]] rhi::RenderDevice&     getRenderDevice();
+        [[nodiscard]] rhi::FrameController&  getFrameController();
+        [[nodiscard]] rhi::Swapchain::Format getTargetFormat() const;
+
+        virtual void run();
+        void         close();
+
+    protected:
+        virtual void onUpdate(const fsec) {}
+        virtual void onPhysicsUpdate(const fsec) {}
+        virtual void onPostUpdate(const fsec) {}
+
+        virtual void onPreRender() {}
+        virtual void onRender(rhi::CommandBuffer&, const rhi::RenderTargetView, const fsec) {}
+        virtual void onPostRender() {}
+
+        // Blocks until the frame that has just been submitted is complete, only meant for onPostRender.
+        bool saveCurrentFrame(const std::string& filePath);
+
+    protected:
+        bool     m_IsRunning {true};
+        uint64_t m_FrameCounter {0};
+
+        HeadlessConfig           m_HeadlessConfig;
+        rhi::Swapchain::Format   m_TargetFormat {rhi::Swapchain::Format::eLinear};
+        Scope<rhi::RenderDevice> m_RenderDevice {nullptr};
+        rhi::FrameController     m_FrameController;
+    };
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        // The attachment writes to one transient resource of a compiled graph, in execution order. Kept by the
+        // resource (see FrameGraphTexture), so it belongs to that graph and follows it into the FrameGraphCache.
+        struct AttachmentWrites
+        {
+            std::vector<bool> accessed;         // Per write, whether its contents are accessed afterwards
+            bool              complete {false}; // Every write of the graph has been seen (after one execution)
+
+            // Current execution
+            uint32_t                next {0};
+            std::optional<uint32_t> pending; // Last write, not accessed yet
+        };
+
+        // Decides which attachment writes to transient textures are stored, the others use
+        // VK_ATTACHMENT_STORE_OP_DONT_CARE.
+        // Who consumes a write is a property of the compiled graph, not of the previous frame: the resource hooks of
+        // the FrameGraph do not see the passes, so the first execution of a graph stores every write and records, per
+        // resource, which writes are accessed later (read, or loaded by a later write). Every following execution of
+        // the same graph (see FrameGraphCache) stores exactly those. A graph built again starts over.
+        //
+        // Usage: begin() -> fg.execute() -> end(), see TransientResources::getAttachmentStoreTracker().
+        // Without begin() every write is stored.
+        class AttachmentStoreTracker
+        {
+        public:
+            void begin();
+            void end();
+
+            // Returns false if the contents do not have to be stored.
+            [[nodiscard]] bool onAttachmentWrite(AttachmentWrites&);
+            // Any access that depends on the current contents of the resource.
+            void onAccess(AttachmentWrites&);
+            // The resource is released, it is not accessed anymore in this execution.
+            void onRelease(AttachmentWrites&);
+
+            [[nodiscard]] uint32_t getNumWrites() const;          // In the last execution
+            [[nodiscard]] uint32_t getNumDiscardedWrites() const; // In the last execution
+
+        private:
+            bool m_Recording {false};
+
+            uint32_t m_NumCurrentWrites {0};
+            uint32_t m_NumCurrentDiscardedWrites {0};
+
+            uint32_t m_NumWrites {0};
+            uint32_t m_NumDiscardedWrites {0};
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
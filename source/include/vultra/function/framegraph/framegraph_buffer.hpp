@@ -30,6 +30,8 @@ namespace vultra
                 BufferType type;
                 uint32_t   stride {sizeof(std::byte)};
                 uint64_t   capacity;
+                // Uniform/storage only: sub-allocate from the UploadRing (persistently mapped, written by the host).
+                bool hostWrite {false};
 
                 [[nodiscard]] constexpr auto dataSize() const { return stride * capacity; }
             };
@@ -43,6 +45,9 @@ namespace vultra
             [[nodiscard]] static std::string toString(const Desc&);
 
             rhi::Buffer* buffer {nullptr};
+            // Non-zero only for UploadRing allocations (see Desc::hostWrite).
+            uint64_t offset {0};
+            void*    mappedMemory {nullptr};
         };
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
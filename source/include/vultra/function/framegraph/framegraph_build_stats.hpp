@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        // CPU cost of getting a compiled frame graph (setup callbacks + compile, or the cache lookup when a graph is
+        // reused), averaged over the last frames.
+        struct FrameGraphBuildStats
+        {
+            float setupTime {0.0f};   // In milliseconds
+            float compileTime {0.0f}; // In milliseconds, zero for reused graphs
+
+            std::size_t topologyKey {0};
+            uint64_t    numBuilds {0};
+            uint64_t    numReuses {0}; // Compiled graphs executed again (see FrameGraphCache)
+            uint64_t    numTopologyChanges {0};
+        };
+
+        // Tracks what getting the graph of a frame costs and whether its topology changed. The topology key is a hash
+        // of everything the pass set, the resource descriptors and the values captured by the passes depend on
+        // (settings, extents, formats), computed by the caller and also used as the FrameGraphCache key.
+        //
+        // Usage: beginSetup(key) -> add passes -> beginCompile() -> fg.compile() -> end(),
+        //        or beginSetup(key) -> reuse() when the compiled graph of the key is cached.
+        class FrameGraphBuildTracker
+        {
+        public:
+            // Returns true when the key differs from the previous frame.
+            bool beginSetup(std::size_t topologyKey);
+            void beginCompile();
+            void end();
+            void reuse();
+
+            [[nodiscard]] bool                        isTopologyChanged() const;
+            [[nodiscard]] const FrameGraphBuildStats& getStats() const;
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            Clock::time_point m_SetupStart;
+            Clock::time_point m_CompileStart;
+
+            bool m_TopologyChanged {true};
+
+            FrameGraphBuildStats m_Stats;
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
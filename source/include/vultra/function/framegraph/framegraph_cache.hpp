@@ -0,0 +1,48 @@
+#pragma once
+
+#include "vultra/core/base/base.hpp"
+
+#include <fg/Fwd.hpp>
+
+#include <vector>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        // Compiled frame graphs by topology key (see FrameGraphBuildTracker). On a hit the graph is executed again as
+        // is: no setup callbacks, no compile, the same culling, lifetimes and barrier order as when it was built.
+        // The passes of a cached graph must therefore read per-frame data when they execute (through references that
+        // outlive the graph) instead of capturing it at setup, and import the textures that change between frames
+        // through a binding (see importTexture). Everything else they capture has to be part of the key.
+        // The least recently used graph is dropped past the capacity (one graph per view and resolution step).
+        class FrameGraphCache
+        {
+        public:
+            explicit FrameGraphCache(const uint32_t capacity = 8);
+            FrameGraphCache(const FrameGraphCache&)     = delete;
+            FrameGraphCache(FrameGraphCache&&) noexcept = delete;
+            ~FrameGraphCache();
+
+            FrameGraphCache& operator=(const FrameGraphCache&)     = delete;
+            FrameGraphCache& operator=(FrameGraphCache&&) noexcept = delete;
+
+            // Null when the graph of the key has to be built (and then handed over with insert).
+            [[nodiscard]] FrameGraph* find(std::size_t topologyKey);
+            // Takes a compiled graph.
+            FrameGraph& insert(std::size_t topologyKey, Scope<FrameGraph>&&);
+
+            [[nodiscard]] uint32_t size() const;
+
+        private:
+            struct Entry
+            {
+                std::size_t       topologyKey {0};
+                Scope<FrameGraph> graph;
+            };
+
+            const uint32_t     m_Capacity;
+            std::vector<Entry> m_Entries; // Most recently used last
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "vultra/core/base/base.hpp"
+
 #include <fg/Fwd.hpp>
 
 #include <string_view>
@@ -14,5 +16,13 @@ namespace vultra
     namespace framegraph
     {
         [[nodiscard]] FrameGraphResource importTexture(FrameGraph&, const std::string_view name, rhi::Texture*);
+
+        // Imports whatever the binding points to when the graph is executed, so that a compiled graph can be reused
+        // while the texture behind it changes (back buffer, ping-pong history, ...). The descriptor is taken from the
+        // current texture, the ones bound later must have the same format and usage.
+        [[nodiscard]] FrameGraphResource
+        importTexture(FrameGraph&, const std::string_view name, rhi::Texture* const* binding);
+        [[nodiscard]] FrameGraphResource
+        importTexture(FrameGraph&, const std::string_view name, const Ref<rhi::Texture>* binding);
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
@@ -3,6 +3,9 @@
 #include "vultra/core/rhi/extent2d.hpp"
 #include "vultra/core/rhi/image_usage.hpp"
 #include "vultra/core/rhi/pixel_format.hpp"
+#include "vultra/function/framegraph/attachment_store_tracker.hpp"
+
+#include <functional>
 
 namespace vultra
 {
@@ -35,7 +38,17 @@ namespace vultra
 
             [[nodiscard]] static std::string toString(const Desc&);
 
-            rhi::Texture* texture {nullptr};
+            // Refreshed from the binding (when set) before every access, so that a compiled graph can be executed
+            // again with another texture behind an import (see importTexture).
+            mutable rhi::Texture*          texture {nullptr};
+            std::function<rhi::Texture*()> binding;
+
+            // Set by create(), null for imported textures (their contents are always loaded and stored).
+            AttachmentStoreTracker*  storeTracker {nullptr};
+            mutable AttachmentWrites attachmentWrites;
+            bool                     transient {false};
+            // The first write to a transient texture does not need its previous contents.
+            mutable bool written {false};
         };
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        // In-memory form of a .vfg file (written by the node editor in examples/rendergraph).
+        // Node positions and id counters are editor state and are not loaded.
+        struct GraphDescription
+        {
+            struct Pass
+            {
+                int32_t                  id {0};
+                std::string              type; // Key in the GraphPassRegistry
+                std::string              name;
+                std::vector<std::string> inputs;
+                std::vector<std::string> outputs;
+            };
+            struct Link
+            {
+                int32_t     fromNode {0};
+                std::string fromPin;
+                int32_t     toNode {0};
+                std::string toPin;
+            };
+
+            std::vector<Pass> passes;
+            std::vector<Link> links;
+        };
+
+        [[nodiscard]] std::expected<GraphDescription, std::string> loadGraphDescription(const std::filesystem::path&);
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
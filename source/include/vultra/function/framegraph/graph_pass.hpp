@@ -0,0 +1,106 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+    } // namespace rhi
+
+    namespace framegraph
+    {
+        // Pins of a pass, as shown by the editor and checked by the GraphRuntime.
+        struct GraphPassReflection
+        {
+            struct IO
+            {
+                std::string name;
+                std::string type; // "Texture", "Buffer" ...
+            };
+            std::vector<IO> inputs;
+            std::vector<IO> outputs;
+        };
+
+        // Resources bound to pins, by pin name.
+        using GraphPassResources = std::map<std::string, FrameGraphResource, std::less<>>;
+
+        struct GraphPassContext
+        {
+            FrameGraph&               fg;
+            FrameGraphBlackboard&     blackboard;
+            const GraphPassResources& inputs;  // Linked or imported inputs, unbound pins are missing
+            GraphPassResources&       outputs; // To be filled by addToGraph
+            // Outlives the graph, which can be executed again without a setup (see GraphRuntime::getFrameGraph):
+            // per-frame values are read from it when the pass executes, not captured here.
+            void* userData {nullptr};
+
+            [[nodiscard]] std::optional<FrameGraphResource> getInput(const std::string_view name) const
+            {
+                const auto it = inputs.find(name);
+                return it != inputs.cend() ? std::make_optional(it->second) : std::nullopt;
+            }
+            void setOutput(const std::string_view name, const FrameGraphResource resource)
+            {
+                outputs.insert_or_assign(std::string {name}, resource);
+            }
+        };
+
+        // A pass that can be instantiated from a graph description.
+        // Instances live as long as the graph that created them, so pipelines cached in a pass survive rebuilds.
+        class GraphPass
+        {
+        public:
+            virtual ~GraphPass() = default;
+
+            virtual void addToGraph(GraphPassContext&) = 0;
+        };
+
+        class GraphPassRegistry
+        {
+        public:
+            using Factory = std::function<std::unique_ptr<GraphPass>(rhi::RenderDevice&)>;
+
+            struct Entry
+            {
+                GraphPassReflection reflection;
+                Factory             factory;
+            };
+
+            // Passes register themselves with VULTRA_REGISTER_GRAPH_PASS, builtin ones through
+            // gfx::registerBuiltinGraphPasses (static initializers of the library are not guaranteed to run).
+            static GraphPassRegistry& instance();
+
+            void registerPass(const std::string& type, GraphPassReflection, Factory);
+
+            // T needs a static reflect() and a constructor taking rhi::RenderDevice&.
+            template<typename T> void registerPass(const std::string& type)
+            {
+                registerPass(type, T::reflect(), [](rhi::RenderDevice& rd) { return std::make_unique<T>(rd); });
+            }
+
+            using Entries = std::map<std::string, Entry, std::less<>>;
+
+            [[nodiscard]] const Entry*   find(const std::string_view type) const;
+            [[nodiscard]] const Entries& getEntries() const;
+
+        private:
+            Entries m_Entries;
+        };
+    } // namespace framegraph
+} // namespace vultra
+
+#define VULTRA_REGISTER_GRAPH_PASS(PASS_TYPE) \
+    static const bool s_##PASS_TYPE##Registered = [] { \
+        vultra::framegraph::GraphPassRegistry::instance().registerPass<PASS_TYPE>(#PASS_TYPE); \
+        return true; \
+    }()
\ No newline at end of file
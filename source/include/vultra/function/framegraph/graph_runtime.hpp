@@ -0,0 +1,107 @@
+#pragma once
+
+#include "vultra/function/framegraph/framegraph_cache.hpp"
+#include "vultra/function/framegraph/graph_description.hpp"
+#include "vultra/function/framegraph/graph_pass.hpp"
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+    } // namespace rhi
+
+    namespace framegraph
+    {
+        // Runs a data-driven render graph (.vfg).
+        // Loading parses and validates the description, instantiates the registered passes and sorts them
+        // topologically; the result (a flat list of passes with their input bindings) is kept until the file changes.
+        // addToGraph() then only walks that list, so setup costs the same as for hand written passes.
+        //
+        // getFrameGraph() keeps the compiled FrameGraph in a FrameGraphCache, keyed on the version and the caller's
+        // key, and only executes it while neither changes. The registered passes must therefore read per-frame data
+        // when they execute (through the user data, see GraphPassContext) and the imports have to be bindings.
+        //
+        // Usage:
+        //   runtime.load("graph.vfg");
+        //   ... every frame:
+        //   runtime.reloadIfChanged();
+        //   backBuffer = &target; // Bound by the import
+        //   auto& fg = runtime.getFrameGraph(hash of the target extent and format, [&](FrameGraph& fg) {
+        //       return GraphPassResources {{"Backbuffer", importTexture(fg, "Backbuffer", &backBuffer)}};
+        //   });
+        //   fg.execute(...);
+        class GraphRuntime
+        {
+        public:
+            // Imports the resources bound to the unlinked inputs, called when a graph is set up.
+            using ImportCallback = std::function<GraphPassResources(FrameGraph&)>;
+
+            explicit GraphRuntime(rhi::RenderDevice&, const GraphPassRegistry& = GraphPassRegistry::instance());
+            GraphRuntime(const GraphRuntime&)     = delete;
+            GraphRuntime(GraphRuntime&&) noexcept = default;
+            ~GraphRuntime();
+
+            GraphRuntime& operator=(const GraphRuntime&)     = delete;
+            GraphRuntime& operator=(GraphRuntime&&) noexcept = delete;
+
+            // On failure the previously loaded graph (if any) is kept, see getError().
+            bool load(const std::filesystem::path&);
+            bool load(const GraphDescription&);
+
+            // Reloads the file if its write time changed. Returns true if a new graph has been loaded.
+            bool reloadIfChanged();
+
+            [[nodiscard]] bool               isValid() const;
+            [[nodiscard]] const std::string& getError() const;
+            [[nodiscard]] uint64_t           getVersion() const; // Incremented on every successful load
+
+            // Inputs that are not linked are bound by pin name from the imports (e.g. "Backbuffer").
+            void addToGraph(FrameGraph&,
+                            FrameGraphBlackboard&,
+                            const GraphPassResources& imports = {},
+                            void*                     userData = nullptr) const;
+
+            // The compiled graph of the loaded description (requires isValid()), set up with addToGraph and compiled
+            // the first time the key is used. The key covers what the setup depends on besides the description
+            // (e.g. the target extent and format). The user data is kept by the graph.
+            [[nodiscard]] FrameGraph&
+            getFrameGraph(std::size_t key, const ImportCallback& importResources, void* userData = nullptr);
+
+        private:
+            struct Binding
+            {
+                std::string pin;
+                int32_t     source {-1}; // Index of the node producing the resource, -1: bound from the imports
+                std::string sourcePin;
+            };
+            struct Node
+            {
+                int32_t                    id {0};
+                std::string                type;
+                std::shared_ptr<GraphPass> pass;
+                std::vector<Binding>       inputs;
+            };
+
+            bool fail(std::string error);
+
+        private:
+            rhi::RenderDevice&       m_RenderDevice;
+            const GraphPassRegistry& m_Registry;
+
+            std::filesystem::path           m_Path;
+            std::filesystem::file_time_type m_LastWriteTime;
+
+            std::vector<Node>      m_Nodes;           // In execution order
+            Scope<FrameGraphCache> m_FrameGraphCache; // Graphs of the current version
+            std::string            m_Error;
+            uint64_t               m_Version {0};
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
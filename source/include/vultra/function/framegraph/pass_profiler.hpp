@@ -0,0 +1,133 @@
+#pragma once
+
+#include "vultra/core/rhi/gpu_zone.hpp"
+#include "vultra/core/rhi/query_pool.hpp"
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+    } // namespace rhi
+
+    namespace framegraph
+    {
+        struct PassStats
+        {
+            std::string name;
+
+            float cpuTime {0.0f}; // Recording, in milliseconds
+            float gpuTime {0.0f}; // In milliseconds, valid when hasGPUTime
+
+            bool hasGPUTime {false}; // Not measured on the async compute queue or past the per-frame query budget
+            bool hasPipelineStatistics {false};
+
+            uint64_t inputAssemblyPrimitives {0};
+            uint64_t vertexShaderInvocations {0};
+            uint64_t clippingPrimitives {0};
+            uint64_t fragmentShaderInvocations {0};
+            uint64_t computeShaderInvocations {0};
+        };
+
+        struct FramePassStats
+        {
+            uint64_t frameNumber {0}; // The frame the passes were recorded in
+
+            float cpuTime {0.0f}; // Sum over the passes, in milliseconds
+            float gpuTime {0.0f};
+
+            std::vector<PassStats> passes;
+        };
+
+        // Per-pass CPU/GPU time and pipeline statistics, gathered from the outermost RHI_GPU_ZONE scopes (one per
+        // pass callback) recorded between begin() and end().
+        // Every frame in flight has its own query pools; results are collected without stalling, two frames late.
+        //
+        // Usage: nextFrame() once per frame, begin() -> fg.execute() -> end() for each graph of the frame.
+        class PassProfiler final : public rhi::GPUZoneListener
+        {
+        public:
+            explicit PassProfiler(rhi::RenderDevice&);
+            PassProfiler(const PassProfiler&)     = delete;
+            PassProfiler(PassProfiler&&) noexcept = delete;
+            ~PassProfiler() override              = default;
+
+            PassProfiler& operator=(const PassProfiler&)     = delete;
+            PassProfiler& operator=(PassProfiler&&) noexcept = delete;
+
+            // GPU timestamps and host query reset, pipeline statistics are optional.
+            [[nodiscard]] bool isSupported() const;
+            [[nodiscard]] bool hasPipelineStatistics() const;
+
+            void               setEnabled(bool);
+            [[nodiscard]] bool isEnabled() const;
+
+            // Collects finished frames and recycles the queries of the oldest one.
+            void nextFrame();
+
+            // Installs the profiler as the GPU zone listener of the calling thread.
+            void begin();
+            void end();
+
+            // The latest frame with complete results.
+            [[nodiscard]] const FramePassStats& getStats() const;
+
+            bool saveJSON(const std::filesystem::path&) const;
+
+            void onZoneBegin(rhi::CommandBuffer&, const std::string_view label) override;
+            void onZoneEnd(rhi::CommandBuffer&) override;
+
+        private:
+            void collect();
+            [[nodiscard]] bool collect(uint32_t slotIndex);
+
+        private:
+            using Clock = std::chrono::steady_clock;
+
+            static constexpr uint32_t NUM_SLOTS   = 3;  // Frame N reads frame N - 2, the remaining slot is recording
+            static constexpr uint32_t MAX_QUERIES = 64; // GPU measured passes per frame
+
+            struct Slot
+            {
+                rhi::QueryPool timestamps;
+                rhi::QueryPool statistics;
+
+                // Query index of each pass (-1 when not measured on the GPU).
+                std::vector<int32_t> queries;
+                uint32_t             numQueries {0};
+
+                FramePassStats stats;
+                bool           pending {false};
+            };
+
+            struct OpenZone
+            {
+                std::size_t       pass {0};
+                int32_t           query {-1};
+                Clock::time_point start;
+            };
+
+            float m_TimestampPeriod {0.0f};
+            bool  m_HostQueryReset {false};
+            bool  m_PipelineStatistics {false};
+
+            bool m_Enabled {false};
+            bool m_SlotReady {false}; // The queries of the current slot have been recycled
+
+            std::array<Slot, NUM_SLOTS> m_Slots;
+            uint32_t                    m_CurrentSlot {0};
+            uint64_t                    m_FrameNumber {0};
+
+            uint32_t m_Depth {0}; // Nesting of the zones, only the outermost one is measured
+            OpenZone m_OpenZone;
+
+            FramePassStats m_Stats;
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
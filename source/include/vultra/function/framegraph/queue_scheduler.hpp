@@ -0,0 +1,148 @@
+#pragma once
+
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/queue_type.hpp"
+#include "vultra/function/framegraph/render_context.hpp"
+
+#include <fg/FrameGraph.hpp>
+
+#include <array>
+#include <deque>
+#include <string_view>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+        class Texture;
+    } // namespace rhi
+
+    namespace framegraph
+    {
+        // Splits the frame command buffer into segments so that compute passes (see addAsyncComputePass) are
+        // recorded for the async compute queue and overlap with the following graphics passes.
+        // Cross-queue edges get queue family ownership transfers (released on the source segment, acquired on the
+        // destination) and timeline semaphore waits. A generic pass touching an image that is still owned by the
+        // compute queue starts a new segment that waits for it.
+        //
+        // Usage:
+        //   nextFrame() once per frame, then per graph: setEnabled(), build the graph with addAsyncComputePass(),
+        //   join() before passes that write the swapchain image, then begin(cb) -> fg.execute() -> end(cb).
+        // What the frame command buffer recorded before begin() is submitted first, as a segment of its own (it must
+        // not touch the swapchain image, which is only waited on by the frame submission). The frame command buffer
+        // ends up holding the last segment (the one recorded after join()), which is submitted as usual, every other
+        // segment is submitted by end(). A GPU zone must not span begin() and end().
+        class QueueScheduler
+        {
+        public:
+            explicit QueueScheduler(rhi::RenderDevice&);
+            QueueScheduler(const QueueScheduler&)     = delete;
+            QueueScheduler(QueueScheduler&&) noexcept = delete;
+            ~QueueScheduler();
+
+            QueueScheduler& operator=(const QueueScheduler&)     = delete;
+            QueueScheduler& operator=(QueueScheduler&&) noexcept = delete;
+
+            // Requires a dedicated compute queue family and timeline semaphores.
+            [[nodiscard]] bool isSupported() const;
+
+            void setEnabled(bool);
+            // Queried while building the graph, the passes fall back to the generic queue when false.
+            [[nodiscard]] bool isEnabled() const;
+
+            // -- Graph setup:
+
+            // Adds a marker pass that moves the recording to the async compute queue.
+            void beginAsync(FrameGraph&);
+            // Adds a marker pass that moves the recording back to the frame command buffer.
+            void join(FrameGraph&);
+
+            // -- Execution:
+
+            // Recycles the command buffers of the frame that used the same pool (kNumPools frames ago).
+            void nextFrame();
+
+            void begin(rhi::CommandBuffer&);
+            // Called after an async pass, the recording continues on a new generic segment.
+            void endAsync(rhi::CommandBuffer&);
+            void end(rhi::CommandBuffer&);
+
+        private:
+            struct Segment
+            {
+                rhi::CommandBuffer* commandBuffer {nullptr};
+                rhi::QueueType      queueType {rhi::QueueType::eGeneric};
+                uint64_t            signalValue {0};
+            };
+
+            [[nodiscard]] uint32_t getQueueFamilyIndex(rhi::QueueType) const;
+
+            [[nodiscard]] rhi::CommandBuffer& acquireCommandBuffer(rhi::QueueType);
+            // Swaps the recording of cb with slot, the previous recording becomes a (not yet submitted) segment.
+            void switchTo(rhi::CommandBuffer& cb, rhi::CommandBuffer& slot);
+            void joinTail(rhi::CommandBuffer&);
+            void track(rhi::CommandBuffer&, rhi::QueueType);
+            void releaseOwnership(rhi::CommandBuffer&);
+
+            void onForeignAccess(const rhi::Texture&);
+
+        private:
+            rhi::RenderDevice& m_RenderDevice;
+
+            bool m_Enabled {false};
+            bool m_Active {false};
+
+            // One per queue (a timeline may only grow, the queues finish in any order).
+            std::array<vk::Semaphore, 2> m_Timelines {};
+            std::array<uint64_t, 2>      m_TimelineValues {};
+
+            // Rotated per frame, so that reusing a command buffer rarely waits for the GPU.
+            static constexpr auto kNumPools = 3u;
+
+            struct Pool
+            {
+                std::deque<rhi::CommandBuffer> commandBuffers;
+                std::vector<bool>              used;
+            };
+            std::array<Pool, kNumPools> m_Pools;
+            uint32_t                    m_PoolIndex {0};
+
+            rhi::CommandBuffer*  m_CommandBuffer {nullptr}; // The frame command buffer (always the current segment)
+            rhi::CommandBuffer*  m_Tail {nullptr};          // Swapped into the frame command buffer by join()
+            rhi::QueueType       m_CurrentQueueType {rhi::QueueType::eGeneric};
+            uint64_t             m_CurrentComputeWait {0};
+            uint64_t             m_LastComputeValue {0};
+            std::vector<Segment> m_Segments;
+
+            std::vector<const rhi::Texture*> m_ComputeOwned;
+        };
+
+        // Adds a compute pass that runs on the async compute queue when the scheduler is enabled (a regular pass
+        // otherwise). Async passes are never culled.
+        template<typename Data, typename Setup, typename Execute>
+        const Data& addAsyncComputePass(FrameGraph&            fg,
+                                        QueueScheduler*        scheduler,
+                                        const std::string_view name,
+                                        Setup&&                setup,
+                                        Execute&&              exec)
+        {
+            if (!scheduler || !scheduler->isEnabled())
+                return fg.addCallbackPass<Data>(name, std::forward<Setup>(setup), std::forward<Execute>(exec));
+
+            scheduler->beginAsync(fg);
+            return fg.addCallbackPass<Data>(
+                name,
+                [setup = std::forward<Setup>(setup)](FrameGraph::Builder& builder, Data& data) {
+                    setup(builder, data);
+                    builder.setSideEffect();
+                },
+                [scheduler, exec = std::forward<Execute>(exec)](
+                    const Data& data, FrameGraphPassResources& resources, void* ctx) {
+                    exec(data, resources, ctx);
+                    scheduler->endAsync(static_cast<RenderContext*>(ctx)->commandBuffer);
+                });
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "vultra/function/framegraph/attachment_store_tracker.hpp"
 #include "vultra/function/framegraph/framegraph_buffer.hpp"
 #include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/framegraph/upload_ring.hpp"
 
 #include <memory>
 #include <unordered_map>
@@ -43,6 +45,11 @@ namespace vultra
             [[nodiscard]] rhi::Buffer* acquireBuffer(const FrameGraphBuffer::Desc&);
             void                       releaseBuffer(const FrameGraphBuffer::Desc&, rhi::Buffer*);
 
+            // Shared by the textures created from this allocator.
+            [[nodiscard]] AttachmentStoreTracker& getAttachmentStoreTracker();
+            // Backs the buffers with Desc::hostWrite, see UploadRing::nextFrame.
+            [[nodiscard]] UploadRing& getUploadRing();
+
         private:
             rhi::RenderDevice& m_RenderDevice;
 
@@ -66,6 +73,9 @@ namespace vultra
             };
             Pool<rhi::Texture> m_Textures;
             Pool<rhi::Buffer>  m_Buffers;
+
+            AttachmentStoreTracker m_AttachmentStoreTracker;
+            UploadRing             m_UploadRing;
         };
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
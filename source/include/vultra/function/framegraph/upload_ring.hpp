@@ -0,0 +1,85 @@
+#pragma once
+
+#include "vultra/core/base/base.hpp"
+#include "vultra/function/framegraph/framegraph_buffer.hpp"
+
+#include <vulkan/vulkan.hpp>
+
+#include <optional>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+        class Buffer;
+    } // namespace rhi
+
+    namespace framegraph
+    {
+        // Persistently mapped uniform/storage buffers for small per-frame data (see uploadStruct).
+        // Each buffer is split in one segment per frame in flight; allocations bump the head of the current segment,
+        // which is recycled numFramesInFlight frames later. Writes are a memcpy (+ flush, a no-op for coherent
+        // memory), there are no transfer commands.
+        //
+        // Inactive until the first nextFrame(), which must be called once per frame (not per FrameGraph), after the
+        // fence of the frame that used the segment has been waited on. Allocations fail when a segment is full and
+        // the caller falls back to a transient buffer.
+        class UploadRing
+        {
+        public:
+            // Per segment and buffer type.
+            static constexpr vk::DeviceSize kSegmentSize = 256 * 1024;
+
+            explicit UploadRing(rhi::RenderDevice&);
+            UploadRing(const UploadRing&)     = delete;
+            UploadRing(UploadRing&&) noexcept = delete;
+            ~UploadRing();
+
+            UploadRing& operator=(const UploadRing&)     = delete;
+            UploadRing& operator=(UploadRing&&) noexcept = delete;
+
+            struct Allocation
+            {
+                rhi::Buffer*   buffer {nullptr};
+                vk::DeviceSize offset {0};
+                void*          mappedMemory {nullptr};
+            };
+            // Only eUniformBuffer and eStorageBuffer.
+            [[nodiscard]] std::optional<Allocation> allocate(const BufferType, const vk::DeviceSize size);
+
+            // numFramesInFlight: see FrameController::size(), the buffers are recreated when it changes.
+            void nextFrame(const uint32_t numFramesInFlight);
+
+            struct Stats
+            {
+                vk::DeviceSize uniformBytes {0}; // In the current segment
+                vk::DeviceSize storageBytes {0}; // In the current segment
+                uint32_t       numFallbacks {0}; // Allocations that did not fit, in the current segment
+            };
+            [[nodiscard]] Stats getStats() const;
+
+        private:
+            struct Ring
+            {
+                Scope<rhi::Buffer> buffer;
+                std::byte*         mappedMemory {nullptr};
+                vk::DeviceSize     alignment {1};
+                vk::DeviceSize     head {0}; // Relative to the current segment
+            };
+            Ring& getRing(const BufferType);
+            void  createRing(Ring&, const BufferType);
+            void  releaseRings();
+
+        private:
+            rhi::RenderDevice& m_RenderDevice;
+
+            Ring m_UniformRing;
+            Ring m_StorageRing;
+
+            uint32_t                m_NumSegments {0};
+            std::optional<uint32_t> m_Segment; // Inactive until the first nextFrame()
+            uint32_t                m_NumFallbacks {0};
+        };
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -7,18 +7,26 @@
 
 #include <fg/FrameGraph.hpp>
 
+#include <cstring>
+#include <type_traits>
+
 namespace vultra
 {
     namespace framegraph
     {
-        template<typename T>
-        [[nodiscard]] FrameGraphResource
-        uploadStruct(FrameGraph& fg, const std::string_view passName, TransientBuffer<T>&& s)
+        // The data is produced by the callable when the pass executes, not captured at setup: a compiled graph that
+        // is executed again uploads the values of the current frame (see FrameGraphCache).
+        template<typename Producer>
+        [[nodiscard]] FrameGraphResource uploadStruct(FrameGraph&            fg,
+                                                      const std::string_view passName,
+                                                      const std::string_view name,
+                                                      const BufferType       type,
+                                                      Producer&&             produce)
         {
             ZoneTransientN(__tracy_zone, passName.data(), true);
 
+            using T                  = std::remove_cvref_t<decltype(produce())>;
             constexpr auto kDataSize = static_cast<uint32_t>(sizeof(T));
-            auto           payload   = std::make_shared<T>(std::move(s.data));
 
             struct Data
             {
@@ -26,24 +34,49 @@ namespace vultra
             };
             const auto [buffer] = fg.addCallbackPass<Data>(
                 passName,
-                [&s](FrameGraph::Builder& builder, Data& data) {
+                [name, type](FrameGraph::Builder& builder, Data& data) {
                     PASS_SETUP_ZONE;
 
-                    data.buffer = builder.create<FrameGraphBuffer>(s.name,
+                    data.buffer = builder.create<FrameGraphBuffer>(name,
                                                                    {
-                                                                       .type     = s.type,
+                                                                       .type     = type,
                                                                        .stride   = kDataSize,
                                                                        .capacity = 1,
+                                                                       .hostWrite =
+                                                                           type == BufferType::eUniformBuffer ||
+                                                                           type == BufferType::eStorageBuffer,
                                                                    });
                     data.buffer = builder.write(data.buffer, BindingInfo {.pipelineStage = PipelineStage::eTransfer});
                 },
-                [passName, payload](const Data& data, FrameGraphPassResources& resources, void* ctx) {
+                [passName, produce = std::forward<Producer>(produce)](
+                    const Data& data, FrameGraphPassResources& resources, void* ctx) {
+                    const T&    payload = produce();
+                    const auto& target  = resources.get<FrameGraphBuffer>(data.buffer);
+                    if (target.mappedMemory)
+                    {
+                        // UploadRing allocation, no commands.
+                        std::memcpy(target.mappedMemory, &payload, kDataSize);
+                        target.buffer->flush(target.offset, kDataSize);
+                        return;
+                    }
+
                     auto& cb = static_cast<RenderContext*>(ctx)->commandBuffer;
                     RHI_GPU_ZONE(cb, passName.data());
-                    cb.update(*resources.get<FrameGraphBuffer>(data.buffer).buffer, 0, kDataSize, payload.get());
+                    cb.update(*target.buffer, 0, kDataSize, &payload);
                 });
 
             return buffer;
         }
+
+        template<typename T>
+        [[nodiscard]] FrameGraphResource
+        uploadStruct(FrameGraph& fg, const std::string_view passName, TransientBuffer<T>&& s)
+        {
+            return uploadStruct(fg,
+                                passName,
+                                s.name,
+                                s.type,
+                                [payload = std::make_shared<T>(std::move(s.data))]() -> const T& { return *payload; });
+        }
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
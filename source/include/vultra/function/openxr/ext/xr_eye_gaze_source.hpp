@@ -0,0 +1,29 @@
+#pragma once
+
+#include <openxr/openxr.h>
+
+namespace vultra
+{
+    namespace openxr
+    {
+        namespace ext
+        {
+            // Source of the eye gaze pose, implemented by the XR_EXT_eye_gaze_interaction tracker
+            // and by a mock that needs no runtime support (headless runs, stub runtimes).
+            class XREyeGazeSource
+            {
+            public:
+                virtual ~XREyeGazeSource() = default;
+
+                virtual bool sync(XrSpace space, XrTime time) = 0;
+
+                // Action set to attach to the session, null when the source does not use actions.
+                [[nodiscard]] virtual XrActionSet getActionSet() const { return XR_NULL_HANDLE; }
+
+                [[nodiscard]] virtual const XrPosef& getGazePose() const = 0;
+                // False until a gaze sample has been located (or while tracking is lost).
+                [[nodiscard]] virtual bool isGazeValid() const = 0;
+            };
+        } // namespace ext
+    } // namespace openxr
+} // namespace vultra
\ No newline at end of file
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "vultra/function/openxr/ext/xr_eye_gaze_source.hpp"
+
 #include <openxr/openxr.h>
 #include <openxr/openxr_platform.h>
 
@@ -9,16 +11,17 @@ namespace vultra
     {
         namespace ext
         {
-            class XREyeTracker final
+            class XREyeTracker final : public XREyeGazeSource
             {
             public:
                 XREyeTracker(XrInstance instance, XrSession session);
-                ~XREyeTracker();
+                ~XREyeTracker() override;
 
-                bool sync(XrSpace space, XrTime time);
+                bool sync(XrSpace space, XrTime time) override;
 
-                XrActionSet    getActionSet() const { return m_GamePlayActionSet; }
-                const XrPosef& getGazePose() const { return m_GazePose; }
+                XrActionSet    getActionSet() const override { return m_GamePlayActionSet; }
+                const XrPosef& getGazePose() const override { return m_GazePose; }
+                bool           isGazeValid() const override { return m_GazeValid; }
 
             private:
                 XrInstance m_XrInstance = nullptr;
@@ -30,6 +33,7 @@ namespace vultra
                 XrSpace m_GazeActionSpace;
 
                 XrPosef m_GazePose {};
+                bool    m_GazeValid {false};
 
                 XrActionSet m_GamePlayActionSet = nullptr;
                 XrAction    m_UserIntentAction  = nullptr;
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "vultra/function/openxr/ext/xr_eye_gaze_source.hpp"
+
+#include <functional>
+#include <optional>
+
+namespace vultra
+{
+    namespace openxr
+    {
+        namespace ext
+        {
+            // Eye gaze source driven by a callback instead of the runtime.
+            // The callback returns the gaze pose at the given time, or nullopt when tracking is lost.
+            class XRMockEyeTracker final : public XREyeGazeSource
+            {
+            public:
+                using GazeFunction = std::function<std::optional<XrPosef>(XrTime)>;
+
+                explicit XRMockEyeTracker(GazeFunction gazeFunction);
+
+                bool sync(XrSpace space, XrTime time) override;
+
+                [[nodiscard]] const XrPosef& getGazePose() const override { return m_GazePose; }
+                [[nodiscard]] bool           isGazeValid() const override { return m_GazeValid; }
+
+            private:
+                GazeFunction m_GazeFunction;
+
+                XrPosef m_GazePose {};
+                bool    m_GazeValid {false};
+            };
+        } // namespace ext
+    } // namespace openxr
+} // namespace vultra
\ No newline at end of file
@@ -10,7 +10,7 @@ namespace vultra
 
         namespace ext
         {
-            class XREyeTracker;
+            class XREyeGazeSource;
         }
 
         class XRCommonAction final
@@ -21,15 +21,19 @@ namespace vultra
 
             bool sync(XrSpace space, XrTime time);
 
-            XRInput*                 getInput() { return m_Input.get(); }
-            const ext::XREyeTracker* getEyeTracker() const { return m_EyeTracker; }
+            XRInput*                    getInput() { return m_Input.get(); }
+            const ext::XREyeGazeSource* getEyeTracker() const { return m_EyeTracker.get(); }
+
+            // Replaces the eye gaze source, e.g. with an ext::XRMockEyeTracker when the runtime has none.
+            // Action sets are attached once per session, so the new source must not need one.
+            void setEyeTracker(std::unique_ptr<ext::XREyeGazeSource>);
 
         private:
             XrInstance m_XrInstance = nullptr;
             XrSession  m_Session    = nullptr;
 
-            std::unique_ptr<XRInput> m_Input {nullptr};
-            ext::XREyeTracker*       m_EyeTracker = nullptr;
+            std::unique_ptr<XRInput>              m_Input {nullptr};
+            std::unique_ptr<ext::XREyeGazeSource> m_EyeTracker {nullptr};
         };
     } // namespace openxr
 } // namespace vultra
\ No newline at end of file
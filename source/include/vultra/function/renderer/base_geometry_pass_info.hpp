@@ -3,6 +3,12 @@
 #include "vultra/core/rhi/pixel_format.hpp"
 #include "vultra/core/rhi/primitive_topology.hpp"
 
+namespace cereal
+{
+    class BinaryOutputArchive;
+    class BinaryInputArchive;
+} // namespace cereal
+
 namespace vultra
 {
     namespace gfx
@@ -15,7 +21,13 @@ namespace vultra
             std::vector<rhi::PixelFormat> colorFormats;
             rhi::PrimitiveTopology        topology {rhi::PrimitiveTopology::eTriangleList};
             const VertexFormat*           vertexFormat {nullptr};
+            uint32_t                      viewMask {0}; // Multiview (stereo) when non-zero
         };
+
+        // For the PipelineManifest, the vertex format is stored by value.
+        // Loading rebuilds it with VertexFormat::Builder and keeps it alive until exit (main thread only).
+        void save(cereal::BinaryOutputArchive&, const BaseGeometryPassInfo&);
+        void load(cereal::BinaryInputArchive&, BaseGeometryPassInfo&);
     } // namespace gfx
 } // namespace vultra
 
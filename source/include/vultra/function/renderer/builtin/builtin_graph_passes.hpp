@@ -0,0 +1,21 @@
+#pragma once
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        class GraphPassRegistry;
+    } // namespace framegraph
+
+    namespace gfx
+    {
+        // Exposes the builtin single input post process passes to data-driven graphs (.vfg):
+        //   FXAAPass            Input -> Output
+        //   GammaCorrectionPass Input -> Output
+        //   BlitPass            Source, Target (usually imported, e.g. the back buffer)
+        // They read the "point" and "bilinear" samplers from the RendererRenderContext.
+        // The scene passes are not exposed: they read the camera, lights and renderables of the BuiltinRenderer,
+        // whose render paths are set up in code.
+        void registerBuiltinGraphPasses(framegraph::GraphPassRegistry&);
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -1,31 +1,59 @@
 #pragma once
 
+#include "vultra/core/rhi/barrier.hpp"
 #include "vultra/function/debug_draw/debug_draw_interface.hpp"
 #include "vultra/function/framegraph/render_context.hpp"
 #include "vultra/function/framegraph/transient_resources.hpp"
 #include "vultra/function/renderer/base_renderer.hpp"
+#include "vultra/function/renderer/builtin/dynamic_resolution_settings.hpp"
+#include "vultra/function/renderer/builtin/foveation_settings.hpp"
 #include "vultra/function/renderer/builtin/pass_output_mode.hpp"
+#include "vultra/function/renderer/builtin/shadow_settings.hpp"
+#include "vultra/function/renderer/builtin/ssr_settings.hpp"
 #include "vultra/function/renderer/builtin/tonemapping_method.hpp"
 #include "vultra/function/renderer/builtin/tool/cubemap_converter.hpp"
 #include "vultra/function/renderer/builtin/tool/ibl_data_generator.hpp"
 #include "vultra/function/renderer/builtin/ui_structs.hpp"
 #include "vultra/function/renderer/builtin/upload_resources.hpp"
 
+#include <filesystem>
+#include <functional>
+#include <optional>
+
 namespace vultra
 {
+    namespace framegraph
+    {
+        class QueueScheduler;
+        class FrameGraphBuildTracker;
+        class FrameGraphCache;
+        struct FrameGraphBuildStats;
+        class PassProfiler;
+        struct FramePassStats;
+    } // namespace framegraph
+
     namespace gfx
     {
         class DepthPrePass;
         class GBufferPass;
+        class CascadedShadowMapPass;
+        class PointShadowPass;
+        class RayTracedShadowPass;
         class DeferredLightingPass;
+        class HiZPass;
+        class SSRPass;
         class SkyboxPass;
         class ToneMappingPass;
         class GammaCorrectionPass;
         class FXAAPass;
+        class UpscalePass;
+        class DynamicResolutionController;
         class FinalPass;
         class BlitPass;
         class DebugDrawPass;
         class ColorBlendPass;
+        class StereoLayerPass;
+        class FoveatedCompositePass;
 
         class UIPass;
 
@@ -34,6 +62,8 @@ namespace vultra
         class MeshletDepthPrePass;
         class MeshletGBufferPass;
 
+        class ParallelCommandRecorder;
+
         enum class RendererType
         {
             eRasterization = 0,
@@ -47,12 +77,42 @@ namespace vultra
             RendererType rendererType {RendererType::eRasterization};
 
             // Rasterization settings
-            PassOutputMode    outputMode {PassOutputMode::SceneColor_AntiAliased};
-            bool              enableAreaLights {true};
-            bool              enableNormalMapping {true};
-            bool              enableIBL {true};
-            float             exposure {1.0f};
-            ToneMappingMethod toneMappingMethod {ToneMappingMethod::KhronosPBRNeutral};
+            PassOutputMode          outputMode {PassOutputMode::SceneColor_AntiAliased};
+            bool                    enableAreaLights {true};
+            bool                    enableNormalMapping {true};
+            bool                    enableIBL {true};
+            float                   exposure {1.0f};
+            ToneMappingMethod       toneMappingMethod {ToneMappingMethod::KhronosPBRNeutral};
+            bool                    enableShadows {true};
+            ShadowSettings          shadow {};
+            bool                    enablePointShadows {true};
+            PointShadowSettings     pointShadow {};
+            bool                    enableRayTracedShadows {false};
+            RayTracedShadowSettings rayTracedShadow {};
+            bool                    enableSSR {false};
+            SSRSettings             ssr {};
+
+            // Dynamic resolution (rasterization and mesh shading)
+            bool                      enableDynamicResolution {false};
+            DynamicResolutionSettings dynamicResolution {};
+
+            // Async compute (rasterization): the Hi-Z build runs on the compute queue, overlapping the shadow passes
+            bool enableAsyncCompute {false};
+
+            // Per-pass CPU/GPU time and pipeline statistics (see framegraph::PassProfiler)
+            bool enablePassProfiling {false};
+
+            // Large G-Buffer draw lists are recorded on worker threads (see ParallelCommandRecorder).
+            // Ignored while pass profiling collects pipeline statistics.
+            bool enableParallelRecording {false};
+
+            // XR: render both eyes' geometry passes in one multiview pass (rasterization only)
+            bool enableMultiview {false};
+
+            // XR: full resolution inset around the gaze point over a low resolution periphery, per eye.
+            // Falls back to fixed foveation (the view axis) without gaze; multiview takes precedence.
+            bool              enableFoveation {false};
+            FoveationSettings foveation {};
 
             // Ray Tracing settings
             uint32_t maxRayRecursionDepth {2};
@@ -64,7 +124,10 @@ namespace vultra
         class BuiltinRenderer : public BaseRenderer
         {
         public:
-            BuiltinRenderer(rhi::RenderDevice& rd, rhi::Swapchain::Format swapChainFormat);
+            // numFramesInFlight: FrameController::size() of the frames this renderer records into.
+            BuiltinRenderer(rhi::RenderDevice&     rd,
+                            rhi::Swapchain::Format swapChainFormat,
+                            uint32_t               numFramesInFlight);
             ~BuiltinRenderer() override;
 
             virtual void onImGui() override;
@@ -96,6 +159,19 @@ namespace vultra
             void                   setSettings(const BuiltinRenderSettings& settings) { m_Settings = settings; }
             BuiltinRenderSettings& getSettings() { return m_Settings; }
 
+            // Queues the pipelines recorded by a previous session (see rhi::PipelineManifest) on the PipelineCompiler,
+            // call before loading the scene and PipelineCompiler::waitIdle before the first frame.
+            // The manifest, with the pipelines created by this session, is written back to the path on destruction.
+            uint32_t warmUpPipelines(const std::filesystem::path& manifestPath);
+
+            // World space eye gaze direction used by foveated XR rendering, nullopt when not tracked.
+            void setXrGazeDirection(const std::optional<glm::vec3>& direction) { m_XrGazeDirection = direction; }
+
+            // CPU cost of building the frame graph (setup + compile).
+            [[nodiscard]] const framegraph::FrameGraphBuildStats& getFrameGraphBuildStats() const;
+            // Per-pass timings, requires BuiltinRenderSettings::enablePassProfiling.
+            [[nodiscard]] const framegraph::FramePassStats& getFramePassStats() const;
+
         private:
             void setupSamplers();
 
@@ -103,9 +179,41 @@ namespace vultra
             void onImGuiRayTracing();
             void onImGuiMeshShading();
 
+            // The compiled graph of the key from the FrameGraphCache, set up and compiled when it is not cached.
+            // A graph is executed again while its topology key does not change.
+            FrameGraph& getFrameGraph(std::size_t topologyKey, const std::function<void(FrameGraph&)>& setup);
+
+            void setupRasterization(FrameGraph&         fg,
+                                    const rhi::Extent2D sceneExtent,
+                                    const rhi::Extent2D targetExtent,
+                                    const fsec          dt);
+            void setupRayTracing(FrameGraph& fg, const rhi::Extent2D extent);
+            void setupMeshShading(FrameGraph&         fg,
+                                  const rhi::Extent2D sceneExtent,
+                                  const rhi::Extent2D targetExtent,
+                                  const fsec          dt);
+            void setupMultiview(FrameGraph& fg, const rhi::Extent2D extent, const fsec dt);
             void renderRasterization(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt);
             void renderRayTracing(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt);
             void renderMeshShading(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt);
+            void renderMultiview(rhi::CommandBuffer& cb,
+                                 rhi::Texture*       leftEyeRenderTarget,
+                                 rhi::Texture*       rightEyeRenderTarget,
+                                 const fsec          dt);
+            void renderFoveated(rhi::CommandBuffer& cb,
+                                rhi::Texture*       renderTarget,
+                                const CameraInfo&   eyeCamera,
+                                const uint32_t      peripheryViewId,
+                                const uint32_t      insetViewId,
+                                const fsec          dt);
+
+            [[nodiscard]] bool isMultiviewSupported() const;
+            // Null when parallel recording is disabled (or not allowed this frame).
+            [[nodiscard]] ParallelCommandRecorder* getParallelCommandRecorder() const;
+
+            // Hash of everything the graph topology (pass set and resource descriptors) depends on.
+            [[nodiscard]] std::size_t getTopologyKey(const rhi::Extent2D sceneExtent,
+                                                     const rhi::Texture& renderTarget) const;
 
             void clearUIDrawList();
             void renderUIDrawList(rhi::CommandBuffer& cb);
@@ -117,6 +225,7 @@ namespace vultra
             LogicScene* m_LogicScene {nullptr};
 
             rhi::Swapchain::Format m_SwapChainFormat;
+            uint32_t               m_NumFramesInFlight {0};
 
             CameraInfo m_CameraInfo {};
             FrameInfo  m_FrameInfo {};
@@ -124,20 +233,47 @@ namespace vultra
 
             CameraInfo m_XrCameraLeft {};
             CameraInfo m_XrCameraRight {};
+            CameraInfo m_XrCameraCulling {}; // Encloses both eye frusta
+
+            std::optional<glm::vec3> m_XrGazeDirection {std::nullopt};
+            glm::vec4                m_FoveatedInsetRect {0.0f}; // Of the eye being composed
+            float                    m_FoveatedFeather {0.0f};
+
+            uint32_t m_ViewId {0}; // Selects the history of the temporal passes, one per rendered view
 
             glm::mat4 m_ReferenceViewProjectionMatrix {1.0f};
 
-            DepthPrePass*         m_DepthPrePass {nullptr};
-            GBufferPass*          m_GBufferPass {nullptr};
-            DeferredLightingPass* m_DeferredLightingPass {nullptr};
-            SkyboxPass*           m_SkyboxPass {nullptr};
-            ToneMappingPass*      m_ToneMappingPass {nullptr};
-            GammaCorrectionPass*  m_GammaCorrectionPass {nullptr};
-            FXAAPass*             m_FXAAPass {nullptr};
-            FinalPass*            m_FinalPass {nullptr};
-            BlitPass*             m_BlitPass {nullptr};
-            DebugDrawPass*        m_DebugDrawPass {nullptr};
-            ColorBlendPass*       m_ColorBlendPass {nullptr};
+            DepthPrePass*          m_DepthPrePass {nullptr};
+            GBufferPass*           m_GBufferPass {nullptr};
+            CascadedShadowMapPass* m_CascadedShadowMapPass {nullptr};
+            PointShadowPass*       m_PointShadowPass {nullptr};
+            RayTracedShadowPass*   m_RayTracedShadowPass {nullptr};
+            DeferredLightingPass*  m_DeferredLightingPass {nullptr};
+            HiZPass*               m_HiZPass {nullptr};
+            SSRPass*               m_SSRPass {nullptr};
+            SkyboxPass*            m_SkyboxPass {nullptr};
+            ToneMappingPass*       m_ToneMappingPass {nullptr};
+            GammaCorrectionPass*   m_GammaCorrectionPass {nullptr};
+            FXAAPass*              m_FXAAPass {nullptr};
+            UpscalePass*           m_UpscalePass {nullptr};
+            FinalPass*             m_FinalPass {nullptr};
+            BlitPass*              m_BlitPass {nullptr};
+            DebugDrawPass*         m_DebugDrawPass {nullptr};
+            ColorBlendPass*        m_ColorBlendPass {nullptr};
+            StereoLayerPass*       m_StereoLayerPass {nullptr};
+            FoveatedCompositePass* m_FoveatedCompositePass {nullptr};
+
+            DynamicResolutionController* m_DynamicResolution {nullptr};
+            framegraph::QueueScheduler*  m_QueueScheduler {nullptr};
+            ParallelCommandRecorder*     m_ParallelCommandRecorder {nullptr};
+
+            framegraph::FrameGraphBuildTracker* m_FrameGraphBuildTracker {nullptr};
+            framegraph::FrameGraphCache*        m_FrameGraphCache {nullptr};
+            rhi::Texture*                       m_BackBuffer {nullptr};         // Bound to the cached graphs
+            rhi::Texture*                       m_RightEyeBackBuffer {nullptr}; // Multiview
+            framegraph::PassProfiler*           m_PassProfiler {nullptr};
+            bool                                m_ShowPassStatsOverlay {false};
+            rhi::Barrier::Stats                 m_BarrierStats; // Of the frame command buffer, at the end of render
 
             CubemapConverter  m_CubemapConverter;
             Ref<rhi::Texture> m_Cubemap {nullptr};
@@ -163,6 +299,8 @@ namespace vultra
 
             std::vector<Ref<DefaultMesh>> m_AreaLightMeshes; // Keep alive for raytracing purposes
 
+            std::filesystem::path m_PipelineManifestPath;
+
             DebugDrawInterface m_DebugDrawInterface;
         };
     } // namespace gfx
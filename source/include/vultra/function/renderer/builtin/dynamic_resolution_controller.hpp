@@ -0,0 +1,66 @@
+#pragma once
+
+#include "vultra/core/rhi/extent2d.hpp"
+#include "vultra/core/rhi/query_pool.hpp"
+#include "vultra/function/renderer/builtin/dynamic_resolution_settings.hpp"
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+        class CommandBuffer;
+    } // namespace rhi
+
+    namespace gfx
+    {
+        // Picks the render scale of the scene passes from GPU timestamps written around them.
+        // Results are read without stalling, a few frames late; only measurements taken at the current
+        // scale are used, assuming the cost grows with the pixel count (scale^2).
+        class DynamicResolutionController
+        {
+        public:
+            explicit DynamicResolutionController(rhi::RenderDevice&);
+
+            [[nodiscard]] bool isSupported() const { return m_TimestampPeriod > 0.0f; }
+
+            // Collects finished measurements and returns the scale to render this frame with (1 when disabled).
+            float update(const DynamicResolutionSettings&, bool enabled);
+
+            // Bracket the measured work, outside of any render pass.
+            void beginMeasure(rhi::CommandBuffer&);
+            void endMeasure(rhi::CommandBuffer&);
+
+            void reset();
+
+            [[nodiscard]] float getScale() const { return m_Scale; }
+            // Smoothed, in milliseconds.
+            [[nodiscard]] float getGPUTime() const { return m_GPUTime; }
+
+            [[nodiscard]] static rhi::Extent2D getScaledExtent(const rhi::Extent2D&, float scale);
+
+        private:
+            void collect();
+
+        private:
+            static constexpr uint32_t NUM_SLOTS = 4; // > frames in flight, so results are ready before reuse
+
+            struct Slot
+            {
+                float scale {1.0f};
+                bool  pending {false};
+            };
+
+            rhi::QueryPool m_QueryPool;
+            float          m_TimestampPeriod {0.0f};
+
+            Slot     m_Slots[NUM_SLOTS] {};
+            uint32_t m_CurrentSlot {0};
+            bool     m_Measuring {false};
+
+            float    m_Scale {1.0f};
+            float    m_GPUTime {0.0f};
+            uint32_t m_NumSamples {0};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
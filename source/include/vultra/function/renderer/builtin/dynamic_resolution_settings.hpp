@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct DynamicResolutionSettings
+        {
+            float    targetFrameTime {16.6f}; // GPU milliseconds of the scene passes
+            float    headroom {0.85f};        // Scale up only while below targetFrameTime * headroom
+            float    minScale {0.5f};
+            float    maxScale {1.0f};
+            float    scaleStep {0.05f};       // Scale is quantized to multiples of this to limit target reallocations
+            uint32_t minSampleCount {8};      // Measurements at the current scale before it may change again
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct FoveationSettings
+        {
+            float insetSize {0.35f};     // Inset size as a fraction of the eye's view, rendered at full resolution
+            float peripheryScale {0.5f}; // Resolution scale of the whole view behind the inset
+            float feather {0.15f};       // Blend band at the inset edge, as a fraction of the inset size
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
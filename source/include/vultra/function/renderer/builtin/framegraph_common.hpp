@@ -1,6 +1,7 @@
 #pragma once
 
 #include "vultra/function/framegraph/framegraph_resource_access.hpp"
+#include "vultra/function/framegraph/render_context.hpp"
 
 #include <fg/Blackboard.hpp>
 #include <fg/FrameGraph.hpp>
@@ -44,5 +45,23 @@ namespace vultra
                 return blackboard.get<T>();
             }
         }
+
+        // A pass without resources (kept by its side effect) that runs the callback every time the graph executes.
+        // Per-frame CPU work of a pass (culling, history ping-pong, ...) goes there rather than into the setup, which
+        // is skipped when a compiled graph is reused (see framegraph::FrameGraphCache).
+        template<typename Callback>
+        inline void addUpdatePass(FrameGraph& fg, const std::string_view name, Callback&& callback)
+        {
+            fg.addCallbackPass(
+                name,
+                [](FrameGraph::Builder& builder, auto&) {
+                    PASS_SETUP_ZONE;
+                    builder.setSideEffect();
+                },
+                [name, callback = std::forward<Callback>(callback)](const auto&, FrameGraphPassResources&, void*) {
+                    ZoneTransientN(__tracy_zone, name.data(), true);
+                    callback();
+                });
+        }
     } // namespace gfx
 } // namespace vultra
\ No newline at end of file
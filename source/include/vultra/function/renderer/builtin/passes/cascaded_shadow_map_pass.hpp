@@ -0,0 +1,83 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+#include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/renderer/base_geometry_pass_info.hpp"
+#include "vultra/function/renderer/builtin/shadow_settings.hpp"
+#include "vultra/function/renderer/builtin/upload_resources.hpp"
+#include "vultra/function/renderer/renderable.hpp"
+
+#include <fg/Fwd.hpp>
+#include <glm/glm.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Cascaded shadow maps for the directional light, rendered position-only into a persistent layered texture.
+        // The first numDynamicCascades cascades are refreshed every frame, the remaining (distant) ones are kept
+        // until the light direction or the geometry changes, or the camera moves past a texel-snapped threshold.
+        // Always provides ShadowData; with shadows disabled the cascade count in the block is zero.
+        // The cascades are fitted and culled when the graph executes, from inputs that must outlive the graph. There
+        // is a pass for every cascade, the cached ones skip their rendering (so a compiled graph can be reused).
+        class CascadedShadowMapPass final : public rhi::RenderPass<CascadedShadowMapPass>
+        {
+            friend class BasePass;
+
+        public:
+            // See BasePass::warmUpPipelines.
+            using PipelineKey = std::tuple<BaseGeometryPassInfo>;
+
+            explicit CascadedShadowMapPass(rhi::RenderDevice&);
+
+            void addPass(FrameGraph&,
+                         FrameGraphBlackboard&,
+                         const CameraInfo&,
+                         const LightInfo&,
+                         const RenderPrimitiveGroup&,
+                         const size_t& geometryVersion,
+                         const ShadowSettings&,
+                         bool enabled);
+
+            // Force all cascades to be re-rendered next frame.
+            void invalidate();
+
+            [[nodiscard]] uint32_t getNumUpdatedCascades() const { return m_NumUpdatedCascades; }
+            [[nodiscard]] uint32_t getNumCulledPrimitives() const { return m_NumCulledPrimitives; }
+
+        private:
+            rhi::GraphicsPipeline createPipeline(const gfx::BaseGeometryPassInfo&) const;
+
+            void prepareShadowMaps(const ShadowSettings&);
+            void update(const CameraInfo&,
+                        const LightInfo&,
+                        const RenderPrimitiveGroup&,
+                        size_t geometryVersion,
+                        const ShadowSettings&,
+                        bool enabled);
+
+        private:
+            struct Cascade
+            {
+                glm::mat4 viewProjection {1.0f};
+                glm::vec3 lightSpaceCenter {0.0f}; // Texel-snapped
+                float     radius {0.0f};
+                float     texelSize {0.0f}; // World-space size of a shadow map texel
+                float     splitDepth {0.0f};
+                bool      valid {false};
+                bool      updated {false}; // This frame
+            };
+
+            Ref<rhi::Texture> m_ShadowMaps {nullptr};
+            Cascade           m_Cascades[CSM_MAX_CASCADES];
+            glm::vec3         m_CachedLightDirection {0.0f};
+            size_t            m_CachedGeometryVersion {0};
+
+            std::vector<const RenderPrimitive*> m_DrawLists[CSM_MAX_CASCADES];
+
+            uint32_t m_NumActiveCascades {0}; // Zero without a directional light
+            uint32_t m_NumUpdatedCascades {0};
+            uint32_t m_NumCulledPrimitives {0};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -16,12 +16,17 @@ namespace vultra
             friend class BasePass;
 
         public:
+            // See BasePass::warmUpPipelines.
+            using PipelineKey = std::tuple<BaseGeometryPassInfo>;
+
             explicit DepthPrePass(rhi::RenderDevice&);
 
+            // A non-zero viewMask renders every view into its own layer of the depth target in one pass (multiview).
             void addPass(FrameGraph&,
                          FrameGraphBlackboard&,
                          const rhi::Extent2D&        resolution,
-                         const RenderPrimitiveGroup& renderPrimitiveGroup);
+                         const RenderPrimitiveGroup& renderPrimitiveGroup,
+                         uint32_t                    viewMask = 0);
 
         private:
             rhi::GraphicsPipeline createPipeline(const gfx::BaseGeometryPassInfo&) const;
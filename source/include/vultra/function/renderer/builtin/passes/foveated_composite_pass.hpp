@@ -0,0 +1,41 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+#include "vultra/core/rhi/texture.hpp"
+
+#include <fg/Fwd.hpp>
+#include <glm/glm.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Owns the periphery and inset targets of a foveated view and blends them into the final target.
+        class FoveatedCompositePass final : public rhi::RenderPass<FoveatedCompositePass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit FoveatedCompositePass(rhi::RenderDevice&);
+
+            // (Re)creates the targets when the extents or the format change.
+            void prepareTargets(const rhi::Extent2D& peripheryExtent,
+                                const rhi::Extent2D& insetExtent,
+                                rhi::PixelFormat     format);
+
+            [[nodiscard]] rhi::Texture* getPeripheryTarget() const { return m_Periphery.get(); }
+            [[nodiscard]] rhi::Texture* getInsetTarget() const { return m_Inset.get(); }
+
+            // insetRect: (min uv, max uv) of the inset in the target, feather in inset uv units.
+            // Both are read when the pass executes, the targets are bound (the graph can be cached).
+            void compose(FrameGraph&, FrameGraphResource target, const glm::vec4& insetRect, const float& feather);
+
+        private:
+            rhi::GraphicsPipeline createPipeline(const rhi::PixelFormat colorFormat) const;
+
+        private:
+            Ref<rhi::Texture> m_Periphery {nullptr};
+            Ref<rhi::Texture> m_Inset {nullptr};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
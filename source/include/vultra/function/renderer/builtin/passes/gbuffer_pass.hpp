@@ -11,21 +11,40 @@ namespace vultra
 {
     namespace gfx
     {
+        class ParallelCommandRecorder;
+        class RendererRenderContext;
+
         class GBufferPass final : public rhi::RenderPass<GBufferPass>
         {
             friend class BasePass;
 
         public:
+            // createPipeline arguments: doubleSided, alphaMasking, earlyZ (see BasePass::warmUpPipelines).
+            using PipelineKey = std::tuple<BaseGeometryPassInfo, bool, bool, bool>;
+
             explicit GBufferPass(rhi::RenderDevice&);
 
+            // A non-zero viewMask renders every view into its own layer of the targets in one pass (multiview),
+            // area light meshes and decals are only drawn in the single view case.
+            // With a recorder, large draw lists are split across its threads into secondary command buffers.
             void addPass(FrameGraph&,
                          FrameGraphBlackboard&,
                          const rhi::Extent2D&        resolution,
                          const RenderPrimitiveGroup& renderPrimitiveGroup,
                          bool                        enableAreaLight,
-                         bool                        enableNormalMapping = true);
+                         bool                        enableNormalMapping = true,
+                         uint32_t                    viewMask            = 0,
+                         ParallelCommandRecorder*    recorder            = nullptr);
 
         private:
+            // Area light meshes and decals, on the calling thread (their pipelines are created lazily).
+            void drawOverlays(RendererRenderContext&,
+                              BaseGeometryPassInfo&,
+                              const std::vector<RenderPrimitive>&     decalPrimitives,
+                              bool                                    enableAreaLight,
+                              uint32_t                                enableNormalMapping,
+                              const std::vector<const rhi::Texture*>& textures);
+
             rhi::GraphicsPipeline createPipeline(const gfx::BaseGeometryPassInfo&,
                                                  bool doubleSided,
                                                  bool alphaMasking,
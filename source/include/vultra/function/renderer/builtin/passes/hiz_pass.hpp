@@ -0,0 +1,32 @@
+#pragma once
+
+#include "vultra/core/rhi/compute_pass.hpp"
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        class QueueScheduler;
+    } // namespace framegraph
+
+    namespace gfx
+    {
+        // Builds a min-depth (closest surface) pyramid at half of the scene depth resolution.
+        // Mip N stores the minimum of the 2x2 (or 3x3 on odd edges) footprint of mip N-1.
+        // Runs on the async compute queue when a (enabled) scheduler is given.
+        class HiZPass final : public rhi::ComputePass<HiZPass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit HiZPass(rhi::RenderDevice&);
+
+            void addPass(FrameGraph&, FrameGraphBlackboard&, framegraph::QueueScheduler* = nullptr);
+
+        private:
+            rhi::ComputePipeline createPipeline() const;
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+#include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/renderer/base_geometry_pass_info.hpp"
+#include "vultra/function/renderer/builtin/shadow_settings.hpp"
+#include "vultra/function/renderer/builtin/upload_resources.hpp"
+#include "vultra/function/renderer/renderable.hpp"
+
+#include <fg/Fwd.hpp>
+#include <glm/glm.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Omnidirectional shadows for the most important point lights, stored in a persistent 2D array depth atlas
+        // (six layers, one per cube face, for each slot). Lights keep their slot while they stay among the
+        // maxShadowedLights most important ones; a slot is only re-rendered when its light moves or the casters
+        // inside the light radius change, and at most updateBudget slots are refreshed per frame.
+        // When the device supports shaderOutputLayer all six faces of a light are rendered in a single layered pass
+        // (instanced, gl_Layer from the vertex shader), otherwise one face at a time.
+        // The slots are assigned and culled when the graph executes, from inputs that must outlive the graph; the pass
+        // is always added (when enabled) and skips its rendering if no slot needs a refresh.
+        // Must be added after CascadedShadowMapPass, it completes the ShadowData on the blackboard.
+        class PointShadowPass final : public rhi::RenderPass<PointShadowPass>
+        {
+            friend class BasePass;
+
+        public:
+            // See BasePass::warmUpPipelines.
+            using PipelineKey = std::tuple<BaseGeometryPassInfo>;
+
+            explicit PointShadowPass(rhi::RenderDevice&);
+
+            void addPass(FrameGraph&,
+                         FrameGraphBlackboard&,
+                         const CameraInfo&,
+                         const LightInfo&,
+                         const RenderPrimitiveGroup&,
+                         const PointShadowSettings&,
+                         bool enabled);
+
+            // Force all slots to be re-rendered (still subject to the update budget).
+            void invalidate();
+
+            [[nodiscard]] bool     isLayered() const { return m_Layered; }
+            [[nodiscard]] uint32_t getNumShadowedLights() const { return m_NumShadowedLights; }
+            [[nodiscard]] uint32_t getNumUpdatedLights() const { return m_NumUpdatedSlots; }
+            [[nodiscard]] uint32_t getNumPendingLights() const { return m_NumPendingLights; }
+
+        private:
+            rhi::GraphicsPipeline createPipeline(const gfx::BaseGeometryPassInfo&) const;
+
+            void prepareShadowMaps(const PointShadowSettings&);
+            void update(const CameraInfo&,
+                        const LightInfo&,
+                        const RenderPrimitiveGroup&,
+                        const PointShadowSettings&,
+                        bool enabled);
+
+        private:
+            struct Slot
+            {
+                int       lightIndex {-1};
+                glm::vec3 position {0.0f}; // Light position the slot was rendered from
+                float     radius {0.0f};
+                size_t    casterHash {0};
+                float     importance {0.0f};
+                uint32_t  staleFrames {0};
+                bool      valid {false};
+                glm::mat4 faceViewProjections[6] {};
+            };
+
+            const bool m_Layered;
+
+            Ref<rhi::Texture> m_ShadowMaps {nullptr};
+            Slot              m_Slots[POINT_SHADOW_MAX_LIGHTS];
+            float             m_TexelScale {0.0f};
+
+            std::vector<const RenderPrimitive*> m_DrawLists[POINT_SHADOW_MAX_LIGHTS];
+
+            uint32_t m_UpdatedSlots[POINT_SHADOW_MAX_LIGHTS] {};
+            uint32_t m_NumActiveSlots {0}; // Zero when disabled or without point lights
+            uint32_t m_NumUpdatedSlots {0};
+            uint32_t m_NumShadowedLights {0};
+            uint32_t m_NumPendingLights {0};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
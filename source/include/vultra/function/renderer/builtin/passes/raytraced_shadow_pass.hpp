@@ -0,0 +1,95 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+#include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/renderer/builtin/shadow_settings.hpp"
+#include "vultra/function/renderer/builtin/upload_resources.hpp"
+#include "vultra/function/renderer/renderable.hpp"
+
+#include <fg/Fwd.hpp>
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Ray query shadows for the directional light and the most important point lights.
+        // One jittered ray per pixel and light at half resolution, denoised by a temporal accumulation with
+        // depth/normal rejection and a spatial filter that also upsamples to full resolution.
+        // Only needs VK_KHR_ray_query (no ray tracing pipeline) and the TLAS of the RenderableGroup.
+        // Must be added after CascadedShadowMapPass; when inactive the ShadowData points to a white mask and
+        // DeferredLightingPass keeps using the shadow maps.
+        // The temporal history is kept per view (e.g. per XR eye), add each view at most once per frame.
+        // The lights are selected when the graph executes, from inputs that must outlive the graph.
+        class RayTracedShadowPass final : public rhi::RenderPass<RayTracedShadowPass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit RayTracedShadowPass(rhi::RenderDevice&);
+
+            void addPass(FrameGraph&,
+                         FrameGraphBlackboard&,
+                         const CameraInfo&,
+                         const LightInfo&,
+                         const RenderableGroup&,
+                         const RayTracedShadowSettings&,
+                         bool           enabled,
+                         const uint32_t viewId = 0);
+
+            // Drop the temporal history of every view, e.g. on camera cuts.
+            void resetHistory();
+
+            [[nodiscard]] bool isSupported() const;
+            [[nodiscard]] bool isActive() const { return m_Active; }
+
+        private:
+            enum class Stage
+            {
+                eTrace = 0,
+                eTemporal,
+                eFilter,
+            };
+
+            rhi::GraphicsPipeline createPipeline(Stage) const;
+
+            struct History
+            {
+                // Accumulated this frame (index) and last frame (index ^ 1)
+                Ref<rhi::Texture> visibility[2];
+                Ref<rhi::Texture> geometry[2];
+                uint32_t          index {0};
+                bool              valid {false};
+                glm::mat4         prevViewProjection {1.0f};
+                glm::ivec4        prevPointLights {-1};
+                bool              prevDirectional {false};
+
+                // Traced this frame
+                glm::ivec4 pointLights {-1};
+                bool       directional {false};
+                glm::vec4  historyMask {0.0f};
+
+                // What the imported textures point to this frame (see framegraph::importTexture)
+                struct Bindings
+                {
+                    rhi::Texture* history {nullptr};
+                    rhi::Texture* historyGeometry {nullptr};
+                    rhi::Texture* accumulated {nullptr};
+                    rhi::Texture* geometry {nullptr};
+                };
+                Bindings bindings;
+            };
+
+            History& prepareHistory(const uint32_t viewId, const rhi::Extent2D&);
+
+        private:
+            Ref<rhi::Texture> m_WhiteMask {nullptr};
+
+            std::unordered_map<uint32_t, History> m_Histories; // Per view
+            uint32_t                              m_FrameIndex {0};
+            bool                                  m_Active {false};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
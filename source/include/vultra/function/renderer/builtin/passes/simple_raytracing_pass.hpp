@@ -18,6 +18,7 @@ namespace vultra
         public:
             explicit SimpleRaytracingPass(rhi::RenderDevice&);
 
+            // The exposure and miss color are read when the pass executes.
             [[nodiscard]] FrameGraphResource addPass(FrameGraph&,
                                                      FrameGraphBlackboard&,
                                                      const rhi::Extent2D&   resolution,
@@ -28,7 +29,7 @@ namespace vultra
                                                      bool                   enableNormalMapping,
                                                      bool                   enableAreaLights,
                                                      bool                   enableIBL,
-                                                     float                  exposure,
+                                                     const float&           exposure,
                                                      ToneMappingMethod      toneMappingMethod);
 
         private:
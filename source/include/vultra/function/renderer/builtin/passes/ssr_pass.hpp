@@ -0,0 +1,70 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+#include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/renderer/builtin/ssr_settings.hpp"
+
+#include <fg/Fwd.hpp>
+#include <glm/glm.hpp>
+
+#include <unordered_map>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Half resolution Hi-Z traced reflections with a temporal resolve.
+        // Requires HiZData (see HiZPass) and composites the result additively onto the given HDR scene color.
+        // The temporal history is kept per view (e.g. per XR eye), add each view at most once per frame.
+        // The settings and the view projection are read when the graph executes, they must outlive the graph.
+        class SSRPass final : public rhi::RenderPass<SSRPass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit SSRPass(rhi::RenderDevice&);
+
+            FrameGraphResource addPass(FrameGraph&,
+                                       FrameGraphBlackboard&,
+                                       FrameGraphResource sceneColorHDR,
+                                       const glm::mat4&   viewProjection,
+                                       const SSRSettings&,
+                                       const uint32_t     viewId = 0);
+
+            // Drop the temporal history of every view, e.g. on camera cuts.
+            void resetHistory();
+
+        private:
+            enum class Stage
+            {
+                eTrace = 0,
+                eResolve,
+                eComposite,
+            };
+
+            rhi::GraphicsPipeline createPipeline(Stage) const;
+
+            struct History
+            {
+                Ref<rhi::Texture> textures[2]; // Resolved this frame (index) and last frame (index ^ 1)
+                uint32_t          index {0};
+                bool              valid {false};
+                glm::mat4         prevViewProjection {1.0f};
+
+                // What the imported textures point to this frame (see framegraph::importTexture)
+                struct Bindings
+                {
+                    rhi::Texture* history {nullptr};
+                    rhi::Texture* resolved {nullptr};
+                };
+                Bindings bindings;
+            };
+
+            History& prepareHistory(const uint32_t viewId, const rhi::Extent2D&);
+
+        private:
+            std::unordered_map<uint32_t, History> m_Histories; // Per view
+            uint32_t                              m_FrameIndex {0};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "vultra/core/rhi/render_pass.hpp"
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Copies one layer (view) of a multiview target into a regular 2D target of the same format.
+        // Handles color and depth targets.
+        class StereoLayerPass final : public rhi::RenderPass<StereoLayerPass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit StereoLayerPass(rhi::RenderDevice&);
+
+            FrameGraphResource extract(FrameGraph&, FrameGraphResource, const uint32_t layer);
+
+        private:
+            rhi::GraphicsPipeline createPipeline(const rhi::PixelFormat) const;
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -16,9 +16,10 @@ namespace vultra
         public:
             explicit ToneMappingPass(rhi::RenderDevice&);
 
+            // The exposure is read when the pass executes.
             FrameGraphResource addPass(FrameGraph&,
                                        FrameGraphResource target,
-                                       float              exposure,
+                                       const float&       exposure,
                                        ToneMappingMethod  method = ToneMappingMethod::KhronosPBRNeutral);
 
         private:
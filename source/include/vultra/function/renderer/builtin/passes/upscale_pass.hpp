@@ -0,0 +1,27 @@
+#pragma once
+
+#include "vultra/core/rhi/extent2d.hpp"
+#include "vultra/core/rhi/render_pass.hpp"
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        // Resamples a color target to the given extent with a Catmull-Rom filter.
+        // Returns the input unchanged when the extents already match.
+        class UpscalePass final : public rhi::RenderPass<UpscalePass>
+        {
+            friend class BasePass;
+
+        public:
+            explicit UpscalePass(rhi::RenderDevice&);
+
+            FrameGraphResource upscale(FrameGraph&, FrameGraphResource, const rhi::Extent2D& extent);
+
+        private:
+            rhi::GraphicsPipeline createPipeline(const rhi::PixelFormat colorFormat) const;
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
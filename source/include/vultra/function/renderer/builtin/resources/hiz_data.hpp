@@ -0,0 +1,14 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct HiZData
+        {
+            FrameGraphResource minDepth; // Half resolution, full mip chain, R32F
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
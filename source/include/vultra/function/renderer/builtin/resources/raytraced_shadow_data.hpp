@@ -0,0 +1,17 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct RayTracedShadowData
+        {
+            FrameGraphResource trace;       // Half resolution, one ray per pixel and light
+            FrameGraphResource accumulated; // Half resolution, temporally accumulated
+            FrameGraphResource geometry;    // Half resolution, normal + linear view depth used for rejection
+            FrameGraphResource mask;        // Full resolution, spatially filtered
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct ShadowData
+        {
+            FrameGraphResource cascadedShadowMaps;   // Layered depth, one layer per cascade
+            FrameGraphResource cascadesBlock;        // Split depths and light space matrices
+            FrameGraphResource pointShadowMaps;      // Layered depth atlas, six layers (cube faces) per slot
+            FrameGraphResource pointShadowBlock;     // Face matrices and light to slot mapping
+            FrameGraphResource rayTracedShadowMask;  // Denoised visibility, r = directional, gba = point lights
+            FrameGraphResource rayTracedShadowBlock; // Which lights the mask holds
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <fg/Fwd.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct SSRData
+        {
+            FrameGraphResource trace;      // Half resolution, current frame only
+            FrameGraphResource reflection; // Half resolution, temporally resolved
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr uint32_t CSM_MAX_CASCADES           = 4;
+        constexpr uint32_t POINT_SHADOW_MAX_LIGHTS    = 8;
+        constexpr uint32_t RT_SHADOW_MAX_POINT_LIGHTS = 3;
+
+        struct ShadowSettings
+        {
+            uint32_t numCascades {4};
+            uint32_t resolution {2048};        // Per cascade, square
+            float    splitLambda {0.85f};      // 0 = uniform splits, 1 = logarithmic splits
+            float    shadowDistance {100.0f};  // View-space distance covered by the last cascade
+            uint32_t numDynamicCascades {2};   // Near cascades re-rendered every frame
+            uint32_t cacheTexelThreshold {16}; // Camera movement (in texels) a cached cascade tolerates
+            float    normalBias {1.5f};        // Receiver offset along the normal, in shadow map texels
+        };
+
+        struct PointShadowSettings
+        {
+            uint32_t maxShadowedLights {4}; // Atlas slots (six faces each), at most POINT_SHADOW_MAX_LIGHTS
+            uint32_t resolution {512};      // Per cube face, square
+            uint32_t updateBudget {2};      // Lights re-rendered per frame
+            float    normalBias {2.0f};     // Receiver offset along the normal, in shadow map texels
+        };
+
+        struct RayTracedShadowSettings
+        {
+            uint32_t numPointLights {3};             // Most important point lights, at most RT_SHADOW_MAX_POINT_LIGHTS
+            float    sunAngularRadius {0.25f};       // Degrees
+            float    pointLightSourceRadius {0.05f}; // World units
+            float    temporalWeight {0.85f};
+            uint32_t filterRadius {2};               // Spatial filter radius, in half resolution texels
+            float    depthThreshold {0.05f};         // Relative view depth difference tolerated on one surface
+            float    normalThreshold {0.9f};         // Minimum cosine between normals of one surface
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        struct SSRSettings
+        {
+            float    intensity {1.0f};
+            float    maxRoughness {0.6f}; // Pixels rougher than this skip tracing entirely
+            float    thickness {0.25f};   // View-space depth tolerance of a hit
+            float    maxDistance {50.0f}; // View-space ray length
+            uint32_t maxRayCount {4};     // Rays per pixel at maxRoughness, mirrors trace a single ray
+            uint32_t maxIterations {64};
+            float    temporalWeight {0.9f};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -9,6 +9,9 @@ namespace vultra
 {
     namespace gfx
     {
+        // The upload*Block functions read the info when the graph executes (a compiled graph may be executed again,
+        // see framegraph::FrameGraphCache), it must outlive the graph.
+
         struct FrameInfo
         {
             float time;
@@ -30,6 +33,13 @@ namespace vultra
         };
 
         void uploadCameraBlock(FrameGraph&, FrameGraphBlackboard&, const vultra::rhi::Extent2D, const CameraInfo&);
+        // Camera block of a multiview pass (u_Cameras[gl_ViewIndex]), both views share the culling frustum.
+        void uploadStereoCameraBlock(FrameGraph&,
+                                     FrameGraphBlackboard&,
+                                     const vultra::rhi::Extent2D,
+                                     const CameraInfo& left,
+                                     const CameraInfo& right,
+                                     const CameraInfo& culling);
 
         constexpr int LIGHTINFO_MAX_POINT_LIGHTS = 32;
         constexpr int LIGHTINFO_MAX_AREA_LIGHTS  = 32;
@@ -4,6 +4,8 @@
 #include "vultra/core/math/aabb.hpp"
 #include "vultra/core/rhi/alpha_mode.hpp"
 #include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/geometry_info.hpp"
+#include "vultra/core/rhi/geometry_pool.hpp"
 #include "vultra/core/rhi/index_buffer.hpp"
 #include "vultra/core/rhi/primitive_topology.hpp"
 #include "vultra/core/rhi/render_device.hpp"
@@ -114,40 +116,21 @@ namespace vultra
 
             MeshletGroup meshletGroup;
 
-            Ref<rhi::StorageBuffer> meshletBuffer {nullptr};
-            Ref<rhi::StorageBuffer> meshletVertexBuffer {nullptr};
-            Ref<rhi::StorageBuffer> meshletTriangleBuffer {nullptr};
+            // Meshlets, meshlet vertices and meshlet triangles, back to back (see getMeshlet*Offset).
+            Ref<rhi::GeometryAllocation> meshletAllocation {nullptr};
 
-            void buildMeshletBuffers(rhi::RenderDevice& rd)
+            [[nodiscard]] vk::DeviceSize getMeshletVerticesOffset() const
             {
-                // Create meshlet buffers
-                meshletBuffer = createRef<rhi::StorageBuffer>(
-                    std::move(rd.createStorageBuffer(sizeof(Meshlet) * meshletGroup.meshlets.size())));
-                meshletVertexBuffer = createRef<rhi::StorageBuffer>(
-                    std::move(rd.createStorageBuffer(sizeof(uint32_t) * meshletGroup.meshletVertices.size())));
-                meshletTriangleBuffer = createRef<rhi::StorageBuffer>(
-                    std::move(rd.createStorageBuffer(sizeof(uint8_t) * meshletGroup.meshletTriangles.size())));
-
-                auto stagingMeshletBuffer       = rd.createStagingBuffer(sizeof(Meshlet) * meshletGroup.meshlets.size(),
-                                                                   meshletGroup.meshlets.data());
-                auto stagingMeshletVertexBuffer = rd.createStagingBuffer(
-                    sizeof(uint32_t) * meshletGroup.meshletVertices.size(), meshletGroup.meshletVertices.data());
-                auto stagingMeshletTriangleBuffer = rd.createStagingBuffer(
-                    sizeof(uint8_t) * meshletGroup.meshletTriangles.size(), meshletGroup.meshletTriangles.data());
-
-                rd.execute(
-                    [&](rhi::CommandBuffer& cb) {
-                        cb.copyBuffer(stagingMeshletBuffer,
-                                      *meshletBuffer,
-                                      vk::BufferCopy {0, 0, stagingMeshletBuffer.getSize()});
-                        cb.copyBuffer(stagingMeshletVertexBuffer,
-                                      *meshletVertexBuffer,
-                                      vk::BufferCopy {0, 0, stagingMeshletVertexBuffer.getSize()});
-                        cb.copyBuffer(stagingMeshletTriangleBuffer,
-                                      *meshletTriangleBuffer,
-                                      vk::BufferCopy {0, 0, stagingMeshletTriangleBuffer.getSize()});
-                    },
-                    true);
+                return sizeof(Meshlet) * meshletGroup.meshlets.size();
+            }
+            [[nodiscard]] vk::DeviceSize getMeshletTrianglesOffset() const
+            {
+                const auto end = getMeshletVerticesOffset() + sizeof(uint32_t) * meshletGroup.meshletVertices.size();
+                return (end + 15) & ~vk::DeviceSize {15};
+            }
+            [[nodiscard]] vk::DeviceSize getMeshletDataSize() const
+            {
+                return getMeshletTrianglesOffset() + sizeof(uint8_t) * meshletGroup.meshletTriangles.size();
             }
         };
 
@@ -161,15 +144,17 @@ namespace vultra
             std::vector<SubMesh>      subMeshes;
             std::vector<MaterialType> materials;
 
-            Ref<rhi::VertexBuffer>  vertexBuffer {nullptr};
-            Ref<rhi::IndexBuffer>   indexBuffer {nullptr};
-            Ref<rhi::StorageBuffer> materialBuffer {nullptr};
+            // Ranges of the rhi::GeometryPool (see buildGeometry).
+            Ref<rhi::GeometryAllocation> vertexAllocation {nullptr};
+            Ref<rhi::GeometryAllocation> indexAllocation {nullptr};
+            Ref<rhi::StorageBuffer>      materialBuffer {nullptr};
 
             Ref<VertexFormat> vertexFormat {nullptr};
 
             rhi::PrimitiveTopology topology {rhi::PrimitiveTopology::eTriangleList};
 
-            rhi::RenderMesh renderMesh {}; // Currently only used for ray tracing
+            rhi::RenderMesh renderMesh {};        // Ray tracing and mesh shading
+            uint32_t        renderMeshVersion {0}; // getGeometryVersion() when renderMesh was built
 
             struct Light
             {
@@ -181,8 +166,8 @@ namespace vultra
             [[nodiscard]] auto& getVertices() { return vertices; }
             [[nodiscard]] auto& getIndices() { return indices; }
             [[nodiscard]] auto& getSubMeshes() { return subMeshes; }
-            [[nodiscard]] auto& getVertexBuffer() { return vertexBuffer; }
-            [[nodiscard]] auto& getIndexBuffer() { return indexBuffer; }
+            [[nodiscard]] auto& getVertexAllocation() { return vertexAllocation; }
+            [[nodiscard]] auto& getIndexAllocation() { return indexAllocation; }
             [[nodiscard]] auto& getVertexFormat() { return vertexFormat; }
             [[nodiscard]] auto& getTopology() { return topology; }
 
@@ -191,6 +176,98 @@ namespace vultra
             [[nodiscard]] static auto getVertexStride() { return static_cast<uint32_t>(sizeof(VertexType)); }
             [[nodiscard]] static auto getIndexStride() { return sizeof(uint32_t); }
 
+            // Of the first vertex/index of the mesh, within the shared buffers of the pool.
+            [[nodiscard]] uint32_t getBaseVertex() const
+            {
+                return vertexAllocation ? static_cast<uint32_t>(vertexAllocation->getOffset() / getVertexStride()) : 0;
+            }
+            [[nodiscard]] uint32_t getFirstIndex() const
+            {
+                return indexAllocation ? static_cast<uint32_t>(indexAllocation->getOffset() / getIndexStride()) : 0;
+            }
+
+            // Changes whenever GeometryPool::defragment moves one of the allocations of the mesh.
+            [[nodiscard]] uint32_t getGeometryVersion() const
+            {
+                uint32_t version {0};
+                for (const auto* allocation : {vertexAllocation.get(), indexAllocation.get()})
+                {
+                    version += allocation ? allocation->getVersion() : 0;
+                }
+                for (const auto& sm : subMeshes)
+                {
+                    version += sm.meshletAllocation ? sm.meshletAllocation->getVersion() : 0;
+                }
+                return version;
+            }
+
+            [[nodiscard]] rhi::GeometryInfo getGeometryInfo(const SubMesh& sm) const
+            {
+                return {
+                    .topology     = sm.topology,
+                    .vertexBuffer = vertexAllocation ? &vertexAllocation->getVertexBuffer() : nullptr,
+                    .vertexOffset = getBaseVertex() + sm.vertexOffset,
+                    .numVertices  = sm.vertexCount,
+                    .indexBuffer  = indexAllocation ? &indexAllocation->getIndexBuffer() : nullptr,
+                    .indexOffset  = getFirstIndex() + sm.indexOffset,
+                    .numIndices   = sm.indexCount,
+                };
+            }
+
+            // Sub-allocates and uploads the vertices, indices and (with mesh shading) meshlets, in one submission.
+            void buildGeometry(rhi::RenderDevice& rd)
+            {
+                auto& pool = rd.getGeometryPool();
+
+                std::vector<rhi::GeometryPool::Upload> uploads;
+                if (!vertices.empty())
+                {
+                    const auto size  = getVertexStride() * vertices.size();
+                    vertexAllocation = pool.allocate(rhi::GeometryRegion::eVertex, size, getVertexStride());
+                    uploads.push_back({vertexAllocation.get(), 0, vertices.data(), size});
+                }
+                if (!indices.empty())
+                {
+                    const auto size = getIndexStride() * indices.size();
+                    indexAllocation = pool.allocate(rhi::GeometryRegion::eIndex, size, getIndexStride());
+                    uploads.push_back({indexAllocation.get(), 0, indices.data(), size});
+                }
+
+                // Only read through device addresses by the meshlet passes.
+                if (HasFlagValues(rd.getFeatureFlag(), rhi::RenderDeviceFeatureFlagBits::eMeshShader))
+                {
+                    for (auto& sm : subMeshes)
+                    {
+                        const auto& group = sm.meshletGroup;
+                        if (group.meshlets.empty())
+                            continue;
+
+                        sm.meshletAllocation =
+                            pool.allocate(rhi::GeometryRegion::eMeshlet, sm.getMeshletDataSize(), alignof(Meshlet));
+                        uploads.push_back({
+                            sm.meshletAllocation.get(),
+                            0,
+                            group.meshlets.data(),
+                            sizeof(Meshlet) * group.meshlets.size(),
+                        });
+                        uploads.push_back({
+                            sm.meshletAllocation.get(),
+                            sm.getMeshletVerticesOffset(),
+                            group.meshletVertices.data(),
+                            sizeof(uint32_t) * group.meshletVertices.size(),
+                        });
+                        uploads.push_back({
+                            sm.meshletAllocation.get(),
+                            sm.getMeshletTrianglesOffset(),
+                            group.meshletTriangles.data(),
+                            sizeof(uint8_t) * group.meshletTriangles.size(),
+                        });
+                    }
+                }
+
+                pool.upload(uploads);
+            }
+
             void buildMaterialBuffer(rhi::RenderDevice& rd)
             {
                 // Create material buffer
@@ -235,27 +312,36 @@ namespace vultra
                     true);
             }
 
+            // Bakes the device addresses of the geometry (relocatable, see refreshRenderMesh).
             void buildRenderMesh(rhi::RenderDevice& rd)
             {
                 const auto& features = rd.getFeatureFlag();
 
+                // The frames in flight might still trace against the previous build.
+                auto& deletionQueue = rd.getDeletionQueue();
+                if (renderMesh.blas)
+                    deletionQueue.push(std::move(renderMesh.blas));
+                if (renderMesh.geometryNodeBuffer)
+                    deletionQueue.push(std::move(renderMesh.geometryNodeBuffer));
+
+                renderMeshVersion = getGeometryVersion();
                 renderMesh.subMeshes.clear();
                 renderMesh.subMeshes.reserve(subMeshes.size());
 
                 for (const auto& sm : subMeshes)
                 {
                     rhi::RenderSubMesh rsm {};
-                    assert(vertexBuffer != nullptr);
+                    assert(vertexAllocation != nullptr);
 
                     if (HasFlagValues(features, rhi::RenderDeviceFeatureFlagBits::eRayTracingPipeline) ||
                         HasFlagValues(features, rhi::RenderDeviceFeatureFlagBits::eRayQuery) ||
                         HasFlagValues(features, rhi::RenderDeviceFeatureFlagBits::eMeshShader))
                     {
                         rsm.vertexBufferAddress =
-                            rd.getBufferDeviceAddress(*vertexBuffer) + sm.vertexOffset * getVertexStride();
+                            vertexAllocation->getDeviceAddress(true) + sm.vertexOffset * getVertexStride();
                         rsm.indexBufferAddress =
-                            indexBuffer ?
-                                (rd.getBufferDeviceAddress(*indexBuffer) + sm.indexOffset * getIndexStride()) :
+                            indexAllocation ?
+                                indexAllocation->getDeviceAddress(true) + sm.indexOffset * getIndexStride() :
                                 0;
                         rsm.transformBufferAddress = 0; // Optional
                     }
@@ -263,11 +349,13 @@ namespace vultra
                     // Meshlet buffer addresses
                     if (HasFlagValues(features, rhi::RenderDeviceFeatureFlagBits::eMeshShader))
                     {
-                        rsm.meshletBufferAddress = sm.meshletBuffer ? rd.getBufferDeviceAddress(*sm.meshletBuffer) : 0;
-                        rsm.meshletVertexBufferAddress =
-                            sm.meshletVertexBuffer ? rd.getBufferDeviceAddress(*sm.meshletVertexBuffer) : 0;
-                        rsm.meshletTriangleBufferAddress =
-                            sm.meshletTriangleBuffer ? rd.getBufferDeviceAddress(*sm.meshletTriangleBuffer) : 0;
+                        if (const auto& allocation = sm.meshletAllocation)
+                        {
+                            const auto address               = allocation->getDeviceAddress(true);
+                            rsm.meshletBufferAddress         = address;
+                            rsm.meshletVertexBufferAddress   = address + sm.getMeshletVerticesOffset();
+                            rsm.meshletTriangleBufferAddress = address + sm.getMeshletTrianglesOffset();
+                        }
                         rsm.meshletCount = static_cast<uint32_t>(sm.meshletGroup.meshlets.size());
                     }
 
@@ -275,7 +363,7 @@ namespace vultra
                     rsm.vertexCount  = sm.vertexCount;
 
                     rsm.indexCount = sm.indexCount;
-                    rsm.indexType  = indexBuffer ? indexBuffer->getIndexType() : rhi::IndexType::eUInt32;
+                    rsm.indexType  = rhi::IndexType::eUInt32;
 
                     rsm.materialIndex = sm.materialIndex;
                     rsm.opaque        = materials[sm.materialIndex].alphaMode == rhi::AlphaMode::eOpaque;
@@ -318,6 +406,18 @@ namespace vultra
                     }
                 }
             }
+
+            // Rebuilds renderMesh (device addresses, geometry nodes and BLAS) if GeometryPool::defragment moved the
+            // geometry since, must happen before the next frame is recorded.
+            // @return true if it was rebuilt, a TLAS referencing the BLAS has to be rebuilt too.
+            bool refreshRenderMesh(rhi::RenderDevice& rd)
+            {
+                if (renderMesh.subMeshes.empty() || renderMeshVersion == getGeometryVersion())
+                    return false;
+
+                buildRenderMesh(rd);
+                return true;
+            }
         };
     } // namespace gfx
 } // namespace vultra
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "vultra/core/base/thread_pool.hpp"
+#include "vultra/core/rhi/command_pool.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        class RenderDevice;
+    }
+
+    namespace gfx
+    {
+        // Records the draws of a render pass in secondary command buffers, spread over a thread pool.
+        // Every thread has its own command pool per frame in flight, a pool is reset by nextFrame() numFramesInFlight
+        // frames after it was used (call it once per frame, after the fence of that frame has been waited on).
+        //
+        // Usage, inside a pass whose attachments are ready:
+        //   auto commandBuffers = recorder.record(framebufferInfo, numTasks, fn);
+        //   cb.beginRendering(framebufferInfo, true).executeCommands(commandBuffers).endRendering();
+        // Pipelines and other lazily created state must be resolved before record(), the tasks only read them.
+        class ParallelCommandRecorder final
+        {
+        public:
+            // numFramesInFlight: see FrameController::size(). numWorkers: see ThreadPool.
+            ParallelCommandRecorder(rhi::RenderDevice&, uint32_t numFramesInFlight, uint32_t numWorkers = 0);
+            ParallelCommandRecorder(const ParallelCommandRecorder&)     = delete;
+            ParallelCommandRecorder(ParallelCommandRecorder&&) noexcept = delete;
+            ~ParallelCommandRecorder()                                  = default;
+
+            ParallelCommandRecorder& operator=(const ParallelCommandRecorder&)     = delete;
+            ParallelCommandRecorder& operator=(ParallelCommandRecorder&&) noexcept = delete;
+
+            // Including the calling thread.
+            [[nodiscard]] uint32_t getNumThreads() const;
+            // Secondary command buffers recorded in the previous frame.
+            [[nodiscard]] uint32_t getNumRecorded() const;
+
+            void nextFrame();
+
+            using RecordFn = std::function<void(uint32_t taskIndex, rhi::CommandBuffer&)>;
+
+            // Blocking, one secondary command buffer per task (returned in task order), each one continues the
+            // render pass of the given framebuffer. The tasks run on any thread, including the calling one.
+            [[nodiscard]] std::vector<rhi::CommandBuffer*>
+            record(const rhi::FramebufferInfo&, uint32_t numTasks, const RecordFn&);
+
+            // Secondary command buffer of the calling thread (already begun), for work that has to be recorded
+            // serially within the same render pass. end() it before executing.
+            [[nodiscard]] rhi::CommandBuffer& acquire(const rhi::FramebufferInfo&);
+
+        private:
+            ThreadPool m_ThreadPool;
+
+            std::vector<std::vector<rhi::CommandPool>> m_Pools; // [frame][thread]
+            uint32_t                                   m_FrameIndex {0};
+            uint32_t                                   m_NumRecorded {0};
+        };
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -43,6 +43,16 @@ namespace vultra
 
             void buildRayTracing(rhi::RenderDevice& rd)
             {
+                // The frames in flight might still trace against the previous build.
+                auto& deletionQueue = rd.getDeletionQueue();
+                if (tlas)
+                    deletionQueue.push(std::move(tlas));
+                for (auto* buffer : {&instanceBuffer, &geometryNodeBuffer, &materialBuffer})
+                {
+                    if (*buffer)
+                        deletionQueue.push(std::move(*buffer));
+                }
+
                 std::vector<rhi::RayTracingInstance> tlasInstances;
                 tlasInstances.reserve(renderables.size());
 
@@ -23,6 +23,7 @@ namespace vultra
             void renderFullScreenPostProcess(const rhi::BasePipeline&);
             void endRendering();
             void endRayTracing();
+            void endCompute();
 
             // Helpers
 
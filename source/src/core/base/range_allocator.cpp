@@ -0,0 +1,104 @@
+#include "vultra/core/base/range_allocator.hpp"
+
+#include <cassert>
+#include <iterator>
+
+namespace vultra
+{
+    RangeAllocator::RangeAllocator(const uint64_t capacity) : m_Capacity(capacity)
+    {
+        if (capacity > 0)
+        {
+            addFreeRange(0, capacity);
+        }
+    }
+
+    std::optional<uint64_t> RangeAllocator::allocate(const uint64_t size, const uint64_t alignment)
+    {
+        assert(size > 0 && alignment > 0);
+
+        // Smallest ranges first, the alignment padding might rule some of them out.
+        for (auto it = m_FreeBySize.lower_bound(size); it != m_FreeBySize.end(); ++it)
+        {
+            const auto [rangeSize, rangeOffset] = *it;
+
+            const auto offset  = (rangeOffset + alignment - 1) / alignment * alignment;
+            const auto padding = offset - rangeOffset;
+            if (padding + size > rangeSize)
+                continue;
+
+            removeFreeRange(m_FreeByOffset.find(rangeOffset));
+            if (padding > 0)
+            {
+                addFreeRange(rangeOffset, padding);
+            }
+            if (const auto tail = rangeSize - padding - size; tail > 0)
+            {
+                addFreeRange(offset + size, tail);
+            }
+
+            m_UsedSize += size;
+            return offset;
+        }
+        return std::nullopt;
+    }
+
+    void RangeAllocator::free(uint64_t offset, uint64_t size)
+    {
+        assert(size > 0 && offset + size <= m_Capacity && size <= m_UsedSize);
+        m_UsedSize -= size;
+
+        // Merge with the neighbours.
+        if (auto next = m_FreeByOffset.find(offset + size); next != m_FreeByOffset.end())
+        {
+            size += next->second;
+            removeFreeRange(next);
+        }
+        if (auto next = m_FreeByOffset.lower_bound(offset); next != m_FreeByOffset.begin())
+        {
+            if (auto prev = std::prev(next); prev->first + prev->second == offset)
+            {
+                offset = prev->first;
+                size += prev->second;
+                removeFreeRange(prev);
+            }
+        }
+        addFreeRange(offset, size);
+    }
+
+    uint64_t RangeAllocator::getCapacity() const { return m_Capacity; }
+
+    uint64_t RangeAllocator::getUsedSize() const { return m_UsedSize; }
+
+    uint64_t RangeAllocator::getLargestFreeRange() const
+    {
+        return m_FreeBySize.empty() ? 0 : m_FreeBySize.rbegin()->first;
+    }
+
+    uint32_t RangeAllocator::getNumFreeRanges() const { return static_cast<uint32_t>(m_FreeByOffset.size()); }
+
+    bool RangeAllocator::empty() const { return m_UsedSize == 0; }
+
+    void RangeAllocator::addFreeRange(const uint64_t offset, const uint64_t size)
+    {
+        assert(!m_FreeByOffset.contains(offset));
+        m_FreeByOffset.emplace(offset, size);
+        m_FreeBySize.emplace(size, offset);
+    }
+
+    void RangeAllocator::removeFreeRange(const std::map<uint64_t, uint64_t>::iterator it)
+    {
+        assert(it != m_FreeByOffset.end());
+
+        auto [first, last] = m_FreeBySize.equal_range(it->second);
+        for (; first != last; ++first)
+        {
+            if (first->second == it->first)
+            {
+                m_FreeBySize.erase(first);
+                break;
+            }
+        }
+        m_FreeByOffset.erase(it);
+    }
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "vultra/core/base/thread_pool.hpp"
+
+#include <algorithm>
+
+namespace vultra
+{
+    ThreadPool::ThreadPool(uint32_t numWorkers)
+    {
+        if (numWorkers == 0)
+        {
+            numWorkers = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+        }
+
+        m_Workers.reserve(numWorkers);
+        for (auto i = 0u; i < numWorkers; ++i)
+        {
+            m_Workers.emplace_back([this, i] { workerLoop(i + 1); });
+        }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::scoped_lock lock {m_Mutex};
+            m_Quit = true;
+        }
+        m_WorkAvailable.notify_all();
+
+        for (auto& worker : m_Workers)
+        {
+            worker.join();
+        }
+    }
+
+    uint32_t ThreadPool::getNumThreads() const { return static_cast<uint32_t>(m_Workers.size()) + 1; }
+
+    void ThreadPool::parallelFor(const uint32_t numTasks, const Task& task)
+    {
+        if (numTasks == 0)
+            return;
+
+        // Not worth waking anyone up.
+        if (m_Workers.empty() || numTasks == 1)
+        {
+            for (auto i = 0u; i < numTasks; ++i)
+            {
+                task(i, 0);
+            }
+            return;
+        }
+
+        {
+            std::scoped_lock lock {m_Mutex};
+            m_Task     = &task;
+            m_NumTasks = numTasks;
+            m_NextTask.store(0, std::memory_order_relaxed);
+            m_NumBusyWorkers = static_cast<uint32_t>(m_Workers.size());
+            ++m_Generation;
+        }
+        m_WorkAvailable.notify_all();
+
+        runTasks(0);
+
+        std::unique_lock lock {m_Mutex};
+        m_WorkDone.wait(lock, [this] { return m_NumBusyWorkers == 0; });
+        m_Task = nullptr;
+    }
+
+    void ThreadPool::workerLoop(const uint32_t threadIndex)
+    {
+        uint64_t generation = 0;
+        while (true)
+        {
+            {
+                std::unique_lock lock {m_Mutex};
+                m_WorkAvailable.wait(lock, [this, generation] { return m_Quit || m_Generation != generation; });
+                if (m_Quit)
+                    return;
+
+                generation = m_Generation;
+            }
+
+            runTasks(threadIndex);
+
+            {
+                std::scoped_lock lock {m_Mutex};
+                if (--m_NumBusyWorkers == 0)
+                {
+                    m_WorkDone.notify_one();
+                }
+            }
+        }
+    }
+
+    void ThreadPool::runTasks(const uint32_t threadIndex)
+    {
+        for (auto i = m_NextTask.fetch_add(1, std::memory_order_relaxed); i < m_NumTasks;
+             i = m_NextTask.fetch_add(1, std::memory_order_relaxed))
+        {
+            (*m_Task)(i, threadIndex);
+        }
+    }
+} // namespace vultra
\ No newline at end of file
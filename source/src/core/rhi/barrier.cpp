@@ -2,6 +2,9 @@
 #include "vultra/core/rhi/buffer.hpp"
 #include "vultra/core/rhi/texture.hpp"
 
+#include <algorithm>
+#include <utility>
+
 namespace vultra
 {
     namespace rhi
@@ -13,6 +16,176 @@ namespace vultra
                 if (mask == vk::ImageAspectFlagBits::eNone)
                     mask = getAspectMask(texture);
             }
+
+            [[nodiscard]] bool hasWriteAccess(const Access access)
+            {
+                constexpr auto kWriteAccess = Access::eShaderWrite | Access::eColorAttachmentWrite |
+                                              Access::eDepthStencilAttachmentWrite | Access::eTransferWrite |
+                                              Access::eMemoryWrite | Access::eShaderStorageWrite |
+                                              Access::eAccelerationStructureWrite;
+                return static_cast<bool>(access & kWriteAccess);
+            }
+
+            // Read after read: the last barrier already made the last write visible to these stages.
+            [[nodiscard]] bool isCovered(const BarrierScope& lastScope, const BarrierScope& dst)
+            {
+                if (lastScope == dst)
+                    return true;
+
+                return !hasWriteAccess(lastScope.accessMask) && !hasWriteAccess(dst.accessMask) &&
+                       (dst.stageMask & ~lastScope.stageMask) == PipelineStages::eNone &&
+                       (dst.accessMask & ~lastScope.accessMask) == Access::eNone;
+            }
+            [[nodiscard]] bool isRedundant(const ImageLayout   layout,
+                                           const BarrierScope& lastScope,
+                                           const ImageLayout   newLayout,
+                                           const BarrierScope& dst)
+            {
+                return layout == newLayout && isCovered(lastScope, dst);
+            }
+
+            template<typename T>
+            [[nodiscard]] BarrierScope getDstScope(const T& barrier)
+            {
+                return BarrierScope {
+                    .stageMask  = static_cast<PipelineStages>(static_cast<VkPipelineStageFlags2>(barrier.dstStageMask)),
+                    .accessMask = static_cast<Access>(static_cast<VkAccessFlags2>(barrier.dstAccessMask)),
+                };
+            }
+
+            struct SubresourceCount
+            {
+                uint32_t mipLevels;
+                uint32_t layers;
+            };
+            [[nodiscard]] SubresourceCount getSubresourceCount(const Texture& texture)
+            {
+                return {
+                    .mipLevels = std::max(texture.getNumMipLevels(), 1u),
+                    .layers    = std::max(texture.getNumLayers(), 1u) * (isCubemap(texture) ? 6u : 1u),
+                };
+            }
+
+            // std::nullopt for a range outside of the tracked subresources (e.g. other layers of an imported image).
+            [[nodiscard]] std::optional<vk::ImageSubresourceRange> resolveRange(vk::ImageSubresourceRange range,
+                                                                                const SubresourceCount& count)
+            {
+                if (range.baseMipLevel >= count.mipLevels || range.baseArrayLayer >= count.layers)
+                    return std::nullopt;
+
+                if (range.levelCount == vk::RemainingMipLevels)
+                    range.levelCount = count.mipLevels - range.baseMipLevel;
+                if (range.layerCount == vk::RemainingArrayLayers)
+                    range.layerCount = count.layers - range.baseArrayLayer;
+
+                if (range.baseMipLevel + range.levelCount > count.mipLevels ||
+                    range.baseArrayLayer + range.layerCount > count.layers)
+                {
+                    return std::nullopt;
+                }
+                return range;
+            }
+
+            [[nodiscard]] bool coversAll(const vk::ImageSubresourceRange& range, const SubresourceCount& count)
+            {
+                return range.baseMipLevel == 0 && range.levelCount == count.mipLevels && range.baseArrayLayer == 0 &&
+                       range.layerCount == count.layers;
+            }
+
+            // Pending transitions of the image become per mip level and layer ones, so the following transitions of
+            // single subresources can be folded into them (two transitions of a subresource in the same barrier
+            // command are not ordered).
+            void splitRanges(std::vector<vk::ImageMemoryBarrier2>& barriers,
+                             const vk::Image                       image,
+                             const SubresourceCount&               count)
+            {
+                const auto isSplit = [image](const vk::ImageMemoryBarrier2& b) {
+                    const auto& range = b.subresourceRange;
+                    return b.image != image || (range.levelCount == 1 && range.layerCount == 1);
+                };
+                if (std::ranges::all_of(barriers, isSplit))
+                    return;
+
+                std::vector<vk::ImageMemoryBarrier2> out;
+                out.reserve(barriers.size());
+                for (const auto& b : barriers)
+                {
+                    const auto range = isSplit(b) ? std::nullopt : resolveRange(b.subresourceRange, count);
+                    if (!range)
+                    {
+                        out.push_back(b);
+                        continue;
+                    }
+                    for (auto mipLevel = range->baseMipLevel; mipLevel < range->baseMipLevel + range->levelCount;
+                         ++mipLevel)
+                    {
+                        for (auto layer = range->baseArrayLayer; layer < range->baseArrayLayer + range->layerCount;
+                             ++layer)
+                        {
+                            auto& unit            = out.emplace_back(b);
+                            unit.subresourceRange = vk::ImageSubresourceRange {
+                                range->aspectMask, mipLevel, 1u, layer, 1u};
+                        }
+                    }
+                }
+                barriers = std::move(out);
+            }
+
+            // Widens b into a, if both transitions only differ by adjacent mip levels or layers.
+            [[nodiscard]] bool tryWiden(vk::ImageMemoryBarrier2& a, const vk::ImageMemoryBarrier2& b)
+            {
+                if (a.image != b.image || a.srcStageMask != b.srcStageMask || a.srcAccessMask != b.srcAccessMask ||
+                    a.dstStageMask != b.dstStageMask || a.dstAccessMask != b.dstAccessMask ||
+                    a.oldLayout != b.oldLayout || a.newLayout != b.newLayout ||
+                    a.srcQueueFamilyIndex != b.srcQueueFamilyIndex ||
+                    a.dstQueueFamilyIndex != b.dstQueueFamilyIndex ||
+                    a.subresourceRange.aspectMask != b.subresourceRange.aspectMask)
+                {
+                    return false;
+                }
+
+                auto&       ra = a.subresourceRange;
+                const auto& rb = b.subresourceRange;
+                if (ra.levelCount == vk::RemainingMipLevels || ra.layerCount == vk::RemainingArrayLayers ||
+                    rb.levelCount == vk::RemainingMipLevels || rb.layerCount == vk::RemainingArrayLayers)
+                {
+                    return false;
+                }
+
+                if (ra.baseMipLevel == rb.baseMipLevel && ra.levelCount == rb.levelCount &&
+                    ra.baseArrayLayer + ra.layerCount == rb.baseArrayLayer)
+                {
+                    ra.layerCount += rb.layerCount;
+                    return true;
+                }
+                if (ra.baseArrayLayer == rb.baseArrayLayer && ra.layerCount == rb.layerCount &&
+                    ra.baseMipLevel + ra.levelCount == rb.baseMipLevel)
+                {
+                    ra.levelCount += rb.levelCount;
+                    return true;
+                }
+                return false;
+            }
+
+            // Per-subresource transitions are recorded mip by mip (layers first), layers are widened by the first
+            // pass and mip levels by the second.
+            void widenRanges(std::vector<vk::ImageMemoryBarrier2>& barriers)
+            {
+                while (barriers.size() > 1)
+                {
+                    auto out = barriers.begin();
+                    for (auto it = std::next(out); it != barriers.end(); ++it)
+                    {
+                        if (!tryWiden(*out, *it))
+                            *++out = *it;
+                    }
+
+                    const auto size = barriers.size();
+                    barriers.erase(std::next(out), barriers.end());
+                    if (barriers.size() == size)
+                        break;
+                }
+            }
         } // namespace
 
         bool Barrier::isEffective() const
@@ -22,90 +195,273 @@ namespace vultra
 
         Barrier::Builder& Barrier::Builder::memoryBarrier(const BarrierScope& src, const BarrierScope& dst)
         {
-            vk::MemoryBarrier2 memoryBarrier2 {};
-            memoryBarrier2.srcStageMask  = static_cast<vk::PipelineStageFlagBits2>(src.stageMask);
-            memoryBarrier2.srcAccessMask = static_cast<vk::AccessFlagBits2>(src.accessMask);
-            memoryBarrier2.dstStageMask  = static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
-            memoryBarrier2.dstAccessMask = static_cast<vk::AccessFlagBits2>(dst.accessMask);
-            m_Dependencies.memory.emplace_back(memoryBarrier2);
+            ++m_Stats.numRequested;
+
+            // A single (wider) global barrier serves all of them.
+            auto& memory         = m_Dependencies.memory;
+            auto& memoryBarrier2 = memory.empty() ? memory.emplace_back() : memory.back();
+            memoryBarrier2.srcStageMask |= static_cast<vk::PipelineStageFlagBits2>(src.stageMask);
+            memoryBarrier2.srcAccessMask |= static_cast<vk::AccessFlagBits2>(src.accessMask);
+            memoryBarrier2.dstStageMask |= static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
+            memoryBarrier2.dstAccessMask |= static_cast<vk::AccessFlagBits2>(dst.accessMask);
             return *this;
         }
 
         Barrier::Builder& Barrier::Builder::bufferBarrier(const BufferInfo& info, const BarrierScope& dst)
         {
-            if (auto& lastScope = info.buffer.m_LastScope; lastScope != dst)
+            ++m_Stats.numRequested;
+
+            auto& lastScope = info.buffer.m_LastScope;
+            if (isCovered(lastScope, dst))
+            {
+                ++m_Stats.numSkipped;
+                return *this;
+            }
+
+            auto& buffers = m_Dependencies.buffer;
+            auto  it      = std::ranges::find_if(buffers, [&info](const vk::BufferMemoryBarrier2& b) {
+                return b.buffer == info.buffer.getHandle() && b.offset == info.offset && b.size == info.size;
+            });
+            if (it == buffers.end())
             {
                 vk::BufferMemoryBarrier2 memoryBarrier2 {};
                 memoryBarrier2.srcStageMask        = static_cast<vk::PipelineStageFlagBits2>(lastScope.stageMask);
                 memoryBarrier2.srcAccessMask       = static_cast<vk::AccessFlagBits2>(lastScope.accessMask);
-                memoryBarrier2.dstStageMask        = static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
-                memoryBarrier2.dstAccessMask       = static_cast<vk::AccessFlagBits2>(dst.accessMask);
                 memoryBarrier2.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
                 memoryBarrier2.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
                 memoryBarrier2.buffer              = info.buffer.getHandle();
                 memoryBarrier2.offset              = info.offset;
                 memoryBarrier2.size                = info.size;
-                m_Dependencies.buffer.emplace_back(memoryBarrier2);
-                lastScope = dst;
+                it = buffers.insert(buffers.end(), memoryBarrier2);
             }
+            // No command runs between two barriers of the same flush, the pending one just gets a wider destination.
+            it->dstStageMask |= static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
+            it->dstAccessMask |= static_cast<vk::AccessFlagBits2>(dst.accessMask);
+            lastScope = getDstScope(*it);
             return *this;
         }
 
         Barrier::Builder& Barrier::Builder::imageBarrier(ImageInfo info, const BarrierScope& dst)
         {
-            auto [layout, lastScope] = std::tie(info.image.m_Layout, info.image.m_LastScope);
+            ++m_Stats.numRequested;
+
+            auto& texture = info.image;
+            fixAspectMask(info.subresourceRange.aspectMask, texture);
 
-            if (layout != info.newLayout || lastScope != dst)
+            auto [layout, lastScope] = std::tie(texture.m_Layout, texture.m_LastScope);
+            auto& states             = texture.m_SubresourceStates;
+
+            if (isForeign(texture))
+            {
+                // Ownership is transferred for the whole image.
+                assert(states.empty());
+
+                const auto dstQueueFamilyIndex = m_QueueOwnership->queueFamilyIndex;
+                if (layout != ImageLayout::eUndefined)
+                {
+                    const OwnershipTransfer transfer {
+                        .image               = &texture,
+                        .srcQueueFamilyIndex = getOwner(texture),
+                        .dstQueueFamilyIndex = dstQueueFamilyIndex,
+                        .srcScope            = lastScope,
+                        .oldLayout           = layout,
+                        .newLayout           = info.newLayout,
+                        .subresourceRange    = info.subresourceRange,
+                    };
+                    // Acquire, the source scope belongs to the release (and the semaphore wait).
+                    imageBarrier(texture.getImageHandle(),
+                                 {},
+                                 dst,
+                                 layout,
+                                 info.newLayout,
+                                 info.subresourceRange,
+                                 transfer.srcQueueFamilyIndex,
+                                 dstQueueFamilyIndex);
+                    m_OwnershipTransfers.push_back(transfer);
+                    layout    = info.newLayout;
+                    lastScope = dst;
+                }
+                texture.m_QueueFamilyIndex = dstQueueFamilyIndex == m_QueueOwnership->defaultQueueFamilyIndex ?
+                                                 vk::QueueFamilyIgnored :
+                                                 dstQueueFamilyIndex;
+                if (layout == info.newLayout)
+                    return *this;
+            }
+
+            const auto count = getSubresourceCount(texture);
+            const auto range = resolveRange(info.subresourceRange, count);
+
+            auto& images = m_Dependencies.image;
+            if (states.empty())
+            {
+                if (isRedundant(layout, lastScope, info.newLayout, dst))
+                {
+                    ++m_Stats.numSkipped;
+                    return *this;
+                }
+                const auto overlapsPending = std::ranges::any_of(images, [&](const vk::ImageMemoryBarrier2& b) {
+                    return b.image == texture.getImageHandle() && b.subresourceRange != info.subresourceRange;
+                });
+                if ((!range || coversAll(*range, count)) && !overlapsPending)
+                {
+                    const auto& entry = imageBarrier(
+                        texture.getImageHandle(), lastScope, dst, layout, info.newLayout, info.subresourceRange);
+                    layout    = info.newLayout;
+                    lastScope = getDstScope(entry);
+                    return *this;
+                }
+                states.assign(count.mipLevels * count.layers, {layout, lastScope});
+            }
+
+            // Diverged (or diverging) subresources, one transition per mip level and layer (widened in build()).
+            splitRanges(images, texture.getImageHandle(), count);
+            const auto resolved   = range.value_or(vk::ImageSubresourceRange {
+                info.subresourceRange.aspectMask, 0u, count.mipLevels, 0u, count.layers});
+            auto       numSkipped = 0u;
+            for (auto mipLevel = resolved.baseMipLevel; mipLevel < resolved.baseMipLevel + resolved.levelCount;
+                 ++mipLevel)
+            {
+                for (auto layer = resolved.baseArrayLayer; layer < resolved.baseArrayLayer + resolved.layerCount;
+                     ++layer)
+                {
+                    auto& state = states[layer * count.mipLevels + mipLevel];
+                    if (isRedundant(state.layout, state.lastScope, info.newLayout, dst))
+                    {
+                        ++numSkipped;
+                        continue;
+                    }
+
+                    const auto& entry = imageBarrier(texture.getImageHandle(),
+                                                     state.lastScope,
+                                                     dst,
+                                                     state.layout,
+                                                     info.newLayout,
+                                                     {resolved.aspectMask, mipLevel, 1u, layer, 1u});
+                    state             = {info.newLayout, getDstScope(entry)};
+                    layout            = state.layout;
+                    lastScope         = state.lastScope;
+                }
+            }
+            if (numSkipped == resolved.levelCount * resolved.layerCount)
+                ++m_Stats.numSkipped;
+
+            if (std::ranges::adjacent_find(states, std::ranges::not_equal_to {}) == states.end())
             {
-                fixAspectMask(info.subresourceRange.aspectMask, info.image);
-                imageBarrier(
-                    info.image.getImageHandle(), lastScope, dst, layout, info.newLayout, info.subresourceRange);
-                layout    = info.newLayout;
-                lastScope = dst;
+                layout    = states.front().layout;
+                lastScope = states.front().lastScope;
+                states.clear();
             }
             return *this;
         }
 
-        Barrier Barrier::Builder::build() { return Barrier {std::move(m_Dependencies)}; }
+        Barrier::Builder& Barrier::Builder::trackQueueOwnership(std::optional<QueueOwnership> queueOwnership)
+        {
+            m_QueueOwnership = std::move(queueOwnership);
+            return *this;
+        }
 
-        Barrier::Builder& Barrier::Builder::imageBarrier(vk::Image                        image,
-                                                         const BarrierScope&              src,
-                                                         const BarrierScope&              dst,
-                                                         ImageLayout                      oldLayout,
-                                                         ImageLayout                      newLayout,
-                                                         const vk::ImageSubresourceRange& subresourceRange)
+        const std::optional<Barrier::Builder::QueueOwnership>& Barrier::Builder::getQueueOwnership() const
+        {
+            return m_QueueOwnership;
+        }
+
+        bool Barrier::Builder::isForeign(const Texture& texture) const
+        {
+            return m_QueueOwnership && getOwner(texture) != m_QueueOwnership->queueFamilyIndex;
+        }
+
+        Barrier::Builder& Barrier::Builder::releaseOwnership(const OwnershipTransfer& transfer)
+        {
+            assert(transfer.image);
+            imageBarrier(transfer.image->getImageHandle(),
+                         transfer.srcScope,
+                         {},
+                         transfer.oldLayout,
+                         transfer.newLayout,
+                         transfer.subresourceRange,
+                         transfer.srcQueueFamilyIndex,
+                         transfer.dstQueueFamilyIndex);
+            return *this;
+        }
+
+        std::vector<Barrier::Builder::OwnershipTransfer> Barrier::Builder::takeOwnershipTransfers()
+        {
+            return std::exchange(m_OwnershipTransfers, {});
+        }
+
+        Barrier Barrier::Builder::build()
+        {
+            widenRanges(m_Dependencies.image);
+
+            const auto& [memory, buffer, image] = m_Dependencies;
+            m_Stats.numEmitted += static_cast<uint32_t>(memory.size() + buffer.size() + image.size());
+            return Barrier {m_Dependencies};
+        }
+
+        const Barrier::Stats& Barrier::Builder::getStats() const { return m_Stats; }
+        void                  Barrier::Builder::resetStats() { m_Stats = {}; }
+
+        vk::ImageMemoryBarrier2& Barrier::Builder::imageBarrier(vk::Image                        image,
+                                                                const BarrierScope&              src,
+                                                                const BarrierScope&              dst,
+                                                                ImageLayout                      oldLayout,
+                                                                ImageLayout                      newLayout,
+                                                                const vk::ImageSubresourceRange& subresourceRange,
+                                                                const uint32_t                   srcQueueFamilyIndex,
+                                                                const uint32_t                   dstQueueFamilyIndex)
         {
             assert(newLayout != ImageLayout::eUndefined);
 
             auto& images = m_Dependencies.image;
 
-            vk::ImageMemoryBarrier2 imageMemoryBarrier2 {};
-            imageMemoryBarrier2.srcStageMask        = static_cast<vk::PipelineStageFlagBits2>(src.stageMask);
-            imageMemoryBarrier2.srcAccessMask       = static_cast<vk::AccessFlagBits2>(src.accessMask);
-            imageMemoryBarrier2.oldLayout           = static_cast<vk::ImageLayout>(oldLayout);
-            imageMemoryBarrier2.srcQueueFamilyIndex = vk::QueueFamilyIgnored;
-            imageMemoryBarrier2.dstQueueFamilyIndex = vk::QueueFamilyIgnored;
-            imageMemoryBarrier2.image               = image;
-            imageMemoryBarrier2.subresourceRange    = subresourceRange;
+            // Ownership transfers are never merged with a plain transition of the same image.
+            auto it = std::ranges::find_if(images, [&](const vk::ImageMemoryBarrier2& b) {
+                return b.image == image && b.subresourceRange == subresourceRange &&
+                       b.srcQueueFamilyIndex == srcQueueFamilyIndex && b.dstQueueFamilyIndex == dstQueueFamilyIndex;
+            });
+            if (it == images.end())
+            {
+                vk::ImageMemoryBarrier2 imageMemoryBarrier2 {};
+                imageMemoryBarrier2.srcStageMask        = static_cast<vk::PipelineStageFlagBits2>(src.stageMask);
+                imageMemoryBarrier2.srcAccessMask       = static_cast<vk::AccessFlagBits2>(src.accessMask);
+                imageMemoryBarrier2.oldLayout           = static_cast<vk::ImageLayout>(oldLayout);
+                imageMemoryBarrier2.srcQueueFamilyIndex = srcQueueFamilyIndex;
+                imageMemoryBarrier2.dstQueueFamilyIndex = dstQueueFamilyIndex;
+                imageMemoryBarrier2.image               = image;
+                imageMemoryBarrier2.subresourceRange    = subresourceRange;
+                it = images.insert(images.end(), imageMemoryBarrier2);
+            }
+
+            // A pending transition of the same range is folded (no command runs in between).
+            it->dstStageMask |= static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
+            it->dstAccessMask |= static_cast<vk::AccessFlagBits2>(dst.accessMask);
+            it->newLayout = static_cast<vk::ImageLayout>(newLayout);
 
-            auto& entry = (!images.empty() && images.back().image == image) ? images.back() :
-                                                                              images.emplace_back(imageMemoryBarrier2);
+            return *it;
+        }
 
-            entry.dstStageMask |= static_cast<vk::PipelineStageFlagBits2>(dst.stageMask);
-            entry.dstAccessMask |= static_cast<vk::AccessFlagBits2>(dst.accessMask);
-            entry.newLayout = static_cast<vk::ImageLayout>(newLayout);
+        uint32_t Barrier::Builder::getOwner(const Texture& texture) const
+        {
+            assert(m_QueueOwnership);
+            return texture.m_QueueFamilyIndex != vk::QueueFamilyIgnored ? texture.m_QueueFamilyIndex :
+                                                                          m_QueueOwnership->defaultQueueFamilyIndex;
+        }
 
-            return *this;
+        void Barrier::Builder::clear()
+        {
+            m_Dependencies.memory.clear();
+            m_Dependencies.buffer.clear();
+            m_Dependencies.image.clear();
         }
 
-        Barrier::Barrier(Dependencies&& dependencies) : m_Dependencies {std::move(dependencies)}
+        Barrier::Barrier(const Dependencies& dependencies)
         {
-            m_Info.memoryBarrierCount       = static_cast<uint32_t>(m_Dependencies.memory.size());
-            m_Info.pMemoryBarriers          = m_Dependencies.memory.data();
-            m_Info.bufferMemoryBarrierCount = static_cast<uint32_t>(m_Dependencies.buffer.size());
-            m_Info.pBufferMemoryBarriers    = m_Dependencies.buffer.data();
-            m_Info.imageMemoryBarrierCount  = static_cast<uint32_t>(m_Dependencies.image.size());
-            m_Info.pImageMemoryBarriers     = m_Dependencies.image.data();
+            m_Info.memoryBarrierCount       = static_cast<uint32_t>(dependencies.memory.size());
+            m_Info.pMemoryBarriers          = dependencies.memory.data();
+            m_Info.bufferMemoryBarrierCount = static_cast<uint32_t>(dependencies.buffer.size());
+            m_Info.pBufferMemoryBarriers    = dependencies.buffer.data();
+            m_Info.imageMemoryBarrierCount  = static_cast<uint32_t>(dependencies.image.size());
+            m_Info.pImageMemoryBarriers     = dependencies.image.data();
         }
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "vultra/core/rhi/base_pipeline.hpp"
 
+#include <utility>
+
 namespace vultra
 {
     namespace rhi
@@ -44,6 +46,8 @@ namespace vultra
             assert(device);
         }
 
+        vk::Pipeline BasePipeline::exchangeHandle(const vk::Pipeline handle) { return std::exchange(m_Handle, handle); }
+
         void BasePipeline::destroy() noexcept
         {
             if (!m_Handle)
@@ -1,4 +1,5 @@
 #include "vultra/core/rhi/buffer.hpp"
+#include "vultra/core/rhi/util.hpp"
 #include "vultra/core/rhi/vk/macro.hpp"
 
 namespace vultra
@@ -7,7 +8,8 @@ namespace vultra
     {
         Buffer::Buffer(Buffer&& other) noexcept :
             m_MemoryAllocator(other.m_MemoryAllocator), m_Allocation(other.m_Allocation), m_Handle(other.m_Handle),
-            m_LastScope(other.m_LastScope), m_Size(other.m_Size), m_MappedMemory(other.m_MappedMemory)
+            m_LastScope(other.m_LastScope), m_Size(other.m_Size), m_MappedMemory(other.m_MappedMemory),
+            m_Id(other.m_Id), m_MemoryCategory(other.m_MemoryCategory)
         {
             other.m_MemoryAllocator = nullptr;
             other.m_Allocation      = nullptr;
@@ -15,6 +17,7 @@ namespace vultra
             other.m_LastScope       = {};
             other.m_Size            = 0;
             other.m_MappedMemory    = nullptr;
+            other.m_Id              = 0;
         }
 
         Buffer::~Buffer() { destroy(); }
@@ -31,6 +34,8 @@ namespace vultra
                 std::swap(m_LastScope, rhs.m_LastScope);
                 std::swap(m_Size, rhs.m_Size);
                 std::swap(m_MappedMemory, rhs.m_MappedMemory);
+                std::swap(m_Id, rhs.m_Id);
+                std::swap(m_MemoryCategory, rhs.m_MemoryCategory);
             }
 
             return *this;
@@ -42,6 +47,21 @@ namespace vultra
 
         vk::DeviceSize Buffer::getSize() const { return m_Size; }
 
+        uint64_t Buffer::getId() const { return m_Id; }
+
+        MemoryCategory Buffer::getMemoryCategory() const { return m_MemoryCategory; }
+
+        Buffer& Buffer::setMemoryCategory(const MemoryCategory category)
+        {
+            if (m_Handle && category != m_MemoryCategory)
+            {
+                trackMemory(m_MemoryCategory, -static_cast<int64_t>(m_Size));
+                trackMemory(category, static_cast<int64_t>(m_Size));
+            }
+            m_MemoryCategory = category;
+            return *this;
+        }
+
         void* Buffer::map()
         {
             assert(m_Handle);
@@ -79,7 +99,9 @@ namespace vultra
                        const vk::DeviceSize             size,
                        const vk::BufferUsageFlags       bufferUsage,
                        const vma::AllocationCreateFlags allocationFlags,
-                       const vma::MemoryUsage           memoryUsage) : m_MemoryAllocator(memoryAllocator)
+                       const vma::MemoryUsage           memoryUsage,
+                       const MemoryCategory             memoryCategory) :
+            m_MemoryAllocator(memoryAllocator), m_Id(generateResourceId()), m_MemoryCategory(memoryCategory)
         {
             vk::BufferCreateInfo bufferCreateInfo {};
             bufferCreateInfo.size        = size;
@@ -97,6 +119,7 @@ namespace vultra
                      "Failed to create buffer");
 
             m_Size = allocationInfo.size;
+            trackMemory(m_MemoryCategory, static_cast<int64_t>(m_Size));
         }
 
         void Buffer::destroy() noexcept
@@ -106,6 +129,7 @@ namespace vultra
                 unmap();
 
                 m_MemoryAllocator.destroyBuffer(m_Handle, m_Allocation);
+                trackMemory(m_MemoryCategory, -static_cast<int64_t>(m_Size));
                 m_MemoryAllocator = nullptr;
                 m_Allocation      = nullptr;
                 m_Handle          = nullptr;
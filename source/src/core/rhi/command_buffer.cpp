@@ -3,6 +3,7 @@
 #include "vultra/core/rhi/buffer.hpp"
 #include "vultra/core/rhi/compute_pipeline.hpp"
 #include "vultra/core/rhi/index_buffer.hpp"
+#include "vultra/core/rhi/query_pool.hpp"
 #include "vultra/core/rhi/raytracing/shader_binding_table.hpp"
 #include "vultra/core/rhi/texture.hpp"
 #include "vultra/core/rhi/vertex_buffer.hpp"
@@ -80,42 +81,61 @@ namespace vultra
             }
             [[nodiscard]] vk::RenderingAttachmentInfo toVk(const AttachmentInfo& attachment, const bool readOnly)
             {
-                const auto& [target, layer, face, clearValue] = attachment;
+                const auto& [target, layer, face, clearValue, loadContents, storeContents] = attachment;
                 assert(!readOnly || !clearValue.has_value());
+                assert(!readOnly || loadContents);
                 vk::RenderingAttachmentInfo attachmentInfo {};
                 attachmentInfo.imageView   = layer ? target->getLayer(*layer, face) : target->getImageView();
                 attachmentInfo.imageLayout = static_cast<vk::ImageLayout>(target->getImageLayout());
                 attachmentInfo.resolveMode = vk::ResolveModeFlagBits::eNone;
-                attachmentInfo.loadOp      = clearValue ? vk::AttachmentLoadOp::eClear : vk::AttachmentLoadOp::eLoad;
-                attachmentInfo.storeOp     = readOnly ? vk::AttachmentStoreOp::eNone : vk::AttachmentStoreOp::eStore;
-                attachmentInfo.clearValue  = clearValue ? toVk(*clearValue) : vk::ClearValue {};
+                attachmentInfo.loadOp      = vk::AttachmentLoadOp::eLoad;
+                attachmentInfo.storeOp     = vk::AttachmentStoreOp::eStore;
+                if (clearValue)
+                {
+                    attachmentInfo.loadOp     = vk::AttachmentLoadOp::eClear;
+                    attachmentInfo.clearValue = toVk(*clearValue);
+                }
+                else if (!loadContents)
+                {
+                    attachmentInfo.loadOp = vk::AttachmentLoadOp::eDontCare;
+                }
+                if (readOnly)
+                {
+                    attachmentInfo.storeOp = vk::AttachmentStoreOp::eNone;
+                }
+                else if (!storeContents)
+                {
+                    attachmentInfo.storeOp = vk::AttachmentStoreOp::eDontCare;
+                }
                 return attachmentInfo;
             }
         } // namespace
 
 #define TRACY_GPU_ZONE2_(Label) TRACY_GPU_ZONE_(m_TracyContext, m_Handle, "RHI::" Label)
 
-        CommandBuffer::CommandBuffer() { m_DescriptorSetCache.reserve(100); }
+        CommandBuffer::CommandBuffer() = default;
 
         CommandBuffer::CommandBuffer(CommandBuffer&& other) noexcept :
             m_Device(other.m_Device), m_CommandPool(other.m_CommandPool), m_State(other.m_State),
-            m_Handle(other.m_Handle), m_TracyContext(other.m_TracyContext), m_Fence(other.m_Fence),
-            m_DescriptorSetAllocator(std::move(other.m_DescriptorSetAllocator)),
-            m_DescriptorSetCache(std::move(other.m_DescriptorSetCache)),
-            m_BarrierBuilder(std::move(other.m_BarrierBuilder)), m_Pipeline(other.m_Pipeline),
-            m_VertexBuffer(other.m_VertexBuffer), m_IndexBuffer(other.m_IndexBuffer),
+            m_Handle(other.m_Handle), m_Level(other.m_Level), m_TracyContext(other.m_TracyContext),
+            m_Fence(other.m_Fence), m_QueueType(other.m_QueueType), m_WaitSemaphores(std::move(other.m_WaitSemaphores)),
+            m_DescriptorSetCache(other.m_DescriptorSetCache), m_BarrierBuilder(std::move(other.m_BarrierBuilder)),
+            m_Pipeline(other.m_Pipeline), m_VertexBuffer(other.m_VertexBuffer), m_IndexBuffer(other.m_IndexBuffer),
             m_InsideRenderPass(other.m_InsideRenderPass)
         {
-            other.m_Device           = nullptr;
-            other.m_CommandPool      = nullptr;
-            other.m_Handle           = nullptr;
-            other.m_TracyContext     = nullptr;
-            other.m_Fence            = nullptr;
-            other.m_State            = State::eInvalid;
-            other.m_Pipeline         = nullptr;
-            other.m_VertexBuffer     = nullptr;
-            other.m_IndexBuffer      = nullptr;
-            other.m_InsideRenderPass = false;
+            other.m_Device             = nullptr;
+            other.m_CommandPool        = nullptr;
+            other.m_Handle             = nullptr;
+            other.m_Level              = vk::CommandBufferLevel::ePrimary;
+            other.m_TracyContext       = nullptr;
+            other.m_Fence              = nullptr;
+            other.m_QueueType          = QueueType::eGeneric;
+            other.m_DescriptorSetCache = nullptr;
+            other.m_State              = State::eInvalid;
+            other.m_Pipeline           = nullptr;
+            other.m_VertexBuffer       = nullptr;
+            other.m_IndexBuffer        = nullptr;
+            other.m_InsideRenderPass   = false;
         }
 
         CommandBuffer::~CommandBuffer() { destroy(); }
@@ -132,11 +152,13 @@ namespace vultra
                 std::swap(m_State, rhs.m_State);
 
                 std::swap(m_Handle, rhs.m_Handle);
+                std::swap(m_Level, rhs.m_Level);
                 std::swap(m_TracyContext, rhs.m_TracyContext);
 
                 std::swap(m_Fence, rhs.m_Fence);
+                std::swap(m_QueueType, rhs.m_QueueType);
+                std::swap(m_WaitSemaphores, rhs.m_WaitSemaphores);
 
-                std::swap(m_DescriptorSetAllocator, rhs.m_DescriptorSetAllocator);
                 std::swap(m_DescriptorSetCache, rhs.m_DescriptorSetCache);
 
                 std::swap(m_BarrierBuilder, rhs.m_BarrierBuilder);
@@ -155,34 +177,84 @@ namespace vultra
 
         TracyVkCtx CommandBuffer::getTracyContext() const { return m_TracyContext; }
 
+        QueueType CommandBuffer::getQueueType() const { return m_QueueType; }
+
+        bool CommandBuffer::isInsideRenderPass() const { return m_InsideRenderPass; }
+
+        bool CommandBuffer::isSecondary() const { return m_Level == vk::CommandBufferLevel::eSecondary; }
+
         Barrier::Builder& CommandBuffer::getBarrierBuilder() { return m_BarrierBuilder; }
 
         DescriptorSetBuilder CommandBuffer::createDescriptorSetBuilder()
         {
-            return DescriptorSetBuilder {m_Device, m_DescriptorSetAllocator, m_DescriptorSetCache};
+            assert(m_DescriptorSetCache);
+            return DescriptorSetBuilder {*m_DescriptorSetCache};
         }
 
         CommandBuffer& CommandBuffer::begin()
         {
-            assert(invariant(State::eInitial));
+            assert(invariant(State::eInitial) && !isSecondary());
 
             VK_CHECK(m_Device.resetFences(1, &m_Fence), "CommandBuffer", "Failed to reset fence");
 
             vk::CommandBufferBeginInfo beginInfo {};
             beginInfo.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit;
             VK_CHECK(m_Handle.begin(&beginInfo), "CommandBuffer", "Failed to begin command buffer");
+            m_BarrierBuilder.resetStats();
 
             m_State = State::eRecording;
             return *this;
         }
 
+        CommandBuffer& CommandBuffer::begin(const FramebufferInfo& framebufferInfo)
+        {
+            assert(invariant(State::eInitial) && isSecondary());
+
+            std::vector<vk::Format> colorFormats;
+            colorFormats.reserve(framebufferInfo.colorAttachments.size());
+            for (const auto format : getColorFormats(framebufferInfo))
+            {
+                colorFormats.push_back(static_cast<vk::Format>(format));
+            }
+
+            vk::CommandBufferInheritanceRenderingInfo renderingInfo {};
+            renderingInfo.viewMask                = framebufferInfo.viewMask;
+            renderingInfo.colorAttachmentCount    = static_cast<uint32_t>(colorFormats.size());
+            renderingInfo.pColorAttachmentFormats = colorFormats.data();
+            renderingInfo.depthAttachmentFormat   = static_cast<vk::Format>(getDepthFormat(framebufferInfo));
+            if (framebufferInfo.stencilAttachment)
+            {
+                renderingInfo.stencilAttachmentFormat =
+                    static_cast<vk::Format>(framebufferInfo.stencilAttachment->target->getPixelFormat());
+            }
+            renderingInfo.rasterizationSamples = vk::SampleCountFlagBits::e1;
+
+            vk::CommandBufferInheritanceInfo inheritanceInfo {};
+            inheritanceInfo.pNext = &renderingInfo;
+
+            vk::CommandBufferBeginInfo beginInfo {};
+            beginInfo.flags =
+                vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue;
+            beginInfo.pInheritanceInfo = &inheritanceInfo;
+            VK_CHECK(m_Handle.begin(&beginInfo), "CommandBuffer", "Failed to begin secondary command buffer");
+            m_BarrierBuilder.resetStats();
+
+            m_State            = State::eRecording;
+            m_InsideRenderPass = true;
+
+            // Dynamic state is not inherited.
+            return setViewport(framebufferInfo.area).setScissor(framebufferInfo.area);
+        }
+
         CommandBuffer& CommandBuffer::end()
         {
-            assert(invariant(State::eRecording, InvariantFlags::eOutsideRenderPass));
+            assert(invariant(State::eRecording,
+                             isSecondary() ? InvariantFlags::eInsideRenderPass : InvariantFlags::eOutsideRenderPass));
 
             m_Handle.end();
 
-            m_State = State::eExecutable;
+            m_State            = State::eExecutable;
+            m_InsideRenderPass = false;
 
             m_Pipeline     = nullptr;
             m_VertexBuffer = nullptr;
@@ -205,9 +277,6 @@ namespace vultra
 
                 m_Handle.reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 
-                m_DescriptorSetCache.clear();
-                m_DescriptorSetAllocator.reset();
-
                 m_State = State::eInitial;
             }
 
@@ -300,6 +369,23 @@ namespace vultra
             return *this;
         }
 
+        CommandBuffer& CommandBuffer::pushDescriptorSet(const DescriptorSetIndex                           index,
+                                                        std::span<const vk::DescriptorUpdateTemplateEntry> entries,
+                                                        const void*                                        data)
+        {
+            assert(data && !entries.empty());
+            assert(invariant(State::eRecording, InvariantFlags::eValidPipeline));
+            assert(m_Pipeline->getLayout().isPushDescriptorSet(index));
+
+            TRACY_GPU_ZONE2_("PushDescriptorSet");
+            const auto pipelineLayout = m_Pipeline->getLayout().getHandle();
+            const auto updateTemplate =
+                m_DescriptorSetCache->getPushTemplate(m_Pipeline->getBindPoint(), pipelineLayout, index, entries);
+            m_Handle.pushDescriptorSetWithTemplateKHR(updateTemplate, pipelineLayout, index, data);
+
+            return *this;
+        }
+
         CommandBuffer& CommandBuffer::pushConstants(const ShaderStages shaderStages,
                                                     const uint32_t     offset,
                                                     const uint32_t     size,
@@ -318,7 +404,8 @@ namespace vultra
             return *this;
         }
 
-        CommandBuffer& CommandBuffer::beginRendering(const FramebufferInfo& framebufferInfo)
+        CommandBuffer& CommandBuffer::beginRendering(const FramebufferInfo& framebufferInfo,
+                                                     const bool             secondaryContents)
         {
             assert(invariant(State::eRecording, InvariantFlags::eOutsideRenderPass));
 
@@ -343,16 +430,25 @@ namespace vultra
             vk::RenderingInfo renderingInfo {};
             renderingInfo.renderArea           = static_cast<vk::Rect2D>(framebufferInfo.area);
             renderingInfo.layerCount           = static_cast<uint32_t>(framebufferInfo.layers);
+            renderingInfo.viewMask             = framebufferInfo.viewMask;
             renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
             renderingInfo.pColorAttachments    = colorAttachments.data();
             renderingInfo.pDepthAttachment     = depthAttachment.imageView ? &depthAttachment : nullptr;
             renderingInfo.pStencilAttachment   = stencilAttachment.imageView ? &stencilAttachment : nullptr;
+            if (secondaryContents)
+            {
+                renderingInfo.flags = vk::RenderingFlagBits::eContentsSecondaryCommandBuffers;
+            }
 
             flushBarriers();
             m_Handle.beginRenderingKHR(&renderingInfo);
 
             m_InsideRenderPass = true;
 
+            // Only vkCmdExecuteCommands is allowed in this render pass, the secondaries set their own viewport.
+            if (secondaryContents)
+                return *this;
+
             return setViewport(framebufferInfo.area).setScissor(framebufferInfo.area);
         }
 
@@ -368,6 +464,31 @@ namespace vultra
             return *this;
         }
 
+        CommandBuffer& CommandBuffer::executeCommands(std::span<CommandBuffer* const> commandBuffers)
+        {
+            assert(invariant(State::eRecording) && !isSecondary());
+
+            if (commandBuffers.empty())
+                return *this;
+
+            std::vector<vk::CommandBuffer> handles;
+            handles.reserve(commandBuffers.size());
+            for (const auto* commandBuffer : commandBuffers)
+            {
+                assert(commandBuffer && commandBuffer->isSecondary() && commandBuffer->m_State == State::eExecutable);
+                handles.push_back(commandBuffer->m_Handle);
+            }
+
+            TRACY_GPU_ZONE2_("ExecuteCommands");
+            m_Handle.executeCommands(static_cast<uint32_t>(handles.size()), handles.data());
+
+            m_Pipeline     = nullptr;
+            m_VertexBuffer = nullptr;
+            m_IndexBuffer  = nullptr;
+
+            return *this;
+        }
+
         CommandBuffer& CommandBuffer::setViewport(const Rect2D& rect)
         {
             assert(invariant(State::eRecording));
@@ -434,6 +555,23 @@ namespace vultra
             return *this;
         }
 
+        CommandBuffer& CommandBuffer::clearDepthAttachment(const Rect2D&  area,
+                                                           const float    depth,
+                                                           const uint32_t baseLayer,
+                                                           const uint32_t layerCount)
+        {
+            assert(invariant(State::eRecording, InvariantFlags::eInsideRenderPass));
+
+            TRACY_GPU_ZONE2_("ClearDepthAttachment");
+
+            const vk::ClearAttachment attachment {
+                vk::ImageAspectFlagBits::eDepth, 0, vk::ClearDepthStencilValue {depth, 0}};
+            const vk::ClearRect rect {static_cast<vk::Rect2D>(area), baseLayer, layerCount};
+            m_Handle.clearAttachments(1, &attachment, 1, &rect);
+
+            return *this;
+        }
+
         CommandBuffer& CommandBuffer::clear(const Buffer& buffer, const uint32_t value)
         {
             assert(buffer);
@@ -754,7 +892,48 @@ namespace vultra
                 .stageMask  = PipelineStages::eBlit,
                 .accessMask = Access::eTransferRead,
             };
+            texture.m_SubresourceStates.clear();
+
+            return *this;
+        }
+
+        CommandBuffer& CommandBuffer::resetQueryPool(QueryPool& queryPool, const uint32_t first, const uint32_t count)
+        {
+            assert(queryPool && first + count <= queryPool.getCount());
+            assert(invariant(State::eRecording, InvariantFlags::eOutsideRenderPass));
+
+            m_Handle.resetQueryPool(queryPool.getHandle(), first, count);
+            return *this;
+        }
+
+        CommandBuffer&
+        CommandBuffer::writeTimestamp(QueryPool& queryPool, const uint32_t query, const PipelineStages stage)
+        {
+            assert(queryPool && queryPool.getType() == vk::QueryType::eTimestamp && query < queryPool.getCount());
+            assert(invariant(State::eRecording, InvariantFlags::eOutsideRenderPass));
 
+            flushBarriers();
+            m_Handle.writeTimestamp2KHR(static_cast<vk::PipelineStageFlagBits2>(stage), queryPool.getHandle(), query);
+            return *this;
+        }
+
+        CommandBuffer& CommandBuffer::beginQuery(QueryPool& queryPool, const uint32_t query)
+        {
+            assert(queryPool && queryPool.getType() != vk::QueryType::eTimestamp && query < queryPool.getCount());
+            assert(invariant(State::eRecording));
+
+            if (!m_InsideRenderPass)
+                flushBarriers();
+            m_Handle.beginQuery(queryPool.getHandle(), query, {});
+            return *this;
+        }
+
+        CommandBuffer& CommandBuffer::endQuery(QueryPool& queryPool, const uint32_t query)
+        {
+            assert(queryPool && query < queryPool.getCount());
+            assert(invariant(State::eRecording));
+
+            m_Handle.endQuery(queryPool.getHandle(), query);
             return *this;
         }
 
@@ -767,17 +946,34 @@ namespace vultra
                 TRACY_GPU_ZONE2_("FlushBarriers");
                 m_Handle.pipelineBarrier2KHR(&barrier.m_Info);
             }
+            m_BarrierBuilder.clear();
+            return *this;
+        }
+
+        CommandBuffer& CommandBuffer::addWaitSemaphore(const vk::Semaphore           semaphore,
+                                                       const uint64_t                value,
+                                                       const vk::PipelineStageFlags2 stageMask)
+        {
+            assert(semaphore);
+
+            auto& waitSemaphoreInfo     = m_WaitSemaphores.emplace_back();
+            waitSemaphoreInfo.semaphore = semaphore;
+            waitSemaphoreInfo.value     = value;
+            waitSemaphoreInfo.stageMask = stageMask;
             return *this;
         }
 
-        CommandBuffer::CommandBuffer(const vk::Device        device,
-                                     const vk::CommandPool   commandPool,
-                                     const vk::CommandBuffer handle,
-                                     TracyVkCtx              tracyContext,
-                                     const vk::Fence         fence,
-                                     const bool              enableRaytracing) :
-            m_Device(device), m_CommandPool(commandPool), m_State(State::eInitial), m_Handle(handle),
-            m_TracyContext(tracyContext), m_Fence(fence), m_DescriptorSetAllocator(device, enableRaytracing)
+        CommandBuffer::CommandBuffer(const vk::Device             device,
+                                     const vk::CommandPool        commandPool,
+                                     const vk::CommandBuffer      handle,
+                                     TracyVkCtx                   tracyContext,
+                                     const vk::Fence              fence,
+                                     DescriptorSetCache*          descriptorSetCache,
+                                     const QueueType              queueType,
+                                     const vk::CommandBufferLevel level) :
+            m_Device(device), m_CommandPool(commandPool), m_State(State::eInitial), m_Handle(handle), m_Level(level),
+            m_TracyContext(tracyContext), m_Fence(fence), m_QueueType(queueType),
+            m_DescriptorSetCache(descriptorSetCache)
         {}
 
         bool CommandBuffer::invariant(const State requiredState, const InvariantFlags flags) const
@@ -836,11 +1032,13 @@ namespace vultra
             m_State = State::eInvalid;
 
             m_Handle       = nullptr;
+            m_Level        = vk::CommandBufferLevel::ePrimary;
             m_TracyContext = nullptr;
 
-            m_Fence = nullptr;
-            m_DescriptorSetAllocator.reset();
-            m_DescriptorSetCache.clear();
+            m_Fence     = nullptr;
+            m_QueueType = QueueType::eGeneric;
+            m_WaitSemaphores.clear();
+            m_DescriptorSetCache = nullptr;
 
             m_Pipeline     = nullptr;
             m_VertexBuffer = nullptr;
@@ -849,6 +1047,13 @@ namespace vultra
             m_InsideRenderPass = false;
         }
 
+        void CommandBuffer::recycle()
+        {
+            assert(m_Handle && m_State != State::eRecording);
+
+            m_State = State::eInitial;
+        }
+
         void CommandBuffer::chunkedUpdate(const vk::Buffer bufferHandle,
                                           vk::DeviceSize   offset,
                                           vk::DeviceSize   size,
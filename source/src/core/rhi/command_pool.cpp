@@ -0,0 +1,114 @@
+#include "vultra/core/rhi/command_pool.hpp"
+#include "vultra/core/rhi/vk/macro.hpp"
+
+namespace vultra
+{
+    namespace rhi
+    {
+        CommandPool::CommandPool(CommandPool&& other) noexcept :
+            m_Device(other.m_Device), m_Handle(other.m_Handle), m_TracyContext(other.m_TracyContext),
+            m_DescriptorSetCache(other.m_DescriptorSetCache), m_QueueType(other.m_QueueType),
+            m_CommandBuffers(std::move(other.m_CommandBuffers)), m_NumAcquired(other.m_NumAcquired)
+        {
+            other.m_Device             = nullptr;
+            other.m_Handle             = nullptr;
+            other.m_TracyContext       = nullptr;
+            other.m_DescriptorSetCache = nullptr;
+            other.m_NumAcquired        = 0;
+        }
+
+        CommandPool::~CommandPool() { destroy(); }
+
+        CommandPool& CommandPool::operator=(CommandPool&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                destroy();
+
+                std::swap(m_Device, rhs.m_Device);
+                std::swap(m_Handle, rhs.m_Handle);
+                std::swap(m_TracyContext, rhs.m_TracyContext);
+                std::swap(m_DescriptorSetCache, rhs.m_DescriptorSetCache);
+                std::swap(m_QueueType, rhs.m_QueueType);
+                std::swap(m_CommandBuffers, rhs.m_CommandBuffers);
+                std::swap(m_NumAcquired, rhs.m_NumAcquired);
+            }
+            return *this;
+        }
+
+        CommandPool::operator bool() const { return m_Handle != nullptr; }
+
+        vk::CommandPool CommandPool::getHandle() const { return m_Handle; }
+
+        QueueType CommandPool::getQueueType() const { return m_QueueType; }
+
+        uint32_t CommandPool::getNumAcquired() const { return m_NumAcquired; }
+
+        CommandBuffer& CommandPool::acquireSecondary()
+        {
+            assert(m_Handle);
+
+            if (m_NumAcquired == m_CommandBuffers.size())
+            {
+                vk::CommandBufferAllocateInfo allocateInfo {};
+                allocateInfo.commandPool        = m_Handle;
+                allocateInfo.level              = vk::CommandBufferLevel::eSecondary;
+                allocateInfo.commandBufferCount = 1;
+
+                vk::CommandBuffer handle {nullptr};
+                VK_CHECK(m_Device.allocateCommandBuffers(&allocateInfo, &handle),
+                         "CommandPool",
+                         "Failed to allocate secondary command buffer");
+                m_CommandBuffers.push_back(CommandBuffer {m_Device,
+                                                          m_Handle,
+                                                          handle,
+                                                          m_TracyContext,
+                                                          nullptr,
+                                                          m_DescriptorSetCache,
+                                                          m_QueueType,
+                                                          vk::CommandBufferLevel::eSecondary});
+            }
+            return m_CommandBuffers[m_NumAcquired++];
+        }
+
+        void CommandPool::reset()
+        {
+            assert(m_Handle);
+
+            if (m_NumAcquired == 0)
+                return;
+
+            m_Device.resetCommandPool(m_Handle);
+            for (auto i = 0u; i < m_NumAcquired; ++i)
+            {
+                m_CommandBuffers[i].recycle();
+            }
+            m_NumAcquired = 0;
+        }
+
+        CommandPool::CommandPool(const vk::Device      device,
+                                 const vk::CommandPool handle,
+                                 TracyVkCtx            tracyContext,
+                                 DescriptorSetCache*   descriptorSetCache,
+                                 const QueueType       queueType) :
+            m_Device(device), m_Handle(handle), m_TracyContext(tracyContext),
+            m_DescriptorSetCache(descriptorSetCache), m_QueueType(queueType)
+        {}
+
+        void CommandPool::destroy() noexcept
+        {
+            if (!m_Handle)
+                return;
+
+            // Frees the command buffers, the pool has to outlive them.
+            m_CommandBuffers.clear();
+            m_Device.destroyCommandPool(m_Handle);
+
+            m_Device             = nullptr;
+            m_Handle             = nullptr;
+            m_TracyContext       = nullptr;
+            m_DescriptorSetCache = nullptr;
+            m_NumAcquired        = 0;
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
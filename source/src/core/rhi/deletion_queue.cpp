@@ -0,0 +1,46 @@
+#include "vultra/core/rhi/deletion_queue.hpp"
+
+#include <iterator>
+#include <vector>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        DeletionQueue::~DeletionQueue() { flush(); }
+
+        void DeletionQueue::nextFrame(const uint32_t numFramesInFlight)
+        {
+            std::vector<Entry> retired;
+            {
+                std::lock_guard lock {m_Mutex};
+
+                ++m_FrameNumber;
+                auto it = m_Entries.begin();
+                while (it != m_Entries.end() && it->frameNumber + numFramesInFlight <= m_FrameNumber)
+                    ++it;
+
+                retired.assign(std::make_move_iterator(m_Entries.begin()), std::make_move_iterator(it));
+                m_Entries.erase(m_Entries.begin(), it);
+            }
+            // Destroyed outside of the lock, a destructor might release another resource.
+            retired.clear();
+        }
+
+        void DeletionQueue::flush()
+        {
+            std::deque<Entry> entries;
+            {
+                std::lock_guard lock {m_Mutex};
+                entries.swap(m_Entries);
+            }
+            entries.clear();
+        }
+
+        std::size_t DeletionQueue::size() const
+        {
+            std::lock_guard lock {m_Mutex};
+            return m_Entries.size();
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -1,17 +1,25 @@
 #include "vultra/core/rhi/descriptorset_allocator.hpp"
 
+#include "vultra/core/rhi/memory_stats.hpp"
 #include "vultra/core/rhi/vk/macro.hpp"
 
+#include <algorithm>
+#include <mutex>
+
 namespace vultra
 {
     namespace rhi
     {
 
-        const uint32_t DescriptorPool::s_kSetsPerPool = 100u;
+        const uint32_t DescriptorPool::s_kSetsPerPool   = 100u;
+        const uint32_t DescriptorPool::s_kMaxIdleResets = 16u;
+
+        const vk::DeviceSize DescriptorPool::s_kEstimatedDescriptorSize = 64u;
 
         namespace
         {
-            [[nodiscard]] auto createDescriptorPool(const vk::Device device, bool raytracing = false)
+            // Used until the first layout has been registered (or without a DescriptorPoolSizer).
+            [[nodiscard]] auto getDefaultPoolSizes(bool raytracing)
             {
 #define POOL_SIZE(Type, Multiplier) \
     vk::DescriptorPoolSize \
@@ -35,9 +43,15 @@ namespace vultra
                 }
                 // clang-format on
 #undef POOL_SIZE
+                return poolSizes;
+            }
 
+            [[nodiscard]] auto createDescriptorPool(const vk::Device                         device,
+                                                    const uint32_t                           maxSets,
+                                                    const std::vector<vk::DescriptorPoolSize>& poolSizes)
+            {
                 vk::DescriptorPoolCreateInfo createInfo {};
-                createInfo.maxSets       = DescriptorPool::s_kSetsPerPool;
+                createInfo.maxSets       = maxSets;
                 createInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
                 createInfo.pPoolSizes    = poolSizes.data();
 #if __APPLE__
@@ -51,16 +65,100 @@ namespace vultra
                 return descriptorPool;
             }
 
+            [[nodiscard]] vk::DeviceSize
+            estimateDescriptorPoolSize(const std::vector<vk::DescriptorPoolSize>& poolSizes)
+            {
+                vk::DeviceSize numDescriptors {0};
+                for (const auto& poolSize : poolSizes)
+                {
+                    numDescriptors += poolSize.descriptorCount;
+                }
+                return numDescriptors * DescriptorPool::s_kEstimatedDescriptorSize;
+            }
+
         } // namespace
 
+        //
+        // DescriptorPoolSizer class:
+        //
+
+        void DescriptorPoolSizer::add(const vk::DescriptorSetLayout                   layout,
+                                      std::span<const vk::DescriptorSetLayoutBinding> bindings)
+        {
+            assert(layout);
+
+            std::vector<vk::DescriptorPoolSize> setSizes;
+            for (const auto& binding : bindings)
+            {
+                if (binding.descriptorCount == 0)
+                    continue;
+
+                const auto it = std::ranges::find(setSizes, binding.descriptorType, &vk::DescriptorPoolSize::type);
+                if (it != setSizes.end())
+                    it->descriptorCount += binding.descriptorCount;
+                else
+                    setSizes.emplace_back(binding.descriptorType, binding.descriptorCount);
+            }
+
+            std::unique_lock lock {m_Mutex};
+            if (!m_Layouts.try_emplace(layout, setSizes).second)
+                return;
+
+            for (const auto& [type, count] : setSizes)
+            {
+                auto& usage = m_Usage[type];
+                usage.total += count;
+                usage.maxPerSet = std::max(usage.maxPerSet, count);
+            }
+            ++m_Generation;
+        }
+
+        uint64_t DescriptorPoolSizer::getGeneration() const
+        {
+            std::shared_lock lock {m_Mutex};
+            return m_Generation;
+        }
+
+        std::vector<vk::DescriptorPoolSize> DescriptorPoolSizer::getPoolSizes(const uint32_t numSets) const
+        {
+            std::shared_lock lock {m_Mutex};
+            if (m_Layouts.empty())
+                return {};
+
+            const auto numLayouts = static_cast<uint64_t>(m_Layouts.size());
+
+            std::vector<vk::DescriptorPoolSize> poolSizes;
+            poolSizes.reserve(m_Usage.size());
+            for (const auto& [type, usage] : m_Usage)
+            {
+                const auto average = (usage.total * numSets + numLayouts - 1) / numLayouts;
+                poolSizes.emplace_back(type, std::max(static_cast<uint32_t>(average), usage.maxPerSet));
+            }
+            return poolSizes;
+        }
+
+        std::vector<vk::DescriptorPoolSize> DescriptorPoolSizer::getSetSizes(const vk::DescriptorSetLayout layout) const
+        {
+            std::shared_lock lock {m_Mutex};
+            const auto       it = m_Layouts.find(layout);
+            return it != m_Layouts.cend() ? it->second : std::vector<vk::DescriptorPoolSize> {};
+        }
+
+        //
+        // DescriptorSetAllocator class:
+        //
+
         DescriptorSetAllocator::DescriptorSetAllocator(DescriptorSetAllocator&& other) noexcept :
-            m_Device(other.m_Device), m_DescriptorPools(other.m_DescriptorPools),
-            m_LastPoolIndex(other.m_LastPoolIndex), m_EnableRaytracing(other.m_EnableRaytracing)
+            m_Device(other.m_Device), m_PoolSizer(other.m_PoolSizer), m_DescriptorPools(other.m_DescriptorPools),
+            m_LastPoolIndex(other.m_LastPoolIndex), m_EnableRaytracing(other.m_EnableRaytracing),
+            m_Stats(other.m_Stats)
         {
-            other.m_Device = nullptr;
+            other.m_Device    = nullptr;
+            other.m_PoolSizer = nullptr;
             other.m_DescriptorPools.clear();
             other.m_LastPoolIndex    = -1;
             other.m_EnableRaytracing = false;
+            other.m_Stats            = {};
         }
 
         DescriptorSetAllocator::~DescriptorSetAllocator() { destroy(); }
@@ -72,9 +170,11 @@ namespace vultra
                 destroy();
 
                 std::swap(m_Device, rhs.m_Device);
+                std::swap(m_PoolSizer, rhs.m_PoolSizer);
                 std::swap(m_DescriptorPools, rhs.m_DescriptorPools);
                 std::swap(m_LastPoolIndex, rhs.m_LastPoolIndex);
                 std::swap(m_EnableRaytracing, rhs.m_EnableRaytracing);
+                std::swap(m_Stats, rhs.m_Stats);
             }
 
             return *this;
@@ -84,12 +184,19 @@ namespace vultra
                                                            uint32_t                      variableDescriptorCount)
         {
             assert(m_Device && descriptorSetLayout);
-            auto descriptorSet = allocate(getPool(), descriptorSetLayout, variableDescriptorCount);
-            if (descriptorSet == nullptr)
+            auto&      descriptorPool = getPool();
+            const auto wasEmpty       = descriptorPool.numAllocatedSets == 0;
+            auto       descriptorSet  = allocate(descriptorPool, descriptorSetLayout, variableDescriptorCount);
+            if (descriptorSet == nullptr && !wasEmpty)
             {
                 // No more space in the descriptor pool (any of .pPoolSizes)
                 descriptorSet = allocate(createPool(), descriptorSetLayout, variableDescriptorCount);
             }
+            if (descriptorSet == nullptr)
+            {
+                // Does not even fit into an empty pool (e.g. sized with the default ratios)
+                descriptorSet = allocate(getPool(descriptorSetLayout), descriptorSetLayout, variableDescriptorCount);
+            }
             assert(descriptorSet);
             return descriptorSet;
         }
@@ -97,19 +204,53 @@ namespace vultra
         void DescriptorSetAllocator::reset()
         {
             assert(m_Device);
-            for (auto& [h, numAllocatedSets] : m_DescriptorPools)
-            {
-                if (numAllocatedSets > 0)
+
+            const auto generation = m_PoolSizer ? m_PoolSizer->getGeneration() : 0;
+
+            std::erase_if(m_DescriptorPools, [this, generation](DescriptorPool& dp) {
+                if (dp.numAllocatedSets > 0)
                 {
-                    m_Device.resetDescriptorPool(h);
-                    numAllocatedSets = 0;
+                    dp.numIdleResets = 0;
                 }
-            }
+                else
+                {
+                    ++dp.numIdleResets;
+                }
+
+                if (dp.generation != generation || dp.numIdleResets > DescriptorPool::s_kMaxIdleResets)
+                {
+                    m_Device.destroyDescriptorPool(dp.handle);
+                    trackMemory(MemoryCategory::eDescriptor, -static_cast<int64_t>(dp.estimatedSize));
+                    ++m_Stats.numPoolsDestroyed;
+                    return true;
+                }
+
+                if (dp.numAllocatedSets > 0)
+                {
+                    m_Device.resetDescriptorPool(dp.handle);
+                    dp.numAllocatedSets = 0;
+                }
+                dp.exhausted = false;
+                return false;
+            });
             m_LastPoolIndex = m_DescriptorPools.empty() ? -1 : 0;
         }
 
-        DescriptorSetAllocator::DescriptorSetAllocator(const vk::Device device, bool raytracing) :
-            m_Device(device), m_EnableRaytracing(raytracing)
+        DescriptorSetAllocator::Stats DescriptorSetAllocator::getStats() const
+        {
+            auto stats     = m_Stats;
+            stats.numPools = static_cast<uint32_t>(m_DescriptorPools.size());
+            for (const auto& dp : m_DescriptorPools)
+            {
+                stats.numAllocatedSets += dp.numAllocatedSets;
+            }
+            return stats;
+        }
+
+        DescriptorSetAllocator::DescriptorSetAllocator(const vk::Device           device,
+                                                       const DescriptorPoolSizer* poolSizer,
+                                                       bool                       raytracing) :
+            m_Device(device), m_PoolSizer(poolSizer), m_EnableRaytracing(raytracing)
         {
             assert(device);
         }
@@ -122,22 +263,42 @@ namespace vultra
                 return;
             }
 
-            for (const auto [h, _] : m_DescriptorPools)
+            for (const auto& dp : m_DescriptorPools)
             {
-                m_Device.destroyDescriptorPool(h);
+                m_Device.destroyDescriptorPool(dp.handle);
+                trackMemory(MemoryCategory::eDescriptor, -static_cast<int64_t>(dp.estimatedSize));
             }
             m_DescriptorPools.clear();
             m_LastPoolIndex    = -1;
             m_EnableRaytracing = false;
+            m_Stats            = {};
 
-            m_Device = nullptr;
+            m_PoolSizer = nullptr;
+            m_Device    = nullptr;
         }
 
         DescriptorPool& DescriptorSetAllocator::createPool()
         {
-            m_LastPoolIndex           = static_cast<int32_t>(m_DescriptorPools.size());
-            const auto descriptorPool = createDescriptorPool(m_Device, m_EnableRaytracing);
-            return m_DescriptorPools.emplace_back(descriptorPool);
+            const auto generation = m_PoolSizer ? m_PoolSizer->getGeneration() : 0;
+
+            auto poolSizes = m_PoolSizer ? m_PoolSizer->getPoolSizes(DescriptorPool::s_kSetsPerPool) :
+                                           std::vector<vk::DescriptorPoolSize> {};
+            if (poolSizes.empty())
+            {
+                poolSizes = getDefaultPoolSizes(m_EnableRaytracing);
+            }
+
+            const auto estimatedSize = estimateDescriptorPoolSize(poolSizes);
+            trackMemory(MemoryCategory::eDescriptor, static_cast<int64_t>(estimatedSize));
+
+            m_LastPoolIndex = static_cast<int32_t>(m_DescriptorPools.size());
+            ++m_Stats.numPoolsCreated;
+            return m_DescriptorPools.emplace_back(DescriptorPool {
+                .handle        = createDescriptorPool(m_Device, DescriptorPool::s_kSetsPerPool, poolSizes),
+                .maxSets       = DescriptorPool::s_kSetsPerPool,
+                .generation    = generation,
+                .estimatedSize = estimatedSize,
+            });
         }
 
         DescriptorPool& DescriptorSetAllocator::getPool()
@@ -145,15 +306,44 @@ namespace vultra
             // NOTE: Compiler will convert m_lastPoolIndex to size_t (-1 < 0u == false)
             for (; m_LastPoolIndex < m_DescriptorPools.size(); ++m_LastPoolIndex)
             {
-                if (auto& dp = m_DescriptorPools[m_LastPoolIndex]; dp.numAllocatedSets < DescriptorPool::s_kSetsPerPool)
+                if (auto& dp = m_DescriptorPools[m_LastPoolIndex];
+                    !dp.dedicatedLayout && !dp.exhausted && dp.numAllocatedSets < dp.maxSets)
                     return dp;
             }
             return createPool();
         }
 
+        DescriptorPool& DescriptorSetAllocator::getPool(const vk::DescriptorSetLayout descriptorSetLayout)
+        {
+            const auto generation = m_PoolSizer ? m_PoolSizer->getGeneration() : 0;
+
+            for (auto& dp : m_DescriptorPools)
+            {
+                if (dp.dedicatedLayout == descriptorSetLayout && dp.numAllocatedSets == 0)
+                    return dp;
+            }
+
+            auto poolSizes = m_PoolSizer ? m_PoolSizer->getSetSizes(descriptorSetLayout) :
+                                           std::vector<vk::DescriptorPoolSize> {};
+            assert(!poolSizes.empty() && "Unknown descriptor set layout");
+
+            const auto estimatedSize = estimateDescriptorPoolSize(poolSizes);
+            trackMemory(MemoryCategory::eDescriptor, static_cast<int64_t>(estimatedSize));
+
+            // Keeps the regular pool (m_LastPoolIndex) current, this one is full after a single set.
+            ++m_Stats.numPoolsCreated;
+            return m_DescriptorPools.emplace_back(DescriptorPool {
+                .handle          = createDescriptorPool(m_Device, 1, poolSizes),
+                .maxSets         = 1,
+                .generation      = generation,
+                .estimatedSize   = estimatedSize,
+                .dedicatedLayout = descriptorSetLayout,
+            });
+        }
+
         vk::DescriptorSet DescriptorSetAllocator::allocate(DescriptorPool&               descriptorPool,
                                                            const vk::DescriptorSetLayout descriptorSetLayout,
-                                                           uint32_t                      variableDescriptorCount) const
+                                                           uint32_t                      variableDescriptorCount)
         {
             vk::DescriptorSetVariableDescriptorCountAllocateInfo countInfo {};
             countInfo.descriptorSetCount = 1;
@@ -170,8 +360,11 @@ namespace vultra
             switch (result)
             {
                 case vk::Result::eSuccess:
+                    break;
                 case vk::Result::eErrorOutOfPoolMemory:
                 case vk::Result::eErrorFragmentedPool:
+                    descriptorPool.exhausted = true;
+                    ++m_Stats.numFailedAllocations;
                     break;
 
                 default:
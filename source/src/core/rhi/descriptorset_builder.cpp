@@ -2,7 +2,8 @@
 #include "vultra/core/base/hash.hpp"
 #include "vultra/core/base/visitor_helper.hpp"
 #include "vultra/core/rhi/buffer.hpp"
-#include "vultra/core/rhi/descriptorset_allocator.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/descriptorset_cache.hpp"
 #include "vultra/core/rhi/raytracing/acceleration_structure.hpp"
 #include "vultra/core/rhi/texture.hpp"
 
@@ -19,6 +20,21 @@ namespace std
     {
         size_t operator()(const vk::Buffer& buffer) const noexcept { return hash<VkBuffer>()(buffer); }
     };
+
+    template<>
+    struct hash<vk::Sampler>
+    {
+        size_t operator()(const vk::Sampler& sampler) const noexcept { return hash<VkSampler>()(sampler); }
+    };
+
+    template<>
+    struct hash<vk::AccelerationStructureKHR>
+    {
+        size_t operator()(const vk::AccelerationStructureKHR& as) const noexcept
+        {
+            return hash<VkAccelerationStructureKHR>()(as);
+        }
+    };
 } // namespace std
 
 namespace vultra
@@ -44,15 +60,13 @@ namespace vultra
 
         } // namespace
 #endif
-        DescriptorSetBuilder::DescriptorSetBuilder(const vk::Device        device,
-                                                   DescriptorSetAllocator& allocator,
-                                                   DescriptorSetCache&     cache) :
-            m_Device(device), m_DescriptorSetAllocator(allocator), m_DescriptorSetCache(cache)
+        DescriptorSetBuilder::DescriptorSetBuilder(DescriptorSetCache& cache) : m_DescriptorSetCache(cache)
         {
-            m_Bindings.reserve(10);
             m_ImageInfos.reserve(10);
             m_BufferInfos.reserve(10);
-            m_ASInfos.reserve(2);
+            m_AccelerationStructures.reserve(2);
+            m_TemplateEntries.reserve(10);
+            m_TemplateData.reserve(10 * sizeof(vk::DescriptorImageInfo));
         }
 
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex index, const ResourceBinding& r)
@@ -71,8 +85,10 @@ namespace vultra
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex                    index,
                                                          const bindings::CombinedImageSampler& info)
         {
-            m_Bindings[index] = {
-                vk::DescriptorType::eCombinedImageSampler, 1, static_cast<int32_t>(m_ImageInfos.size())};
+            m_Bindings[index]  = {vk::DescriptorType::eCombinedImageSampler,
+                                  1,
+                                  static_cast<int32_t>(m_ImageInfos.size()),
+                                  std::hash<uint64_t> {}(info.texture->getId())};
             const auto sampler = info.sampler.value_or(info.texture->getSampler());
             assert(sampler != VK_NULL_HANDLE);
             const auto imageLayout = info.texture->getImageLayout();
@@ -88,10 +104,13 @@ namespace vultra
         {
             const auto numImages = static_cast<uint32_t>(info.textures.size());
             assert(numImages > 0);
-            m_Bindings[index] = {
+            auto& binding = m_Bindings[index];
+            binding       = {
                 vk::DescriptorType::eCombinedImageSampler, numImages, static_cast<int32_t>(m_ImageInfos.size())};
             for (const auto* texture : info.textures)
             {
+                hashCombine(binding.resourceHash, texture->getId());
+
                 const auto imageLayout = texture->getImageLayout();
                 assert(imageLayout != ImageLayout::eUndefined);
                 const auto sampler = info.sampler.value_or(texture->getSampler());
@@ -104,7 +123,10 @@ namespace vultra
 
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex index, const bindings::SampledImage& info)
         {
-            m_Bindings[index] = {vk::DescriptorType::eSampledImage, 1, static_cast<int32_t>(m_ImageInfos.size())};
+            m_Bindings[index] = {vk::DescriptorType::eSampledImage,
+                                 1,
+                                 static_cast<int32_t>(m_ImageInfos.size()),
+                                 std::hash<uint64_t> {}(info.texture->getId())};
             addImage(info.texture->getImageView(toVk(info.imageAspect)),
                      static_cast<vk::ImageLayout>(info.texture->getImageLayout()));
             return *this;
@@ -113,10 +135,12 @@ namespace vultra
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex index, const bindings::StorageImage& info)
         {
             const auto numImages = info.mipLevel ? 1 : info.texture->getNumMipLevels();
-            m_Bindings[index]    = {
-                vk::DescriptorType::eStorageImage, numImages, static_cast<int32_t>(m_ImageInfos.size())};
+            m_Bindings[index]    = {vk::DescriptorType::eStorageImage,
+                                    numImages,
+                                    static_cast<int32_t>(m_ImageInfos.size()),
+                                    std::hash<uint64_t> {}(info.texture->getId())};
             for (uint32_t i = 0; i < numImages; ++i)
-                addImage(info.texture->getMipLevel(i, toVk(info.imageAspect)),
+                addImage(info.texture->getMipLevel(info.mipLevel.value_or(i), toVk(info.imageAspect)),
                          static_cast<vk::ImageLayout>(info.texture->getImageLayout()));
             return *this;
         }
@@ -125,94 +149,113 @@ namespace vultra
         {
             return bindBuffer(index,
                               vk::DescriptorType::eUniformBuffer,
-                              {info.buffer->getHandle(), info.offset, info.range.value_or(vk::WholeSize)});
+                              {info.buffer->getHandle(), info.offset, info.range.value_or(vk::WholeSize)},
+                              info.buffer->getId());
         }
 
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex index, const bindings::StorageBuffer& info)
         {
             return bindBuffer(index,
                               vk::DescriptorType::eStorageBuffer,
-                              {info.buffer->getHandle(), info.offset, info.range.value_or(vk::WholeSize)});
+                              {info.buffer->getHandle(), info.offset, info.range.value_or(vk::WholeSize)},
+                              info.buffer->getId());
         }
 
         DescriptorSetBuilder& DescriptorSetBuilder::bind(const BindingIndex                        index,
                                                          const bindings::AccelerationStructureKHR& info)
         {
-            m_Bindings[index] = {
-                vk::DescriptorType::eAccelerationStructureKHR, 1, static_cast<int32_t>(m_ASInfos.size())};
+            m_Bindings[index] = {vk::DescriptorType::eAccelerationStructureKHR,
+                                 1,
+                                 static_cast<int32_t>(m_AccelerationStructures.size()),
+                                 std::hash<uint64_t> {}(info.as->getId())};
             addAccelerationStructure(info.as->getHandle());
             return *this;
         }
 
         vk::DescriptorSet DescriptorSetBuilder::build(const vk::DescriptorSetLayout layout)
         {
-            auto                                hash = std::bit_cast<std::size_t>(layout);
-            std::vector<vk::WriteDescriptorSet> writes;
-            writes.reserve(m_Bindings.size());
+            // The hash covers every descriptor (not just the first one of an array), as the set outlives this frame.
+            auto       hash                    = std::bit_cast<std::size_t>(layout);
+            const auto variableDescriptorCount = pack(&hash);
 
-            for (auto& [idx, binding] : m_Bindings)
+            const auto set =
+                m_DescriptorSetCache.get(hash, layout, variableDescriptorCount, m_TemplateEntries, m_TemplateData);
+
+            clear();
+            return set;
+        }
+
+        void DescriptorSetBuilder::push(CommandBuffer& cb, const DescriptorSetIndex index)
+        {
+            // A push descriptor set has no variable-sized binding (see RenderDevice::createPipelineLayout).
+            pack(nullptr);
+            cb.pushDescriptorSet(index, m_TemplateEntries, m_TemplateData.data());
+            clear();
+        }
+
+        uint32_t DescriptorSetBuilder::pack(std::size_t* hash)
+        {
+            m_TemplateEntries.clear();
+            m_TemplateData.clear();
+
+            uint32_t variableDescriptorCount = 0;
+            for (const auto& [idx, binding] : m_Bindings)
             {
-                vk::WriteDescriptorSet record {};
-                record.dstBinding      = idx;
-                record.descriptorCount = binding.count;
-                record.descriptorType  = binding.type;
+                if (hash)
+                    hashCombine(*hash, idx, binding.type, binding.count, binding.resourceHash);
 
+                const void* descriptors {nullptr};
+                std::size_t stride {0};
                 switch (binding.type)
                 {
                     case vk::DescriptorType::eSampler:
                     case vk::DescriptorType::eCombinedImageSampler:
                     case vk::DescriptorType::eSampledImage:
                     case vk::DescriptorType::eStorageImage:
-                        record.pImageInfo = &m_ImageInfos[binding.descriptorId];
-                        hashCombine(hash, record.pImageInfo->imageView);
+                        descriptors = &m_ImageInfos[binding.descriptorId];
+                        stride      = sizeof(vk::DescriptorImageInfo);
+                        for (const auto& info : std::span {&m_ImageInfos[binding.descriptorId], binding.count})
+                        {
+                            if (!hash)
+                                break;
+                            hashCombine(*hash, info.sampler, info.imageView, info.imageLayout);
+                        }
                         break;
 
                     case vk::DescriptorType::eUniformBuffer:
                     case vk::DescriptorType::eStorageBuffer:
-                        record.pBufferInfo = &m_BufferInfos[binding.descriptorId];
-                        hashCombine(
-                            hash, record.pBufferInfo->offset, record.pBufferInfo->range, record.pBufferInfo->buffer);
+                        descriptors = &m_BufferInfos[binding.descriptorId];
+                        stride      = sizeof(vk::DescriptorBufferInfo);
+                        for (const auto& info : std::span {&m_BufferInfos[binding.descriptorId], binding.count})
+                        {
+                            if (!hash)
+                                break;
+                            hashCombine(*hash, info.buffer, info.offset, info.range);
+                        }
                         break;
 
                     case vk::DescriptorType::eAccelerationStructureKHR:
-                        record.pNext = &m_ASInfos[binding.descriptorId];
-                        hashCombine(
-                            hash,
-                            reinterpret_cast<const vk::WriteDescriptorSetAccelerationStructureKHR*>(record.pNext)
-                                ->pAccelerationStructures);
+                        descriptors = &m_AccelerationStructures[binding.descriptorId];
+                        stride      = sizeof(vk::AccelerationStructureKHR);
+                        if (hash)
+                            hashCombine(*hash, m_AccelerationStructures[binding.descriptorId]);
                         break;
 
                     default:
                         assert(false);
                 }
-                writes.emplace_back(record);
-            }
 
-            vk::DescriptorSet set;
-            if (auto it = m_DescriptorSetCache.find(hash); it != m_DescriptorSetCache.end())
-            {
-                set = it->second;
-            }
-            else
-            {
-                uint32_t variableDescriptorCount = 0;
-                for (const auto& [_, binding] : m_Bindings)
+                m_TemplateEntries.emplace_back(idx, 0, binding.count, binding.type, m_TemplateData.size(), stride);
+                const auto* bytes = static_cast<const std::byte*>(descriptors);
+                m_TemplateData.insert(m_TemplateData.end(), bytes, bytes + stride * binding.count);
+
+                if (binding.type == vk::DescriptorType::eCombinedImageSampler && binding.count > 1 &&
+                    variableDescriptorCount == 0)
                 {
-                    if (binding.type == vk::DescriptorType::eCombinedImageSampler && binding.count > 1)
-                    {
-                        variableDescriptorCount = binding.count;
-                        break;
-                    }
+                    variableDescriptorCount = binding.count;
                 }
-                set = m_DescriptorSetAllocator.allocate(layout, variableDescriptorCount);
-                for (auto& r : writes)
-                    r.dstSet = set;
-                m_Device.updateDescriptorSets(static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
-                m_DescriptorSetCache.emplace(hash, set);
             }
-
-            clear();
-            return set;
+            return variableDescriptorCount;
         }
 
         void DescriptorSetBuilder::clear()
@@ -220,7 +263,6 @@ namespace vultra
             m_Bindings.clear();
             m_ImageInfos.clear();
             m_BufferInfos.clear();
-            m_ASInfos.clear();
             m_AccelerationStructures.clear();
         }
 
@@ -244,17 +286,15 @@ namespace vultra
         void DescriptorSetBuilder::addAccelerationStructure(const vk::AccelerationStructureKHR& as)
         {
             m_AccelerationStructures.push_back(as);
-            vk::WriteDescriptorSetAccelerationStructureKHR info {};
-            info.accelerationStructureCount = 1;
-            info.pAccelerationStructures    = &m_AccelerationStructures.back();
-            m_ASInfos.emplace_back(info);
         }
 
         DescriptorSetBuilder& DescriptorSetBuilder::bindBuffer(const BindingIndex         index,
                                                                const vk::DescriptorType   type,
-                                                               vk::DescriptorBufferInfo&& buf)
+                                                               vk::DescriptorBufferInfo&& buf,
+                                                               const uint64_t             resourceId)
         {
-            m_Bindings[index] = {type, 1, static_cast<int32_t>(m_BufferInfos.size())};
+            m_Bindings[index] = {
+                type, 1, static_cast<int32_t>(m_BufferInfos.size()), std::hash<uint64_t> {}(resourceId)};
             m_BufferInfos.emplace_back(std::move(buf));
             return *this;
         }
@@ -0,0 +1,255 @@
+#include "vultra/core/rhi/descriptorset_cache.hpp"
+#include "vultra/core/base/hash.hpp"
+#include "vultra/core/rhi/vk/macro.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            template<typename T>
+            [[nodiscard]] bool equalDescriptor(const std::byte* lhs, const std::byte* rhs)
+            {
+                T a {}, b {};
+                std::memcpy(&a, lhs, sizeof(T));
+                std::memcpy(&b, rhs, sizeof(T));
+                return a == b;
+            }
+
+            // Member-wise, the packed descriptors have padding.
+            [[nodiscard]] bool equalData(std::span<const vk::DescriptorUpdateTemplateEntry> entries,
+                                         std::span<const std::byte>                         lhs,
+                                         std::span<const std::byte>                         rhs)
+            {
+                if (lhs.size() != rhs.size())
+                    return false;
+
+                for (const auto& entry : entries)
+                {
+                    for (auto i = 0u; i < entry.descriptorCount; ++i)
+                    {
+                        const auto  offset = entry.offset + i * entry.stride;
+                        const auto* a      = lhs.data() + offset;
+                        const auto* b      = rhs.data() + offset;
+
+                        bool equal {false};
+                        switch (entry.descriptorType)
+                        {
+                            case vk::DescriptorType::eSampler:
+                            case vk::DescriptorType::eCombinedImageSampler:
+                            case vk::DescriptorType::eSampledImage:
+                            case vk::DescriptorType::eStorageImage:
+                                equal = equalDescriptor<vk::DescriptorImageInfo>(a, b);
+                                break;
+
+                            case vk::DescriptorType::eUniformBuffer:
+                            case vk::DescriptorType::eStorageBuffer:
+                                equal = equalDescriptor<vk::DescriptorBufferInfo>(a, b);
+                                break;
+
+                            default:
+                                equal = std::memcmp(a, b, entry.stride) == 0;
+                        }
+                        if (!equal)
+                            return false;
+                    }
+                }
+                return true;
+            }
+
+            [[nodiscard]] bool matches(const auto&                                        entry,
+                                       const vk::DescriptorSetLayout                      layout,
+                                       std::span<const vk::DescriptorUpdateTemplateEntry> templateEntries,
+                                       std::span<const std::byte>                         data)
+            {
+                return entry.layout == layout && std::ranges::equal(entry.templateEntries, templateEntries) &&
+                       equalData(templateEntries, entry.data, data);
+            }
+        } // namespace
+
+        const uint32_t DescriptorSetCache::s_kFramesPerGeneration = 64u;
+
+        DescriptorSetCache::~DescriptorSetCache()
+        {
+            for (auto [_, updateTemplate] : m_UpdateTemplates)
+            {
+                m_Device.destroyDescriptorUpdateTemplate(updateTemplate);
+            }
+        }
+
+        vk::DescriptorSet DescriptorSetCache::get(const std::size_t             hash,
+                                                  const vk::DescriptorSetLayout layout,
+                                                  const uint32_t                variableDescriptorCount,
+                                                  std::span<const vk::DescriptorUpdateTemplateEntry> entries,
+                                                  std::span<const std::byte>                         data)
+        {
+            uint32_t generation {0};
+            bool     hit {false};
+            {
+                std::shared_lock lock {m_Mutex};
+
+                generation = m_CurrentGeneration;
+                if (const auto it = m_DescriptorSets.find(hash); it != m_DescriptorSets.cend())
+                {
+                    hit = matches(it->second, layout, entries, data);
+                    if (hit && it->second.generation == generation)
+                    {
+                        ++m_NumHits;
+                        return it->second.descriptorSet;
+                    }
+                }
+            }
+            ++(hit ? m_NumHits : m_NumMisses);
+
+            // A set of the older generation is left untouched (the GPU might still use it), its copy goes to the
+            // current one.
+            vk::DescriptorUpdateTemplateCreateInfo createInfo {};
+            createInfo.templateType        = vk::DescriptorUpdateTemplateType::eDescriptorSet;
+            createInfo.descriptorSetLayout = layout;
+
+            vk::DescriptorSet descriptorSet {nullptr};
+            {
+                std::lock_guard lock {m_AllocatorMutexes[generation]};
+                descriptorSet = m_Allocators[generation].allocate(layout, variableDescriptorCount);
+            }
+            m_Device.updateDescriptorSetWithTemplate(
+                descriptorSet, getUpdateTemplate(createInfo, entries), data.data());
+
+            std::unique_lock lock {m_Mutex};
+
+            auto& entry = m_DescriptorSets[hash];
+            if (entry.descriptorSet && matches(entry, layout, entries, data))
+            {
+                // Another thread might have written the same set meanwhile, ours then stays unused in the allocator
+                // until its generation is reset.
+                if (entry.generation != generation)
+                {
+                    entry.descriptorSet = descriptorSet;
+                    entry.generation    = generation;
+                }
+                return entry.descriptorSet;
+            }
+
+            // On a collision the other set is dropped from the cache (not from its allocator, it might still be in
+            // use), whichever key comes next will be written again.
+            entry = Entry {
+                .descriptorSet   = descriptorSet,
+                .generation      = generation,
+                .layout          = layout,
+                .templateEntries = {entries.begin(), entries.end()},
+                .data            = {data.begin(), data.end()},
+            };
+            return descriptorSet;
+        }
+
+        vk::DescriptorUpdateTemplate
+        DescriptorSetCache::getPushTemplate(const vk::PipelineBindPoint                        bindPoint,
+                                            const vk::PipelineLayout                           pipelineLayout,
+                                            const DescriptorSetIndex                           set,
+                                            std::span<const vk::DescriptorUpdateTemplateEntry> entries)
+        {
+            vk::DescriptorUpdateTemplateCreateInfo createInfo {};
+            createInfo.templateType      = vk::DescriptorUpdateTemplateType::ePushDescriptorsKHR;
+            createInfo.pipelineBindPoint = bindPoint;
+            createInfo.pipelineLayout    = pipelineLayout;
+            createInfo.set               = set;
+            return getUpdateTemplate(createInfo, entries);
+        }
+
+        void DescriptorSetCache::nextFrame()
+        {
+            std::unique_lock lock {m_Mutex};
+
+            m_LastFrameStats.numHits   = m_NumHits.exchange(0);
+            m_LastFrameStats.numMisses = m_NumMisses.exchange(0);
+
+            if (++m_NumFrames < s_kFramesPerGeneration)
+                return;
+
+            // Every set that is still in the older generation has not been used for s_kFramesPerGeneration frames.
+            const auto olderGeneration = m_CurrentGeneration ^ 1u;
+            std::erase_if(m_DescriptorSets,
+                          [olderGeneration](const auto& p) { return p.second.generation == olderGeneration; });
+            {
+                std::lock_guard allocatorLock {m_AllocatorMutexes[olderGeneration]};
+                m_Allocators[olderGeneration].reset();
+            }
+
+            m_CurrentGeneration = olderGeneration;
+            m_NumFrames         = 0;
+        }
+
+        DescriptorSetCache::Stats DescriptorSetCache::getStats() const
+        {
+            std::shared_lock lock {m_Mutex};
+
+            auto stats    = m_LastFrameStats;
+            stats.numSets = static_cast<uint32_t>(m_DescriptorSets.size());
+            for (auto i = 0u; i < m_Allocators.size(); ++i)
+            {
+                std::lock_guard allocatorLock {m_AllocatorMutexes[i]};
+                const auto      allocatorStats = m_Allocators[i].getStats();
+                stats.numPools += allocatorStats.numPools;
+                stats.numFailedAllocations += allocatorStats.numFailedAllocations;
+            }
+            return stats;
+        }
+
+        DescriptorSetCache::DescriptorSetCache(const vk::Device           device,
+                                               const DescriptorPoolSizer* poolSizer,
+                                               const bool                 raytracing) :
+            m_Device(device)
+        {
+            assert(device);
+
+            m_DescriptorSets.reserve(1000);
+            for (auto& allocator : m_Allocators)
+            {
+                allocator = DescriptorSetAllocator {device, poolSizer, raytracing};
+            }
+        }
+
+        vk::DescriptorUpdateTemplate
+        DescriptorSetCache::getUpdateTemplate(vk::DescriptorUpdateTemplateCreateInfo             createInfo,
+                                              std::span<const vk::DescriptorUpdateTemplateEntry> entries)
+        {
+            std::size_t hash {0};
+            hashCombine(hash,
+                        createInfo.templateType,
+                        std::bit_cast<std::size_t>(createInfo.descriptorSetLayout),
+                        createInfo.pipelineBindPoint,
+                        std::bit_cast<std::size_t>(createInfo.pipelineLayout),
+                        createInfo.set);
+            for (const auto& entry : entries)
+            {
+                hashCombine(hash,
+                            entry.dstBinding,
+                            entry.dstArrayElement,
+                            entry.descriptorCount,
+                            entry.descriptorType,
+                            entry.offset,
+                            entry.stride);
+            }
+
+            std::lock_guard lock {m_TemplateMutex};
+            if (const auto it = m_UpdateTemplates.find(hash); it != m_UpdateTemplates.cend())
+                return it->second;
+
+            createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+            createInfo.pDescriptorUpdateEntries   = entries.data();
+
+            vk::DescriptorUpdateTemplate updateTemplate {nullptr};
+            VK_CHECK(m_Device.createDescriptorUpdateTemplate(&createInfo, nullptr, &updateTemplate),
+                     "DescriptorSetCache",
+                     "Failed to create descriptor update template");
+
+            m_UpdateTemplates.emplace(hash, updateTemplate);
+            return updateTemplate;
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
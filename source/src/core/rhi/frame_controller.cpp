@@ -16,9 +16,19 @@ namespace vultra
             create(numFramesInFlight);
         }
 
+        FrameController::FrameController(RenderDevice&               rd,
+                                         const Extent2D              extent,
+                                         const PixelFormat           pixelFormat,
+                                         const FrameIndex::ValueType numFramesInFlight) :
+            m_RenderDevice(&rd), m_FrameIndex(numFramesInFlight)
+        {
+            create(numFramesInFlight);
+            createTargets(extent, pixelFormat);
+        }
+
         FrameController::FrameController(FrameController&& other) noexcept :
             m_RenderDevice(other.m_RenderDevice), m_Swapchain(other.m_Swapchain), m_Frames(std::move(other.m_Frames)),
-            m_FrameIndex(other.m_FrameIndex)
+            m_FrameIndex(other.m_FrameIndex), m_Targets(std::move(other.m_Targets))
         {
             other.m_RenderDevice = nullptr;
             other.m_Swapchain    = nullptr;
@@ -37,12 +47,20 @@ namespace vultra
                 std::swap(m_Swapchain, rhs.m_Swapchain);
                 std::swap(m_Frames, rhs.m_Frames);
                 std::swap(m_FrameIndex, rhs.m_FrameIndex);
+                std::swap(m_Targets, rhs.m_Targets);
             }
 
             return *this;
         }
 
-        FrameController::operator bool() const { return m_Swapchain != nullptr && *m_Swapchain && !m_Frames.empty(); }
+        FrameController::operator bool() const
+        {
+            if (m_Frames.empty())
+                return false;
+            return isOffscreen() ? !m_Targets.empty() : m_Swapchain != nullptr && *m_Swapchain;
+        }
+
+        bool FrameController::isOffscreen() const { return m_Swapchain == nullptr && m_RenderDevice != nullptr; }
 
         FrameIndex::ValueType FrameController::size() const
         {
@@ -51,6 +69,14 @@ namespace vultra
 
         RenderTargetView FrameController::getCurrentTarget() const
         {
+            if (isOffscreen())
+            {
+                return {
+                    m_FrameIndex,
+                    *m_Targets[m_FrameIndex],
+                };
+            }
+
             assert(m_Swapchain);
 
             return {
@@ -59,9 +85,33 @@ namespace vultra
             };
         }
 
-        CommandBuffer& FrameController::beginFrame()
+        Extent2D FrameController::getExtent() const
         {
+            if (isOffscreen())
+                return m_Targets.front()->getExtent();
+
+            assert(m_Swapchain);
+            return m_Swapchain->getExtent();
+        }
+
+        PixelFormat FrameController::getPixelFormat() const
+        {
+            if (isOffscreen())
+                return m_Targets.front()->getPixelFormat();
+
             assert(m_Swapchain);
+            return m_Swapchain->getPixelFormat();
+        }
+
+        const Texture& FrameController::getPreviousTarget() const
+        {
+            assert(isOffscreen());
+            return *m_Targets[m_FrameIndex.getPreviousIndex()];
+        }
+
+        CommandBuffer& FrameController::beginFrame()
+        {
+            assert(m_RenderDevice);
             assert(m_ImageAcquireAttempted);
             ZoneScopedN("RHI::BeginFrame");
 
@@ -78,23 +128,49 @@ namespace vultra
 
         bool FrameController::acquireNextFrame()
         {
-            assert(m_Swapchain);
+            assert(m_RenderDevice);
             ZoneScopedN("RHI::AcquireNextFrame");
 
             auto& [cb, imageAcquired, _] = m_Frames[m_FrameIndex];
             cb.reset();
+            // The GPU is done with the frame that used this slot (and every frame before it).
+            m_RenderDevice->getDeletionQueue().nextFrame(size());
+            m_RenderDevice->getDescriptorSetCache().nextFrame();
+            m_RenderDevice->updateMemoryStats();
 
-            m_ImageAcquired         = m_Swapchain->acquireNextImage(imageAcquired);
+            // The owned target of this slot is free as soon as the command buffer above has retired.
+            m_ImageAcquired         = isOffscreen() || m_Swapchain->acquireNextImage(imageAcquired);
             m_ImageAcquireAttempted = true;
             return m_ImageAcquired;
         }
 
         FrameController& FrameController::endFrame()
         {
-            assert(m_Swapchain);
+            assert(m_RenderDevice);
             ZoneScopedN("RHI::EndFrame");
 
             auto& [cb, imageAcquired, renderCompleted] = m_Frames[m_FrameIndex];
+            if (isOffscreen())
+            {
+                // Nothing to present, leave the target ready to be copied out (e.g. saveTextureToFile).
+                cb.getBarrierBuilder().imageBarrier(
+                    {
+                        .image            = *m_Targets[m_FrameIndex],
+                        .newLayout        = ImageLayout::eTransferSrc,
+                        .subresourceRange = VkImageSubresourceRange {.levelCount = 1, .layerCount = 1},
+                    },
+                    {
+                        .stageMask  = PipelineStages::eBottom,
+                        .accessMask = Access::eNone,
+                    });
+                m_RenderDevice->execute(cb, JobInfo {});
+
+                m_ImageAcquired         = false;
+                m_ImageAcquireAttempted = false;
+
+                return *this;
+            }
+
             cb.getBarrierBuilder().imageBarrier(
                 {
                     .image            = m_Swapchain->getCurrentBuffer(),
@@ -121,13 +197,37 @@ namespace vultra
 
         void FrameController::present()
         {
-            assert(m_Swapchain);
-            auto& currentFrame = m_Frames[m_FrameIndex];
-            m_RenderDevice->present(*m_Swapchain, currentFrame.renderCompleted);
+            assert(m_RenderDevice);
+            if (!isOffscreen())
+            {
+                auto& currentFrame = m_Frames[m_FrameIndex];
+                m_RenderDevice->present(*m_Swapchain, currentFrame.renderCompleted);
+            }
             ++m_FrameIndex;
         }
 
-        void FrameController::recreate() { m_Swapchain->recreate(); }
+        void FrameController::recreate()
+        {
+            if (m_Swapchain)
+                m_Swapchain->recreate();
+        }
+
+        void FrameController::resize(const Extent2D extent)
+        {
+            assert(isOffscreen());
+            if (extent == getExtent())
+                return;
+
+            // The frames in flight might still render into (or copy from) the old targets.
+            const auto pixelFormat   = getPixelFormat();
+            auto&      deletionQueue = m_RenderDevice->getDeletionQueue();
+            for (auto& target : m_Targets)
+            {
+                deletionQueue.push(std::move(target));
+            }
+            m_Targets.clear();
+            createTargets(extent, pixelFormat);
+        }
 
         void FrameController::create(const FrameIndex::ValueType numFramesInFlight)
         {
@@ -142,6 +242,27 @@ namespace vultra
             VULTRA_CORE_TRACE("[FrameController] Created with {} frames in flight", numFramesInFlight);
         }
 
+        void FrameController::createTargets(const Extent2D extent, const PixelFormat pixelFormat)
+        {
+            assert(extent && pixelFormat != PixelFormat::eUndefined);
+
+            m_Targets.reserve(m_Frames.size());
+            std::generate_n(std::back_inserter(m_Targets), m_Frames.size(), [&] {
+                return createScope<Texture>(Texture::Builder {}
+                                                .setExtent(extent)
+                                                .setPixelFormat(pixelFormat)
+                                                .setNumMipLevels(1)
+                                                .setUsageFlags(ImageUsage::eRenderTarget | ImageUsage::eSampled |
+                                                               ImageUsage::eTransferSrc)
+                                                .setupOptimalSampler(true)
+                                                .build(*m_RenderDevice));
+            });
+            VULTRA_CORE_TRACE("[FrameController] Created {} offscreen targets ({}x{})",
+                              m_Targets.size(),
+                              extent.width,
+                              extent.height);
+        }
+
         void FrameController::destroy() noexcept
         {
             if (!m_RenderDevice)
@@ -153,6 +274,7 @@ namespace vultra
                 m_RenderDevice->destroy(f.imageAcquired).destroy(f.renderCompleted);
             }
             m_Frames.clear();
+            m_Targets.clear();
 
             m_Swapchain    = nullptr;
             m_RenderDevice = nullptr;
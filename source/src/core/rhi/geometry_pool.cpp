@@ -0,0 +1,392 @@
+#include "vultra/core/rhi/geometry_pool.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            [[nodiscard]] constexpr auto toIndex(const GeometryRegion region) { return static_cast<uint32_t>(region); }
+
+            [[nodiscard]] float getOccupancy(const GeometryPage& page)
+            {
+                return static_cast<float>(page.allocator.getUsedSize()) /
+                       static_cast<float>(page.allocator.getCapacity());
+            }
+        } // namespace
+
+        //
+        // GeometryAllocation class:
+        //
+
+        GeometryAllocation::~GeometryAllocation() { m_Pool->release(*this); }
+
+        GeometryRegion GeometryAllocation::getRegion() const { return m_Page->region; }
+
+        vk::DeviceSize GeometryAllocation::getOffset() const { return m_Offset; }
+
+        vk::DeviceSize GeometryAllocation::getSize() const { return m_Size; }
+
+        const Buffer& GeometryAllocation::getBuffer() const { return *m_Page->buffer; }
+
+        const VertexBuffer& GeometryAllocation::getVertexBuffer() const
+        {
+            assert(getRegion() == GeometryRegion::eVertex);
+            return static_cast<const VertexBuffer&>(*m_Page->buffer);
+        }
+
+        const IndexBuffer& GeometryAllocation::getIndexBuffer() const
+        {
+            assert(getRegion() == GeometryRegion::eIndex);
+            return static_cast<const IndexBuffer&>(*m_Page->buffer);
+        }
+
+        uint64_t GeometryAllocation::getDeviceAddress(const bool relocatable) const
+        {
+            std::lock_guard lock {m_Pool->m_Mutex};
+
+            if (!m_Page->deviceAddress)
+                return 0;
+
+            m_Pinned |= !relocatable;
+            return m_Page->deviceAddress + m_Offset;
+        }
+
+        uint32_t GeometryAllocation::getVersion() const { return m_Version; }
+
+        GeometryAllocation::GeometryAllocation(GeometryPool&        pool,
+                                               GeometryPage&        page,
+                                               const vk::DeviceSize offset,
+                                               const vk::DeviceSize size,
+                                               const vk::DeviceSize alignment) :
+            m_Pool(&pool), m_Page(&page), m_Offset(offset), m_Size(size), m_Alignment(alignment)
+        {}
+
+        //
+        // GeometryPool class:
+        //
+
+        // Returns a released range to its page, once the frames that might still read it are done.
+        class GeometryPool::PendingFree final
+        {
+        public:
+            PendingFree(GeometryPool&        pool,
+                        GeometryPage&        page,
+                        const vk::DeviceSize offset,
+                        const vk::DeviceSize size) :
+                m_Pool(&pool), m_Page(&page), m_Offset(offset), m_Size(size)
+            {}
+            PendingFree(const PendingFree&) = delete;
+            PendingFree(PendingFree&& other) noexcept :
+                m_Pool(std::exchange(other.m_Pool, nullptr)), m_Page(other.m_Page), m_Offset(other.m_Offset),
+                m_Size(other.m_Size)
+            {}
+            ~PendingFree()
+            {
+                if (m_Pool)
+                {
+                    m_Pool->free(*m_Page, m_Offset, m_Size);
+                }
+            }
+
+            PendingFree& operator=(const PendingFree&)     = delete;
+            PendingFree& operator=(PendingFree&&) noexcept = delete;
+
+        private:
+            GeometryPool*  m_Pool {nullptr};
+            GeometryPage*  m_Page {nullptr};
+            vk::DeviceSize m_Offset {0};
+            vk::DeviceSize m_Size {0};
+        };
+
+        const std::array<vk::DeviceSize, 3> GeometryPool::s_kPageSizes = {
+            64u << 20, // eVertex
+            32u << 20, // eIndex
+            32u << 20, // eMeshlet
+        };
+
+        GeometryPool::GeometryPool(RenderDevice& rd) : m_RenderDevice(rd) {}
+
+        GeometryPool::~GeometryPool()
+        {
+#ifndef NDEBUG
+            for (const auto& pages : m_Pages)
+            {
+                for (const auto& page : pages)
+                {
+                    assert(page->allocations.empty() && "GeometryAllocation outlives its pool");
+                }
+            }
+#endif
+        }
+
+        Ref<GeometryAllocation>
+        GeometryPool::allocate(const GeometryRegion region, const vk::DeviceSize size, const vk::DeviceSize alignment)
+        {
+            assert(size > 0 && alignment > 0);
+
+            std::lock_guard lock {m_Mutex};
+
+            auto tryAllocate = [&](GeometryPage& page) -> Ref<GeometryAllocation> {
+                if (page.retired)
+                    return nullptr;
+
+                const auto offset = page.allocator.allocate(size, alignment);
+                if (!offset)
+                    return nullptr;
+
+                Ref<GeometryAllocation> allocation {new GeometryAllocation {*this, page, *offset, size, alignment}};
+                page.allocations.insert(allocation.get());
+                return allocation;
+            };
+
+            for (auto& page : m_Pages[toIndex(region)])
+            {
+                if (auto allocation = tryAllocate(*page))
+                    return allocation;
+            }
+
+            auto allocation = tryAllocate(createPage(region, std::max(s_kPageSizes[toIndex(region)], size)));
+            assert(allocation);
+            return allocation;
+        }
+
+        GeometryPool& GeometryPool::upload(std::span<const Upload> uploads)
+        {
+            ZoneScopedN("GeometryPool::Upload");
+
+            vk::DeviceSize totalSize {0};
+            for (const auto& upload : uploads)
+            {
+                assert(upload.allocation && upload.offset + upload.size <= upload.allocation->getSize());
+                totalSize += upload.size;
+            }
+            if (totalSize == 0)
+                return *this;
+
+            auto  stagingBuffer = m_RenderDevice.createStagingBuffer(totalSize);
+            auto* mappedPtr     = static_cast<std::byte*>(stagingBuffer.map());
+
+            std::lock_guard lock {m_Mutex};
+
+            std::vector<std::pair<Buffer*, vk::BufferCopy>> copies;
+            copies.reserve(uploads.size());
+
+            vk::DeviceSize stagingOffset {0};
+            for (const auto& upload : uploads)
+            {
+                if (upload.size == 0)
+                    continue;
+
+                std::memcpy(mappedPtr + stagingOffset, upload.data, upload.size);
+
+                const auto& allocation = *upload.allocation;
+                copies.emplace_back(allocation.m_Page->buffer.get(),
+                                    vk::BufferCopy {stagingOffset, allocation.m_Offset + upload.offset, upload.size});
+                stagingOffset += upload.size;
+            }
+            stagingBuffer.unmap();
+
+            m_RenderDevice.execute(
+                [&](CommandBuffer& cb) {
+                    for (auto& [dst, copy] : copies)
+                    {
+                        cb.copyBuffer(stagingBuffer, *dst, copy);
+                    }
+                },
+                true);
+
+            return *this;
+        }
+
+        uint32_t GeometryPool::defragment(const float maxOccupancy)
+        {
+            ZoneScopedN("GeometryPool::Defragment");
+
+            std::lock_guard lock {m_Mutex};
+
+            struct Move
+            {
+                GeometryAllocation* allocation {nullptr};
+                GeometryPage*       dst {nullptr};
+                vk::DeviceSize      dstOffset {0};
+            };
+            std::vector<Move> moves;
+
+            for (auto& pages : m_Pages)
+            {
+                std::vector<GeometryPage*> sources;
+                std::vector<GeometryPage*> targets;
+                for (auto& page : pages)
+                {
+                    if (page->retired)
+                        continue;
+                    (getOccupancy(*page) <= maxOccupancy ? sources : targets).push_back(page.get());
+                }
+                // Sparsest pages are emptied first, into the fullest ones.
+                std::ranges::sort(
+                    sources, {}, [](const GeometryPage* page) { return page->allocator.getUsedSize(); });
+                if (targets.empty() && !sources.empty())
+                {
+                    targets.push_back(sources.back());
+                    sources.pop_back();
+                }
+                std::ranges::sort(targets, std::ranges::greater {}, [](const GeometryPage* page) {
+                    return page->allocator.getUsedSize();
+                });
+
+                for (auto* src : sources)
+                {
+                    auto evacuated = true;
+                    for (auto* allocation : src->allocations)
+                    {
+                        // Its device address might be baked somewhere that would not follow the move.
+                        if (allocation->m_Pinned)
+                        {
+                            evacuated = false;
+                            continue;
+                        }
+
+                        auto moved = false;
+                        for (auto* dst : targets)
+                        {
+                            if (const auto offset =
+                                    dst->allocator.allocate(allocation->m_Size, allocation->m_Alignment))
+                            {
+                                moves.push_back({allocation, dst, *offset});
+                                moved = true;
+                                break;
+                            }
+                        }
+                        evacuated &= moved;
+                    }
+                    src->retired = evacuated;
+                }
+            }
+
+            if (!moves.empty())
+            {
+                m_RenderDevice.execute(
+                    [&moves](CommandBuffer& cb) {
+                        for (const auto& [allocation, dst, dstOffset] : moves)
+                        {
+                            cb.copyBuffer(*allocation->m_Page->buffer,
+                                          *dst->buffer,
+                                          vk::BufferCopy {allocation->m_Offset, dstOffset, allocation->m_Size});
+                        }
+                    },
+                    true);
+            }
+
+            auto& deletionQueue = m_RenderDevice.getDeletionQueue();
+            for (const auto& [allocation, dst, dstOffset] : moves)
+            {
+                // The frames in flight still read the old range.
+                auto& src = *allocation->m_Page;
+                src.allocations.erase(allocation);
+                deletionQueue.push(PendingFree {*this, src, allocation->m_Offset, allocation->m_Size});
+
+                allocation->m_Page   = dst;
+                allocation->m_Offset = dstOffset;
+                ++allocation->m_Version;
+                dst->allocations.insert(allocation);
+            }
+
+            // Retired pages without pending ranges go right away.
+            for (auto& pages : m_Pages)
+            {
+                std::erase_if(pages, [](const Scope<GeometryPage>& page) {
+                    return page->retired && page->allocator.empty();
+                });
+            }
+
+            return static_cast<uint32_t>(moves.size());
+        }
+
+        GeometryPool::Stats GeometryPool::getStats(const GeometryRegion region) const
+        {
+            std::lock_guard lock {m_Mutex};
+
+            Stats stats {};
+            for (const auto& page : m_Pages[toIndex(region)])
+            {
+                ++stats.numPages;
+                stats.numAllocations += static_cast<uint32_t>(page->allocations.size());
+                stats.numFreeRanges += page->allocator.getNumFreeRanges();
+                stats.capacity += page->allocator.getCapacity();
+                stats.usedSize += page->allocator.getUsedSize();
+            }
+            return stats;
+        }
+
+        GeometryPage& GeometryPool::createPage(const GeometryRegion region, const vk::DeviceSize capacity)
+        {
+            ZoneScopedN("GeometryPool::CreatePage");
+
+            auto page    = createScope<GeometryPage>();
+            page->region = region;
+
+            switch (region)
+            {
+                case GeometryRegion::eVertex:
+                    // Byte addressed, the vertex format comes with the pipeline.
+                    page->buffer    = createScope<VertexBuffer>(m_RenderDevice.createVertexBuffer(1, capacity));
+                    page->allocator = RangeAllocator {capacity};
+                    break;
+                case GeometryRegion::eIndex: {
+                    const auto numIndices = (capacity + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+                    page->buffer =
+                        createScope<IndexBuffer>(m_RenderDevice.createIndexBuffer(IndexType::eUInt32, numIndices));
+                    page->allocator = RangeAllocator {numIndices * sizeof(uint32_t)};
+                }
+                break;
+                case GeometryRegion::eMeshlet:
+                    page->buffer = createScope<StorageBuffer>(m_RenderDevice.createStorageBuffer(capacity));
+                    page->buffer->setMemoryCategory(MemoryCategory::eMesh);
+                    page->allocator = RangeAllocator {capacity};
+                    break;
+            }
+
+            // Same condition as for the eShaderDeviceAddress usage of the buffers above.
+            const auto featureFlag = m_RenderDevice.getFeatureFlag();
+            if (HasFlagValues(featureFlag, RenderDeviceFeatureFlagBits::eRayTracingPipeline) ||
+                HasFlagValues(featureFlag, RenderDeviceFeatureFlagBits::eRayQuery) ||
+                HasFlagValues(featureFlag, RenderDeviceFeatureFlagBits::eMeshShader))
+            {
+                page->deviceAddress = m_RenderDevice.getBufferDeviceAddress(*page->buffer);
+            }
+
+            VULTRA_CORE_TRACE("[GeometryPool] Created page: region {}, {} bytes", toIndex(region), capacity);
+
+            return *m_Pages[toIndex(region)].emplace_back(std::move(page));
+        }
+
+        void GeometryPool::release(GeometryAllocation& allocation)
+        {
+            std::lock_guard lock {m_Mutex};
+
+            auto& page = *allocation.m_Page;
+            page.allocations.erase(&allocation);
+            m_RenderDevice.getDeletionQueue().push(PendingFree {*this, page, allocation.m_Offset, allocation.m_Size});
+        }
+
+        void GeometryPool::free(GeometryPage& page, const vk::DeviceSize offset, const vk::DeviceSize size)
+        {
+            std::lock_guard lock {m_Mutex};
+
+            page.allocator.free(offset, size);
+            if (page.retired && page.allocator.empty())
+            {
+                std::erase_if(m_Pages[toIndex(page.region)],
+                              [&page](const Scope<GeometryPage>& p) { return p.get() == &page; });
+            }
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,29 @@
+#include "vultra/core/rhi/gpu_zone.hpp"
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            thread_local GPUZoneListener* s_Listener {nullptr};
+        } // namespace
+
+        void setGPUZoneListener(GPUZoneListener* listener) { s_Listener = listener; }
+
+        GPUZoneListener* getGPUZoneListener() { return s_Listener; }
+
+        GPUZone::GPUZone(CommandBuffer& cb, const std::string_view label) :
+            m_CommandBuffer {cb}, m_Listener {s_Listener}
+        {
+            if (m_Listener)
+                m_Listener->onZoneBegin(m_CommandBuffer, label);
+        }
+
+        GPUZone::~GPUZone()
+        {
+            if (m_Listener)
+                m_Listener->onZoneEnd(m_CommandBuffer);
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
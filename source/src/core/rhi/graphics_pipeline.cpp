@@ -1,4 +1,5 @@
 #include "vultra/core/rhi/graphics_pipeline.hpp"
+#include "vultra/core/base/hash.hpp"
 #include "vultra/core/rhi/render_device.hpp"
 #include "vultra/core/rhi/shader_module.hpp"
 #include "vultra/core/rhi/shader_reflection.hpp"
@@ -6,6 +7,9 @@
 
 #include <glm/common.hpp>
 
+#include <atomic>
+#include <string_view>
+
 namespace vultra
 {
     namespace rhi
@@ -84,6 +88,60 @@ namespace vultra
                 };
             }
 
+            [[nodiscard]] std::size_t hashSpirv(const SPIRV& spv)
+            {
+                return std::hash<std::string_view> {}(
+                    std::string_view {reinterpret_cast<const char*>(spv.data()), spv.size() * sizeof(uint32_t)});
+            }
+
+            [[nodiscard]] std::size_t hashShaderStage(const ShaderType type, const ShaderStageInfo& stageInfo)
+            {
+                std::size_t h {0};
+                hashCombine(h, type, stageInfo.code, stageInfo.entryPointName);
+
+                // Independent of the iteration order.
+                std::size_t defines {0};
+                for (const auto& [name, value] : stageInfo.defines)
+                {
+                    std::size_t define {0};
+                    hashCombine(define, name, value);
+                    defines ^= define;
+                }
+                hashCombine(h, defines);
+                return h;
+            }
+
+            [[nodiscard]] std::size_t hashStencil(const vk::StencilOpState& state)
+            {
+                std::size_t h {0};
+                hashCombine(h,
+                            state.failOp,
+                            state.passOp,
+                            state.depthFailOp,
+                            state.compareOp,
+                            state.compareMask,
+                            state.writeMask,
+                            state.reference);
+                return h;
+            }
+
+            // Parts of a pipeline can only be built as libraries for the classic vertex pipeline.
+            [[nodiscard]] bool isLibraryCompatible(const std::vector<vk::PipelineShaderStageCreateInfo>& stages)
+            {
+                constexpr vk::ShaderStageFlags kSupportedStages =
+                    vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eGeometry |
+                    vk::ShaderStageFlagBits::eFragment;
+
+                bool hasVertexShader {false};
+                for (const auto& stage : stages)
+                {
+                    if (!(stage.stage & kSupportedStages))
+                        return false;
+                    hasVertexShader |= stage.stage == vk::ShaderStageFlagBits::eVertex;
+                }
+                return hasVertexShader;
+            }
+
             [[nodiscard]] auto convert(const auto& container)
             {
                 std::vector<vk::Format> out(container.size());
@@ -96,6 +154,36 @@ namespace vultra
 
         } // namespace
 
+        struct GraphicsPipeline::OptimizedLink
+        {
+            vk::Device        device {nullptr};
+            DeletionQueue*    deletionQueue {nullptr};
+            vk::Pipeline      handle {nullptr}; // Null if the link failed
+            std::atomic<bool> ready {false};
+
+            ~OptimizedLink()
+            {
+                // Never swapped in (the fast-linked pipeline went first).
+                if (handle)
+                    device.destroyPipeline(handle);
+            }
+        };
+
+        bool GraphicsPipeline::upgrade()
+        {
+            if (!m_OptimizedLink || !m_OptimizedLink->ready.load(std::memory_order_acquire))
+                return false;
+
+            const auto link = std::move(m_OptimizedLink);
+            if (!link->handle)
+                return false;
+
+            // Command buffers in flight may still use the fast-linked one.
+            const auto fastLinked = exchangeHandle(std::exchange(link->handle, nullptr));
+            link->deletionQueue->push(GraphicsPipeline {link->device, PipelineLayout {}, fastLinked});
+            return true;
+        }
+
         GraphicsPipeline::Builder::Builder()
         {
             constexpr auto kMaxNumStages = 3; // CS or VS/GS/FS
@@ -190,6 +278,12 @@ namespace vultra
             return *this;
         }
 
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setViewMask(const uint32_t viewMask)
+        {
+            m_ViewMask = viewMask;
+            return *this;
+        }
+
         GraphicsPipeline::Builder& GraphicsPipeline::Builder::setTopology(const PrimitiveTopology topology)
         {
             m_PrimitiveTopology = static_cast<vk::PrimitiveTopology>(topology);
@@ -202,6 +296,12 @@ namespace vultra
             return *this;
         }
 
+        GraphicsPipeline::Builder& GraphicsPipeline::Builder::setPushDescriptorSet(const DescriptorSetIndex index)
+        {
+            m_PushDescriptorSet = index;
+            return *this;
+        }
+
         GraphicsPipeline::Builder& GraphicsPipeline::Builder::addShader(const ShaderType       type,
                                                                         const ShaderStageInfo& stageInfo)
         {
@@ -281,6 +381,7 @@ namespace vultra
             renderingInfo.pColorAttachmentFormats = m_ColorAttachmentFormats.data();
             renderingInfo.depthAttachmentFormat   = m_DepthFormat;
             renderingInfo.stencilAttachmentFormat = m_StencilFormat;
+            renderingInfo.viewMask                = m_ViewMask;
 
             // -- Vertex Attributes:
 
@@ -309,6 +410,8 @@ namespace vultra
             shaderModules.reserve(numShaderStages);
             std::vector<vk::PipelineShaderStageCreateInfo> shaderStages;
             shaderStages.reserve(numShaderStages);
+            std::vector<std::size_t> shaderHashes; // Per shaderStages entry, for the pipeline library
+            shaderHashes.reserve(numShaderStages);
 
             // -- Builtin stages:
             for (const auto& [shaderType, spv] : m_BuiltinShaderStages)
@@ -325,6 +428,7 @@ namespace vultra
 
                 shaderStages.push_back(shaderStageCreateInfo);
                 shaderModules.emplace_back(std::move(shaderModule));
+                shaderHashes.push_back(hashSpirv(spv));
             }
 
             // -- Shader stages:
@@ -345,12 +449,13 @@ namespace vultra
 
                 shaderStages.push_back(shaderStageCreateInfo);
                 shaderModules.emplace_back(std::move(shaderModule));
+                shaderHashes.push_back(hashShaderStage(shaderType, shaderStageInfo));
             }
             if (shaderStages.size() != numShaderStages)
                 return {};
 
             if (reflection.has_value())
-                m_PipelineLayout = reflectPipelineLayout(rd, *reflection);
+                m_PipelineLayout = reflectPipelineLayout(rd, *reflection, m_PushDescriptorSet);
             assert(m_PipelineLayout);
 
             // -- Blending state:
@@ -389,6 +494,147 @@ namespace vultra
 
             const auto device = rd.m_Device;
 
+            if (auto* library = rd.getGraphicsPipelineLibrary(); library && isLibraryCompatible(shaderStages))
+            {
+                using enum GraphicsPipelineLibrary::Part;
+
+                const auto layout = m_PipelineLayout.getHandle();
+
+                // Every part gets the same dynamic state, the driver only reads the states it owns.
+                std::size_t dynamicStateHash {0};
+                for (const auto state : m_DynamicStates)
+                    hashCombine(dynamicStateHash, state);
+
+                // -- Vertex input interface:
+
+                vk::GraphicsPipelineCreateInfo vertexInputInfo {};
+                vertexInputInfo.pVertexInputState   = &vertexInputStateInfo;
+                vertexInputInfo.pInputAssemblyState = &inputAssemblyInfo;
+                vertexInputInfo.pDynamicState       = &dynamicStateInfo;
+
+                auto vertexInputHash = dynamicStateHash;
+                hashCombine(vertexInputHash,
+                            vertexInputStateInfo.vertexBindingDescriptionCount,
+                            m_VertexInput.stride,
+                            inputAssemblyInfo.topology,
+                            inputAssemblyInfo.primitiveRestartEnable);
+                for (const auto& attribute : m_VertexInputAttributes)
+                    hashCombine(vertexInputHash, attribute.location, attribute.format, attribute.offset);
+
+                // -- Pre-rasterization shaders and fragment shader:
+
+                std::vector<vk::PipelineShaderStageCreateInfo> preRasterizationStages;
+                std::vector<vk::PipelineShaderStageCreateInfo> fragmentStages;
+
+                auto preRasterizationHash = dynamicStateHash;
+                hashCombine(preRasterizationHash,
+                            static_cast<VkPipelineLayout>(layout),
+                            m_ViewMask,
+                            m_RasterizerState.depthClampEnable,
+                            m_RasterizerState.polygonMode,
+                            static_cast<VkCullModeFlags>(m_RasterizerState.cullMode),
+                            m_RasterizerState.frontFace,
+                            m_RasterizerState.depthBiasEnable,
+                            m_RasterizerState.depthBiasConstantFactor,
+                            m_RasterizerState.depthBiasSlopeFactor,
+                            m_RasterizerState.lineWidth);
+
+                auto fragmentShaderHash = dynamicStateHash;
+                hashCombine(fragmentShaderHash,
+                            static_cast<VkPipelineLayout>(layout),
+                            m_ViewMask,
+                            m_DepthStencilState.depthTestEnable,
+                            m_DepthStencilState.depthWriteEnable,
+                            m_DepthStencilState.depthCompareOp,
+                            m_DepthStencilState.stencilTestEnable,
+                            hashStencil(m_DepthStencilState.front),
+                            hashStencil(m_DepthStencilState.back));
+
+                for (auto i = 0u; i < shaderStages.size(); ++i)
+                {
+                    const auto isFragment = shaderStages[i].stage == vk::ShaderStageFlagBits::eFragment;
+                    (isFragment ? fragmentStages : preRasterizationStages).push_back(shaderStages[i]);
+                    hashCombine(isFragment ? fragmentShaderHash : preRasterizationHash,
+                                shaderStages[i].stage,
+                                shaderHashes[i]);
+                }
+
+                vk::GraphicsPipelineCreateInfo preRasterizationInfo {};
+                preRasterizationInfo.pNext               = &renderingInfo;
+                preRasterizationInfo.stageCount          = static_cast<uint32_t>(preRasterizationStages.size());
+                preRasterizationInfo.pStages             = preRasterizationStages.data();
+                preRasterizationInfo.pViewportState      = &kIgnoreViewportState;
+                preRasterizationInfo.pRasterizationState = &m_RasterizerState;
+                preRasterizationInfo.pDynamicState       = &dynamicStateInfo;
+                preRasterizationInfo.layout              = layout;
+
+                vk::GraphicsPipelineCreateInfo fragmentShaderInfo {};
+                fragmentShaderInfo.pNext              = &renderingInfo;
+                fragmentShaderInfo.stageCount         = static_cast<uint32_t>(fragmentStages.size());
+                fragmentShaderInfo.pStages            = fragmentStages.data();
+                fragmentShaderInfo.pMultisampleState  = &kIgnoreMultisampleState;
+                fragmentShaderInfo.pDepthStencilState = &m_DepthStencilState;
+                fragmentShaderInfo.pDynamicState      = &dynamicStateInfo;
+                fragmentShaderInfo.layout             = layout;
+
+                // -- Fragment output interface:
+
+                vk::GraphicsPipelineCreateInfo fragmentOutputInfo {};
+                fragmentOutputInfo.pNext             = &renderingInfo;
+                fragmentOutputInfo.pMultisampleState = &kIgnoreMultisampleState;
+                fragmentOutputInfo.pColorBlendState  = &colorBlendInfo;
+                fragmentOutputInfo.pDynamicState     = &dynamicStateInfo;
+
+                auto fragmentOutputHash = dynamicStateHash;
+                hashCombine(fragmentOutputHash, m_ViewMask, m_DepthFormat, m_StencilFormat);
+                for (const auto format : m_ColorAttachmentFormats)
+                    hashCombine(fragmentOutputHash, format);
+                for (const auto& blend : m_BlendStates)
+                {
+                    hashCombine(fragmentOutputHash,
+                                blend.blendEnable,
+                                blend.srcColorBlendFactor,
+                                blend.dstColorBlendFactor,
+                                blend.colorBlendOp,
+                                blend.srcAlphaBlendFactor,
+                                blend.dstAlphaBlendFactor,
+                                blend.alphaBlendOp,
+                                static_cast<VkColorComponentFlags>(blend.colorWriteMask));
+                }
+
+                // -- Link:
+
+                const GraphicsPipelineLibrary::Libraries libraries {
+                    library->getOrCreate(eVertexInput, vertexInputHash, vertexInputInfo),
+                    library->getOrCreate(ePreRasterization, preRasterizationHash, preRasterizationInfo),
+                    library->getOrCreate(eFragmentShader, fragmentShaderHash, fragmentShaderInfo),
+                    library->getOrCreate(eFragmentOutput, fragmentOutputHash, fragmentOutputInfo),
+                };
+                const auto       fastLinked = library->link(libraries, layout, false);
+                GraphicsPipeline pipeline {device, std::move(m_PipelineLayout), fastLinked};
+
+                auto& compiler = rd.getPipelineCompiler();
+                if (library->isOptimizedLinkEnabled() && compiler.isEnabled())
+                {
+                    auto link           = std::make_shared<OptimizedLink>();
+                    link->device        = device;
+                    link->deletionQueue = &rd.getDeletionQueue();
+                    compiler.enqueue([link, library, libraries, layout] {
+                        try
+                        {
+                            link->handle = library->link(libraries, layout, true);
+                        }
+                        catch (const std::exception&)
+                        {
+                            // Logged by VK_CHECK, the fast-linked pipeline stays.
+                        }
+                        link->ready.store(true, std::memory_order_release);
+                    });
+                    pipeline.m_OptimizedLink = std::move(link);
+                }
+                return pipeline;
+            }
+
             vk::Pipeline handle {nullptr};
 
             VK_CHECK(device.createGraphicsPipelines(rd.m_PipelineCache, 1, &graphicsPipelineInfo, nullptr, &handle),
@@ -0,0 +1,133 @@
+#include "vultra/core/rhi/graphics_pipeline_library.hpp"
+#include "vultra/core/base/hash.hpp"
+#include "vultra/core/rhi/vk/macro.hpp"
+
+#include <mutex>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            [[nodiscard]] constexpr auto toVk(const GraphicsPipelineLibrary::Part part)
+            {
+                switch (part)
+                {
+                    using enum GraphicsPipelineLibrary::Part;
+
+                    case eVertexInput:
+                        return vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface;
+                    case ePreRasterization:
+                        return vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders;
+                    case eFragmentShader:
+                        return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+                    case eFragmentOutput:
+                        return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+                }
+                assert(false);
+                return static_cast<vk::GraphicsPipelineLibraryFlagBitsEXT>(0);
+            }
+        } // namespace
+
+        GraphicsPipelineLibrary::GraphicsPipelineLibrary(const vk::Device        device,
+                                                         const vk::PipelineCache pipelineCache) :
+            m_Device {device}, m_PipelineCache {pipelineCache}
+        {
+            assert(device);
+        }
+
+        GraphicsPipelineLibrary::~GraphicsPipelineLibrary()
+        {
+            // Linked pipelines do not depend on their libraries.
+            for (const auto [_, library] : m_Libraries)
+            {
+                m_Device.destroyPipeline(library);
+            }
+        }
+
+        vk::Pipeline GraphicsPipelineLibrary::getOrCreate(const Part                     part,
+                                                          const std::size_t              hash,
+                                                          vk::GraphicsPipelineCreateInfo info)
+        {
+            auto key = hash;
+            hashCombine(key, part);
+
+            {
+                std::shared_lock lock {m_Mutex};
+                if (const auto it = m_Libraries.find(key); it != m_Libraries.cend())
+                {
+                    m_NumHits.fetch_add(1, std::memory_order_relaxed);
+                    return it->second;
+                }
+            }
+
+            // Created outside of the lock, a library takes as long to compile as its stages.
+            vk::GraphicsPipelineLibraryCreateInfoEXT libraryInfo {toVk(part)};
+            libraryInfo.pNext = info.pNext;
+
+            info.pNext = &libraryInfo;
+            info.flags = vk::PipelineCreateFlagBits::eLibraryKHR |
+                         vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+
+            vk::Pipeline library {nullptr};
+            VK_CHECK(m_Device.createGraphicsPipelines(m_PipelineCache, 1, &info, nullptr, &library),
+                     "GraphicsPipelineLibrary",
+                     "Failed to create graphics pipeline library!");
+
+            std::scoped_lock lock {m_Mutex};
+            const auto [it, inserted] = m_Libraries.try_emplace(key, library);
+            if (!inserted)
+            {
+                // Another thread was faster.
+                m_Device.destroyPipeline(library);
+            }
+            return it->second;
+        }
+
+        vk::Pipeline
+        GraphicsPipelineLibrary::link(const Libraries& libraries, const vk::PipelineLayout layout, const bool optimized)
+        {
+            vk::PipelineLibraryCreateInfoKHR linkInfo {};
+            linkInfo.libraryCount = kNumParts;
+            linkInfo.pLibraries   = libraries.data();
+
+            vk::GraphicsPipelineCreateInfo info {};
+            info.pNext  = &linkInfo;
+            info.layout = layout;
+            if (optimized)
+                info.flags = vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT;
+
+            vk::Pipeline pipeline {nullptr};
+            VK_CHECK(m_Device.createGraphicsPipelines(m_PipelineCache, 1, &info, nullptr, &pipeline),
+                     "GraphicsPipelineLibrary",
+                     "Failed to link graphics pipeline!");
+
+            (optimized ? m_NumOptimizedLinks : m_NumFastLinks).fetch_add(1, std::memory_order_relaxed);
+            return pipeline;
+        }
+
+        void GraphicsPipelineLibrary::setOptimizedLinkEnabled(const bool enabled)
+        {
+            m_OptimizedLinkEnabled.store(enabled, std::memory_order_relaxed);
+        }
+
+        bool GraphicsPipelineLibrary::isOptimizedLinkEnabled() const
+        {
+            return m_OptimizedLinkEnabled.load(std::memory_order_relaxed);
+        }
+
+        GraphicsPipelineLibrary::Stats GraphicsPipelineLibrary::getStats() const
+        {
+            Stats stats {
+                .numHits           = m_NumHits.load(std::memory_order_relaxed),
+                .numFastLinks      = m_NumFastLinks.load(std::memory_order_relaxed),
+                .numOptimizedLinks = m_NumOptimizedLinks.load(std::memory_order_relaxed),
+            };
+
+            std::shared_lock lock {m_Mutex};
+            stats.numLibraries = static_cast<uint32_t>(m_Libraries.size());
+            return stats;
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "vultra/core/rhi/memory_stats.hpp"
+
+#include <atomic>
+#include <cassert>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            struct CategoryCounters
+            {
+                std::atomic<int64_t>  current {0};
+                std::atomic<int64_t>  peak {0};
+                std::atomic<uint32_t> numAllocations {0};
+            };
+
+            [[nodiscard]] auto& getCounters(const MemoryCategory category)
+            {
+                static std::array<CategoryCounters, kNumMemoryCategories> s_Counters;
+                return s_Counters[static_cast<uint32_t>(category)];
+            }
+        } // namespace
+
+        const char* toString(const MemoryCategory category)
+        {
+#define CASE(Value, Str) \
+    case MemoryCategory::Value: \
+        return Str
+
+            switch (category)
+            {
+                CASE(eOther, "Other");
+                CASE(eMesh, "Mesh");
+                CASE(eTexture, "Texture");
+                CASE(eTransient, "Transient");
+                CASE(eStaging, "Staging");
+                CASE(eAccelerationStructure, "AccelerationStructure");
+                CASE(eDescriptor, "Descriptor");
+            }
+#undef CASE
+
+            assert(false);
+            return "Undefined";
+        }
+
+        void trackMemory(const MemoryCategory category, const int64_t delta)
+        {
+            if (delta == 0)
+                return;
+
+            auto& counters = getCounters(category);
+            if (delta > 0)
+            {
+                counters.numAllocations.fetch_add(1, std::memory_order_relaxed);
+            }
+            else
+            {
+                counters.numAllocations.fetch_sub(1, std::memory_order_relaxed);
+            }
+
+            const auto current = counters.current.fetch_add(delta, std::memory_order_relaxed) + delta;
+            assert(current >= 0);
+
+            auto peak = counters.peak.load(std::memory_order_relaxed);
+            while (current > peak && !counters.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        MemoryCategoryStats getMemoryCategoryStats(const MemoryCategory category)
+        {
+            const auto& counters = getCounters(category);
+            return MemoryCategoryStats {
+                .current        = static_cast<vk::DeviceSize>(counters.current.load(std::memory_order_relaxed)),
+                .peak           = static_cast<vk::DeviceSize>(counters.peak.load(std::memory_order_relaxed)),
+                .numAllocations = counters.numAllocations.load(std::memory_order_relaxed),
+            };
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
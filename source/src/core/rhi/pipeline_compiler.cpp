@@ -0,0 +1,139 @@
+#include "vultra/core/rhi/pipeline_compiler.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+#include <algorithm>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            constexpr auto kLatencyPlotName = "Pipeline Compile Latency (ms)";
+        }
+
+        PipelineCompiler::PipelineCompiler(uint32_t numWorkers)
+        {
+            if (numWorkers == 0)
+            {
+                numWorkers = std::max(std::thread::hardware_concurrency() / 4, 1u);
+            }
+
+            m_Workers.reserve(numWorkers);
+            for (auto i = 0u; i < numWorkers; ++i)
+            {
+                m_Workers.emplace_back([this] { workerLoop(); });
+            }
+        }
+
+        PipelineCompiler::~PipelineCompiler()
+        {
+            {
+                std::scoped_lock lock {m_Mutex};
+                m_Quit = true;
+            }
+            m_WorkAvailable.notify_all();
+
+            // Queued jobs still run, passes may be waiting for them.
+            for (auto& worker : m_Workers)
+            {
+                worker.join();
+            }
+        }
+
+        void PipelineCompiler::setEnabled(const bool enabled) { m_Enabled.store(enabled, std::memory_order_relaxed); }
+
+        bool PipelineCompiler::isEnabled() const { return m_Enabled.load(std::memory_order_relaxed); }
+
+        void PipelineCompiler::enqueue(Job job)
+        {
+            assert(job);
+            {
+                std::scoped_lock lock {m_Mutex};
+                m_Jobs.push_back(std::move(job));
+            }
+            m_WorkAvailable.notify_one();
+        }
+
+        void PipelineCompiler::waitIdle()
+        {
+            std::unique_lock lock {m_Mutex};
+            m_WorkDone.wait(lock, [this] { return m_Jobs.empty() && m_NumRunning == 0; });
+        }
+
+        uint32_t PipelineCompiler::getNumWorkers() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+        uint32_t PipelineCompiler::getNumPending() const
+        {
+            std::scoped_lock lock {m_Mutex};
+            return static_cast<uint32_t>(m_Jobs.size()) + m_NumRunning;
+        }
+
+        void PipelineCompiler::reportCompiled(const Duration latency, const bool async)
+        {
+            {
+                std::scoped_lock lock {m_StatsMutex};
+                if (async)
+                {
+                    ++m_Stats.numAsync;
+                }
+                else
+                {
+                    ++m_Stats.numBlocking;
+                    m_Stats.totalBlocking += latency;
+                }
+                m_Stats.totalLatency += latency;
+                m_Stats.maxLatency  = std::max(m_Stats.maxLatency, latency);
+                m_Stats.lastLatency = latency;
+            }
+
+            TracyPlot(kLatencyPlotName, latency.count());
+            VULTRA_CORE_TRACE("[PipelineCompiler] Pipeline ready after {:.2f} ms ({})",
+                              latency.count(),
+                              async ? "async" : "blocking");
+        }
+
+        PipelineCompiler::Stats PipelineCompiler::getStats() const
+        {
+            std::scoped_lock lock {m_StatsMutex};
+            return m_Stats;
+        }
+
+        PipelineManifest& PipelineCompiler::getManifest() { return m_Manifest; }
+
+        void PipelineCompiler::workerLoop()
+        {
+            while (true)
+            {
+                Job job;
+                {
+                    std::unique_lock lock {m_Mutex};
+                    m_WorkAvailable.wait(lock, [this] { return m_Quit || !m_Jobs.empty(); });
+                    if (m_Jobs.empty())
+                        return;
+
+                    job = std::move(m_Jobs.front());
+                    m_Jobs.pop_front();
+                    ++m_NumRunning;
+                }
+
+                {
+                    ZoneScopedN("PipelineCompiler::Job");
+                    job();
+                }
+
+                {
+                    std::scoped_lock lock {m_Mutex};
+                    --m_NumRunning;
+                    if (m_Jobs.empty() && m_NumRunning == 0)
+                    {
+                        m_WorkDone.notify_all();
+                    }
+                }
+            }
+        }
+
+        PipelineCompiler& getPipelineCompiler(RenderDevice& rd) { return rd.getPipelineCompiler(); }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -14,7 +14,8 @@ namespace vultra
         } // namespace
 
         PipelineLayout::PipelineLayout(PipelineLayout&& other) noexcept :
-            m_Handle(other.m_Handle), m_DescriptorSetLayouts(std::move(other.m_DescriptorSetLayouts))
+            m_Handle(other.m_Handle), m_DescriptorSetLayouts(std::move(other.m_DescriptorSetLayouts)),
+            m_PushDescriptorSet(other.m_PushDescriptorSet)
         {
             other.m_Handle = nullptr;
         }
@@ -25,6 +26,7 @@ namespace vultra
             {
                 m_Handle               = std::exchange(rhs.m_Handle, nullptr);
                 m_DescriptorSetLayouts = std::move(rhs.m_DescriptorSetLayouts);
+                m_PushDescriptorSet    = std::exchange(rhs.m_PushDescriptorSet, std::nullopt);
             }
 
             return *this;
@@ -41,6 +43,11 @@ namespace vultra
             return m_DescriptorSetLayouts[index];
         }
 
+        bool PipelineLayout::isPushDescriptorSet(const DescriptorSetIndex index) const
+        {
+            return m_PushDescriptorSet == index;
+        }
+
         PipelineLayout::Builder& PipelineLayout::Builder::addImage(const DescriptorSetIndex         setIndex,
                                                                    const BindingIndex               bindingIndex,
                                                                    const vk::ShaderStageFlags       stages,
@@ -133,19 +140,32 @@ namespace vultra
             return *this;
         }
 
+        PipelineLayout::Builder& PipelineLayout::Builder::setPushDescriptorSet(const DescriptorSetIndex index)
+        {
+            assert(index < m_LayoutInfo.descriptorSets.size());
+            m_LayoutInfo.pushDescriptorSet = index;
+            return *this;
+        }
+
         PipelineLayout PipelineLayout::Builder::build(RenderDevice& rd) const
         {
             return rd.createPipelineLayout(m_LayoutInfo);
         }
 
-        PipelineLayout::PipelineLayout(const vk::PipelineLayout               handle,
-                                       std::vector<vk::DescriptorSetLayout>&& descriptorSetLayouts) :
-            m_Handle(handle), m_DescriptorSetLayouts(std::move(descriptorSetLayouts))
+        PipelineLayout::PipelineLayout(const vk::PipelineLayout                handle,
+                                       std::vector<vk::DescriptorSetLayout>&&  descriptorSetLayouts,
+                                       const std::optional<DescriptorSetIndex> pushDescriptorSet) :
+            m_Handle(handle), m_DescriptorSetLayouts(std::move(descriptorSetLayouts)),
+            m_PushDescriptorSet(pushDescriptorSet)
         {}
 
-        PipelineLayout reflectPipelineLayout(RenderDevice& rd, const ShaderReflection& reflection)
+        PipelineLayout reflectPipelineLayout(RenderDevice&                           rd,
+                                             const ShaderReflection&                 reflection,
+                                             const std::optional<DescriptorSetIndex> pushDescriptorSet)
         {
             PipelineLayout::Builder builder {};
+            if (pushDescriptorSet)
+                builder.setPushDescriptorSet(*pushDescriptorSet);
 
             for (const auto& [set, bindings] : vultra::enumerate(reflection.descriptorSets))
             {
@@ -0,0 +1,120 @@
+#include "vultra/core/rhi/pipeline_manifest.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/base/hash.hpp"
+
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <fstream>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        namespace
+        {
+            // Bump whenever the encoding of any recorded key changes.
+            constexpr uint32_t kManifestVersion = 1;
+        } // namespace
+
+        std::size_t PipelineManifest::EntryHash::operator()(const Entry& entry) const noexcept
+        {
+            std::size_t h {0};
+            hashCombine(h, entry.pass, entry.key);
+            return h;
+        }
+
+        bool PipelineManifest::record(const std::string& pass, std::string key)
+        {
+            std::scoped_lock lock {m_Mutex};
+            return m_Entries.emplace(Entry {pass, std::move(key)}).second;
+        }
+
+        std::vector<std::string> PipelineManifest::getKeys(const std::string& pass) const
+        {
+            std::vector<std::string> keys;
+
+            std::scoped_lock lock {m_Mutex};
+            for (const auto& entry : m_Entries)
+            {
+                if (entry.pass == pass)
+                    keys.push_back(entry.key);
+            }
+            return keys;
+        }
+
+        uint32_t PipelineManifest::size() const
+        {
+            std::scoped_lock lock {m_Mutex};
+            return static_cast<uint32_t>(m_Entries.size());
+        }
+
+        void PipelineManifest::clear()
+        {
+            std::scoped_lock lock {m_Mutex};
+            m_Entries.clear();
+        }
+
+        bool PipelineManifest::load(const std::filesystem::path& path)
+        {
+            std::ifstream ifs {path, std::ios::binary};
+            if (!ifs.is_open())
+            {
+                // First run, nothing to warm up.
+                return false;
+            }
+
+            uint32_t           version {0};
+            std::vector<Entry> entries;
+            try
+            {
+                cereal::BinaryInputArchive archive {ifs};
+                archive(version);
+                if (version != kManifestVersion)
+                {
+                    VULTRA_CORE_WARN("[PipelineManifest] Ignoring {} (version {}, expected {})",
+                                     path.generic_string(),
+                                     version,
+                                     kManifestVersion);
+                    return false;
+                }
+                archive(entries);
+            }
+            catch (const std::exception& e)
+            {
+                VULTRA_CORE_ERROR("[PipelineManifest] Failed to read {}: {}", path.generic_string(), e.what());
+                return false;
+            }
+
+            std::scoped_lock lock {m_Mutex};
+            for (auto& entry : entries)
+            {
+                m_Entries.insert(std::move(entry));
+            }
+            VULTRA_CORE_INFO(
+                "[PipelineManifest] Loaded {} pipeline keys from {}", entries.size(), path.generic_string());
+            return true;
+        }
+
+        bool PipelineManifest::save(const std::filesystem::path& path) const
+        {
+            std::ofstream ofs {path, std::ios::binary};
+            if (!ofs.is_open())
+            {
+                VULTRA_CORE_ERROR("[PipelineManifest] Failed to open file: {}", path.generic_string());
+                return false;
+            }
+
+            std::vector<Entry> entries;
+            {
+                std::scoped_lock lock {m_Mutex};
+                entries.assign(m_Entries.cbegin(), m_Entries.cend());
+            }
+            {
+                cereal::BinaryOutputArchive archive {ofs};
+                archive(kManifestVersion, entries);
+            }
+            return true;
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "vultra/core/rhi/query_pool.hpp"
+
+#include <bit>
+#include <cassert>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        QueryPool::QueryPool(QueryPool&& other) noexcept :
+            m_Device(other.m_Device), m_Handle(other.m_Handle), m_Type(other.m_Type), m_Count(other.m_Count),
+            m_PipelineStatistics(other.m_PipelineStatistics)
+        {
+            other.m_Device = nullptr;
+            other.m_Handle = nullptr;
+            other.m_Count  = 0;
+        }
+
+        QueryPool::~QueryPool() { destroy(); }
+
+        QueryPool& QueryPool::operator=(QueryPool&& rhs) noexcept
+        {
+            if (this != &rhs)
+            {
+                destroy();
+
+                std::swap(m_Device, rhs.m_Device);
+                std::swap(m_Handle, rhs.m_Handle);
+                std::swap(m_Type, rhs.m_Type);
+                std::swap(m_Count, rhs.m_Count);
+                std::swap(m_PipelineStatistics, rhs.m_PipelineStatistics);
+            }
+            return *this;
+        }
+
+        QueryPool::operator bool() const { return m_Handle != nullptr; }
+
+        vk::QueryPool QueryPool::getHandle() const { return m_Handle; }
+
+        vk::QueryType QueryPool::getType() const { return m_Type; }
+
+        uint32_t QueryPool::getCount() const { return m_Count; }
+
+        uint32_t QueryPool::getNumValuesPerQuery() const
+        {
+            if (m_Type != vk::QueryType::ePipelineStatistics)
+                return 1;
+            const auto flags = static_cast<VkQueryPipelineStatisticFlags>(m_PipelineStatistics);
+            return static_cast<uint32_t>(std::popcount(flags));
+        }
+
+        bool QueryPool::getResults(const uint32_t first, std::span<uint64_t> results) const
+        {
+            const auto numValues  = getNumValuesPerQuery();
+            const auto numQueries = static_cast<uint32_t>(results.size() / numValues);
+            assert(m_Handle && results.size() % numValues == 0 && first + numQueries <= m_Count);
+
+            const auto result = m_Device.getQueryPoolResults(m_Handle,
+                                                             first,
+                                                             numQueries,
+                                                             results.size_bytes(),
+                                                             results.data(),
+                                                             sizeof(uint64_t) * numValues,
+                                                             vk::QueryResultFlagBits::e64);
+            return result == vk::Result::eSuccess;
+        }
+
+        void QueryPool::reset(const uint32_t first, const uint32_t count)
+        {
+            assert(m_Handle && first + count <= m_Count);
+            m_Device.resetQueryPool(m_Handle, first, count);
+        }
+
+        QueryPool::QueryPool(const vk::Device                      device,
+                             const vk::QueryPool                   handle,
+                             const vk::QueryType                   type,
+                             const uint32_t                        count,
+                             const vk::QueryPipelineStatisticFlags pipelineStatistics) :
+            m_Device(device), m_Handle(handle), m_Type(type), m_Count(count), m_PipelineStatistics(pipelineStatistics)
+        {}
+
+        void QueryPool::destroy() noexcept
+        {
+            if (m_Handle)
+            {
+                m_Device.destroyQueryPool(m_Handle);
+
+                m_Device = nullptr;
+                m_Handle = nullptr;
+                m_Count  = 0;
+            }
+        }
+    } // namespace rhi
+} // namespace vultra
\ No newline at end of file
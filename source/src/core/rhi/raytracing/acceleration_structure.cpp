@@ -54,6 +54,8 @@ namespace vultra
 
         AccelerationStructureBuffer* AccelerationStructure::getBuffer() { return &m_Buffer; }
 
+        uint64_t AccelerationStructure::getId() const { return m_Buffer.getId(); }
+
         AccelerationStructure::AccelerationStructure(vk::Device                            deviceHandle,
                                                      vk::AccelerationStructureKHR          handle,
                                                      uint64_t                              deviceAddress,
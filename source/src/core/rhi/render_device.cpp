@@ -1,6 +1,8 @@
 #include "vultra/core/rhi/render_device.hpp"
 #include "vultra/core/base/hash.hpp"
 #include "vultra/core/base/ranges.hpp"
+#include "vultra/core/base/string_util.hpp"
+#include "vultra/core/profiling/tracky.hpp"
 #include "vultra/core/rhi/command_buffer.hpp"
 #include "vultra/core/rhi/raytracing/raytracing_pipeline.hpp"
 #include "vultra/core/rhi/shader_reflection.hpp"
@@ -15,6 +17,7 @@
 #include <stb_image_write.h>
 
 #include <set>
+#include <utility>
 
 VULKAN_HPP_DEFAULT_DISPATCH_LOADER_DYNAMIC_STORAGE
 
@@ -203,6 +206,19 @@ namespace vultra
     {
         constexpr auto LOGTAG = "RenderDevice";
 
+        // Tracy/Tracky keep the pointers. Indexed by MemoryCategory, followed by the device local heap totals.
+        constexpr std::array<const char*, kNumMemoryCategories + 2> kMemoryPlotNames {
+            "GPU Memory: Other",
+            "GPU Memory: Mesh",
+            "GPU Memory: Texture",
+            "GPU Memory: Transient",
+            "GPU Memory: Staging",
+            "GPU Memory: AccelerationStructure",
+            "GPU Memory: Descriptor",
+            "GPU Memory: Device Local Usage",
+            "GPU Memory: Device Local Budget",
+        };
+
         RenderDevice::RenderDevice(const RenderDeviceFeatureFlagBits featureFlag, std::string_view appName) :
             m_FeatureFlag(featureFlag), m_AppName(appName)
         {
@@ -214,27 +230,38 @@ namespace vultra
             createInstance();
             selectPhysicalDevice();
             findGenericQueue();
+            findAsyncComputeQueue();
             createLogicalDevice();
             createMemoryAllocator();
-            createCommandPool();
+            createCommandPools();
             createPipelineCache();
             createDefaultDescriptorPool();
+            createDescriptorSetCache();
             createTracyContext();
             createTracky();
         }
 
         RenderDevice::~RenderDevice()
         {
+            // Runs whatever is still queued, before the pipeline cache and the layouts go.
+            m_PipelineCompiler.reset();
             if (m_Device)
             {
                 m_Device.waitIdle();
             }
+            m_DeletionQueue->flush();
+            m_GraphicsPipelineLibrary.reset();
+            // Its pages go with the memory allocator.
+            m_GeometryPool.reset();
 
             for (auto& texture : m_LoadedTextures)
             {
                 texture.reset();
             }
 
+            // Destroys the update templates and pools, before their layouts.
+            m_DescriptorSetCache.reset();
+
             for (auto [_, layout] : m_DescriptorSetLayouts)
             {
                 m_Device.destroyDescriptorSetLayout(layout);
@@ -251,6 +278,10 @@ namespace vultra
             }
 
             TracyVkDestroy(m_TracyContext);
+            if (m_AsyncComputeTracyContext)
+            {
+                TracyVkDestroy(m_AsyncComputeTracyContext);
+            }
             TRACKY_TEARDOWN();
 
             if (m_MemoryAllocator)
@@ -263,6 +294,10 @@ namespace vultra
                 m_Device.destroyDescriptorPool(m_DefaultDescriptorPool);
                 m_Device.destroyPipelineCache(m_PipelineCache);
                 m_Device.destroyCommandPool(m_CommandPool);
+                if (m_AsyncComputeCommandPool)
+                {
+                    m_Device.destroyCommandPool(m_AsyncComputeCommandPool);
+                }
                 m_Device.destroy();
             }
 
@@ -284,6 +319,11 @@ namespace vultra
 
         RenderDeviceFeatureReport RenderDevice::getFeatureReport() const { return m_FeatureReport; }
 
+        bool RenderDevice::isHeadless() const
+        {
+            return HasFlagValues(m_FeatureFlag, RenderDeviceFeatureFlagBits::eHeadless);
+        }
+
         std::string RenderDevice::getName() const
         {
             const auto v = m_PhysicalDevice.getProperties().apiVersion;
@@ -325,11 +365,13 @@ namespace vultra
                                                 const VerticalSync      vsync) const
         {
             assert(m_Device);
+            assert(!isHeadless() && "A headless RenderDevice has no surface support");
 
             return Swapchain {
                 m_Instance,
                 m_PhysicalDevice,
                 m_Device,
+                m_DeletionQueue.get(),
                 &window,
                 format,
                 vsync,
@@ -356,6 +398,58 @@ namespace vultra
             return semaphore;
         }
 
+        vk::Semaphore RenderDevice::createTimelineSemaphore(const uint64_t initialValue)
+        {
+            assert(m_Device);
+            assert(HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eTimelineSemaphore));
+            vk::SemaphoreTypeCreateInfo typeCreateInfo {};
+            typeCreateInfo.semaphoreType = vk::SemaphoreType::eTimeline;
+            typeCreateInfo.initialValue  = initialValue;
+            vk::SemaphoreCreateInfo createInfo {};
+            createInfo.pNext = &typeCreateInfo;
+            vk::Semaphore semaphore {nullptr};
+            VK_CHECK(m_Device.createSemaphore(&createInfo, nullptr, &semaphore),
+                     LOGTAG,
+                     "Failed to create timeline semaphore");
+            return semaphore;
+        }
+
+        bool RenderDevice::hasAsyncComputeQueue() const { return m_AsyncComputeQueue != nullptr; }
+
+        uint32_t RenderDevice::getQueueFamilyIndex(const QueueType queueType) const
+        {
+            if (queueType == QueueType::eAsyncCompute)
+            {
+                assert(hasAsyncComputeQueue());
+                return static_cast<uint32_t>(m_AsyncComputeQueueFamilyIndex);
+            }
+            return static_cast<uint32_t>(m_GenericQueueFamilyIndex);
+        }
+
+        QueryPool RenderDevice::createQueryPool(const vk::QueryType                   type,
+                                                const uint32_t                        count,
+                                                const vk::QueryPipelineStatisticFlags pipelineStatistics) const
+        {
+            assert(m_Device && count > 0);
+            assert(type != vk::QueryType::ePipelineStatistics || pipelineStatistics);
+            vk::QueryPoolCreateInfo createInfo {};
+            createInfo.queryType          = type;
+            createInfo.queryCount         = count;
+            createInfo.pipelineStatistics = pipelineStatistics;
+            vk::QueryPool queryPool {nullptr};
+            VK_CHECK(m_Device.createQueryPool(&createInfo, nullptr, &queryPool), LOGTAG, "Failed to create query pool");
+            return QueryPool {m_Device, queryPool, type, count, pipelineStatistics};
+        }
+
+        float RenderDevice::getTimestampPeriod() const
+        {
+            assert(m_PhysicalDevice && m_GenericQueueFamilyIndex >= 0);
+            const auto queueFamilies = m_PhysicalDevice.getQueueFamilyProperties();
+            if (queueFamilies[m_GenericQueueFamilyIndex].timestampValidBits == 0)
+                return 0.0f;
+            return getDeviceLimits().timestampPeriod;
+        }
+
         Buffer RenderDevice::createStagingBuffer(const vk::DeviceSize size, const void* data) const
         {
             assert(m_MemoryAllocator);
@@ -366,6 +460,7 @@ namespace vultra
                 vk::BufferUsageFlagBits::eTransferSrc,
                 makeAllocationFlags(AllocationHints::eSequentialWrite),
                 vma::MemoryUsage::eAutoPreferHost,
+                MemoryCategory::eStaging,
             };
 
             if (data)
@@ -403,6 +498,7 @@ namespace vultra
                     usage,
                     makeAllocationFlags(allocationHint),
                     vma::MemoryUsage::eAutoPreferDevice,
+                    MemoryCategory::eMesh,
                 },
                 stride,
             };
@@ -434,6 +530,7 @@ namespace vultra
                     usage,
                     makeAllocationFlags(allocationHint),
                     vma::MemoryUsage::eAutoPreferDevice,
+                    MemoryCategory::eMesh,
                 },
                 indexType,
             };
@@ -486,14 +583,18 @@ namespace vultra
         }
 
         std::pair<std::size_t, vk::DescriptorSetLayout>
-        RenderDevice::createDescriptorSetLayout(const std::vector<DescriptorSetLayoutBindingEx>& bindings)
+        RenderDevice::createDescriptorSetLayout(const std::vector<DescriptorSetLayoutBindingEx>& bindings,
+                                                const bool                                       pushDescriptor)
         {
             assert(m_Device);
+            assert(!pushDescriptor || m_MaxPushDescriptors > 0);
 
             std::size_t hash {0};
             for (const auto& b : bindings)
                 hashCombine(hash, b);
+            hashCombine(hash, pushDescriptor);
 
+            std::scoped_lock lock {m_LayoutMutex};
             if (const auto it = m_DescriptorSetLayouts.find(hash); it != m_DescriptorSetLayouts.cend())
             {
                 return {hash, it->second};
@@ -520,30 +621,182 @@ namespace vultra
 #if __APPLE__
             createInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool;
 #endif
+            // Push descriptors are never allocated from a pool (hence incompatible with eUpdateAfterBindPool).
+            if (pushDescriptor)
+                createInfo.flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
 
             vk::DescriptorSetLayout descriptorSetLayout {nullptr};
             VK_CHECK(m_Device.createDescriptorSetLayout(&createInfo, nullptr, &descriptorSetLayout),
                      LOGTAG,
                      "Failed to create descriptor set layout");
+            if (!pushDescriptor)
+                m_DescriptorPoolSizer.add(descriptorSetLayout, vkBindings);
 
             const auto& [inserted, _] = m_DescriptorSetLayouts.emplace(hash, descriptorSetLayout);
             return {hash, inserted->second};
         }
 
+        DescriptorSetCache& RenderDevice::getDescriptorSetCache()
+        {
+            assert(m_DescriptorSetCache);
+            return *m_DescriptorSetCache;
+        }
+
+        DeletionQueue& RenderDevice::getDeletionQueue() { return *m_DeletionQueue; }
+
+        GeometryPool& RenderDevice::getGeometryPool() { return *m_GeometryPool; }
+
+        PipelineCompiler& RenderDevice::getPipelineCompiler() { return *m_PipelineCompiler; }
+
+        GraphicsPipelineLibrary* RenderDevice::getGraphicsPipelineLibrary() { return m_GraphicsPipelineLibrary.get(); }
+
+        MemoryStats RenderDevice::getMemoryStats() const
+        {
+            assert(m_MemoryAllocator);
+
+            const auto memoryProperties = m_PhysicalDevice.getMemoryProperties();
+
+            std::array<vma::Budget, VK_MAX_MEMORY_HEAPS> budgets {};
+            m_MemoryAllocator.getHeapBudgets(budgets.data());
+
+            MemoryStats stats;
+            stats.heaps.reserve(memoryProperties.memoryHeapCount);
+            for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i)
+            {
+                stats.heaps.push_back({
+                    .flags     = memoryProperties.memoryHeaps[i].flags,
+                    .budget    = budgets[i].budget,
+                    .usage     = budgets[i].usage,
+                    .peakUsage = std::max(m_HeapPeakUsage[i], budgets[i].usage),
+                });
+            }
+            for (uint32_t i = 0; i < kNumMemoryCategories; ++i)
+            {
+                stats.categories[i] = getMemoryCategoryStats(static_cast<MemoryCategory>(i));
+            }
+            return stats;
+        }
+
+        RenderDevice& RenderDevice::updateMemoryStats()
+        {
+            ZoneScopedN("RHI::UpdateMemoryStats");
+
+            // Lets VMA refresh the budget (otherwise only every few allocations).
+            m_MemoryAllocator.setCurrentFrameIndex(m_MemoryFrameIndex++);
+
+            const auto stats = getMemoryStats();
+
+            int64_t deviceLocalUsage {0};
+            int64_t deviceLocalBudget {0};
+            for (uint32_t i = 0; i < stats.heaps.size(); ++i)
+            {
+                const auto& heap   = stats.heaps[i];
+                m_HeapPeakUsage[i] = heap.peakUsage;
+
+                if (heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal)
+                {
+                    deviceLocalUsage += static_cast<int64_t>(heap.usage);
+                    deviceLocalBudget += static_cast<int64_t>(heap.budget);
+                }
+
+                const auto heapBit = 1u << i;
+                if (heap.getBudgetFraction() > m_MemoryBudgetFraction)
+                {
+                    if (!(m_OverBudgetHeaps & heapBit))
+                    {
+                        m_OverBudgetHeaps |= heapBit;
+                        if (m_MemoryBudgetCallback)
+                        {
+                            m_MemoryBudgetCallback(stats, i);
+                        }
+                        else
+                        {
+                            std::string breakdown;
+                            for (uint32_t c = 0; c < kNumMemoryCategories; ++c)
+                            {
+                                breakdown += std::format(" {}: {} (peak {}),",
+                                                         toString(static_cast<MemoryCategory>(c)),
+                                                         util::formatBytes(stats.categories[c].current),
+                                                         util::formatBytes(stats.categories[c].peak));
+                            }
+                            breakdown.pop_back();
+                            VULTRA_CORE_WARN("[RenderDevice] Memory heap {} at {} of {} budget,{}",
+                                             i,
+                                             util::formatBytes(heap.usage),
+                                             util::formatBytes(heap.budget),
+                                             breakdown);
+                        }
+                    }
+                }
+                else
+                {
+                    m_OverBudgetHeaps &= ~heapBit;
+                }
+            }
+
+            TracyPlot(kMemoryPlotNames[kNumMemoryCategories], deviceLocalUsage);
+            TracyPlot(kMemoryPlotNames[kNumMemoryCategories + 1], deviceLocalBudget);
+            TRACKY_COUNTER(deviceLocalUsage, kMemoryPlotNames[kNumMemoryCategories]);
+            for (uint32_t i = 0; i < kNumMemoryCategories; ++i)
+            {
+                const auto current = static_cast<int64_t>(stats.categories[i].current);
+                TracyPlot(kMemoryPlotNames[i], current);
+                TRACKY_COUNTER(current, kMemoryPlotNames[i]);
+            }
+
+            return *this;
+        }
+
+        RenderDevice& RenderDevice::setMemoryBudgetWarning(const float fraction, MemoryBudgetCallback callback)
+        {
+            assert(fraction > 0.0f);
+            m_MemoryBudgetFraction = fraction;
+            m_MemoryBudgetCallback = std::move(callback);
+            m_OverBudgetHeaps      = 0;
+            return *this;
+        }
+
         PipelineLayout RenderDevice::createPipelineLayout(const PipelineLayoutInfo& layoutInfo)
         {
             assert(m_Device);
 
+            // A set can be pushed if the extension is present, none of its bindings needs a flag (variable count or
+            // update after bind) and its descriptors fit within the limit.
+            auto canPushDescriptorSet = [this](const PipelineLayoutInfo::DescriptorSetBindings& bindings) {
+                uint32_t numDescriptors {0};
+                for (const auto& [binding, flags] : bindings)
+                {
+                    if (flags != 0 || binding.descriptorType == vk::DescriptorType::eUniformBufferDynamic ||
+                        binding.descriptorType == vk::DescriptorType::eStorageBufferDynamic)
+                    {
+                        return false;
+                    }
+                    numDescriptors += binding.descriptorCount;
+                }
+                return !bindings.empty() && numDescriptors <= m_MaxPushDescriptors;
+            };
+
+            std::optional<DescriptorSetIndex> pushDescriptorSet;
+            if (layoutInfo.pushDescriptorSet &&
+                canPushDescriptorSet(layoutInfo.descriptorSets[*layoutInfo.pushDescriptorSet]))
+            {
+                pushDescriptorSet = layoutInfo.pushDescriptorSet;
+            }
+
             std::size_t                          hash {0};
             std::vector<vk::DescriptorSetLayout> descriptorSetLayouts(kMinNumDescriptorSets);
 
+            // Recursive, createDescriptorSetLayout takes it too.
+            std::scoped_lock lock {m_LayoutMutex};
             for (const auto& [set, bindings] : vultra::enumerate(layoutInfo.descriptorSets))
             {
+                const auto pushDescriptor = pushDescriptorSet == set;
                 for (const auto& binding : bindings)
                 {
                     hashCombine(hash, set, binding);
                 }
-                auto [_, handle]          = createDescriptorSetLayout(bindings);
+                hashCombine(hash, pushDescriptor);
+                auto [_, handle]          = createDescriptorSetLayout(bindings, pushDescriptor);
                 descriptorSetLayouts[set] = handle;
             }
             for (const auto& range : layoutInfo.pushConstantRanges)
@@ -551,7 +804,7 @@ namespace vultra
 
             if (const auto it = m_PipelineLayouts.find(hash); it != m_PipelineLayouts.cend())
             {
-                return PipelineLayout {it->second, std::move(descriptorSetLayouts)};
+                return PipelineLayout {it->second, std::move(descriptorSetLayouts), pushDescriptorSet};
             }
 
             vk::PipelineLayoutCreateInfo createInfo {};
@@ -566,7 +819,7 @@ namespace vultra
                      "Failed to create pipeline layout");
 
             const auto& [inserted, _] = m_PipelineLayouts.emplace(hash, handle);
-            return PipelineLayout {inserted->second, std::move(descriptorSetLayouts)};
+            return PipelineLayout {inserted->second, std::move(descriptorSetLayouts), pushDescriptorSet};
         }
 
         Texture RenderDevice::createTexture2D(const Extent2D    extent,
@@ -840,12 +1093,16 @@ namespace vultra
             std::vector<const char*> requiredExtensions;
             std::vector<const char*> extensions;
 
-            uint32_t    sdlExtensionCount = 0;
-            const auto* sdlExtensions     = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
-            requiredExtensions.reserve(sdlExtensionCount);
-            for (uint32_t i = 0; i < sdlExtensionCount; ++i)
+            // SDL needs a video subsystem to report the surface extensions, there is none without a display.
+            if (!isHeadless())
             {
-                requiredExtensions.push_back(sdlExtensions[i]);
+                uint32_t    sdlExtensionCount = 0;
+                const auto* sdlExtensions     = SDL_Vulkan_GetInstanceExtensions(&sdlExtensionCount);
+                requiredExtensions.reserve(sdlExtensionCount);
+                for (uint32_t i = 0; i < sdlExtensionCount; ++i)
+                {
+                    requiredExtensions.push_back(sdlExtensions[i]);
+                }
             }
 
 #if _DEBUG
@@ -1056,6 +1313,11 @@ namespace vultra
                     {
                         score += 1000;
                     }
+                    // Software rasterizers (lavapipe, SwiftShader) only win on machines without a GPU.
+                    if (properties.deviceType != vk::PhysicalDeviceType::eCpu)
+                    {
+                        score += 100;
+                    }
 
                     score += properties.limits.maxImageDimension2D;
 
@@ -1073,11 +1335,18 @@ namespace vultra
                 }
 
                 m_PhysicalDevice = bestDevice;
+                if (m_PhysicalDevice.getProperties().deviceType == vk::PhysicalDeviceType::eCpu)
+                {
+                    VULTRA_CORE_WARN("[RenderDevice] Selected a software rasterizer, expect CPU bound performance");
+                }
             }
 
             // Query properties and features (for raytracing)
             // Properties
-            vk::StructureChain<vk::PhysicalDeviceProperties2, vk::PhysicalDeviceRayTracingPipelinePropertiesKHR>
+            vk::StructureChain<vk::PhysicalDeviceProperties2,
+                               vk::PhysicalDeviceRayTracingPipelinePropertiesKHR,
+                               vk::PhysicalDevicePushDescriptorPropertiesKHR,
+                               vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>
                 propertyChain;
             m_PhysicalDevice.getProperties2(&propertyChain.get<vk::PhysicalDeviceProperties2>());
             m_RayTracingPipelineProperties = propertyChain.get<vk::PhysicalDeviceRayTracingPipelinePropertiesKHR>();
@@ -1094,6 +1363,7 @@ namespace vultra
 
             // Query supported features
             vk::PhysicalDeviceFeatures2        features2 {};
+            vk::PhysicalDeviceVulkan11Features vk11 {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_1_FEATURES};
             vk::PhysicalDeviceVulkan12Features vk12 {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
             vk::PhysicalDeviceVulkan13Features vk13 {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_3_FEATURES};
             vk::PhysicalDeviceAccelerationStructureFeaturesKHR accel {
@@ -1102,13 +1372,17 @@ namespace vultra
             vk::PhysicalDeviceRayTracingPipelineFeaturesKHR rayTracing {
                 VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_TRACING_PIPELINE_FEATURES_KHR};
             vk::PhysicalDeviceMeshShaderFeaturesEXT mesh {VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MESH_SHADER_FEATURES_EXT};
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibrary {
+                VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
 
             features2.pNext  = &vk13;
-            vk13.pNext       = &vk12;
+            vk13.pNext       = &vk11;
+            vk11.pNext       = &vk12;
             vk12.pNext       = &accel;
             accel.pNext      = &rayQuery;
             rayQuery.pNext   = &rayTracing;
             rayTracing.pNext = &mesh;
+            mesh.pNext       = &pipelineLibrary;
 
             m_PhysicalDevice.getFeatures2(&features2);
 
@@ -1145,6 +1419,47 @@ namespace vultra
                 vk12.descriptorIndexing && vk12.shaderSampledImageArrayNonUniformIndexing &&
                     vk12.runtimeDescriptorArray && vk12.descriptorBindingPartiallyBound &&
                     vk12.descriptorBindingVariableDescriptorCount && vk12.descriptorBindingUpdateUnusedWhilePending);
+            // Small per-draw sets are written straight into the command buffer (see createPipelineLayout).
+            add(RenderDeviceFeatureReportFlagBits::ePushDescriptor, VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+            // Driver side budget/usage per heap, VMA falls back to its own estimate otherwise.
+            add(RenderDeviceFeatureReportFlagBits::eMemoryBudget, VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            // Pipelines are linked from separately compiled parts (see GraphicsPipelineLibrary). Without fast linking
+            // a link costs about as much as a monolithic pipeline, so there is nothing to gain.
+            add(RenderDeviceFeatureReportFlagBits::eGraphicsPipelineLibrary,
+                VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME,
+                pipelineLibrary.graphicsPipelineLibrary &&
+                    m_SupportedExtensions.count(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+                    propertyChain.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>()
+                        .graphicsPipelineLibraryFastLinking);
+            if (HasFlagValues(flags, RenderDeviceFeatureReportFlagBits::ePushDescriptor))
+            {
+                m_MaxPushDescriptors =
+                    propertyChain.get<vk::PhysicalDevicePushDescriptorPropertiesKHR>().maxPushDescriptors;
+            }
+            // Core in Vulkan 1.2, lets vertex shaders write gl_Layer (layered single pass rendering).
+            if (vk12.shaderOutputLayer)
+                flags |= RenderDeviceFeatureReportFlagBits::eShaderOutputLayer;
+            else
+                VULTRA_CORE_WARN("[RenderDevice] Extension or feature not supported: {}", "shaderOutputLayer");
+            // Core in Vulkan 1.1, renders several views (gl_ViewIndex) into array layers with a single draw.
+            if (vk11.multiview)
+                flags |= RenderDeviceFeatureReportFlagBits::eMultiview;
+            else
+                VULTRA_CORE_WARN("[RenderDevice] Extension or feature not supported: {}", "multiview");
+            // Core in Vulkan 1.2, used to order work between the generic and the async compute queue.
+            if (vk12.timelineSemaphore)
+                flags |= RenderDeviceFeatureReportFlagBits::eTimelineSemaphore;
+            else
+                VULTRA_CORE_WARN("[RenderDevice] Extension or feature not supported: {}", "timelineSemaphore");
+            // Core in Vulkan 1.2, lets profilers recycle their queries without recording a reset.
+            if (vk12.hostQueryReset)
+                flags |= RenderDeviceFeatureReportFlagBits::eHostQueryReset;
+            else
+                VULTRA_CORE_WARN("[RenderDevice] Extension or feature not supported: {}", "hostQueryReset");
+            if (features2.features.pipelineStatisticsQuery)
+                flags |= RenderDeviceFeatureReportFlagBits::ePipelineStatistics;
+            else
+                VULTRA_CORE_WARN("[RenderDevice] Extension or feature not supported: {}", "pipelineStatisticsQuery");
 
             // Summarize selected device
             VULTRA_CORE_INFO("[RenderDevice] Selected GPU: {}", props.deviceName.data());
@@ -1164,6 +1479,14 @@ namespace vultra
             PRINT_FEATURE(eMeshShader);
             PRINT_FEATURE(eBufferDeviceAddress);
             PRINT_FEATURE(eDescriptorIndexing);
+            PRINT_FEATURE(eShaderOutputLayer);
+            PRINT_FEATURE(eMultiview);
+            PRINT_FEATURE(eTimelineSemaphore);
+            PRINT_FEATURE(eHostQueryReset);
+            PRINT_FEATURE(ePipelineStatistics);
+            PRINT_FEATURE(ePushDescriptor);
+            PRINT_FEATURE(eMemoryBudget);
+            PRINT_FEATURE(eGraphicsPipelineLibrary);
 #undef PRINT_FEATURE
 
             // === Assign & Check Feature Flags ===
@@ -1186,6 +1509,8 @@ namespace vultra
             {
                 availableFeatureFlag |= RenderDeviceFeatureFlagBits::eOpenXR;
             }
+            // Needs nothing from the device.
+            availableFeatureFlag |= RenderDeviceFeatureFlagBits::eHeadless;
 
             if (!HasFlagValues(availableFeatureFlag, m_FeatureFlag) &&
                 m_FeatureFlag != RenderDeviceFeatureFlagBits::eNormal)
@@ -1220,20 +1545,51 @@ namespace vultra
             }
         }
 
+        void RenderDevice::findAsyncComputeQueue()
+        {
+            // Timeline semaphores order the work across queues, without them everything stays on the generic queue.
+            if (!HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eTimelineSemaphore))
+                return;
+
+            const auto queueFamilies = m_PhysicalDevice.getQueueFamilyProperties();
+            for (uint32_t i = 0; i < queueFamilies.size(); ++i)
+            {
+                const auto flags = queueFamilies[i].queueFlags;
+                if ((flags & vk::QueueFlagBits::eCompute) && !(flags & vk::QueueFlagBits::eGraphics))
+                {
+                    m_AsyncComputeQueueFamilyIndex = i;
+                    break;
+                }
+            }
+
+            if (m_AsyncComputeQueueFamilyIndex == -1)
+                VULTRA_CORE_WARN("[RenderDevice] No dedicated compute queue family, async compute is disabled");
+        }
+
         void RenderDevice::createLogicalDevice()
         {
-            constexpr float           queuePriority = 1.0f;
-            vk::DeviceQueueCreateInfo queueCreateInfo {};
-            queueCreateInfo.queueFamilyIndex = m_GenericQueueFamilyIndex;
-            queueCreateInfo.queueCount       = 1;
-            queueCreateInfo.pQueuePriorities = &queuePriority;
+            constexpr float                        queuePriority = 1.0f;
+            std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos(1);
+            queueCreateInfos[0].queueFamilyIndex = m_GenericQueueFamilyIndex;
+            queueCreateInfos[0].queueCount       = 1;
+            queueCreateInfos[0].pQueuePriorities = &queuePriority;
+            if (m_AsyncComputeQueueFamilyIndex != -1)
+            {
+                auto& asyncComputeQueueCreateInfo            = queueCreateInfos.emplace_back();
+                asyncComputeQueueCreateInfo.queueFamilyIndex = m_AsyncComputeQueueFamilyIndex;
+                asyncComputeQueueCreateInfo.queueCount       = 1;
+                asyncComputeQueueCreateInfo.pQueuePriorities = &queuePriority;
+            }
 
             // === Base extensions ===
             std::vector<const char*> extensions = {
-                VK_KHR_SWAPCHAIN_EXTENSION_NAME,
                 VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME,
                 VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
             };
+            if (!isHeadless())
+            {
+                extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+            }
 
             // === Feature structs ===
             vk::PhysicalDeviceFeatures2        deviceFeatures2 {};
@@ -1246,6 +1602,18 @@ namespace vultra
             enabledFeatures.shaderImageGatherExtended = VK_TRUE;
             enabledFeatures.shaderInt64               = VK_TRUE;
 #endif
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::ePipelineStatistics))
+            {
+                enabledFeatures.pipelineStatisticsQuery = VK_TRUE;
+            }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::ePushDescriptor))
+            {
+                extensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+            }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eMemoryBudget))
+            {
+                extensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+            }
             deviceFeatures2.features = enabledFeatures;
 
 #ifdef __APPLE__
@@ -1266,6 +1634,14 @@ namespace vultra
             featureChain.push_back(reinterpret_cast<vk::BaseOutStructure*>(&vk13Features));
 #endif
 
+            // Vulkan 1.1 features
+            vk::PhysicalDeviceVulkan11Features vk11Features {};
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eMultiview))
+            {
+                vk11Features.multiview = VK_TRUE;
+            }
+            featureChain.push_back(reinterpret_cast<vk::BaseOutStructure*>(&vk11Features));
+
             // Vulkan 1.2 features
             vk::PhysicalDeviceVulkan12Features vk12Features {};
             if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eBufferDeviceAddress))
@@ -1286,6 +1662,18 @@ namespace vultra
                 vk12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
                 vk12Features.runtimeDescriptorArray                    = VK_TRUE;
             }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eShaderOutputLayer))
+            {
+                vk12Features.shaderOutputLayer = VK_TRUE;
+            }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eTimelineSemaphore))
+            {
+                vk12Features.timelineSemaphore = VK_TRUE;
+            }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eHostQueryReset))
+            {
+                vk12Features.hostQueryReset = VK_TRUE;
+            }
             featureChain.push_back(reinterpret_cast<vk::BaseOutStructure*>(&vk12Features));
 
             // Ray Tracing & Ray Query
@@ -1327,6 +1715,16 @@ namespace vultra
                 featureChain.push_back(reinterpret_cast<vk::BaseOutStructure*>(&meshShaderFeatures));
             }
 
+            // Graphics Pipeline Libraries
+            vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibraryFeatures {};
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eGraphicsPipelineLibrary))
+            {
+                extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+                extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+                pipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+                featureChain.push_back(reinterpret_cast<vk::BaseOutStructure*>(&pipelineLibraryFeatures));
+            }
+
             // === Link chain ===
             vk::BaseOutStructure* prev = nullptr;
             for (auto* f : featureChain)
@@ -1350,8 +1748,8 @@ namespace vultra
 
             // === Device Creation ===
             vk::DeviceCreateInfo createInfo {};
-            createInfo.queueCreateInfoCount    = 1;
-            createInfo.pQueueCreateInfos       = &queueCreateInfo;
+            createInfo.queueCreateInfoCount    = static_cast<uint32_t>(queueCreateInfos.size());
+            createInfo.pQueueCreateInfos       = queueCreateInfos.data();
             createInfo.pNext                   = &deviceFeatures2;
             createInfo.enabledExtensionCount   = static_cast<uint32_t>(filteredExtensions.size());
             createInfo.ppEnabledExtensionNames = filteredExtensions.data();
@@ -1397,6 +1795,10 @@ namespace vultra
 
             // === Get Generic Queue (for both graphics & compute) ===
             m_Device.getQueue(m_GenericQueueFamilyIndex, 0, &m_GenericQueue);
+            if (m_AsyncComputeQueueFamilyIndex != -1)
+            {
+                m_Device.getQueue(m_AsyncComputeQueueFamilyIndex, 0, &m_AsyncComputeQueue);
+            }
         }
 
         void RenderDevice::createMemoryAllocator()
@@ -1416,14 +1818,24 @@ namespace vultra
                 // When using raytracing/query or mesh shading, enable the buffer device address feature in VMA
                 allocatorInfo.flags |= vma::AllocatorCreateFlagBits::eBufferDeviceAddress;
             }
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eMemoryBudget))
+            {
+                allocatorInfo.flags |= vma::AllocatorCreateFlagBits::eExtMemoryBudget;
+            }
 
             vma::Allocator allocator;
             VK_CHECK(vma::createAllocator(&allocatorInfo, &allocator), LOGTAG, "Failed to create memory allocator");
 
             m_MemoryAllocator = allocator;
+
+            m_HeapPeakUsage.assign(m_PhysicalDevice.getMemoryProperties().memoryHeapCount, 0);
+            for (const auto* name : kMemoryPlotNames)
+            {
+                TracyPlotConfig(name, tracy::PlotFormatType::Memory, false, true, 0);
+            }
         }
 
-        void RenderDevice::createCommandPool()
+        void RenderDevice::createCommandPools()
         {
             vk::CommandPoolCreateInfo createInfo {};
             createInfo.flags            = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
@@ -1431,6 +1843,14 @@ namespace vultra
             VK_CHECK(m_Device.createCommandPool(&createInfo, nullptr, &m_CommandPool),
                      LOGTAG,
                      "Failed to create command pool");
+
+            if (hasAsyncComputeQueue())
+            {
+                createInfo.queueFamilyIndex = m_AsyncComputeQueueFamilyIndex;
+                VK_CHECK(m_Device.createCommandPool(&createInfo, nullptr, &m_AsyncComputeCommandPool),
+                         LOGTAG,
+                         "Failed to create async compute command pool");
+            }
         }
 
         void RenderDevice::createPipelineCache()
@@ -1439,6 +1859,11 @@ namespace vultra
             VK_CHECK(m_Device.createPipelineCache(&createInfo, nullptr, &m_PipelineCache),
                      LOGTAG,
                      "Failed to create pipeline cache");
+
+            if (HasFlagValues(m_FeatureReport.flags, RenderDeviceFeatureReportFlagBits::eGraphicsPipelineLibrary))
+            {
+                m_GraphicsPipelineLibrary = createScope<GraphicsPipelineLibrary>(m_Device, m_PipelineCache);
+            }
         }
 
         void RenderDevice::createDefaultDescriptorPool()
@@ -1466,25 +1891,44 @@ namespace vultra
             m_DefaultDescriptorPool = m_Device.createDescriptorPool(descriptorPoolCreateInfo);
         }
 
+        void RenderDevice::createDescriptorSetCache()
+        {
+            const auto raytracing = isRaytracingOrRayQueryEnabled(m_FeatureFlag);
+            // The constructor is private (hence no createScope).
+            m_DescriptorSetCache.reset(new DescriptorSetCache {m_Device, &m_DescriptorPoolSizer, raytracing});
+        }
+
         void RenderDevice::createTracyContext()
         {
 #ifdef TRACY_ENABLE
-            const auto cmdBuffer = allocateCommandBuffer();
+            const auto cmdBuffer = allocateCommandBuffer(m_CommandPool);
             m_TracyContext       = TracyVkContext(m_PhysicalDevice, m_Device, m_GenericQueue, cmdBuffer);
             m_Device.freeCommandBuffers(m_CommandPool, 1, &cmdBuffer);
             const auto deviceName = getPhysicalDeviceInfo().deviceName;
             TracyVkContextName(m_TracyContext, deviceName.data(), static_cast<uint16_t>(deviceName.length()));
+
+            // A separate context gives the async compute queue its own track in the GPU timeline.
+            if (hasAsyncComputeQueue())
+            {
+                const auto computeCmdBuffer = allocateCommandBuffer(m_AsyncComputeCommandPool);
+                m_AsyncComputeTracyContext =
+                    TracyVkContext(m_PhysicalDevice, m_Device, m_AsyncComputeQueue, computeCmdBuffer);
+                m_Device.freeCommandBuffers(m_AsyncComputeCommandPool, 1, &computeCmdBuffer);
+                const auto contextName = deviceName + " (Async Compute)";
+                TracyVkContextName(
+                    m_AsyncComputeTracyContext, contextName.data(), static_cast<uint16_t>(contextName.length()));
+            }
 #endif
         }
 
         void RenderDevice::createTracky() { TRACKY_STARTUP(m_Device, 64 * 1024); }
 
-        vk::CommandBuffer RenderDevice::allocateCommandBuffer() const
+        vk::CommandBuffer RenderDevice::allocateCommandBuffer(const vk::CommandPool commandPool) const
         {
-            assert(m_Device);
+            assert(m_Device && commandPool);
 
             vk::CommandBufferAllocateInfo allocateInfo {};
-            allocateInfo.commandPool        = m_CommandPool;
+            allocateInfo.commandPool        = commandPool;
             allocateInfo.level              = vk::CommandBufferLevel::ePrimary;
             allocateInfo.commandBufferCount = 1;
 
@@ -1523,14 +1967,42 @@ namespace vultra
             return sampler;
         }
 
-        CommandBuffer RenderDevice::createCommandBuffer() const
+        CommandBuffer RenderDevice::createCommandBuffer(const QueueType queueType) const
         {
+            if (queueType == QueueType::eAsyncCompute)
+            {
+                assert(hasAsyncComputeQueue());
+                return CommandBuffer {m_Device,
+                                      m_AsyncComputeCommandPool,
+                                      allocateCommandBuffer(m_AsyncComputeCommandPool),
+                                      m_AsyncComputeTracyContext,
+                                      createFence(),
+                                      m_DescriptorSetCache.get(),
+                                      QueueType::eAsyncCompute};
+            }
             return CommandBuffer {m_Device,
                                   m_CommandPool,
-                                  allocateCommandBuffer(),
+                                  allocateCommandBuffer(m_CommandPool),
                                   m_TracyContext,
                                   createFence(),
-                                  isRaytracingOrRayQueryEnabled(m_FeatureFlag)};
+                                  m_DescriptorSetCache.get(),
+                                  QueueType::eGeneric};
+        }
+
+        CommandPool RenderDevice::createCommandPool(const QueueType queueType) const
+        {
+            vk::CommandPoolCreateInfo createInfo {};
+            createInfo.flags            = vk::CommandPoolCreateFlagBits::eTransient;
+            createInfo.queueFamilyIndex = getQueueFamilyIndex(queueType);
+            vk::CommandPool commandPool {nullptr};
+            VK_CHECK(m_Device.createCommandPool(&createInfo, nullptr, &commandPool),
+                     LOGTAG,
+                     "Failed to create command pool");
+            return CommandPool {m_Device,
+                                commandPool,
+                                queueType == QueueType::eAsyncCompute ? m_AsyncComputeTracyContext : m_TracyContext,
+                                m_DescriptorSetCache.get(),
+                                queueType};
         }
 
         RenderDevice& RenderDevice::execute(const std::function<void(CommandBuffer&)>& f, bool oneTime)
@@ -1549,29 +2021,37 @@ namespace vultra
         RenderDevice& RenderDevice::execute(CommandBuffer& cb, const JobInfo& jobInfo, bool oneTime)
         {
             cb.flushBarriers();
-            TracyVkCollect(m_TracyContext, cb.m_Handle);
+            TracyVkCollect(cb.m_TracyContext, cb.m_Handle);
             cb.end();
             assert(cb.invariant(CommandBuffer::State::eExecutable));
 
             vk::CommandBufferSubmitInfo commandBufferInfo {};
             commandBufferInfo.commandBuffer = cb.m_Handle;
 
-            vk::SemaphoreSubmitInfo waitSemaphoreInfo {};
-            waitSemaphoreInfo.semaphore = jobInfo.wait;
-            waitSemaphoreInfo.stageMask = jobInfo.waitStage;
+            // Waits recorded on the command buffer itself (cross-queue dependencies) come first.
+            auto waitSemaphoreInfos = std::exchange(cb.m_WaitSemaphores, {});
+            if (jobInfo.wait)
+            {
+                auto& waitSemaphoreInfo     = waitSemaphoreInfos.emplace_back();
+                waitSemaphoreInfo.semaphore = jobInfo.wait;
+                waitSemaphoreInfo.value     = jobInfo.waitValue;
+                waitSemaphoreInfo.stageMask = jobInfo.waitStage;
+            }
 
             vk::SemaphoreSubmitInfo signalSemaphoreInfo {};
             signalSemaphoreInfo.semaphore = jobInfo.signal;
+            signalSemaphoreInfo.value     = jobInfo.signalValue;
 
             vk::SubmitInfo2 submitInfo {};
-            submitInfo.waitSemaphoreInfoCount   = jobInfo.wait != nullptr ? 1u : 0u;
-            submitInfo.pWaitSemaphoreInfos      = jobInfo.wait ? &waitSemaphoreInfo : nullptr;
+            submitInfo.waitSemaphoreInfoCount   = static_cast<uint32_t>(waitSemaphoreInfos.size());
+            submitInfo.pWaitSemaphoreInfos      = waitSemaphoreInfos.data();
             submitInfo.commandBufferInfoCount   = 1;
             submitInfo.pCommandBufferInfos      = &commandBufferInfo;
             submitInfo.signalSemaphoreInfoCount = jobInfo.signal != nullptr ? 1u : 0u;
             submitInfo.pSignalSemaphoreInfos    = jobInfo.signal ? &signalSemaphoreInfo : nullptr;
 
-            VK_CHECK(m_GenericQueue.submit2KHR(1, &submitInfo, cb.m_Fence), LOGTAG, "Failed to submit command buffer");
+            const auto queue = cb.m_QueueType == QueueType::eAsyncCompute ? m_AsyncComputeQueue : m_GenericQueue;
+            VK_CHECK(queue.submit2KHR(1, &submitInfo, cb.m_Fence), LOGTAG, "Failed to submit command buffer");
 
             if (oneTime)
             {
@@ -1645,6 +2125,7 @@ namespace vultra
         {
             assert(m_Device);
             m_Device.waitIdle();
+            m_DeletionQueue->flush();
             return *this;
         }
 
@@ -2067,6 +2548,7 @@ namespace vultra
                 vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
                 makeAllocationFlags(allocationHint),
                 vma::MemoryUsage::eAutoPreferDevice,
+                MemoryCategory::eAccelerationStructure,
             };
 
             uint64_t bufferAddress = getBufferDeviceAddress(buffer);
@@ -2085,6 +2567,7 @@ namespace vultra
                     vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR,
                 makeAllocationFlags(allocationHint),
                 vma::MemoryUsage::eCpuToGpu, // Host visible & coherent for easy mapping
+                MemoryCategory::eAccelerationStructure,
             };
         }
 
@@ -2099,6 +2582,7 @@ namespace vultra
                     vk::BufferUsageFlagBits::eAccelerationStructureBuildInputReadOnlyKHR,
                 makeAllocationFlags(allocationHint),
                 vma::MemoryUsage::eCpuToGpu, // Host visible & coherent for easy mapping
+                MemoryCategory::eAccelerationStructure,
             };
         }
 
@@ -2143,6 +2627,7 @@ namespace vultra
                     vk::BufferUsageFlagBits::eTransferDst,
                 makeAllocationFlags(allocationHint),
                 vma::MemoryUsage::eCpuToGpu, // Host visible & coherent for easy mapping
+                MemoryCategory::eAccelerationStructure,
             };
 
             std::vector<uint8_t> handles(sbtSize);
@@ -2225,6 +2710,7 @@ namespace vultra
                         vk::BufferUsageFlagBits::eShaderDeviceAddress,
                     makeAllocationFlags(allocationHint),
                     vma::MemoryUsage::eAutoPreferDevice,
+                    MemoryCategory::eAccelerationStructure,
                 },
             };
         }
@@ -2298,6 +2784,7 @@ namespace vultra
                 vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
                 makeAllocationFlags(allocationHint),
                 vma::MemoryUsage::eAutoPreferDevice,
+                MemoryCategory::eDescriptor,
             };
 
             return createRef<rhi::Buffer>(std::move(buffer));
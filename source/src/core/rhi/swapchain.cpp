@@ -1,5 +1,6 @@
 #include "vultra/core/rhi/swapchain.hpp"
 #include "vultra/core/os/window.hpp"
+#include "vultra/core/rhi/deletion_queue.hpp"
 #include "vultra/core/rhi/vk/macro.hpp"
 
 #include "vultra/core/profiling/tracy_wrapper.hpp"
@@ -71,18 +72,49 @@ namespace vultra
                 assert(false);
                 return vk::PresentModeKHR::eImmediate;
             }
+
+            // Frames in flight might still render to (or present) the images of a recreated swapchain.
+            class RetiredSwapchain final
+            {
+            public:
+                RetiredSwapchain(const vk::Device       device,
+                                 const vk::SwapchainKHR handle,
+                                 std::vector<Texture>&& buffers) :
+                    m_Device(device), m_Handle(handle), m_Buffers(std::move(buffers))
+                {}
+                RetiredSwapchain(const RetiredSwapchain&) = delete;
+                RetiredSwapchain(RetiredSwapchain&& other) noexcept :
+                    m_Device(other.m_Device), m_Handle(std::exchange(other.m_Handle, nullptr)),
+                    m_Buffers(std::move(other.m_Buffers))
+                {}
+                ~RetiredSwapchain()
+                {
+                    m_Buffers.clear();
+                    if (m_Handle)
+                        m_Device.destroySwapchainKHR(m_Handle);
+                }
+
+                RetiredSwapchain& operator=(const RetiredSwapchain&)     = delete;
+                RetiredSwapchain& operator=(RetiredSwapchain&&) noexcept = delete;
+
+            private:
+                vk::Device           m_Device {nullptr};
+                vk::SwapchainKHR     m_Handle {nullptr};
+                std::vector<Texture> m_Buffers;
+            };
         } // namespace
 
         Swapchain::Swapchain(Swapchain&& other) noexcept :
             m_Window(other.m_Window), m_Instance(other.m_Instance), m_PhysicalDevice(other.m_PhysicalDevice),
-            m_Device(other.m_Device), m_Surface(other.m_Surface), m_Handle(other.m_Handle), m_Format(other.m_Format),
-            m_VerticalSync(other.m_VerticalSync), m_Buffers(std::move(other.m_Buffers)),
-            m_CurrentImageIndex(other.m_CurrentImageIndex)
+            m_Device(other.m_Device), m_DeletionQueue(other.m_DeletionQueue), m_Surface(other.m_Surface),
+            m_Handle(other.m_Handle), m_Format(other.m_Format), m_VerticalSync(other.m_VerticalSync),
+            m_Buffers(std::move(other.m_Buffers)), m_CurrentImageIndex(other.m_CurrentImageIndex)
         {
             other.m_Window            = nullptr;
             other.m_Instance          = nullptr;
             other.m_PhysicalDevice    = nullptr;
             other.m_Device            = nullptr;
+            other.m_DeletionQueue     = nullptr;
             other.m_Surface           = nullptr;
             other.m_Handle            = nullptr;
             other.m_CurrentImageIndex = 0;
@@ -100,6 +132,7 @@ namespace vultra
                 std::swap(m_Instance, rhs.m_Instance);
                 std::swap(m_PhysicalDevice, rhs.m_PhysicalDevice);
                 std::swap(m_Device, rhs.m_Device);
+                std::swap(m_DeletionQueue, rhs.m_DeletionQueue);
                 std::swap(m_Surface, rhs.m_Surface);
                 std::swap(m_Handle, rhs.m_Handle);
                 std::swap(m_Format, rhs.m_Format);
@@ -134,7 +167,6 @@ namespace vultra
 
         void Swapchain::recreate(const std::optional<VerticalSync> vsync)
         {
-            m_Buffers.clear();
             create(m_Format, vsync.value_or(m_VerticalSync));
         }
 
@@ -164,11 +196,14 @@ namespace vultra
         Swapchain::Swapchain(const vk::Instance       instance,
                              const vk::PhysicalDevice physicalDevice,
                              const vk::Device         device,
+                             DeletionQueue*           deletionQueue,
                              os::Window*              window,
                              const Format             format,
                              const VerticalSync       vsync) :
-            m_Instance(instance), m_PhysicalDevice(physicalDevice), m_Device(device), m_Window(window)
+            m_Window(window), m_Instance(instance), m_PhysicalDevice(physicalDevice), m_Device(device),
+            m_DeletionQueue(deletionQueue)
         {
+            assert(deletionQueue);
             createSurface();
             create(format, vsync);
         }
@@ -181,9 +216,10 @@ namespace vultra
 
         void Swapchain::create(Format format, VerticalSync vsync)
         {
-            m_Device.waitIdle();
-
+            // The old swapchain (and its images) are released through the DeletionQueue, no need to wait for the GPU.
             const auto oldSwapchain = std::exchange(m_Handle, nullptr);
+            auto       oldBuffers   = std::move(m_Buffers);
+            m_Buffers.clear();
 
             const auto surfaceInfo = getSurfaceInfo(m_PhysicalDevice, m_Surface);
 
@@ -262,12 +298,9 @@ namespace vultra
 
             if (oldSwapchain)
             {
-                m_Device.waitIdle();
-                m_Device.destroySwapchainKHR(oldSwapchain);
+                m_DeletionQueue->push(RetiredSwapchain {m_Device, oldSwapchain, std::move(oldBuffers)});
             }
 
-            m_Device.waitIdle();
-
             VULTRA_CORE_TRACE("[Swapchain] Created, extent: ({}, {}), present mode: {}",
                               extent.width,
                               extent.height,
@@ -302,6 +335,8 @@ namespace vultra
             if (m_Handle)
             {
                 m_Device.waitIdle();
+                // Retired swapchains must go before the surface.
+                m_DeletionQueue->flush();
                 m_Device.destroySwapchainKHR(m_Handle);
                 m_Handle = nullptr;
             }
@@ -317,6 +352,7 @@ namespace vultra
             m_Instance       = nullptr;
             m_PhysicalDevice = nullptr;
             m_Device         = nullptr;
+            m_DeletionQueue  = nullptr;
 
             m_CurrentImageIndex = 0;
         }
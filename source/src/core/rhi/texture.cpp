@@ -137,6 +137,13 @@ namespace vultra
                 }
                 if (static_cast<bool>(usage & ImageUsage::eSampled))
                     out |= vk::ImageUsageFlagBits::eSampled;
+                if (static_cast<bool>(usage & ImageUsage::eTransient))
+                {
+                    // VUID-VkImageCreateInfo-usage-00963
+                    assert(!(out & ~(vk::ImageUsageFlagBits::eColorAttachment |
+                                     vk::ImageUsageFlagBits::eDepthStencilAttachment)));
+                    out |= vk::ImageUsageFlagBits::eTransientAttachment;
+                }
 
                 // UNASSIGNED-BestPractices-vkImage-DontUseStorageRenderTargets
                 [[maybe_unused]] constexpr auto kForbiddenSet =
@@ -149,19 +156,23 @@ namespace vultra
         Texture::Texture(Texture&& other) noexcept :
             m_DeviceOrAllocator(std::move(other.m_DeviceOrAllocator)), m_Image(std::move(other.m_Image)),
             m_Type(other.m_Type), m_Layout(other.m_Layout), m_LastScope(std::move(other.m_LastScope)),
+            m_SubresourceStates(std::move(other.m_SubresourceStates)), m_QueueFamilyIndex(other.m_QueueFamilyIndex),
             m_Aspects(std::move(other.m_Aspects)), m_Sampler(other.m_Sampler), m_Extent(other.m_Extent),
             m_Depth(other.m_Depth), m_Format(other.m_Format), m_NumMipLevels(other.m_NumMipLevels),
-            m_NumLayers(other.m_NumLayers), m_LayerFaces(other.m_LayerFaces), m_UsageFlags(other.m_UsageFlags)
+            m_NumLayers(other.m_NumLayers), m_LayerFaces(other.m_LayerFaces), m_UsageFlags(other.m_UsageFlags),
+            m_Id(other.m_Id), m_MemoryCategory(other.m_MemoryCategory)
         {
             other.m_DeviceOrAllocator = {};
             other.m_Image             = {};
 
-            other.m_Type   = TextureType::eUndefined;
-            other.m_Layout = ImageLayout::eUndefined;
+            other.m_Type             = TextureType::eUndefined;
+            other.m_Layout           = ImageLayout::eUndefined;
+            other.m_QueueFamilyIndex = vk::QueueFamilyIgnored;
 
             other.m_Sampler = nullptr;
 
             other.m_Format = PixelFormat::eUndefined;
+            other.m_Id     = 0;
         }
 
         Texture::~Texture() { destroy(); }
@@ -177,6 +188,8 @@ namespace vultra
                 std::swap(m_Type, rhs.m_Type);
                 std::swap(m_Layout, rhs.m_Layout);
                 std::swap(m_LastScope, rhs.m_LastScope);
+                std::swap(m_SubresourceStates, rhs.m_SubresourceStates);
+                std::swap(m_QueueFamilyIndex, rhs.m_QueueFamilyIndex);
                 std::swap(m_Aspects, rhs.m_Aspects);
                 std::swap(m_Sampler, rhs.m_Sampler);
                 std::swap(m_Extent, rhs.m_Extent);
@@ -186,6 +199,8 @@ namespace vultra
                 std::swap(m_NumLayers, rhs.m_NumLayers);
                 std::swap(m_LayerFaces, rhs.m_LayerFaces);
                 std::swap(m_UsageFlags, rhs.m_UsageFlags);
+                std::swap(m_Id, rhs.m_Id);
+                std::swap(m_MemoryCategory, rhs.m_MemoryCategory);
             }
 
             return *this;
@@ -278,6 +293,23 @@ namespace vultra
 
         vk::Sampler Texture::getSampler() const { return m_Sampler; }
 
+        uint64_t Texture::getId() const { return m_Id; }
+
+        MemoryCategory Texture::getMemoryCategory() const { return m_MemoryCategory; }
+
+        Texture& Texture::setMemoryCategory(const MemoryCategory category)
+        {
+            // Imported (swapchain) images are not ours to account.
+            if (const auto* allocatedImage = std::get_if<AllocatedImage>(&m_Image);
+                allocatedImage && category != m_MemoryCategory)
+            {
+                trackMemory(m_MemoryCategory, -static_cast<int64_t>(allocatedImage->size));
+                trackMemory(category, static_cast<int64_t>(allocatedImage->size));
+            }
+            m_MemoryCategory = category;
+            return *this;
+        }
+
         Texture::Builder& Texture::Builder::setExtent(const Extent2D extent, const uint32_t depth)
         {
             m_Extent = extent;
@@ -365,7 +397,8 @@ namespace vultra
             return texture;
         }
 
-        Texture::Texture(vma::Allocator memoryAllocator, CreateInfo&& ci) : m_DeviceOrAllocator(memoryAllocator)
+        Texture::Texture(vma::Allocator memoryAllocator, CreateInfo&& ci) :
+            m_DeviceOrAllocator(memoryAllocator), m_Id(generateResourceId())
         {
             assert(ci.extent && (ci.numFaces != 6 || ci.extent.width == ci.extent.height));
 
@@ -407,12 +440,19 @@ namespace vultra
 
             vma::AllocationCreateInfo allocationCreateInfo {};
             allocationCreateInfo.usage = vma::MemoryUsage::eGpuOnly;
+            if (static_cast<bool>(ci.usageFlags & ImageUsage::eTransient))
+            {
+                allocationCreateInfo.preferredFlags = vk::MemoryPropertyFlagBits::eLazilyAllocated;
+            }
 
-            AllocatedImage image;
+            AllocatedImage      image;
+            vma::AllocationInfo allocationInfo {};
             VK_CHECK(memoryAllocator.createImage(
-                         &imageCreateInfo, &allocationCreateInfo, &image.handle, &image.allocation, nullptr),
+                         &imageCreateInfo, &allocationCreateInfo, &image.handle, &image.allocation, &allocationInfo),
                      "Texture",
                      "Failed to create image");
+            image.size = allocationInfo.size;
+            trackMemory(m_MemoryCategory, static_cast<int64_t>(image.size));
 
             m_Image        = image;
             m_Layout       = static_cast<ImageLayout>(imageCreateInfo.initialLayout);
@@ -452,7 +492,7 @@ namespace vultra
                          PixelFormat pixelFormat,
                          uint32_t    baseLayer) :
             m_DeviceOrAllocator(device), m_Image(handle), m_Type(TextureType::eTexture2D), m_Extent(extent),
-            m_Format(pixelFormat), m_UsageFlags(kSwapchainDefaultUsageFlags)
+            m_Format(pixelFormat), m_UsageFlags(kSwapchainDefaultUsageFlags), m_Id(generateResourceId())
         {
             m_Aspects[static_cast<uint32_t>(vk::ImageAspectFlagBits::eColor)].imageView =
                 createImageView(device,
@@ -502,6 +542,7 @@ namespace vultra
             {
                 std::get<vma::Allocator>(m_DeviceOrAllocator)
                     .destroyImage(allocatedImage->handle, allocatedImage->allocation);
+                trackMemory(m_MemoryCategory, -static_cast<int64_t>(allocatedImage->size));
             }
 
             m_DeviceOrAllocator = {};
@@ -509,7 +550,9 @@ namespace vultra
 
             m_Type = TextureType::eUndefined;
 
-            m_Layout = ImageLayout::eUndefined;
+            m_Layout           = ImageLayout::eUndefined;
+            m_QueueFamilyIndex = vk::QueueFamilyIgnored;
+            m_SubresourceStates.clear();
 
             m_Extent       = {};
             m_Depth        = 0u;
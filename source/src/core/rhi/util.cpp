@@ -3,6 +3,8 @@
 #include "vultra/core/rhi/render_device.hpp"
 #include "vultra/core/rhi/texture.hpp"
 
+#include <atomic>
+
 namespace vultra
 {
     namespace rhi
@@ -64,5 +66,11 @@ namespace vultra
         {
             return (size + alignment - 1) & ~(alignment - 1);
         }
+
+        uint64_t generateResourceId()
+        {
+            static std::atomic<uint64_t> s_NextId {1};
+            return s_NextId.fetch_add(1, std::memory_order_relaxed);
+        }
     } // namespace rhi
 } // namespace vultra
\ No newline at end of file
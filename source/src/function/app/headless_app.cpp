@@ -0,0 +1,111 @@
+#include "vultra/function/app/headless_app.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/function/service/services.hpp"
+
+namespace vultra
+{
+    namespace
+    {
+        [[nodiscard]] rhi::PixelFormat toTargetPixelFormat(const rhi::Swapchain::Format format)
+        {
+            // Unlike a swapchain (BGRA8), so saveTextureToFile can write the pixels as they are.
+            return format == rhi::Swapchain::Format::esRGB ? rhi::PixelFormat::eRGBA8_sRGB :
+                                                             rhi::PixelFormat::eRGBA8_UNorm;
+        }
+    } // namespace
+
+    HeadlessApp::HeadlessApp(std::span<char*>, const AppConfig& appConfig, const HeadlessConfig& headlessConfig) :
+        m_HeadlessConfig(headlessConfig), m_TargetFormat(appConfig.swapchainFormat),
+        m_RenderDevice(std::make_unique<rhi::RenderDevice>(
+            appConfig.renderDeviceFeatureFlag | rhi::RenderDeviceFeatureFlagBits::eHeadless, appConfig.title))
+    {
+        VULTRA_CORE_INFO("[App] {} running headless on {}", appConfig.title, m_RenderDevice->getName());
+        // Regression runs compare frames, no draw may be skipped while its pipeline compiles.
+        m_RenderDevice->getPipelineCompiler().setEnabled(false);
+
+        m_FrameController = rhi::FrameController {
+            *m_RenderDevice,
+            rhi::Extent2D {appConfig.width, appConfig.height},
+            toTargetPixelFormat(m_TargetFormat),
+            appConfig.numFramesInFlight,
+        };
+
+        service::Services::init(*m_RenderDevice);
+    }
+
+    rhi::RenderDevice& HeadlessApp::getRenderDevice() { return *m_RenderDevice; }
+
+    rhi::FrameController& HeadlessApp::getFrameController() { return m_FrameController; }
+
+    rhi::Swapchain::Format HeadlessApp::getTargetFormat() const { return m_TargetFormat; }
+
+    void HeadlessApp::run()
+    {
+        using clock = std::chrono::high_resolution_clock;
+
+        const auto deltaTime  = m_HeadlessConfig.fixedDeltaTime;
+        const auto beginTicks = clock::now();
+
+        while (m_IsRunning && (m_HeadlessConfig.numFrames == 0 || m_FrameCounter < m_HeadlessConfig.numFrames))
+        {
+            {
+                ZoneScopedN("[App] Update");
+                onUpdate(deltaTime);
+            }
+            {
+                ZoneScopedN("[App] PhysicsUpdate");
+                onPhysicsUpdate(deltaTime);
+            }
+            {
+                ZoneScopedN("[App] PostUpdate");
+                onPostUpdate(deltaTime);
+            }
+            if (!m_IsRunning)
+                break;
+
+            {
+                ZoneScopedN("[App] PreRender");
+                onPreRender();
+            }
+            {
+                ZoneScopedN("[App] Render");
+
+                // Never fails offscreen, only throttles on the frame that used the slot before.
+                m_FrameController.acquireNextFrame();
+
+                auto& cb = m_FrameController.beginFrame();
+                onRender(cb, m_FrameController.getCurrentTarget(), deltaTime);
+                m_FrameController.endFrame();
+            }
+            {
+                ZoneScopedN("[App] PostRender");
+                onPostRender();
+            }
+            m_FrameController.present();
+            m_FrameCounter++;
+
+            FrameMark;
+        }
+
+        m_RenderDevice->waitIdle();
+
+        const fsec elapsed = clock::now() - beginTicks;
+        if (m_FrameCounter > 0)
+        {
+            VULTRA_CORE_INFO("[App] Rendered {} frames in {:.3f}s ({:.3f} ms/frame)",
+                             m_FrameCounter,
+                             elapsed.count(),
+                             elapsed.count() * 1000.0f / static_cast<float>(m_FrameCounter));
+        }
+
+        commonContext.cleanup();
+        service::Services::reset();
+    }
+
+    void HeadlessApp::close() { m_IsRunning = false; }
+
+    bool HeadlessApp::saveCurrentFrame(const std::string& filePath)
+    {
+        return m_RenderDevice->saveTextureToFile(m_FrameController.getCurrentTarget().texture, filePath);
+    }
+} // namespace vultra
\ No newline at end of file
@@ -48,6 +48,12 @@ namespace vultra
         if (!m_NeedsPipelineRebuild)
             return;
 
+        if (m_LineGraphicsPipeline)
+        {
+            // Might still be used by the frames in flight.
+            m_RenderDevice->getDeletionQueue().push(std::move(m_LineGraphicsPipeline));
+        }
+
         auto builder = rhi::GraphicsPipeline::Builder {};
         builder.setColorFormats({m_ColorFormat});
 
@@ -119,6 +125,7 @@ namespace vultra
 
         if (dataSize > m_VertexBuffer.getSize())
         {
+            m_RenderDevice->getDeletionQueue().push(std::move(m_VertexBuffer));
             m_VertexBuffer = m_RenderDevice->createVertexBuffer(sizeof(DrawVertex), count);
         }
 
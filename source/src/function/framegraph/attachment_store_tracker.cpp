@@ -0,0 +1,74 @@
+#include "vultra/function/framegraph/attachment_store_tracker.hpp"
+
+#include <cassert>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        void AttachmentStoreTracker::begin()
+        {
+            assert(!m_Recording);
+            m_Recording                 = true;
+            m_NumCurrentWrites          = 0;
+            m_NumCurrentDiscardedWrites = 0;
+        }
+
+        void AttachmentStoreTracker::end()
+        {
+            assert(m_Recording);
+            m_Recording          = false;
+            m_NumWrites          = m_NumCurrentWrites;
+            m_NumDiscardedWrites = m_NumCurrentDiscardedWrites;
+        }
+
+        bool AttachmentStoreTracker::onAttachmentWrite(AttachmentWrites& writes)
+        {
+            const auto index = writes.next++;
+
+            auto store = true;
+            if (writes.complete)
+            {
+                // Same graph, same writes in the same order.
+                assert(index < writes.accessed.size());
+                store = index >= writes.accessed.size() || writes.accessed[index];
+            }
+            else
+            {
+                writes.accessed.push_back(false);
+            }
+            writes.pending = index;
+
+            if (m_Recording)
+            {
+                ++m_NumCurrentWrites;
+                if (!store)
+                {
+                    ++m_NumCurrentDiscardedWrites;
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        void AttachmentStoreTracker::onAccess(AttachmentWrites& writes)
+        {
+            if (writes.pending && !writes.complete)
+            {
+                writes.accessed[*writes.pending] = true;
+            }
+            writes.pending.reset();
+        }
+
+        void AttachmentStoreTracker::onRelease(AttachmentWrites& writes)
+        {
+            writes.complete = true;
+            writes.next     = 0;
+            writes.pending.reset();
+        }
+
+        uint32_t AttachmentStoreTracker::getNumWrites() const { return m_NumWrites; }
+
+        uint32_t AttachmentStoreTracker::getNumDiscardedWrites() const { return m_NumDiscardedWrites; }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -12,13 +12,31 @@ namespace vultra
     {
         void FrameGraphBuffer::create(const Desc& desc, void* allocator)
         {
-            buffer = static_cast<TransientResources*>(allocator)->acquireBuffer(desc);
+            auto& transientResources = *static_cast<TransientResources*>(allocator);
+            if (desc.hostWrite)
+            {
+                if (const auto allocation = transientResources.getUploadRing().allocate(desc.type, desc.dataSize());
+                    allocation)
+                {
+                    buffer       = allocation->buffer;
+                    offset       = allocation->offset;
+                    mappedMemory = allocation->mappedMemory;
+                    return;
+                }
+            }
+            buffer = transientResources.acquireBuffer(desc);
         }
 
         void FrameGraphBuffer::destroy(const Desc& desc, void* allocator)
         {
-            static_cast<TransientResources*>(allocator)->releaseBuffer(desc, buffer);
-            buffer = nullptr;
+            // The ring recycles its segments on its own.
+            if (!mappedMemory)
+            {
+                static_cast<TransientResources*>(allocator)->releaseBuffer(desc, buffer);
+            }
+            buffer       = nullptr;
+            offset       = 0;
+            mappedMemory = nullptr;
         }
 
         void FrameGraphBuffer::preRead(const Desc& desc, uint32_t flags, void* ctx)
@@ -57,19 +75,28 @@ namespace vultra
                         break;
                 }
 
+                const auto range = mappedMemory ? std::optional {desc.dataSize()} : std::nullopt;
+
                 const auto [set, binding] = bindingInfo.location;
                 switch (desc.type)
                 {
                     case BufferType::eUniformBuffer:
-                        rc.resourceSet[set][binding] = rhi::bindings::UniformBuffer {.buffer = buffer};
+                        rc.resourceSet[set][binding] =
+                            rhi::bindings::UniformBuffer {.buffer = buffer, .offset = offset, .range = range};
                         break;
                     case BufferType::eStorageBuffer:
-                        rc.resourceSet[set][binding] = rhi::bindings::StorageBuffer {.buffer = buffer};
+                        rc.resourceSet[set][binding] =
+                            rhi::bindings::StorageBuffer {.buffer = buffer, .offset = offset, .range = range};
                         break;
                     default:
                         break;
                 }
             }
+            // Host writes are made visible by the submission itself.
+            if (mappedMemory)
+            {
+                return;
+            }
             dst.stageMask |= convert(bindingInfo.pipelineStage);
             rc.commandBuffer.getBarrierBuilder().bufferBarrier({.buffer = *buffer}, dst);
         }
@@ -81,6 +108,12 @@ namespace vultra
             auto& rc                             = *static_cast<RenderContext*>(ctx);
             const auto [location, pipelineStage] = decodeBindingInfo(flags);
 
+            if (mappedMemory)
+            {
+                VULTRA_CUSTOM_ASSERT(static_cast<bool>(pipelineStage & PipelineStage::eTransfer));
+                return;
+            }
+
             rhi::BarrierScope dst {};
             if (static_cast<bool>(pipelineStage & PipelineStage::eTransfer))
             {
@@ -0,0 +1,68 @@
+#include "vultra/function/framegraph/framegraph_build_stats.hpp"
+#include "vultra/core/base/common_context.hpp"
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        namespace
+        {
+            [[nodiscard]] float toMilliseconds(const auto duration)
+            {
+                return std::chrono::duration<float, std::milli> {duration}.count();
+            }
+
+            // Exponential moving average, smooths the per-frame jitter of the displayed values.
+            void accumulate(float& average, const float value, const bool reset)
+            {
+                constexpr auto kSmoothing = 0.1f;
+                average                   = reset ? value : average + (value - average) * kSmoothing;
+            }
+        } // namespace
+
+        bool FrameGraphBuildTracker::beginSetup(const std::size_t topologyKey)
+        {
+            const auto first  = m_Stats.numBuilds + m_Stats.numReuses == 0;
+            m_TopologyChanged = first || m_Stats.topologyKey != topologyKey;
+            if (m_TopologyChanged)
+            {
+                if (!first)
+                {
+                    VULTRA_CORE_TRACE(
+                        "[FrameGraph] Topology changed: {:#x} -> {:#x}", m_Stats.topologyKey, topologyKey);
+                }
+                m_Stats.topologyKey = topologyKey;
+                ++m_Stats.numTopologyChanges;
+            }
+
+            m_SetupStart = Clock::now();
+            return m_TopologyChanged;
+        }
+
+        void FrameGraphBuildTracker::beginCompile() { m_CompileStart = Clock::now(); }
+
+        void FrameGraphBuildTracker::end()
+        {
+            const auto now   = Clock::now();
+            const auto first = m_Stats.numBuilds + m_Stats.numReuses == 0;
+
+            accumulate(m_Stats.setupTime, toMilliseconds(m_CompileStart - m_SetupStart), first);
+            accumulate(m_Stats.compileTime, toMilliseconds(now - m_CompileStart), first);
+            ++m_Stats.numBuilds;
+        }
+
+        void FrameGraphBuildTracker::reuse()
+        {
+            const auto now   = Clock::now();
+            const auto first = m_Stats.numBuilds + m_Stats.numReuses == 0;
+
+            accumulate(m_Stats.setupTime, toMilliseconds(now - m_SetupStart), first);
+            accumulate(m_Stats.compileTime, 0.0f, first);
+            ++m_Stats.numReuses;
+        }
+
+        bool FrameGraphBuildTracker::isTopologyChanged() const { return m_TopologyChanged; }
+
+        const FrameGraphBuildStats& FrameGraphBuildTracker::getStats() const { return m_Stats; }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,41 @@
+#include "vultra/function/framegraph/framegraph_cache.hpp"
+
+#include <fg/FrameGraph.hpp>
+
+#include <algorithm>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        FrameGraphCache::FrameGraphCache(const uint32_t capacity) : m_Capacity(std::max(capacity, 1u))
+        {
+            m_Entries.reserve(m_Capacity);
+        }
+
+        FrameGraphCache::~FrameGraphCache() = default;
+
+        FrameGraph* FrameGraphCache::find(const std::size_t topologyKey)
+        {
+            const auto it = std::ranges::find(m_Entries, topologyKey, &Entry::topologyKey);
+            if (it == m_Entries.end())
+                return nullptr;
+
+            // Move to the back (most recently used)
+            std::rotate(it, it + 1, m_Entries.end());
+            return m_Entries.back().graph.get();
+        }
+
+        FrameGraph& FrameGraphCache::insert(const std::size_t topologyKey, Scope<FrameGraph>&& graph)
+        {
+            assert(graph && !find(topologyKey));
+            if (m_Entries.size() == m_Capacity)
+            {
+                m_Entries.erase(m_Entries.begin());
+            }
+            return *m_Entries.emplace_back(Entry {topologyKey, std::move(graph)}).graph;
+        }
+
+        uint32_t FrameGraphCache::size() const { return static_cast<uint32_t>(m_Entries.size()); }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
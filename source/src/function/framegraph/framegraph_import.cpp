@@ -8,20 +8,53 @@ namespace vultra
 {
     namespace framegraph
     {
+        namespace
+        {
+            [[nodiscard]] FrameGraphResource
+            importResource(FrameGraph& fg, const std::string_view name, FrameGraphTexture&& resource)
+            {
+                const auto* texture = resource.texture;
+                assert(texture && *texture);
+                return fg.import <FrameGraphTexture>(name,
+                                                     {
+                                                         .extent       = texture->getExtent(),
+                                                         .depth        = texture->getDepth(),
+                                                         .format       = texture->getPixelFormat(),
+                                                         .numMipLevels = texture->getNumMipLevels(),
+                                                         .layers       = texture->getNumLayers(),
+                                                         .cubemap      = rhi::isCubemap(*texture),
+                                                         .usageFlags   = texture->getUsageFlags(),
+                                                     },
+                                                     std::move(resource));
+            }
+        } // namespace
+
         FrameGraphResource importTexture(FrameGraph& fg, const std::string_view name, rhi::Texture* texture)
         {
-            assert(texture && *texture);
-            return fg.import <FrameGraphTexture>(name,
-                                                 {
-                                                     .extent       = texture->getExtent(),
-                                                     .depth        = texture->getDepth(),
-                                                     .format       = texture->getPixelFormat(),
-                                                     .numMipLevels = texture->getNumMipLevels(),
-                                                     .layers       = texture->getNumLayers(),
-                                                     .cubemap      = rhi::isCubemap(*texture),
-                                                     .usageFlags   = texture->getUsageFlags(),
-                                                 },
-                                                 {texture});
+            return importResource(fg, name, {.texture = texture});
+        }
+
+        FrameGraphResource importTexture(FrameGraph& fg, const std::string_view name, rhi::Texture* const* binding)
+        {
+            assert(binding);
+            return importResource(fg,
+                                  name,
+                                  {
+                                      .texture = *binding,
+                                      .binding = [binding] { return *binding; },
+                                  });
+        }
+
+        FrameGraphResource
+        importTexture(FrameGraph& fg, const std::string_view name, const Ref<rhi::Texture>* binding)
+        {
+            assert(binding);
+            return importResource(fg,
+                                  name,
+                                  {
+                                      .texture = binding->get(),
+                                      .binding = [binding] { return binding->get(); },
+                                  });
         }
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "vultra/core/base/string_util.hpp"
 #include "vultra/core/rhi/command_buffer.hpp"
 #include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/framegraph/attachment_store_tracker.hpp"
 #include "vultra/function/framegraph/framegraph_resource_access.hpp"
 #include "vultra/function/framegraph/render_context.hpp"
 #include "vultra/function/framegraph/transient_resources.hpp"
@@ -56,14 +57,33 @@ namespace vultra
                 return {};
             }
 
-            [[nodiscard]] auto makeAttachment(const Attachment& in, rhi::Texture* texture)
+            // Gives a queue scheduler the chance to move the recording before an image owned by another queue is
+            // accessed (see Barrier::Builder::QueueOwnership).
+            void notifyAccess(rhi::CommandBuffer& cb, const rhi::Texture& texture)
+            {
+                auto& builder = cb.getBarrierBuilder();
+                if (const auto& ownership = builder.getQueueOwnership();
+                    ownership && ownership->onForeignAccess && builder.isForeign(texture))
+                {
+                    // Copied, the callback may swap the recording (along with the barrier builder) of cb.
+                    const auto onForeignAccess = ownership->onForeignAccess;
+                    onForeignAccess(texture);
+                }
+            }
+
+            [[nodiscard]] auto makeAttachment(const Attachment& in,
+                                              rhi::Texture*     texture,
+                                              const bool        loadContents,
+                                              const bool        storeContents)
             {
                 assert(texture && *texture);
                 return rhi::AttachmentInfo {
-                    .target     = texture,
-                    .layer      = in.layer,
-                    .face       = map(in.face, StaticCast<rhi::CubeFace> {}),
-                    .clearValue = map(in.clearValue, convert),
+                    .target        = texture,
+                    .layer         = in.layer,
+                    .face          = map(in.face, StaticCast<rhi::CubeFace> {}),
+                    .clearValue    = map(in.clearValue, convert),
+                    .loadContents  = loadContents,
+                    .storeContents = storeContents,
                 };
             }
 
@@ -88,14 +108,29 @@ namespace vultra
                 return static_cast<VkDeviceSize>(size);
             }
 
+            void resolveBinding(const FrameGraphTexture& resource)
+            {
+                if (resource.binding)
+                {
+                    resource.texture = resource.binding();
+                    assert(resource.texture && *resource.texture);
+                }
+            }
         } // namespace
 
         void FrameGraphTexture::create(const Desc& desc, void* allocator)
         {
-            texture = static_cast<TransientResources*>(allocator)->acquireTexture(desc);
+            auto* transientResources = static_cast<TransientResources*>(allocator);
+
+            texture      = transientResources->acquireTexture(desc);
+            storeTracker = &transientResources->getAttachmentStoreTracker();
+            transient    = true;
+            written      = false;
         }
         void FrameGraphTexture::destroy(const Desc& desc, void* allocator)
         {
+            if (storeTracker)
+                storeTracker->onRelease(attachmentWrites);
             static_cast<TransientResources*>(allocator)->releaseTexture(desc, texture);
             texture = nullptr;
         }
@@ -104,7 +139,12 @@ namespace vultra
         {
             ZoneScopedN("T*");
 
+            resolveBinding(*this);
+
             auto& [cb, framebufferInfo, sets, _] = *static_cast<RenderContext*>(ctx);
+            notifyAccess(cb, *texture);
+            if (storeTracker)
+                storeTracker->onAccess(attachmentWrites);
 
             if (holdsAttachment(bits))
             {
@@ -194,11 +234,14 @@ namespace vultra
                     });
             }
         }
-        void FrameGraphTexture::preWrite(const Desc&, const uint32_t bits, void* ctx) const
+        void FrameGraphTexture::preWrite(const Desc& desc, const uint32_t bits, void* ctx) const
         {
             ZoneScopedN("+T");
 
+            resolveBinding(*this);
+
             auto& [cb, framebufferInfo, sets, _] = *static_cast<RenderContext*>(ctx);
+            notifyAccess(cb, *texture);
 
             if (holdsAttachment(bits))
             {
@@ -207,22 +250,34 @@ namespace vultra
 
                 const auto attachment = decodeAttachment(bits);
 
+                // Load only if there is something to load (a transient texture starts with garbage), store only if a
+                // later pass of the graph accesses the contents. Contents of textures with transient usage never
+                // leave the pass.
+                const auto transientUsage = static_cast<bool>(desc.usageFlags & rhi::ImageUsage::eTransient);
+                const auto loadContents   = !transientUsage && (!transient || written);
+                if (storeTracker && loadContents && !attachment.clearValue)
+                    storeTracker->onAccess(attachmentWrites);
+                const auto storeContents =
+                    !transientUsage && (!storeTracker || storeTracker->onAttachmentWrite(attachmentWrites));
+                written = true;
+
+                const auto attachmentInfo = makeAttachment(attachment, texture, loadContents, storeContents);
                 switch (attachment.imageAspect)
                 {
                     using enum rhi::ImageAspect;
 
                     case eDepth:
-                        framebufferInfo->depthAttachment = makeAttachment(attachment, texture);
+                        framebufferInfo->depthAttachment = attachmentInfo;
                         framebufferInfo->depthReadOnly   = false;
                         break;
                     case eStencil:
-                        framebufferInfo->stencilAttachment = makeAttachment(attachment, texture);
+                        framebufferInfo->stencilAttachment = attachmentInfo;
                         framebufferInfo->stencilReadOnly   = false;
                         break;
                     case eColor: {
                         auto& v = framebufferInfo->colorAttachments;
                         v.resize(attachment.index + 1);
-                        v[attachment.index] = makeAttachment(attachment, texture);
+                        v[attachment.index] = attachmentInfo;
                     }
                     break;
                     default:
@@ -233,6 +288,11 @@ namespace vultra
             }
             else
             {
+                // Storage writes may be partial, treat them as reads.
+                if (storeTracker)
+                    storeTracker->onAccess(attachmentWrites);
+                written = true;
+
                 const auto [bindingInfo, imageAspect] = decodeImageWrite(bits);
                 assert(imageAspect != rhi::ImageAspect::eNone);
                 const auto [location, pipelineStage] = bindingInfo;
@@ -247,7 +307,11 @@ namespace vultra
                     {
                         .image            = *texture,
                         .newLayout        = rhi::ImageLayout::eGeneral,
-                        .subresourceRange = {vk::ImageAspectFlagBits::eNone, 0, 1, 0, 1},
+                        .subresourceRange =
+                            VkImageSubresourceRange {
+                                .levelCount = VK_REMAINING_MIP_LEVELS,
+                                .layerCount = VK_REMAINING_ARRAY_LAYERS,
+                            },
                     },
                     {
                         .stageMask  = convert(pipelineStage),
@@ -0,0 +1,53 @@
+#include "vultra/function/framegraph/graph_description.hpp"
+
+#include <cereal/archives/json.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <fstream>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        template<class Archive>
+        void serialize(Archive& archive, GraphDescription::Pass& pass)
+        {
+            archive(cereal::make_nvp("id", pass.id),
+                    cereal::make_nvp("type", pass.type),
+                    cereal::make_nvp("name", pass.name),
+                    cereal::make_nvp("inputs", pass.inputs),
+                    cereal::make_nvp("outputs", pass.outputs));
+        }
+
+        template<class Archive>
+        void serialize(Archive& archive, GraphDescription::Link& link)
+        {
+            archive(cereal::make_nvp("fromNode", link.fromNode),
+                    cereal::make_nvp("fromPin", link.fromPin),
+                    cereal::make_nvp("toNode", link.toNode),
+                    cereal::make_nvp("toPin", link.toPin));
+        }
+
+        std::expected<GraphDescription, std::string> loadGraphDescription(const std::filesystem::path& p)
+        {
+            std::ifstream file {p};
+            if (!file.is_open())
+            {
+                return std::unexpected {"Failed to open file: " + p.generic_string()};
+            }
+
+            GraphDescription description;
+            try
+            {
+                cereal::JSONInputArchive archive {file};
+                archive(cereal::make_nvp("passes", description.passes), cereal::make_nvp("links", description.links));
+            }
+            catch (const cereal::Exception& e)
+            {
+                return std::unexpected {p.generic_string() + ": " + e.what()};
+            }
+            return description;
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,26 @@
+#include "vultra/function/framegraph/graph_pass.hpp"
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        GraphPassRegistry& GraphPassRegistry::instance()
+        {
+            static GraphPassRegistry registry;
+            return registry;
+        }
+
+        void GraphPassRegistry::registerPass(const std::string& type, GraphPassReflection reflection, Factory factory)
+        {
+            m_Entries.insert_or_assign(type, Entry {std::move(reflection), std::move(factory)});
+        }
+
+        const GraphPassRegistry::Entry* GraphPassRegistry::find(const std::string_view type) const
+        {
+            const auto it = m_Entries.find(type);
+            return it != m_Entries.cend() ? std::addressof(it->second) : nullptr;
+        }
+
+        const GraphPassRegistry::Entries& GraphPassRegistry::getEntries() const { return m_Entries; }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,303 @@
+#include "vultra/function/framegraph/graph_runtime.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/base/hash.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+#include <algorithm>
+#include <format>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        namespace
+        {
+            [[nodiscard]] const GraphPassReflection::IO* findIO(const std::vector<GraphPassReflection::IO>& pins,
+                                                                const std::string_view                      name)
+            {
+                const auto it = std::ranges::find(pins, name, &GraphPassReflection::IO::name);
+                return it != pins.cend() ? std::addressof(*it) : nullptr;
+            }
+        } // namespace
+
+        GraphRuntime::GraphRuntime(rhi::RenderDevice& rd, const GraphPassRegistry& registry) :
+            m_RenderDevice {rd}, m_Registry {registry}, m_FrameGraphCache {createScope<FrameGraphCache>()}
+        {}
+
+        GraphRuntime::~GraphRuntime() = default;
+
+        bool GraphRuntime::load(const std::filesystem::path& p)
+        {
+            // Remember the write time even if the file is broken, so it is not reparsed until it changes again.
+            std::error_code ec;
+            m_Path          = p;
+            m_LastWriteTime = std::filesystem::last_write_time(p, ec);
+
+            auto description = loadGraphDescription(p);
+            if (!description)
+            {
+                return fail(description.error());
+            }
+            return load(*description);
+        }
+
+        bool GraphRuntime::load(const GraphDescription& description)
+        {
+            const auto numPasses = description.passes.size();
+
+            std::unordered_map<int32_t, std::size_t>      indices;
+            std::vector<const GraphPassRegistry::Entry*> entries(numPasses, nullptr);
+            for (std::size_t i = 0; i < numPasses; ++i)
+            {
+                const auto& pass = description.passes[i];
+                if (!indices.emplace(pass.id, i).second)
+                {
+                    return fail(std::format("Duplicate pass id: {}.", pass.id));
+                }
+                entries[i] = m_Registry.find(pass.type);
+                if (!entries[i])
+                {
+                    return fail(std::format("Unknown pass type: '{}' ('{}').", pass.type, pass.name));
+                }
+            }
+
+            std::vector<std::vector<Binding>>     bindings(numPasses);
+            std::vector<std::vector<std::size_t>> consumers(numPasses);
+            std::vector<uint32_t>                 numDependencies(numPasses, 0);
+            for (const auto& link : description.links)
+            {
+                const auto from = indices.find(link.fromNode);
+                const auto to   = indices.find(link.toNode);
+                if (from == indices.cend() || to == indices.cend())
+                {
+                    return fail(std::format("Link {} -> {} references a missing pass.", link.fromNode, link.toNode));
+                }
+
+                const auto& fromPass = description.passes[from->second];
+                const auto& toPass   = description.passes[to->second];
+
+                const auto* output = findIO(entries[from->second]->reflection.outputs, link.fromPin);
+                if (!output)
+                {
+                    return fail(std::format("'{}' has no output '{}'.", fromPass.name, link.fromPin));
+                }
+                const auto* input = findIO(entries[to->second]->reflection.inputs, link.toPin);
+                if (!input)
+                {
+                    return fail(std::format("'{}' has no input '{}'.", toPass.name, link.toPin));
+                }
+                if (output->type != input->type)
+                {
+                    return fail(std::format("Type mismatch: {}.{} ({}) -> {}.{} ({}).",
+                                            fromPass.name,
+                                            link.fromPin,
+                                            output->type,
+                                            toPass.name,
+                                            link.toPin,
+                                            input->type));
+                }
+
+                auto& inputs = bindings[to->second];
+                if (std::ranges::find(inputs, link.toPin, &Binding::pin) != inputs.cend())
+                {
+                    return fail(std::format("Input {}.{} is linked more than once.", toPass.name, link.toPin));
+                }
+                inputs.push_back({
+                    .pin       = link.toPin,
+                    .source    = static_cast<int32_t>(from->second),
+                    .sourcePin = link.fromPin,
+                });
+                consumers[from->second].push_back(to->second);
+                ++numDependencies[to->second];
+            }
+
+            // Inputs without a link are bound from the imports, by their own name.
+            for (std::size_t i = 0; i < numPasses; ++i)
+            {
+                for (const auto& [name, _] : entries[i]->reflection.inputs)
+                {
+                    if (std::ranges::find(bindings[i], name, &Binding::pin) == bindings[i].cend())
+                    {
+                        bindings[i].push_back({.pin = name, .source = -1, .sourcePin = name});
+                    }
+                }
+            }
+
+            // Kahn's algorithm, ties are broken by the order in the file so the result is stable.
+            std::priority_queue<std::size_t, std::vector<std::size_t>, std::greater<>> ready;
+            for (std::size_t i = 0; i < numPasses; ++i)
+            {
+                if (numDependencies[i] == 0)
+                {
+                    ready.push(i);
+                }
+            }
+            std::vector<std::size_t> order;
+            order.reserve(numPasses);
+            while (!ready.empty())
+            {
+                const auto i = ready.top();
+                ready.pop();
+                order.push_back(i);
+                for (const auto consumer : consumers[i])
+                {
+                    if (--numDependencies[consumer] == 0)
+                    {
+                        ready.push(consumer);
+                    }
+                }
+            }
+            if (order.size() != numPasses)
+            {
+                return fail("The graph contains a cycle.");
+            }
+
+            std::vector<int32_t> positions(numPasses, -1);
+            for (std::size_t i = 0; i < numPasses; ++i)
+            {
+                positions[order[i]] = static_cast<int32_t>(i);
+            }
+
+            std::vector<Node> nodes;
+            nodes.reserve(numPasses);
+            for (const auto i : order)
+            {
+                const auto& pass = description.passes[i];
+
+                // Keep the instance of an unchanged node, along with its pipelines.
+                std::shared_ptr<GraphPass> instance;
+                const auto                 it = std::ranges::find_if(
+                    m_Nodes, [&pass](const Node& node) { return node.id == pass.id && node.type == pass.type; });
+                if (it != m_Nodes.cend())
+                {
+                    instance = it->pass;
+                }
+                else
+                {
+                    instance = entries[i]->factory(m_RenderDevice);
+                    if (!instance)
+                    {
+                        return fail(std::format("Could not create '{}' ({}).", pass.name, pass.type));
+                    }
+                }
+
+                auto inputs = std::move(bindings[i]);
+                for (auto& binding : inputs)
+                {
+                    if (binding.source >= 0)
+                    {
+                        binding.source = positions[binding.source];
+                    }
+                }
+                nodes.push_back({
+                    .id     = pass.id,
+                    .type   = pass.type,
+                    .pass   = std::move(instance),
+                    .inputs = std::move(inputs),
+                });
+            }
+
+            if (!m_Nodes.empty())
+            {
+                // The passes of the previous graph own pipelines that the frames in flight might still use.
+                m_RenderDevice.getDeletionQueue().push(std::move(m_Nodes));
+            }
+            m_Nodes = std::move(nodes);
+            m_Error.clear();
+            ++m_Version;
+
+            // The compiled graphs reference the passes of the previous version.
+            m_FrameGraphCache = createScope<FrameGraphCache>();
+
+            VULTRA_CORE_TRACE("[GraphRuntime] Loaded a graph with {} passes (version {}).", numPasses, m_Version);
+            return true;
+        }
+
+        bool GraphRuntime::reloadIfChanged()
+        {
+            if (m_Path.empty())
+            {
+                return false;
+            }
+
+            std::error_code ec;
+            const auto      lastWriteTime = std::filesystem::last_write_time(m_Path, ec);
+            if (ec || lastWriteTime == m_LastWriteTime)
+            {
+                return false;
+            }
+            return load(m_Path);
+        }
+
+        bool GraphRuntime::isValid() const { return m_Version > 0; }
+
+        const std::string& GraphRuntime::getError() const { return m_Error; }
+
+        uint64_t GraphRuntime::getVersion() const { return m_Version; }
+
+        void GraphRuntime::addToGraph(FrameGraph&               fg,
+                                      FrameGraphBlackboard&     blackboard,
+                                      const GraphPassResources& imports,
+                                      void*                     userData) const
+        {
+            std::vector<GraphPassResources> outputs(m_Nodes.size());
+            for (std::size_t i = 0; i < m_Nodes.size(); ++i)
+            {
+                const auto& node = m_Nodes[i];
+
+                GraphPassResources inputs;
+                for (const auto& [pin, source, sourcePin] : node.inputs)
+                {
+                    const auto& resources = source >= 0 ? outputs[source] : imports;
+                    if (const auto it = resources.find(sourcePin); it != resources.cend())
+                    {
+                        inputs.emplace(pin, it->second);
+                    }
+                }
+
+                GraphPassContext context {
+                    .fg         = fg,
+                    .blackboard = blackboard,
+                    .inputs     = inputs,
+                    .outputs    = outputs[i],
+                    .userData   = userData,
+                };
+                node.pass->addToGraph(context);
+            }
+        }
+
+        FrameGraph&
+        GraphRuntime::getFrameGraph(const std::size_t key, const ImportCallback& importResources, void* userData)
+        {
+            assert(isValid());
+
+            std::size_t topologyKey {0};
+            hashCombine(topologyKey, m_Version, key);
+
+            if (auto* fg = m_FrameGraphCache->find(topologyKey))
+            {
+                return *fg;
+            }
+
+            auto                 fg = createScope<FrameGraph>();
+            FrameGraphBlackboard blackboard;
+            addToGraph(*fg, blackboard, importResources(*fg), userData);
+            fg->compile();
+
+            return m_FrameGraphCache->insert(topologyKey, std::move(fg));
+        }
+
+        bool GraphRuntime::fail(std::string error)
+        {
+            VULTRA_CORE_ERROR("[GraphRuntime] {}", error);
+            m_Error = std::move(error);
+            return false;
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "vultra/function/framegraph/pass_profiler.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+#include <cereal/archives/json.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <cassert>
+#include <fstream>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        template<class Archive>
+        void serialize(Archive& archive, PassStats& stats)
+        {
+            archive(cereal::make_nvp("name", stats.name),
+                    cereal::make_nvp("cpuTime", stats.cpuTime),
+                    cereal::make_nvp("gpuTime", stats.gpuTime),
+                    cereal::make_nvp("hasGPUTime", stats.hasGPUTime),
+                    cereal::make_nvp("hasPipelineStatistics", stats.hasPipelineStatistics),
+                    cereal::make_nvp("inputAssemblyPrimitives", stats.inputAssemblyPrimitives),
+                    cereal::make_nvp("vertexShaderInvocations", stats.vertexShaderInvocations),
+                    cereal::make_nvp("clippingPrimitives", stats.clippingPrimitives),
+                    cereal::make_nvp("fragmentShaderInvocations", stats.fragmentShaderInvocations),
+                    cereal::make_nvp("computeShaderInvocations", stats.computeShaderInvocations));
+        }
+
+        template<class Archive>
+        void serialize(Archive& archive, FramePassStats& stats)
+        {
+            archive(cereal::make_nvp("frameNumber", stats.frameNumber),
+                    cereal::make_nvp("cpuTime", stats.cpuTime),
+                    cereal::make_nvp("gpuTime", stats.gpuTime),
+                    cereal::make_nvp("passes", stats.passes));
+        }
+
+        namespace
+        {
+            // Results are written in bit order, see getResults().
+            constexpr auto kPipelineStatistics = vk::QueryPipelineStatisticFlagBits::eInputAssemblyPrimitives |
+                                                 vk::QueryPipelineStatisticFlagBits::eVertexShaderInvocations |
+                                                 vk::QueryPipelineStatisticFlagBits::eClippingPrimitives |
+                                                 vk::QueryPipelineStatisticFlagBits::eFragmentShaderInvocations |
+                                                 vk::QueryPipelineStatisticFlagBits::eComputeShaderInvocations;
+            constexpr auto kNumPipelineStatistics = 5u;
+
+            [[nodiscard]] float toMilliseconds(const auto duration)
+            {
+                return std::chrono::duration<float, std::milli> {duration}.count();
+            }
+        } // namespace
+
+        PassProfiler::PassProfiler(rhi::RenderDevice& rd) : m_TimestampPeriod(rd.getTimestampPeriod())
+        {
+            const auto flags     = rd.getFeatureReport().flags;
+            m_HostQueryReset     = HasFlagValues(flags, rhi::RenderDeviceFeatureReportFlagBits::eHostQueryReset);
+            m_PipelineStatistics = HasFlagValues(flags, rhi::RenderDeviceFeatureReportFlagBits::ePipelineStatistics);
+
+            if (!isSupported())
+                return;
+
+            for (auto& slot : m_Slots)
+            {
+                slot.timestamps = rd.createQueryPool(vk::QueryType::eTimestamp, MAX_QUERIES * 2);
+                slot.timestamps.reset(0, MAX_QUERIES * 2);
+                if (m_PipelineStatistics)
+                {
+                    slot.statistics =
+                        rd.createQueryPool(vk::QueryType::ePipelineStatistics, MAX_QUERIES, kPipelineStatistics);
+                    slot.statistics.reset(0, MAX_QUERIES);
+                }
+            }
+        }
+
+        bool PassProfiler::isSupported() const { return m_TimestampPeriod > 0.0f && m_HostQueryReset; }
+
+        bool PassProfiler::hasPipelineStatistics() const { return isSupported() && m_PipelineStatistics; }
+
+        void PassProfiler::setEnabled(const bool enabled) { m_Enabled = enabled; }
+
+        bool PassProfiler::isEnabled() const { return m_Enabled && isSupported(); }
+
+        void PassProfiler::nextFrame()
+        {
+            collect();
+
+            m_CurrentSlot = (m_CurrentSlot + 1) % NUM_SLOTS;
+            ++m_FrameNumber;
+            m_SlotReady = false;
+
+            if (!isEnabled())
+                return;
+
+            auto& slot = m_Slots[m_CurrentSlot];
+            if (slot.pending && !collect(m_CurrentSlot))
+            {
+                // Still in flight (more frames in flight than slots), skip this frame rather than stall.
+                return;
+            }
+
+            if (slot.numQueries > 0)
+            {
+                slot.timestamps.reset(0, slot.numQueries * 2);
+                if (slot.statistics)
+                {
+                    slot.statistics.reset(0, slot.numQueries);
+                }
+            }
+            slot.queries.clear();
+            slot.numQueries = 0;
+            slot.stats      = {.frameNumber = m_FrameNumber};
+            slot.pending    = false;
+            m_SlotReady     = true;
+        }
+
+        void PassProfiler::begin()
+        {
+            if (!isEnabled() || !m_SlotReady)
+                return;
+
+            m_Depth = 0;
+            rhi::setGPUZoneListener(this);
+        }
+
+        void PassProfiler::end()
+        {
+            if (rhi::getGPUZoneListener() != this)
+                return;
+
+            rhi::setGPUZoneListener(nullptr);
+            assert(m_Depth == 0);
+
+            auto& slot = m_Slots[m_CurrentSlot];
+            slot.pending |= !slot.stats.passes.empty();
+        }
+
+        const FramePassStats& PassProfiler::getStats() const { return m_Stats; }
+
+        bool PassProfiler::saveJSON(const std::filesystem::path& path) const
+        {
+            std::ofstream ofs {path};
+            if (!ofs.is_open())
+            {
+                VULTRA_CORE_ERROR("[PassProfiler] Failed to open file: {}", path.generic_string());
+                return false;
+            }
+
+            {
+                cereal::JSONOutputArchive archive {ofs};
+                auto                      stats = m_Stats;
+                archive(cereal::make_nvp("frame", stats));
+            }
+            return true;
+        }
+
+        void PassProfiler::onZoneBegin(rhi::CommandBuffer& cb, const std::string_view label)
+        {
+            if (m_Depth++ > 0)
+                return;
+
+            auto& slot  = m_Slots[m_CurrentSlot];
+            m_OpenZone  = {.pass = slot.stats.passes.size(), .query = -1, .start = Clock::now()};
+            auto& stats = slot.stats.passes.emplace_back();
+            stats.name  = label;
+
+            // Timestamps are only measured on the generic queue (the compute queue may not support them) and
+            // statistics queries may not span a render pass boundary.
+            if (cb.getQueueType() == rhi::QueueType::eGeneric && !cb.isInsideRenderPass() &&
+                slot.numQueries < MAX_QUERIES)
+            {
+                const auto query = slot.numQueries++;
+                cb.writeTimestamp(slot.timestamps, query * 2, rhi::PipelineStages::eTop);
+                if (slot.statistics)
+                {
+                    cb.beginQuery(slot.statistics, query);
+                }
+                m_OpenZone.query = static_cast<int32_t>(query);
+            }
+            slot.queries.push_back(m_OpenZone.query);
+        }
+
+        void PassProfiler::onZoneEnd(rhi::CommandBuffer& cb)
+        {
+            if (m_Depth == 0 || --m_Depth > 0)
+                return;
+
+            auto& slot    = m_Slots[m_CurrentSlot];
+            auto& stats   = slot.stats.passes[m_OpenZone.pass];
+            stats.cpuTime = toMilliseconds(Clock::now() - m_OpenZone.start);
+
+            if (m_OpenZone.query >= 0)
+            {
+                const auto query = static_cast<uint32_t>(m_OpenZone.query);
+                if (slot.statistics)
+                {
+                    cb.endQuery(slot.statistics, query);
+                }
+                cb.writeTimestamp(slot.timestamps, query * 2 + 1, rhi::PipelineStages::eBottom);
+            }
+        }
+
+        void PassProfiler::collect()
+        {
+            // Oldest slot first (the one after the current); queries complete in submission order.
+            for (uint32_t i = 1; i <= NUM_SLOTS; ++i)
+            {
+                if (!collect((m_CurrentSlot + i) % NUM_SLOTS))
+                    break;
+            }
+        }
+
+        bool PassProfiler::collect(const uint32_t slotIndex)
+        {
+            auto& slot = m_Slots[slotIndex];
+            if (!slot.pending)
+                return true;
+
+            std::vector<uint64_t> timestamps(slot.numQueries * 2);
+            std::vector<uint64_t> statistics(slot.statistics ? slot.numQueries * kNumPipelineStatistics : 0);
+            if (slot.numQueries > 0)
+            {
+                if (!slot.timestamps.getResults(0, timestamps))
+                    return false;
+                if (slot.statistics && !slot.statistics.getResults(0, statistics))
+                    return false;
+            }
+
+            auto& frame = slot.stats;
+            for (std::size_t i = 0; i < frame.passes.size(); ++i)
+            {
+                auto& pass = frame.passes[i];
+                frame.cpuTime += pass.cpuTime;
+
+                const auto query = slot.queries[i];
+                if (query < 0)
+                    continue;
+
+                const auto begin = timestamps[query * 2];
+                const auto end   = timestamps[query * 2 + 1];
+                if (end >= begin)
+                {
+                    pass.gpuTime =
+                        static_cast<float>(static_cast<double>(end - begin) * m_TimestampPeriod * 1e-6);
+                    pass.hasGPUTime = true;
+                    frame.gpuTime += pass.gpuTime;
+                }
+
+                if (slot.statistics)
+                {
+                    const auto* values             = &statistics[query * kNumPipelineStatistics];
+                    pass.inputAssemblyPrimitives   = values[0];
+                    pass.vertexShaderInvocations   = values[1];
+                    pass.clippingPrimitives        = values[2];
+                    pass.fragmentShaderInvocations = values[3];
+                    pass.computeShaderInvocations  = values[4];
+                    pass.hasPipelineStatistics     = true;
+                }
+            }
+
+            m_Stats      = std::move(frame);
+            frame        = {};
+            slot.pending = false;
+            return true;
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,277 @@
+#include "vultra/function/framegraph/queue_scheduler.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/core/rhi/texture.hpp"
+
+#include <algorithm>
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        namespace
+        {
+            [[nodiscard]] constexpr auto toIndex(const rhi::QueueType queueType)
+            {
+                return static_cast<std::size_t>(queueType);
+            }
+        } // namespace
+
+        QueueScheduler::QueueScheduler(rhi::RenderDevice& rd) : m_RenderDevice(rd)
+        {
+            if (isSupported())
+            {
+                for (auto& timeline : m_Timelines)
+                {
+                    timeline = rd.createTimelineSemaphore();
+                }
+            }
+        }
+
+        QueueScheduler::~QueueScheduler()
+        {
+            if (!isSupported())
+                return;
+
+            m_RenderDevice.waitIdle();
+            for (auto& timeline : m_Timelines)
+            {
+                m_RenderDevice.destroy(timeline);
+            }
+        }
+
+        bool QueueScheduler::isSupported() const { return m_RenderDevice.hasAsyncComputeQueue(); }
+
+        void QueueScheduler::setEnabled(const bool enabled) { m_Enabled = enabled; }
+        bool QueueScheduler::isEnabled() const { return m_Enabled && isSupported(); }
+
+        void QueueScheduler::beginAsync(FrameGraph& fg)
+        {
+            fg.addCallbackPass(
+                "Begin Async Compute",
+                [](FrameGraph::Builder& builder, auto&) {
+                    PASS_SETUP_ZONE;
+                    builder.setSideEffect();
+                },
+                [this](const auto&, FrameGraphPassResources&, void* ctx) {
+                    // After join() the remaining async passes stay on the generic queue.
+                    if (!m_Active || !m_Tail)
+                        return;
+
+                    auto& cb = static_cast<RenderContext*>(ctx)->commandBuffer;
+                    switchTo(cb, acquireCommandBuffer(rhi::QueueType::eAsyncCompute));
+                    cb.addWaitSemaphore(m_Timelines[toIndex(rhi::QueueType::eGeneric)], m_Segments.back().signalValue);
+                    track(cb, rhi::QueueType::eAsyncCompute);
+                });
+        }
+
+        void QueueScheduler::join(FrameGraph& fg)
+        {
+            fg.addCallbackPass(
+                "Join Async Compute",
+                [](FrameGraph::Builder& builder, auto&) {
+                    PASS_SETUP_ZONE;
+                    builder.setSideEffect();
+                },
+                [this](const auto&, FrameGraphPassResources&, void* ctx) {
+                    if (m_Active && m_Tail)
+                        joinTail(static_cast<RenderContext*>(ctx)->commandBuffer);
+                });
+        }
+
+        void QueueScheduler::nextFrame()
+        {
+            assert(!m_Active);
+            m_PoolIndex = (m_PoolIndex + 1) % kNumPools;
+            auto& used = m_Pools[m_PoolIndex].used;
+            used.assign(used.size(), false);
+        }
+
+        void QueueScheduler::begin(rhi::CommandBuffer& cb)
+        {
+            if (!isEnabled())
+                return;
+
+            ZoneScopedN("QueueScheduler::Begin");
+
+            m_Active           = true;
+            m_CommandBuffer    = &cb;
+            m_CurrentQueueType = rhi::QueueType::eGeneric;
+
+            // Whatever the caller recorded so far (uploads, copies, profiler markers) runs before the graph, the
+            // frame command buffer itself is submitted after every segment.
+            switchTo(cb, acquireCommandBuffer(rhi::QueueType::eGeneric));
+            track(cb, rhi::QueueType::eGeneric);
+
+            // Continues the recording from join() on, submitted by the caller.
+            m_Tail = &acquireCommandBuffer(rhi::QueueType::eGeneric);
+        }
+
+        void QueueScheduler::endAsync(rhi::CommandBuffer& cb)
+        {
+            if (!m_Active || m_CurrentQueueType != rhi::QueueType::eAsyncCompute)
+                return;
+
+            // No wait, the following graphics passes overlap with the compute work.
+            switchTo(cb, acquireCommandBuffer(rhi::QueueType::eGeneric));
+            track(cb, rhi::QueueType::eGeneric);
+        }
+
+        void QueueScheduler::end(rhi::CommandBuffer& cb)
+        {
+            if (!m_Active)
+                return;
+
+            ZoneScopedN("QueueScheduler::End");
+
+            if (m_Tail)
+                joinTail(cb);
+
+            // Hand the images back to the generic queue, transient textures are reused by the next frames.
+            auto& builder = cb.getBarrierBuilder();
+            for (const auto* texture : m_ComputeOwned)
+            {
+                if (const auto layout = texture->getImageLayout();
+                    builder.isForeign(*texture) && layout != rhi::ImageLayout::eUndefined)
+                {
+                    builder.imageBarrier({.image = *texture, .newLayout = layout}, rhi::kFatScope);
+                }
+            }
+            releaseOwnership(cb);
+            builder.trackQueueOwnership(std::nullopt);
+
+            for (const auto& [commandBuffer, queueType, signalValue] : m_Segments)
+            {
+                m_RenderDevice.execute(*commandBuffer,
+                                       rhi::JobInfo {
+                                           .signal      = m_Timelines[toIndex(queueType)],
+                                           .signalValue = signalValue,
+                                       });
+            }
+
+            m_Segments.clear();
+            m_ComputeOwned.clear();
+            m_CommandBuffer      = nullptr;
+            m_CurrentQueueType   = rhi::QueueType::eGeneric;
+            m_CurrentComputeWait = 0;
+            m_LastComputeValue   = 0;
+            m_Active             = false;
+        }
+
+        uint32_t QueueScheduler::getQueueFamilyIndex(const rhi::QueueType queueType) const
+        {
+            return m_RenderDevice.getQueueFamilyIndex(queueType);
+        }
+
+        rhi::CommandBuffer& QueueScheduler::acquireCommandBuffer(const rhi::QueueType queueType)
+        {
+            auto& [commandBuffers, used] = m_Pools[m_PoolIndex];
+
+            rhi::CommandBuffer* cb {nullptr};
+            for (std::size_t i = 0; i < commandBuffers.size(); ++i)
+            {
+                if (!used[i] && commandBuffers[i].getQueueType() == queueType)
+                {
+                    used[i] = true;
+                    cb      = &commandBuffers[i];
+                    break;
+                }
+            }
+            if (!cb)
+            {
+                cb = &commandBuffers.emplace_back(m_RenderDevice.createCommandBuffer(queueType));
+                used.push_back(true);
+            }
+
+            // Waits only if the command buffer is still in flight.
+            cb->reset();
+            cb->begin();
+            return *cb;
+        }
+
+        void QueueScheduler::switchTo(rhi::CommandBuffer& cb, rhi::CommandBuffer& slot)
+        {
+            releaseOwnership(cb);
+
+            const auto queueType = m_CurrentQueueType;
+            std::swap(cb, slot);
+            const auto signalValue = ++m_TimelineValues[toIndex(queueType)];
+            m_Segments.push_back({
+                .commandBuffer = &slot,
+                .queueType     = queueType,
+                .signalValue   = signalValue,
+            });
+            if (queueType == rhi::QueueType::eAsyncCompute)
+                m_LastComputeValue = signalValue;
+        }
+
+        void QueueScheduler::joinTail(rhi::CommandBuffer& cb)
+        {
+            assert(m_Tail && m_CurrentQueueType == rhi::QueueType::eGeneric);
+
+            switchTo(cb, *m_Tail);
+            m_Tail = nullptr;
+            track(cb, rhi::QueueType::eGeneric);
+            if (m_LastComputeValue > 0)
+            {
+                cb.addWaitSemaphore(m_Timelines[toIndex(rhi::QueueType::eAsyncCompute)], m_LastComputeValue);
+                m_CurrentComputeWait = m_LastComputeValue;
+            }
+        }
+
+        void QueueScheduler::track(rhi::CommandBuffer& cb, const rhi::QueueType queueType)
+        {
+            m_CurrentQueueType = queueType;
+            if (queueType == rhi::QueueType::eGeneric)
+                m_CurrentComputeWait = 0;
+
+            cb.getBarrierBuilder().trackQueueOwnership(rhi::Barrier::Builder::QueueOwnership {
+                .queueFamilyIndex        = getQueueFamilyIndex(queueType),
+                .defaultQueueFamilyIndex = getQueueFamilyIndex(rhi::QueueType::eGeneric),
+                .onForeignAccess         = [this](const rhi::Texture& texture) { onForeignAccess(texture); },
+            });
+        }
+
+        void QueueScheduler::releaseOwnership(rhi::CommandBuffer& cb)
+        {
+            const auto computeQueueFamilyIndex = getQueueFamilyIndex(rhi::QueueType::eAsyncCompute);
+
+            for (const auto& transfer : cb.getBarrierBuilder().takeOwnershipTransfers())
+            {
+                // The latest segment of the source queue, the acquiring one waits for it.
+                const auto it = std::find_if(m_Segments.rbegin(), m_Segments.rend(), [&](const Segment& segment) {
+                    return getQueueFamilyIndex(segment.queueType) == transfer.srcQueueFamilyIndex;
+                });
+                if (it != m_Segments.rend())
+                    it->commandBuffer->getBarrierBuilder().releaseOwnership(transfer);
+                else
+                    VULTRA_CORE_WARN("[QueueScheduler] No segment to release the queue ownership of an image from");
+
+                if (transfer.dstQueueFamilyIndex == computeQueueFamilyIndex)
+                    m_ComputeOwned.push_back(transfer.image);
+            }
+        }
+
+        void QueueScheduler::onForeignAccess(const rhi::Texture& texture)
+        {
+            assert(m_CommandBuffer);
+
+            if (m_CurrentQueueType == rhi::QueueType::eAsyncCompute)
+            {
+                // Waits for the preceding generic segment already, only remember the image to hand it back.
+                m_ComputeOwned.push_back(&texture);
+                return;
+            }
+
+            // A generic pass consumes the output of an async pass, continue on a segment that waits for it.
+            if (m_LastComputeValue > m_CurrentComputeWait)
+            {
+                auto& cb = *m_CommandBuffer;
+                switchTo(cb, acquireCommandBuffer(rhi::QueueType::eGeneric));
+                track(cb, rhi::QueueType::eGeneric);
+                cb.addWaitSemaphore(m_Timelines[toIndex(rhi::QueueType::eAsyncCompute)], m_LastComputeValue);
+                m_CurrentComputeWait = m_LastComputeValue;
+            }
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
@@ -56,7 +56,7 @@ namespace vultra
                 return total;
             }
 
-            void heartbeat(auto& pool)
+            void heartbeat(auto& pool, rhi::DeletionQueue& deletionQueue)
             {
                 // A resource's life (for how long it is going to be cached).
                 constexpr auto kMaxNumFrames = 10;
@@ -81,8 +81,9 @@ namespace vultra
                             if (life >= kMaxNumFrames)
                             {
                                 VULTRA_CORE_TRACE("[FrameGraph] Deleting resource: {}", fmt::ptr(resource));
-                                *resource = {};
-                                entryIt   = group.erase(entryIt);
+                                // Leaves an empty resource behind (removed below).
+                                deletionQueue.push(std::move(*resource));
+                                entryIt = group.erase(entryIt);
                             }
                             else
                             {
@@ -102,7 +103,7 @@ namespace vultra
 
         } // namespace
 
-        TransientResources::TransientResources(rhi::RenderDevice& rd) : m_RenderDevice {rd} {}
+        TransientResources::TransientResources(rhi::RenderDevice& rd) : m_RenderDevice {rd}, m_UploadRing {rd} {}
 
         TransientResources::MemoryStats TransientResources::getStats() const
         {
@@ -114,8 +115,9 @@ namespace vultra
 
         void TransientResources::update()
         {
-            heartbeat(m_Textures);
-            heartbeat(m_Buffers);
+            auto& deletionQueue = m_RenderDevice.getDeletionQueue();
+            heartbeat(m_Textures, deletionQueue);
+            heartbeat(m_Buffers, deletionQueue);
         }
 
         rhi::Texture* TransientResources::acquireTexture(const FrameGraphTexture::Desc& desc)
@@ -136,6 +138,7 @@ namespace vultra
                         .setCubemap(desc.cubemap)
                         .setupOptimalSampler(false)
                         .build(m_RenderDevice);
+                texture.setMemoryCategory(rhi::MemoryCategory::eTransient);
 
                 m_Textures.resources.emplace_back(std::make_unique<rhi::Texture>(std::move(texture)));
 
@@ -191,6 +194,7 @@ namespace vultra
                     default:
                         assert(false);
                 }
+                buffer->setMemoryCategory(rhi::MemoryCategory::eTransient);
                 m_Buffers.resources.push_back(std::move(buffer));
                 auto* ptr = m_Buffers.resources.back().get();
                 VULTRA_CORE_TRACE("[FrameGraph] Created buffer: {}", fmt::ptr(ptr));
@@ -208,5 +212,9 @@ namespace vultra
             const auto h = std::hash<FrameGraphBuffer::Desc> {}(desc);
             m_Buffers.entryGroups[h].emplace_back(buffer, 0u);
         }
+
+        AttachmentStoreTracker& TransientResources::getAttachmentStoreTracker() { return m_AttachmentStoreTracker; }
+
+        UploadRing& TransientResources::getUploadRing() { return m_UploadRing; }
     } // namespace framegraph
 } // namespace vultra
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "vultra/function/framegraph/upload_ring.hpp"
+#include "vultra/core/base/common_context.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+namespace vultra
+{
+    namespace framegraph
+    {
+        namespace
+        {
+            [[nodiscard]] constexpr vk::DeviceSize alignUp(const vk::DeviceSize v, const vk::DeviceSize alignment)
+            {
+                return (v + alignment - 1) / alignment * alignment;
+            }
+        } // namespace
+
+        UploadRing::UploadRing(rhi::RenderDevice& rd) : m_RenderDevice {rd} {}
+
+        UploadRing::~UploadRing()
+        {
+            for (auto* ring : {&m_UniformRing, &m_StorageRing})
+            {
+                if (ring->buffer)
+                    ring->buffer->unmap();
+            }
+        }
+
+        std::optional<UploadRing::Allocation> UploadRing::allocate(const BufferType type, const vk::DeviceSize size)
+        {
+            assert(type == BufferType::eUniformBuffer || type == BufferType::eStorageBuffer);
+            if (!m_Segment)
+            {
+                return std::nullopt;
+            }
+
+            auto& ring = getRing(type);
+            if (!ring.buffer)
+            {
+                createRing(ring, type);
+            }
+
+            const auto offset = alignUp(ring.head, ring.alignment);
+            if (offset + size > kSegmentSize)
+            {
+                ++m_NumFallbacks;
+                return std::nullopt;
+            }
+            ring.head = offset + size;
+
+            const auto absoluteOffset = *m_Segment * kSegmentSize + offset;
+            return Allocation {
+                .buffer       = ring.buffer.get(),
+                .offset       = absoluteOffset,
+                .mappedMemory = ring.mappedMemory + absoluteOffset,
+            };
+        }
+
+        void UploadRing::nextFrame(const uint32_t numFramesInFlight)
+        {
+            assert(numFramesInFlight > 0);
+            if (numFramesInFlight != m_NumSegments)
+            {
+                // The segments of the frames still in flight stay valid until the old buffers are deleted.
+                releaseRings();
+                m_NumSegments = numFramesInFlight;
+                m_Segment.reset();
+            }
+            m_Segment = m_Segment ? (*m_Segment + 1) % m_NumSegments : 0;
+
+            m_UniformRing.head = 0;
+            m_StorageRing.head = 0;
+            m_NumFallbacks     = 0;
+        }
+
+        UploadRing::Stats UploadRing::getStats() const
+        {
+            return Stats {
+                .uniformBytes = m_UniformRing.head,
+                .storageBytes = m_StorageRing.head,
+                .numFallbacks = m_NumFallbacks,
+            };
+        }
+
+        UploadRing::Ring& UploadRing::getRing(const BufferType type)
+        {
+            return type == BufferType::eUniformBuffer ? m_UniformRing : m_StorageRing;
+        }
+
+        void UploadRing::createRing(Ring& ring, const BufferType type)
+        {
+            constexpr auto kHints = rhi::AllocationHints::eSequentialWrite;
+
+            const auto size   = kSegmentSize * m_NumSegments;
+            const auto limits = m_RenderDevice.getDeviceLimits();
+            if (type == BufferType::eUniformBuffer)
+            {
+                ring.buffer =
+                    std::make_unique<rhi::UniformBuffer>(m_RenderDevice.createUniformBuffer(size, kHints));
+                ring.alignment = limits.minUniformBufferOffsetAlignment;
+            }
+            else
+            {
+                ring.buffer =
+                    std::make_unique<rhi::StorageBuffer>(m_RenderDevice.createStorageBuffer(size, kHints));
+                ring.alignment = limits.minStorageBufferOffsetAlignment;
+            }
+            ring.mappedMemory = static_cast<std::byte*>(ring.buffer->map());
+
+            VULTRA_CORE_TRACE("[UploadRing] Created {} ring: {} x {} bytes",
+                              type == BufferType::eUniformBuffer ? "uniform" : "storage",
+                              m_NumSegments,
+                              kSegmentSize);
+        }
+
+        void UploadRing::releaseRings()
+        {
+            for (auto* ring : {&m_UniformRing, &m_StorageRing})
+            {
+                if (ring->buffer)
+                {
+                    ring->buffer->unmap();
+                    m_RenderDevice.getDeletionQueue().push(std::move(ring->buffer));
+                }
+                *ring = {};
+            }
+        }
+    } // namespace framegraph
+} // namespace vultra
\ No newline at end of file
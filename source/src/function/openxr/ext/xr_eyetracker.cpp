@@ -97,6 +97,7 @@ namespace vultra
                 OPENXR_CHECK(xrGetActionStatePose(m_Session, &getActionStateInfo, &actionStatePose),
                              "Failed to get action state pose");
 
+                m_GazeValid = actionStatePose.isActive;
                 if (actionStatePose.isActive)
                 {
                     XrEyeGazeSampleTimeEXT eyeGazeSampleTime {.type = XR_TYPE_EYE_GAZE_SAMPLE_TIME_EXT};
@@ -0,0 +1,25 @@
+#include "vultra/function/openxr/ext/xr_mock_eyetracker.hpp"
+
+namespace vultra
+{
+    namespace openxr
+    {
+        namespace ext
+        {
+            XRMockEyeTracker::XRMockEyeTracker(GazeFunction gazeFunction) : m_GazeFunction(std::move(gazeFunction)) {}
+
+            bool XRMockEyeTracker::sync(XrSpace /*space*/, XrTime time)
+            {
+                const auto gazePose = m_GazeFunction ? m_GazeFunction(time) : std::nullopt;
+
+                m_GazeValid = gazePose.has_value();
+                if (m_GazeValid)
+                {
+                    m_GazePose = *gazePose;
+                }
+
+                return true;
+            }
+        } // namespace ext
+    } // namespace openxr
+} // namespace vultra
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "vultra/function/openxr/ext/xr_eyetracker.hpp"
 #include "vultra/function/openxr/xr_helper.hpp"
 
+#include <cassert>
+
 namespace vultra
 {
     namespace openxr
@@ -14,7 +16,7 @@ namespace vultra
             if (supportEyetracking)
             {
                 // Create the eye tracker if supported
-                m_EyeTracker = new ext::XREyeTracker(instance, session);
+                m_EyeTracker = std::make_unique<ext::XREyeTracker>(instance, session);
             }
 
             // Attach action sets
@@ -32,7 +34,13 @@ namespace vultra
             OPENXR_CHECK(xrAttachSessionActionSets(session, &attachInfo), "Failed to attach session action sets");
         }
 
-        XRCommonAction::~XRCommonAction() { delete m_EyeTracker; }
+        XRCommonAction::~XRCommonAction() = default;
+
+        void XRCommonAction::setEyeTracker(std::unique_ptr<ext::XREyeGazeSource> eyeTracker)
+        {
+            assert(!eyeTracker || eyeTracker->getActionSet() == XR_NULL_HANDLE);
+            m_EyeTracker = std::move(eyeTracker);
+        }
 
         bool XRCommonAction::sync(XrSpace space, XrTime time)
         {
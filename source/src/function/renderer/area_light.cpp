@@ -62,37 +62,14 @@ namespace vultra
             subMesh.materialIndex = 0;
             outMesh->subMeshes.push_back(subMesh);
 
-            outMesh->vertexBuffer =
-                createRef<rhi::VertexBuffer>(rd.createVertexBuffer(outMesh->getVertexStride(), vertices.size()));
-            outMesh->indexBuffer =
-                createRef<rhi::IndexBuffer>(rd.createIndexBuffer(rhi::IndexType::eUInt32, indices.size()));
-
-            auto stagingVertexBuffer = rd.createStagingBuffer(sizeof(SimpleVertex) * vertices.size(), vertices.data());
-            auto stagingIndexBuffer  = rd.createStagingBuffer(sizeof(uint32_t) * indices.size(), indices.data());
-
-            rd.execute(
-                [&](rhi::CommandBuffer& cb) {
-                    cb.copyBuffer(stagingVertexBuffer,
-                                  *outMesh->vertexBuffer,
-                                  vk::BufferCopy {0, 0, stagingVertexBuffer.getSize()});
-                    cb.copyBuffer(
-                        stagingIndexBuffer, *outMesh->indexBuffer, vk::BufferCopy {0, 0, stagingIndexBuffer.getSize()});
-                },
-                true);
-
             outMesh->aabb = AABB::build(vertices);
 
             // Generate meshlets
             generateMeshlets(*outMesh);
 
+            outMesh->buildGeometry(rd);
             outMesh->buildMaterialBuffer(rd);
 
-            // Build meshlet buffers for each sub-mesh
-            for (auto& sm : outMesh->subMeshes)
-            {
-                sm.buildMeshletBuffers(rd);
-            }
-
             // Build the render mesh for ray tracing, ray query or mesh shading if supported
             if (HasFlagValues(rd.getFeatureFlag(), rhi::RenderDeviceFeatureFlagBits::eRayTracingPipeline) ||
                 HasFlagValues(rd.getFeatureFlag(), rhi::RenderDeviceFeatureFlagBits::eRayQuery) ||
@@ -2,6 +2,60 @@
 #include "vultra/core/base/hash.hpp"
 #include "vultra/function/renderer/vertex_format.hpp"
 
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/map.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <unordered_set>
+
+namespace vultra
+{
+    namespace rhi
+    {
+        template<class Archive>
+        void serialize(Archive& archive, VertexAttribute& attribute)
+        {
+            archive(attribute.type, attribute.offset);
+        }
+    } // namespace rhi
+
+    namespace gfx
+    {
+        void save(cereal::BinaryOutputArchive& archive, const BaseGeometryPassInfo& info)
+        {
+            archive(info.depthFormat, info.colorFormats, info.topology, info.viewMask);
+
+            const bool hasVertexFormat = info.vertexFormat != nullptr;
+            archive(hasVertexFormat);
+            if (hasVertexFormat)
+                archive(info.vertexFormat->getAttributes());
+        }
+
+        void load(cereal::BinaryInputArchive& archive, BaseGeometryPassInfo& info)
+        {
+            archive(info.depthFormat, info.colorFormats, info.topology, info.viewMask);
+
+            bool hasVertexFormat {false};
+            archive(hasVertexFormat);
+            info.vertexFormat = nullptr;
+            if (!hasVertexFormat)
+                return;
+
+            rhi::VertexAttributes attributes;
+            archive(attributes);
+
+            VertexFormat::Builder builder;
+            for (const auto& [location, attribute] : attributes)
+                builder.setAttribute(static_cast<AttributeLocation>(location), attribute);
+
+            // The builder only caches weak references, while the pipelines are compiled in the background
+            // (and until a mesh with that format is loaded) nothing else owns it.
+            static std::unordered_set<Ref<VertexFormat>> s_Retained;
+            info.vertexFormat = s_Retained.insert(builder.build()).first->get();
+        }
+    } // namespace gfx
+} // namespace vultra
+
 namespace std
 {
     size_t
@@ -14,6 +68,7 @@ namespace std
             hashCombine(h, format);
 
         hashCombine(h, v.topology);
+        hashCombine(h, v.viewMask);
 
         if (v.vertexFormat)
             hashCombine(h, v.vertexFormat->getHash());
@@ -38,8 +38,16 @@ namespace vultra
             m_RenderableGroup.renderables.clear();
             std::copy(renderables.begin(), renderables.end(), std::back_inserter(m_RenderableGroup.renderables));
 
+            // Meshes moved by GeometryPool::defragment get new device addresses and BLAS, the TLAS has to follow.
+            auto geometryMoved = false;
+            for (const auto& renderable : m_RenderableGroup.renderables)
+            {
+                if (renderable.mesh)
+                    geometryMoved |= renderable.mesh->refreshRenderMesh(m_RenderDevice);
+            }
+
             auto hash_value = std::hash<RenderableGroup>()(m_RenderableGroup);
-            if (m_RenderableGroupHash != hash_value)
+            if (m_RenderableGroupHash != hash_value || geometryMoved)
             {
                 m_RenderableGroupHash = hash_value;
 
@@ -0,0 +1,90 @@
+#include "vultra/function/renderer/builtin/builtin_graph_passes.hpp"
+#include "vultra/function/framegraph/graph_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/blit_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/fxaa_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/gamma_correction_pass.hpp"
+
+namespace vultra
+{
+    namespace gfx
+    {
+        namespace
+        {
+            class FXAAGraphPass final : public framegraph::GraphPass
+            {
+            public:
+                explicit FXAAGraphPass(rhi::RenderDevice& rd) : m_Pass {rd} {}
+
+                static framegraph::GraphPassReflection reflect()
+                {
+                    return {{{"Input", "Texture"}}, {{"Output", "Texture"}}};
+                }
+
+                void addToGraph(framegraph::GraphPassContext& ctx) override
+                {
+                    if (const auto input = ctx.getInput("Input"))
+                    {
+                        ctx.setOutput("Output", m_Pass.aa(ctx.fg, *input));
+                    }
+                }
+
+            private:
+                FXAAPass m_Pass;
+            };
+
+            class GammaCorrectionGraphPass final : public framegraph::GraphPass
+            {
+            public:
+                explicit GammaCorrectionGraphPass(rhi::RenderDevice& rd) : m_Pass {rd} {}
+
+                static framegraph::GraphPassReflection reflect()
+                {
+                    return {{{"Input", "Texture"}}, {{"Output", "Texture"}}};
+                }
+
+                void addToGraph(framegraph::GraphPassContext& ctx) override
+                {
+                    if (const auto input = ctx.getInput("Input"))
+                    {
+                        ctx.setOutput("Output",
+                                      m_Pass.addPass(ctx.fg, *input, GammaCorrectionPass::GammaCorrectionMode::eGamma));
+                    }
+                }
+
+            private:
+                GammaCorrectionPass m_Pass;
+            };
+
+            class BlitGraphPass final : public framegraph::GraphPass
+            {
+            public:
+                explicit BlitGraphPass(rhi::RenderDevice& rd) : m_Pass {rd} {}
+
+                static framegraph::GraphPassReflection reflect()
+                {
+                    return {{{"Source", "Texture"}, {"Target", "Texture"}}, {}};
+                }
+
+                void addToGraph(framegraph::GraphPassContext& ctx) override
+                {
+                    const auto source = ctx.getInput("Source");
+                    const auto target = ctx.getInput("Target");
+                    if (source && target)
+                    {
+                        m_Pass.blit(ctx.fg, *source, *target);
+                    }
+                }
+
+            private:
+                BlitPass m_Pass;
+            };
+        } // namespace
+
+        void registerBuiltinGraphPasses(framegraph::GraphPassRegistry& registry)
+        {
+            registry.registerPass<FXAAGraphPass>("FXAAPass");
+            registry.registerPass<GammaCorrectionGraphPass>("GammaCorrectionPass");
+            registry.registerPass<BlitGraphPass>("BlitPass");
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -1,29 +1,47 @@
 #include "vultra/function/renderer/builtin/builtin_renderer.hpp"
+#include "vultra/core/base/hash.hpp"
+#include "vultra/core/base/string_util.hpp"
 #include "vultra/core/color/color.hpp"
 #include "vultra/core/rhi/command_buffer.hpp"
 #include "vultra/core/rhi/render_device.hpp"
 #include "vultra/core/rhi/swapchain.hpp"
 #include "vultra/function/debug_draw/debug_draw_interface.hpp"
+#include "vultra/function/framegraph/framegraph_build_stats.hpp"
+#include "vultra/function/framegraph/framegraph_cache.hpp"
 #include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/pass_profiler.hpp"
+#include "vultra/function/framegraph/queue_scheduler.hpp"
 #include "vultra/function/renderer/area_light.hpp"
+#include "vultra/function/renderer/builtin/dynamic_resolution_controller.hpp"
 #include "vultra/function/renderer/builtin/passes/blit_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/cascaded_shadow_map_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/color_blend_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/debug_draw_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/deferred_lighting_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/depth_pre_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/foveated_composite_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/final_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/fxaa_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/gamma_correction_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/gbuffer_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/hiz_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/meshlet_depth_pre_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/meshlet_gbuffer_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/point_shadow_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/raytraced_shadow_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/simple_raytracing_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/skybox_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/ssr_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/stereo_layer_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/tonemapping_pass.hpp"
+#include "vultra/function/renderer/builtin/passes/upscale_pass.hpp"
 #include "vultra/function/renderer/builtin/passes/ui_pass.hpp"
 #include "vultra/function/renderer/builtin/resources/debug_draw_data.hpp"
+#include "vultra/function/renderer/builtin/resources/depth_pre_data.hpp"
+#include "vultra/function/renderer/builtin/resources/gbuffer_data.hpp"
 #include "vultra/function/renderer/builtin/resources/ibl_data.hpp"
 #include "vultra/function/renderer/builtin/resources/scene_color_data.hpp"
+#include "vultra/function/renderer/parallel_command_recorder.hpp"
 #include "vultra/function/renderer/renderer_render_context.hpp"
 #include "vultra/function/scenegraph/component_utils.hpp"
 #include "vultra/function/scenegraph/entity.hpp"
@@ -32,10 +50,14 @@
 #include <fg/Blackboard.hpp>
 #include <fg/FrameGraph.hpp>
 
+#include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
 #include <imgui.h>
 
+#include <array>
+#include <string_view>
+
 #if _DEBUG
 #include <fstream>
 #endif
@@ -44,10 +66,119 @@ namespace vultra
 {
     namespace gfx
     {
-        BuiltinRenderer::BuiltinRenderer(rhi::RenderDevice& rd, rhi::Swapchain::Format swapChainFormat) :
-            BaseRenderer(rd), m_SwapChainFormat(swapChainFormat), m_TransientResources(rd), m_CubemapConverter(rd),
-            m_IBLDataGenerator(rd)
+        namespace
         {
+            // Temporal passes (SSR, ray traced shadows) keep their history per view.
+            constexpr uint32_t kMainView          = 0;
+            constexpr uint32_t kLeftEyeView       = 1; // Also the periphery when foveated
+            constexpr uint32_t kRightEyeView      = 2;
+            constexpr uint32_t kLeftEyeInsetView  = 3;
+            constexpr uint32_t kRightEyeInsetView = 4;
+
+            // Tangents (left, right, bottom, top) of a projection built by xrutils::createProjectionMatrix.
+            [[nodiscard]] glm::vec4 getFrustumTangents(const glm::mat4& projection)
+            {
+                const float w = 2.0f / projection[0][0];
+                const float h = 2.0f / projection[1][1];
+                return {(projection[2][0] - 1.0f) * w * 0.5f,
+                        (projection[2][0] + 1.0f) * w * 0.5f,
+                        (projection[2][1] + 1.0f) * h * 0.5f,
+                        (projection[2][1] - 1.0f) * h * 0.5f};
+            }
+
+            // Single frustum enclosing both eyes, used to cull and fit shadows once for a multiview frame.
+            // Takes the outer side planes of each eye and moves the apex behind the eyes to where they meet
+            // (assumes parallel eye orientations, as reported by common runtimes).
+            [[nodiscard]] CameraInfo makeStereoCullingCamera(const CameraInfo& left, const CameraInfo& right)
+            {
+                const auto leftTangents  = getFrustumTangents(left.projection);
+                const auto rightTangents = getFrustumTangents(right.projection);
+
+                const float tanLeft   = glm::min(leftTangents.x, rightTangents.x);
+                const float tanRight  = glm::max(leftTangents.y, rightTangents.y);
+                const float tanBottom = glm::min(leftTangents.z, rightTangents.z);
+                const float tanTop    = glm::max(leftTangents.w, rightTangents.w);
+
+                // Right eye position in the left eye's view space, x is the interpupillary distance.
+                const auto  rightEye = left.view * glm::inverse(right.view) * glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+                const float ipd      = glm::max(rightEye.x, 0.0f);
+
+                // Intersection of the left eye's left plane and the right eye's right plane (behind the eyes).
+                const float     apexDistance = ipd / glm::max(tanRight - tanLeft, 1e-4f);
+                const glm::vec3 apex {-apexDistance * tanLeft, 0.0f, apexDistance};
+
+                CameraInfo culling = left;
+                culling.view       = glm::translate(glm::mat4(1.0f), -apex) * left.view;
+                culling.projection = xrutils::createProjectionMatrix(
+                    {glm::atan(tanLeft), glm::atan(tanRight), glm::atan(tanTop), glm::atan(tanBottom)},
+                    left.zNear,
+                    left.zFar + apexDistance);
+                culling.inverseOriginalProjection = glm::inverse(culling.projection);
+                culling.viewProjection            = culling.projection * culling.view;
+                culling.zFar                      = left.zFar + apexDistance;
+
+                const auto frustumPlanes = vultra::math::extractFrustumPlanes(culling.viewProjection);
+                for (int i = 0; i < 6; ++i)
+                {
+                    const auto& plane        = frustumPlanes[i];
+                    culling.frustumPlanes[i] = glm::vec4(plane.normal, plane.d);
+                }
+                return culling;
+            }
+
+            void drawPassStats(const framegraph::FramePassStats& stats, const bool pipelineStatistics)
+            {
+                ImGui::Text("Frame %llu: CPU %.3f ms, GPU %.3f ms",
+                            static_cast<unsigned long long>(stats.frameNumber),
+                            stats.cpuTime,
+                            stats.gpuTime);
+
+                const auto numColumns = pipelineStatistics ? 5 : 3;
+                if (!ImGui::BeginTable("PassStats", numColumns, ImGuiTableFlags_RowBg | ImGuiTableFlags_Borders))
+                    return;
+
+                ImGui::TableSetupColumn("Pass");
+                ImGui::TableSetupColumn("CPU (ms)");
+                ImGui::TableSetupColumn("GPU (ms)");
+                if (pipelineStatistics)
+                {
+                    ImGui::TableSetupColumn("Primitives");
+                    ImGui::TableSetupColumn("Fragments");
+                }
+                ImGui::TableHeadersRow();
+
+                for (const auto& pass : stats.passes)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn();
+                    ImGui::TextUnformatted(pass.name.c_str());
+                    ImGui::TableNextColumn();
+                    ImGui::Text("%.3f", pass.cpuTime);
+                    ImGui::TableNextColumn();
+                    if (pass.hasGPUTime)
+                        ImGui::Text("%.3f", pass.gpuTime);
+                    else
+                        ImGui::TextUnformatted("-");
+                    if (pipelineStatistics)
+                    {
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(pass.clippingPrimitives));
+                        ImGui::TableNextColumn();
+                        ImGui::Text("%llu", static_cast<unsigned long long>(pass.fragmentShaderInvocations));
+                    }
+                }
+                ImGui::EndTable();
+            }
+        } // namespace
+
+        BuiltinRenderer::BuiltinRenderer(rhi::RenderDevice&     rd,
+                                         rhi::Swapchain::Format swapChainFormat,
+                                         const uint32_t         numFramesInFlight) :
+            BaseRenderer(rd), m_TransientResources(rd), m_SwapChainFormat(swapChainFormat),
+            m_NumFramesInFlight(numFramesInFlight), m_CubemapConverter(rd), m_IBLDataGenerator(rd)
+        {
+            assert(numFramesInFlight > 0);
+
             // Initialize debug draw interface and library
             m_DebugDrawInterface.initialize(rd,
                                             swapChainFormat == rhi::Swapchain::Format::eLinear ?
@@ -55,17 +186,34 @@ namespace vultra
                                                 rhi::PixelFormat::eRGBA8_sRGB);
             dd::initialize(&m_DebugDrawInterface);
 
-            m_DepthPrePass         = new DepthPrePass(rd);
-            m_GBufferPass          = new GBufferPass(rd);
-            m_DeferredLightingPass = new DeferredLightingPass(rd);
-            m_SkyboxPass           = new SkyboxPass(rd);
-            m_ToneMappingPass      = new ToneMappingPass(rd);
-            m_GammaCorrectionPass  = new GammaCorrectionPass(rd);
-            m_FXAAPass             = new FXAAPass(rd);
-            m_FinalPass            = new FinalPass(rd);
-            m_BlitPass             = new BlitPass(rd);
-            m_DebugDrawPass        = new DebugDrawPass(rd, m_DebugDrawInterface);
-            m_ColorBlendPass       = new ColorBlendPass(rd);
+            m_DepthPrePass          = new DepthPrePass(rd);
+            m_GBufferPass           = new GBufferPass(rd);
+            m_CascadedShadowMapPass = new CascadedShadowMapPass(rd);
+            m_PointShadowPass       = new PointShadowPass(rd);
+            m_RayTracedShadowPass   = new RayTracedShadowPass(rd);
+            m_DeferredLightingPass  = new DeferredLightingPass(rd);
+            m_HiZPass               = new HiZPass(rd);
+            m_SSRPass               = new SSRPass(rd);
+            m_SkyboxPass            = new SkyboxPass(rd);
+            m_ToneMappingPass       = new ToneMappingPass(rd);
+            m_GammaCorrectionPass   = new GammaCorrectionPass(rd);
+            m_FXAAPass              = new FXAAPass(rd);
+            m_UpscalePass           = new UpscalePass(rd);
+            m_FinalPass             = new FinalPass(rd);
+            m_BlitPass              = new BlitPass(rd);
+            m_DebugDrawPass         = new DebugDrawPass(rd, m_DebugDrawInterface);
+            m_ColorBlendPass        = new ColorBlendPass(rd);
+            m_StereoLayerPass       = new StereoLayerPass(rd);
+            m_FoveatedCompositePass = new FoveatedCompositePass(rd);
+
+            m_DynamicResolution = new DynamicResolutionController(rd);
+            m_QueueScheduler    = new framegraph::QueueScheduler(rd);
+
+            m_ParallelCommandRecorder = new ParallelCommandRecorder(rd, numFramesInFlight);
+
+            m_FrameGraphBuildTracker = new framegraph::FrameGraphBuildTracker();
+            m_FrameGraphCache        = new framegraph::FrameGraphCache();
+            m_PassProfiler           = new framegraph::PassProfiler(rd);
 
             m_UIPass = new UIPass(rd);
 
@@ -91,17 +239,41 @@ namespace vultra
 
         BuiltinRenderer::~BuiltinRenderer()
         {
+            if (!m_PipelineManifestPath.empty())
+            {
+                m_RenderDevice.getPipelineCompiler().getManifest().save(m_PipelineManifestPath);
+            }
+
+            // The cached graphs call into the passes.
+            delete m_FrameGraphCache;
+
             delete m_DepthPrePass;
             delete m_GBufferPass;
+            delete m_CascadedShadowMapPass;
+            delete m_PointShadowPass;
+            delete m_RayTracedShadowPass;
             delete m_DeferredLightingPass;
+            delete m_HiZPass;
+            delete m_SSRPass;
             delete m_SkyboxPass;
             delete m_ToneMappingPass;
             delete m_GammaCorrectionPass;
             delete m_FXAAPass;
+            delete m_UpscalePass;
             delete m_FinalPass;
             delete m_BlitPass;
             delete m_DebugDrawPass;
             delete m_ColorBlendPass;
+            delete m_StereoLayerPass;
+            delete m_FoveatedCompositePass;
+
+            delete m_DynamicResolution;
+            delete m_QueueScheduler;
+
+            delete m_ParallelCommandRecorder;
+
+            delete m_FrameGraphBuildTracker;
+            delete m_PassProfiler;
 
             delete m_UIPass;
 
@@ -114,6 +286,21 @@ namespace vultra
             dd::shutdown();
         }
 
+        uint32_t BuiltinRenderer::warmUpPipelines(const std::filesystem::path& manifestPath)
+        {
+            ZoneScopedN("BuiltinRenderer::WarmUpPipelines");
+
+            m_PipelineManifestPath = manifestPath;
+            if (!m_RenderDevice.getPipelineCompiler().getManifest().load(manifestPath))
+                return 0;
+
+            // Only the geometry passes, their permutations depend on the loaded meshes.
+            const auto numQueued = m_DepthPrePass->warmUpPipelines() + m_GBufferPass->warmUpPipelines() +
+                                   m_CascadedShadowMapPass->warmUpPipelines() + m_PointShadowPass->warmUpPipelines();
+            VULTRA_CORE_INFO("[BuiltinRenderer] Warming up {} pipelines", numQueued);
+            return numQueued;
+        }
+
         void BuiltinRenderer::onImGui()
         {
             if (m_LogicScene == nullptr)
@@ -170,6 +357,241 @@ namespace vultra
                         glm::value_ptr(m_LogicScene->getMainCamera().getComponent<CameraComponent>().clearColor));
                 }
 
+                if (settings.rendererType != RendererType::eRayTracing && ImGui::CollapsingHeader("Shadows"))
+                {
+                    ImGui::Indent(5.0f);
+                    ImGui::Checkbox("Enable Shadows", &settings.enableShadows);
+                    int numCascades = static_cast<int>(settings.shadow.numCascades);
+                    ImGui::SliderInt("Cascades", &numCascades, 1, static_cast<int>(CSM_MAX_CASCADES));
+                    settings.shadow.numCascades = static_cast<uint32_t>(numCascades);
+                    int resolution = static_cast<int>(settings.shadow.resolution);
+                    ImGui::RadioButton("1024", &resolution, 1024);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("2048", &resolution, 2048);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("4096", &resolution, 4096);
+                    settings.shadow.resolution = static_cast<uint32_t>(resolution);
+                    ImGui::DragFloat("Split Lambda", &settings.shadow.splitLambda, 0.01f, 0.0f, 1.0f, "%.2f");
+                    ImGui::DragFloat("Shadow Distance", &settings.shadow.shadowDistance, 1.0f, 1.0f, 1000.0f, "%.1f");
+                    int numDynamicCascades = static_cast<int>(settings.shadow.numDynamicCascades);
+                    ImGui::SliderInt("Dynamic Cascades", &numDynamicCascades, 0, static_cast<int>(CSM_MAX_CASCADES));
+                    settings.shadow.numDynamicCascades = static_cast<uint32_t>(numDynamicCascades);
+                    int cacheTexelThreshold = static_cast<int>(settings.shadow.cacheTexelThreshold);
+                    ImGui::SliderInt("Cache Threshold (texels)", &cacheTexelThreshold, 1, 64);
+                    settings.shadow.cacheTexelThreshold = static_cast<uint32_t>(cacheTexelThreshold);
+                    ImGui::DragFloat("Normal Bias", &settings.shadow.normalBias, 0.05f, 0.0f, 8.0f, "%.2f");
+                    ImGui::Text("Cascades updated: %u", m_CascadedShadowMapPass->getNumUpdatedCascades());
+                    ImGui::Text("Primitives culled: %u", m_CascadedShadowMapPass->getNumCulledPrimitives());
+
+                    ImGui::Separator();
+                    ImGui::Text("Point Lights");
+                    ImGui::Checkbox("Enable Point Shadows", &settings.enablePointShadows);
+                    int maxShadowedLights = static_cast<int>(settings.pointShadow.maxShadowedLights);
+                    ImGui::SliderInt(
+                        "Shadowed Lights", &maxShadowedLights, 1, static_cast<int>(POINT_SHADOW_MAX_LIGHTS));
+                    settings.pointShadow.maxShadowedLights = static_cast<uint32_t>(maxShadowedLights);
+                    int pointResolution = static_cast<int>(settings.pointShadow.resolution);
+                    ImGui::RadioButton("256##Point", &pointResolution, 256);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("512##Point", &pointResolution, 512);
+                    ImGui::SameLine();
+                    ImGui::RadioButton("1024##Point", &pointResolution, 1024);
+                    settings.pointShadow.resolution = static_cast<uint32_t>(pointResolution);
+                    int updateBudget = static_cast<int>(settings.pointShadow.updateBudget);
+                    ImGui::SliderInt("Updates per Frame", &updateBudget, 1, static_cast<int>(POINT_SHADOW_MAX_LIGHTS));
+                    settings.pointShadow.updateBudget = static_cast<uint32_t>(updateBudget);
+                    ImGui::DragFloat(
+                        "Normal Bias##Point", &settings.pointShadow.normalBias, 0.05f, 0.0f, 8.0f, "%.2f");
+                    ImGui::Text("Layered rendering: %s", m_PointShadowPass->isLayered() ? "yes" : "no");
+                    ImGui::Text("Lights shadowed: %u", m_PointShadowPass->getNumShadowedLights());
+                    ImGui::Text("Lights updated: %u (pending: %u)",
+                                m_PointShadowPass->getNumUpdatedLights(),
+                                m_PointShadowPass->getNumPendingLights());
+
+                    ImGui::Separator();
+                    ImGui::Text("Ray Traced");
+                    if (m_RayTracedShadowPass->isSupported())
+                    {
+                        ImGui::Checkbox("Enable Ray Traced Shadows", &settings.enableRayTracedShadows);
+                        int numPointLights = static_cast<int>(settings.rayTracedShadow.numPointLights);
+                        ImGui::SliderInt(
+                            "Traced Point Lights", &numPointLights, 0, static_cast<int>(RT_SHADOW_MAX_POINT_LIGHTS));
+                        settings.rayTracedShadow.numPointLights = static_cast<uint32_t>(numPointLights);
+                        ImGui::DragFloat("Sun Angular Radius (deg)",
+                                         &settings.rayTracedShadow.sunAngularRadius,
+                                         0.01f,
+                                         0.0f,
+                                         5.0f,
+                                         "%.2f");
+                        ImGui::DragFloat("Point Light Source Radius",
+                                         &settings.rayTracedShadow.pointLightSourceRadius,
+                                         0.005f,
+                                         0.0f,
+                                         1.0f,
+                                         "%.3f");
+                        ImGui::DragFloat(
+                            "Temporal Weight", &settings.rayTracedShadow.temporalWeight, 0.01f, 0.0f, 0.98f, "%.2f");
+                        int filterRadius = static_cast<int>(settings.rayTracedShadow.filterRadius);
+                        ImGui::SliderInt("Filter Radius", &filterRadius, 0, 4);
+                        settings.rayTracedShadow.filterRadius = static_cast<uint32_t>(filterRadius);
+                        ImGui::Text("Active: %s", m_RayTracedShadowPass->isActive() ? "yes" : "no");
+                    }
+                    else
+                    {
+                        ImGui::Text("Ray query is not supported on this device.");
+                    }
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (settings.rendererType != RendererType::eRayTracing &&
+                    ImGui::CollapsingHeader("Screen Space Reflections"))
+                {
+                    ImGui::Indent(5.0f);
+                    ImGui::Checkbox("Enable SSR", &settings.enableSSR);
+                    ImGui::DragFloat("Intensity", &settings.ssr.intensity, 0.01f, 0.0f, 4.0f, "%.2f");
+                    ImGui::DragFloat("Max Roughness", &settings.ssr.maxRoughness, 0.01f, 0.0f, 1.0f, "%.2f");
+                    ImGui::DragFloat("Thickness", &settings.ssr.thickness, 0.01f, 0.01f, 5.0f, "%.2f");
+                    ImGui::DragFloat("Max Distance", &settings.ssr.maxDistance, 0.5f, 1.0f, 500.0f, "%.1f");
+                    int maxRayCount = static_cast<int>(settings.ssr.maxRayCount);
+                    ImGui::SliderInt("Max Rays", &maxRayCount, 1, 8);
+                    settings.ssr.maxRayCount = static_cast<uint32_t>(maxRayCount);
+                    int maxIterations = static_cast<int>(settings.ssr.maxIterations);
+                    ImGui::SliderInt("Max Iterations", &maxIterations, 8, 256);
+                    settings.ssr.maxIterations = static_cast<uint32_t>(maxIterations);
+                    ImGui::DragFloat("Temporal Weight", &settings.ssr.temporalWeight, 0.01f, 0.0f, 0.98f, "%.2f");
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (settings.rendererType != RendererType::eRayTracing &&
+                    ImGui::CollapsingHeader("Dynamic Resolution"))
+                {
+                    ImGui::Indent(5.0f);
+                    if (m_DynamicResolution->isSupported())
+                    {
+                        auto& dynamicResolution = settings.dynamicResolution;
+                        ImGui::Checkbox("Enable Dynamic Resolution", &settings.enableDynamicResolution);
+                        ImGui::DragFloat(
+                            "Target GPU Time (ms)", &dynamicResolution.targetFrameTime, 0.1f, 1.0f, 100.0f, "%.1f");
+                        ImGui::DragFloat("Headroom", &dynamicResolution.headroom, 0.01f, 0.5f, 1.0f, "%.2f");
+                        ImGui::DragFloat("Min Scale", &dynamicResolution.minScale, 0.01f, 0.25f, 1.0f, "%.2f");
+                        ImGui::DragFloat("Max Scale", &dynamicResolution.maxScale, 0.01f, 0.25f, 1.0f, "%.2f");
+                        ImGui::DragFloat("Scale Step", &dynamicResolution.scaleStep, 0.01f, 0.01f, 0.25f, "%.2f");
+                        int minSampleCount = static_cast<int>(dynamicResolution.minSampleCount);
+                        ImGui::SliderInt("Min Samples", &minSampleCount, 1, 60);
+                        dynamicResolution.minSampleCount = static_cast<uint32_t>(minSampleCount);
+                        ImGui::Text("GPU time: %.2f ms", m_DynamicResolution->getGPUTime());
+                        ImGui::Text("Scale: %.2f", m_DynamicResolution->getScale());
+                    }
+                    else
+                    {
+                        ImGui::Text("GPU timestamps are not supported on this device.");
+                    }
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (settings.rendererType == RendererType::eRasterization && ImGui::CollapsingHeader("Async Compute"))
+                {
+                    ImGui::Indent(5.0f);
+                    if (m_QueueScheduler->isSupported())
+                    {
+                        ImGui::Checkbox("Enable Async Compute", &settings.enableAsyncCompute);
+                        ImGui::Text("Hi-Z (SSR) overlaps the shadow passes.");
+                    }
+                    else
+                    {
+                        ImGui::Text("No dedicated compute queue on this device.");
+                    }
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (settings.rendererType == RendererType::eRasterization &&
+                    ImGui::CollapsingHeader("Parallel Recording"))
+                {
+                    ImGui::Indent(5.0f);
+                    ImGui::Checkbox("Enable Parallel Recording", &settings.enableParallelRecording);
+                    ImGui::Text("Threads: %u", m_ParallelCommandRecorder->getNumThreads());
+                    ImGui::Text("Secondary command buffers: %u", m_ParallelCommandRecorder->getNumRecorded());
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (ImGui::CollapsingHeader("Frame Graph"))
+                {
+                    ImGui::Indent(5.0f);
+                    const auto& stats = m_FrameGraphBuildTracker->getStats();
+                    ImGui::Text("Setup: %.3f ms", stats.setupTime);
+                    ImGui::Text("Compile: %.3f ms", stats.compileTime);
+                    ImGui::Text("Topology changes: %llu / %llu builds, %llu reuses",
+                                static_cast<unsigned long long>(stats.numTopologyChanges),
+                                static_cast<unsigned long long>(stats.numBuilds),
+                                static_cast<unsigned long long>(stats.numReuses));
+                    ImGui::Text("Cached graphs: %u", m_FrameGraphCache->size());
+                    const auto& storeTracker = m_TransientResources.getAttachmentStoreTracker();
+                    ImGui::Text("Discarded attachment stores: %u / %u",
+                                storeTracker.getNumDiscardedWrites(),
+                                storeTracker.getNumWrites());
+                    const auto uploadStats = m_TransientResources.getUploadRing().getStats();
+                    ImGui::Text("Upload ring: %s uniform, %s storage (%u fallbacks)",
+                                util::formatBytes(uploadStats.uniformBytes).c_str(),
+                                util::formatBytes(uploadStats.storageBytes).c_str(),
+                                uploadStats.numFallbacks);
+                    ImGui::Text("Barriers: %u recorded / %u requested (%u skipped)",
+                                m_BarrierStats.numEmitted,
+                                m_BarrierStats.numRequested,
+                                m_BarrierStats.numSkipped);
+                    const auto descriptorSetStats = m_RenderDevice.getDescriptorSetCache().getStats();
+                    ImGui::Text("Descriptor sets: %u in %u pools (%u hits, %u misses, %u failed allocations)",
+                                descriptorSetStats.numSets,
+                                descriptorSetStats.numPools,
+                                descriptorSetStats.numHits,
+                                descriptorSetStats.numMisses,
+                                descriptorSetStats.numFailedAllocations);
+
+                    ImGui::Separator();
+                    if (m_PassProfiler->isSupported())
+                    {
+                        ImGui::Checkbox("Enable Pass Profiling", &settings.enablePassProfiling);
+                        ImGui::Checkbox("Show Overlay", &m_ShowPassStatsOverlay);
+                        if (ImGui::Button("Save Pass Stats"))
+                        {
+                            m_PassProfiler->saveJSON("pass_stats.json");
+                        }
+                        drawPassStats(m_PassProfiler->getStats(), m_PassProfiler->hasPipelineStatistics());
+                    }
+                    else
+                    {
+                        ImGui::Text("GPU timestamps are not supported on this device.");
+                    }
+                    ImGui::Unindent(5.0f);
+                }
+
+                if (settings.rendererType == RendererType::eRasterization &&
+                    HasFlagValues(m_RenderDevice.getFeatureFlag(), rhi::RenderDeviceFeatureFlagBits::eOpenXR) &&
+                    ImGui::CollapsingHeader("XR"))
+                {
+                    ImGui::Indent(5.0f);
+                    if (isMultiviewSupported())
+                    {
+                        ImGui::Checkbox("Enable Multiview", &settings.enableMultiview);
+                    }
+                    else
+                    {
+                        ImGui::Text("Multiview is not supported on this device.");
+                    }
+
+                    ImGui::Separator();
+                    ImGui::Checkbox("Enable Foveation", &settings.enableFoveation);
+                    ImGui::DragFloat("Inset Size", &settings.foveation.insetSize, 0.01f, 0.1f, 1.0f, "%.2f");
+                    ImGui::DragFloat(
+                        "Periphery Scale", &settings.foveation.peripheryScale, 0.01f, 0.25f, 1.0f, "%.2f");
+                    ImGui::DragFloat("Feather", &settings.foveation.feather, 0.01f, 0.0f, 0.5f, "%.2f");
+                    ImGui::Text("Gaze: %s", m_XrGazeDirection ? "tracked" : "fixed");
+                    if (settings.enableFoveation && settings.enableMultiview && isMultiviewSupported())
+                    {
+                        ImGui::Text("Foveation is not applied while multiview is enabled.");
+                    }
+                    ImGui::Unindent(5.0f);
+                }
+
                 if (ImGui::CollapsingHeader("Tone Mapping", ImGuiTreeNodeFlags_DefaultOpen))
                 {
                     ImGui::Indent(5.0f);
@@ -203,6 +625,18 @@ namespace vultra
 
                 ImGui::Unindent(5.0f);
             }
+
+            if (m_ShowPassStatsOverlay)
+            {
+                ImGui::SetNextWindowBgAlpha(0.75f);
+                if (ImGui::Begin("Pass Stats",
+                                 &m_ShowPassStatsOverlay,
+                                 ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoFocusOnAppearing))
+                {
+                    drawPassStats(m_PassProfiler->getStats(), m_PassProfiler->hasPipelineStatistics());
+                }
+                ImGui::End();
+            }
         }
 
         void BuiltinRenderer::onUpdate(const fsec dt)
@@ -234,6 +668,7 @@ namespace vultra
                     VULTRA_CLIENT_ERROR("Unknown renderer type");
                     return;
             }
+            m_BarrierStats = cb.getBarrierBuilder().getStats();
         }
 
         void BuiltinRenderer::renderXR(rhi::CommandBuffer& cb,
@@ -241,16 +676,152 @@ namespace vultra
                                        rhi::Texture*       rightEyeRenderTarget,
                                        const fsec          dt)
         {
+            if (m_LogicScene && m_Settings.rendererType == RendererType::eRasterization &&
+                m_Settings.enableMultiview && isMultiviewSupported())
+            {
+                renderMultiview(cb, leftEyeRenderTarget, rightEyeRenderTarget, dt);
+                m_BarrierStats = cb.getBarrierBuilder().getStats();
+                return;
+            }
+
+            if (m_LogicScene && m_Settings.enableFoveation)
+            {
+                renderFoveated(cb, leftEyeRenderTarget, m_XrCameraLeft, kLeftEyeView, kLeftEyeInsetView, dt);
+                renderFoveated(cb, rightEyeRenderTarget, m_XrCameraRight, kRightEyeView, kRightEyeInsetView, dt);
+                m_BarrierStats = cb.getBarrierBuilder().getStats();
+                return;
+            }
+
             m_CameraInfo = m_XrCameraLeft;
+            m_ViewId     = kLeftEyeView;
             render(cb, leftEyeRenderTarget, dt);
 
             m_CameraInfo = m_XrCameraRight;
+            m_ViewId     = kRightEyeView;
             render(cb, rightEyeRenderTarget, dt);
+
+            m_ViewId = kMainView;
+        }
+
+        void BuiltinRenderer::renderFoveated(rhi::CommandBuffer& cb,
+                                             rhi::Texture*       renderTarget,
+                                             const CameraInfo&   eyeCamera,
+                                             const uint32_t      peripheryViewId,
+                                             const uint32_t      insetViewId,
+                                             const fsec          dt)
+        {
+            ZoneScopedN("Foveated Rendering");
+
+            const auto& foveation      = m_Settings.foveation;
+            const float insetSize      = glm::clamp(foveation.insetSize, 0.1f, 1.0f);
+            const float peripheryScale = glm::clamp(foveation.peripheryScale, 0.25f, 1.0f);
+
+            // Inset center in NDC: the gaze point, or the view axis (fixed foveation) when the gaze is unknown.
+            // Clamped so the inset stays inside the view.
+            const glm::vec3 gazeVS =
+                m_XrGazeDirection ? glm::mat3(eyeCamera.view) * *m_XrGazeDirection : glm::vec3(0.0f, 0.0f, -1.0f);
+            const glm::vec4 gazeClip = eyeCamera.projection * glm::vec4(gazeVS, 0.0f);
+
+            glm::vec2 center {0.0f};
+            if (gazeClip.w > 1e-4f)
+            {
+                center = glm::vec2(gazeClip) / gazeClip.w;
+            }
+            center = glm::clamp(center, glm::vec2(insetSize - 1.0f), glm::vec2(1.0f - insetSize));
+
+            // Off-axis projection mapping [center - insetSize, center + insetSize] of the eye's NDC to the full view.
+            glm::mat4 crop {1.0f};
+            crop[0][0] = 1.0f / insetSize;
+            crop[1][1] = 1.0f / insetSize;
+            crop[3][0] = -center.x / insetSize;
+            crop[3][1] = -center.y / insetSize;
+
+            CameraInfo insetCamera                = eyeCamera;
+            insetCamera.projection                = crop * eyeCamera.projection;
+            insetCamera.inverseOriginalProjection = glm::inverse(insetCamera.projection);
+            insetCamera.viewProjection            = insetCamera.projection * insetCamera.view;
+
+            const auto frustumPlanes = vultra::math::extractFrustumPlanes(insetCamera.viewProjection);
+            for (int i = 0; i < 6; ++i)
+            {
+                const auto& plane            = frustumPlanes[i];
+                insetCamera.frustumPlanes[i] = glm::vec4(plane.normal, plane.d);
+            }
+
+            // The inset keeps the pixel density of the target, the periphery covers the whole view at a lower one.
+            const auto targetExtent = renderTarget->getExtent();
+            m_FoveatedCompositePass->prepareTargets(
+                DynamicResolutionController::getScaledExtent(targetExtent, peripheryScale),
+                DynamicResolutionController::getScaledExtent(targetExtent, insetSize),
+                renderTarget->getPixelFormat());
+
+            // Periphery and inset differ in extent and projection, each has its own temporal history.
+            m_CameraInfo = eyeCamera;
+            m_ViewId     = peripheryViewId;
+            render(cb, m_FoveatedCompositePass->getPeripheryTarget(), dt);
+
+            m_CameraInfo = insetCamera;
+            m_ViewId     = insetViewId;
+            render(cb, m_FoveatedCompositePass->getInsetTarget(), dt);
+
+            m_CameraInfo = eyeCamera;
+            m_ViewId     = kMainView;
+
+            {
+                ZoneScopedN("Prepare Attachments");
+
+                rhi::prepareForAttachment(cb, *renderTarget, false);
+            }
+
+            // Read by the composite pass when the graph executes.
+            const glm::vec2 insetMin = (center - insetSize) * 0.5f + 0.5f;
+            const glm::vec2 insetMax = (center + insetSize) * 0.5f + 0.5f;
+            m_FoveatedInsetRect      = glm::vec4(insetMin, insetMax);
+            m_FoveatedFeather        = glm::clamp(foveation.feather, 0.0f, 0.5f);
+
+            // The back buffer import of the cached graphs is bound to it.
+            m_BackBuffer = renderTarget;
+
+            // The imports take their descriptors from the targets.
+            const auto  peripheryExtent = m_FoveatedCompositePass->getPeripheryTarget()->getExtent();
+            const auto  insetExtent     = m_FoveatedCompositePass->getInsetTarget()->getExtent();
+            std::size_t topologyKey {0};
+            hashCombine(topologyKey,
+                        std::string_view {"FoveatedComposite"},
+                        targetExtent.width,
+                        targetExtent.height,
+                        renderTarget->getPixelFormat(),
+                        peripheryExtent.width,
+                        peripheryExtent.height,
+                        insetExtent.width,
+                        insetExtent.height);
+
+            auto& fg = getFrameGraph(topologyKey, [&](FrameGraph& graph) {
+                ZoneScopedN("Setup");
+
+                const auto backBuffer = framegraph::importTexture(graph, "Backbuffer", &m_BackBuffer);
+                m_FoveatedCompositePass->compose(graph, backBuffer, m_FoveatedInsetRect, m_FoveatedFeather);
+            });
+
+            {
+                gfx::RendererRenderContext rc {cb, m_Samplers};
+                FG_GPU_ZONE(rc.commandBuffer);
+                m_PassProfiler->begin();
+                fg.execute(&rc, &m_TransientResources);
+                m_PassProfiler->end();
+            }
+
+            m_TransientResources.update();
         }
 
         void BuiltinRenderer::beginFrame(rhi::CommandBuffer& cb)
         {
             BaseRenderer::beginFrame(cb);
+            m_QueueScheduler->nextFrame();
+            m_ParallelCommandRecorder->nextFrame();
+            m_TransientResources.getUploadRing().nextFrame(m_NumFramesInFlight);
+            m_PassProfiler->setEnabled(m_Settings.enablePassProfiling);
+            m_PassProfiler->nextFrame();
             clearUIDrawList();
         }
 
@@ -413,6 +984,10 @@ namespace vultra
                     m_XrCameraRight = CameraInfo {};
                 }
 
+                m_XrCameraCulling = (leftEyeCamera && rightEyeCamera) ?
+                                        makeStereoCullingCamera(m_XrCameraLeft, m_XrCameraRight) :
+                                        m_XrCameraLeft;
+
                 // Lights
                 m_LightInfo = LightInfo {};
 
@@ -526,122 +1101,394 @@ namespace vultra
                 .addressModeT = rhi::SamplerAddressMode::eClampToBorder,
                 .addressModeR = rhi::SamplerAddressMode::eClampToBorder,
 
+                .compareOp = rhi::CompareOp::eLessOrEqual,
+
                 .borderColor = rhi::BorderColor::eOpaqueWhite,
             });
         }
 
+        bool BuiltinRenderer::isMultiviewSupported() const
+        {
+            return HasFlagValues(m_RenderDevice.getFeatureReport().flags,
+                                 rhi::RenderDeviceFeatureReportFlagBits::eMultiview);
+        }
+
+        const framegraph::FrameGraphBuildStats& BuiltinRenderer::getFrameGraphBuildStats() const
+        {
+            return m_FrameGraphBuildTracker->getStats();
+        }
+
+        const framegraph::FramePassStats& BuiltinRenderer::getFramePassStats() const
+        {
+            return m_PassProfiler->getStats();
+        }
+
+        ParallelCommandRecorder* BuiltinRenderer::getParallelCommandRecorder() const
+        {
+            // Secondary command buffers would have to inherit the pipeline statistics queries of the profiler.
+            if (!m_Settings.enableParallelRecording ||
+                (m_Settings.enablePassProfiling && m_PassProfiler->hasPipelineStatistics()))
+                return nullptr;
+
+            return m_ParallelCommandRecorder;
+        }
+
+        std::size_t BuiltinRenderer::getTopologyKey(const rhi::Extent2D sceneExtent,
+                                                    const rhi::Texture& renderTarget) const
+        {
+            // What decides which passes are added, how their resources are described and what the passes capture by
+            // value. Per-frame values (camera, lights, exposure, ...) are read by the passes when the graph executes
+            // and do not change the topology, so the compiled graph of the key can be reused (see FrameGraphCache).
+            const auto& settings = m_Settings;
+
+            std::size_t h {0};
+            hashCombine(h,
+                        settings.rendererType,
+                        settings.outputMode,
+                        settings.enableAreaLights,
+                        settings.enableNormalMapping,
+                        settings.enableIBL,
+                        settings.toneMappingMethod,
+                        settings.enableShadows,
+                        settings.shadow.numCascades,
+                        settings.shadow.resolution,
+                        settings.enablePointShadows,
+                        settings.pointShadow.maxShadowedLights,
+                        settings.pointShadow.resolution,
+                        settings.enableRayTracedShadows,
+                        settings.enableSSR,
+                        settings.enableAsyncCompute,
+                        settings.enableMultiview,
+                        settings.maxRayRecursionDepth,
+                        settings.meshletDebugMode);
+            hashCombine(h,
+                        sceneExtent.width,
+                        sceneExtent.height,
+                        renderTarget.getExtent().width,
+                        renderTarget.getExtent().height,
+                        renderTarget.getPixelFormat(),
+                        m_SwapChainFormat,
+                        m_EnableSkybox,
+                        dd::hasPendingDraws());
+            hashCombine(h,
+                        m_ViewId,
+                        m_ClearColor.r,
+                        m_ClearColor.g,
+                        m_ClearColor.b,
+                        m_ClearColor.a,
+                        getParallelCommandRecorder() != nullptr,
+                        static_cast<bool>(m_RenderableGroup.tlas));
+            return h;
+        }
+
+        FrameGraph& BuiltinRenderer::getFrameGraph(const std::size_t                       topologyKey,
+                                                   const std::function<void(FrameGraph&)>& setup)
+        {
+            m_FrameGraphBuildTracker->beginSetup(topologyKey);
+
+            if (auto* fg = m_FrameGraphCache->find(topologyKey))
+            {
+                m_FrameGraphBuildTracker->reuse();
+                return *fg;
+            }
+
+            auto graph = createScope<FrameGraph>();
+            setup(*graph);
+
+            m_FrameGraphBuildTracker->beginCompile();
+            {
+                ZoneScopedN("FrameGraph::Compile");
+                graph->compile();
+            }
+            m_FrameGraphBuildTracker->end();
+
+            return m_FrameGraphCache->insert(topologyKey, std::move(graph));
+        }
+
         void BuiltinRenderer::onImGuiRasterization() {}
 
         void BuiltinRenderer::onImGuiRayTracing() {}
 
         void BuiltinRenderer::onImGuiMeshShading() {}
 
-        void BuiltinRenderer::renderRasterization(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt)
+        void BuiltinRenderer::setupRasterization(FrameGraph&         fg,
+                                                 const rhi::Extent2D sceneExtent,
+                                                 const rhi::Extent2D targetExtent,
+                                                 const fsec          dt)
         {
+            FrameGraphBlackboard blackboard;
+
+            ZoneScopedN("Setup");
+
+            const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", &m_BackBuffer);
+
+            // Import skybox cubemap (bound, a new environment does not change the topology)
+            const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", &m_Cubemap);
+
+            // Import IBL textures
+            const auto brdfLUT           = framegraph::importTexture(fg, "BRDF LUT", &m_BrdfLUT);
+            const auto irradianceMap     = framegraph::importTexture(fg, "Irradiance Map", &m_IrradianceMap);
+            const auto prefilteredEnvMap = framegraph::importTexture(fg, "Prefiltered Env Map", &m_PrefilteredEnvMap);
+            auto& iblData             = blackboard.add<IBLData>();
+            iblData.brdfLUT           = brdfLUT;
+            iblData.irradianceMap     = irradianceMap;
+            iblData.prefilteredEnvMap = prefilteredEnvMap;
+
+            uploadCameraBlock(fg, blackboard, sceneExtent, m_CameraInfo);
+            uploadFrameBlock(fg, blackboard, m_FrameInfo);
+            uploadLightBlock(fg, blackboard, m_LightInfo);
+
+            // Depth pre-pass
+            m_DepthPrePass->addPass(fg, blackboard, sceneExtent, m_RenderPrimitiveGroup);
+
+            if (m_Settings.enableSSR)
             {
-                ZoneScopedN("Prepare Attachments");
+                // Hi-Z, only needs the pre-pass depth. With async compute it overlaps the shadow passes
+                // below, which do not touch the scene depth (the G-Buffer pass waits for it).
+                m_HiZPass->addPass(fg, blackboard, m_QueueScheduler);
+            }
 
-                rhi::prepareForAttachment(cb, *renderTarget, false);
+            // Cascaded shadow maps (directional light)
+            m_CascadedShadowMapPass->addPass(fg,
+                                             blackboard,
+                                             m_CameraInfo,
+                                             m_LightInfo,
+                                             m_RenderPrimitiveGroup,
+                                             m_RenderableGroupHash,
+                                             m_Settings.shadow,
+                                             m_Settings.enableShadows);
+
+            // Point light shadow atlas
+            m_PointShadowPass->addPass(fg,
+                                       blackboard,
+                                       m_CameraInfo,
+                                       m_LightInfo,
+                                       m_RenderPrimitiveGroup,
+                                       m_Settings.pointShadow,
+                                       m_Settings.enablePointShadows);
+
+            // G-Buffer
+            m_GBufferPass->addPass(fg,
+                                   blackboard,
+                                   sceneExtent,
+                                   m_RenderPrimitiveGroup,
+                                   m_Settings.enableAreaLights,
+                                   m_Settings.enableNormalMapping,
+                                   0,
+                                   getParallelCommandRecorder());
+
+            // Ray traced shadow mask (overrides the shadow maps for the traced lights)
+            m_RayTracedShadowPass->addPass(fg,
+                                           blackboard,
+                                           m_CameraInfo,
+                                           m_LightInfo,
+                                           m_RenderableGroup,
+                                           m_Settings.rayTracedShadow,
+                                           m_Settings.enableRayTracedShadows,
+                                           m_ViewId);
+
+            // Deferred lighting
+            m_DeferredLightingPass->addPass(fg,
+                                            blackboard,
+                                            m_Settings.enableAreaLights,
+                                            m_Settings.enableIBL,
+                                            color::sRGBToLinear(m_ClearColor));
+            auto& sceneColor = blackboard.get<SceneColorData>();
+
+            if (m_EnableSkybox)
+            {
+                // Skybox
+                sceneColor.hdr = m_SkyboxPass->addPass(fg, blackboard, skyboxCubemap, sceneColor.hdr);
             }
 
+            if (m_Settings.enableSSR)
             {
-                ZoneScopedN("BultinRenderer");
+                // Hi-Z screen space reflections
+                sceneColor.hdr = m_SSRPass->addPass(
+                    fg, blackboard, sceneColor.hdr, m_CameraInfo.viewProjection, m_Settings.ssr, m_ViewId);
+            }
 
-                FrameGraph fg;
-                {
-                    FrameGraphBlackboard blackboard;
+            // Tone mapping
+            sceneColor.hdr = m_ToneMappingPass->addPass(
+                fg, sceneColor.hdr, m_Settings.exposure, m_Settings.toneMappingMethod);
+
+            // Gamma correction if swapchain is not in sRGB format
+            if (m_SwapChainFormat != rhi::Swapchain::Format::esRGB)
+            {
+                sceneColor.ldr = m_GammaCorrectionPass->addPass(
+                    fg, sceneColor.hdr, GammaCorrectionPass::GammaCorrectionMode::eGamma);
+            }
+            else
+            {
+                sceneColor.ldr = sceneColor.hdr;
+            }
+
+            // FXAA
+            sceneColor.aa = m_FXAAPass->aa(fg, sceneColor.ldr);
+
+            if (dd::hasPendingDraws())
+            {
+                // Debug draw
+                m_DebugDrawPass->addPass(fg, blackboard, dt, m_CameraInfo.viewProjection);
+                auto& debugDrawData = blackboard.get<DebugDrawData>();
 
-                    ZoneScopedN("Setup");
+                // Color blend
+                sceneColor.aa = m_ColorBlendPass->blend(
+                    fg, debugDrawData.debugDraw, sceneColor.aa, BlendType::eAdditive, ColorRange::eLDR);
+            }
 
-                    const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", renderTarget);
+            // Upscale to the output resolution (dynamic resolution)
+            sceneColor.aa = m_UpscalePass->upscale(fg, sceneColor.aa, targetExtent);
 
-                    // Import skybox cubemap
-                    const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", m_Cubemap.get());
+            if (m_QueueScheduler->isEnabled())
+            {
+                // The back buffer is written by the frame command buffer (waits for the swapchain image)
+                m_QueueScheduler->join(fg);
+            }
 
-                    // Import IBL textures
-                    const auto brdfLUT       = framegraph::importTexture(fg, "BRDF LUT", m_BrdfLUT.get());
-                    const auto irradianceMap = framegraph::importTexture(fg, "Irradiance Map", m_IrradianceMap.get());
-                    const auto prefilteredEnvMap =
-                        framegraph::importTexture(fg, "Prefiltered Env Map", m_PrefilteredEnvMap.get());
-                    auto& iblData             = blackboard.add<IBLData>();
-                    iblData.brdfLUT           = brdfLUT;
-                    iblData.irradianceMap     = irradianceMap;
-                    iblData.prefilteredEnvMap = prefilteredEnvMap;
+            // Final composition
+            m_FinalPass->compose(fg, blackboard, m_Settings.outputMode, backBuffer);
+        }
 
-                    uploadCameraBlock(fg, blackboard, renderTarget->getExtent(), m_CameraInfo);
-                    uploadFrameBlock(fg, blackboard, m_FrameInfo);
-                    uploadLightBlock(fg, blackboard, m_LightInfo);
+        void BuiltinRenderer::renderRasterization(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt)
+        {
+            // Moves the Hi-Z build to the async compute queue (see QueueScheduler).
+            m_QueueScheduler->setEnabled(m_Settings.enableAsyncCompute);
 
-                    // Depth pre-pass
-                    m_DepthPrePass->addPass(fg, blackboard, renderTarget->getExtent(), m_RenderPrimitiveGroup);
+            // With async compute, the recording so far is submitted ahead of the swapchain wait: leave the back
+            // buffer to the final pass, which is recorded after join().
+            if (!m_QueueScheduler->isEnabled())
+            {
+                ZoneScopedN("Prepare Attachments");
 
-                    // G-Buffer
-                    m_GBufferPass->addPass(fg,
-                                           blackboard,
-                                           renderTarget->getExtent(),
-                                           m_RenderPrimitiveGroup,
-                                           m_Settings.enableAreaLights,
-                                           m_Settings.enableNormalMapping);
-
-                    // Deferred lighting
-                    m_DeferredLightingPass->addPass(fg,
-                                                    blackboard,
-                                                    m_Settings.enableAreaLights,
-                                                    m_Settings.enableIBL,
-                                                    color::sRGBToLinear(m_ClearColor));
-                    auto& sceneColor = blackboard.get<SceneColorData>();
-
-                    if (m_EnableSkybox)
-                    {
-                        // Skybox
-                        sceneColor.hdr = m_SkyboxPass->addPass(fg, blackboard, skyboxCubemap, sceneColor.hdr);
-                    }
+                rhi::prepareForAttachment(cb, *renderTarget, false);
+            }
+
+            // Scene passes render at a scale picked from the measured GPU time, upscaled before the final pass.
+            const auto targetExtent = renderTarget->getExtent();
+            const auto sceneExtent  = DynamicResolutionController::getScaledExtent(
+                targetExtent,
+                m_DynamicResolution->update(m_Settings.dynamicResolution, m_Settings.enableDynamicResolution));
 
-                    // Tone mapping
-                    sceneColor.hdr = m_ToneMappingPass->addPass(
-                        fg, sceneColor.hdr, m_Settings.exposure, m_Settings.toneMappingMethod);
+            {
+                ZoneScopedN("BultinRenderer");
+
+                // The back buffer import of the cached graphs is bound to it.
+                m_BackBuffer = renderTarget;
 
-                    // Gamma correction if swapchain is not in sRGB format
-                    if (m_SwapChainFormat != rhi::Swapchain::Format::esRGB)
+                auto& fg = getFrameGraph(getTopologyKey(sceneExtent, *renderTarget), [&](FrameGraph& graph) {
+                    setupRasterization(graph, sceneExtent, targetExtent, dt);
+                });
+
+                m_QueueScheduler->begin(cb);
+                m_DynamicResolution->beginMeasure(cb);
+                {
+                    gfx::RendererRenderContext rc {cb, m_Samplers};
+                    const auto                 execute = [&] {
+                        auto& storeTracker = m_TransientResources.getAttachmentStoreTracker();
+                        storeTracker.begin();
+                        m_PassProfiler->begin();
+                        fg.execute(&rc, &m_TransientResources);
+                        m_PassProfiler->end();
+                        storeTracker.end();
+                    };
+                    if (m_QueueScheduler->isEnabled())
                     {
-                        sceneColor.ldr = m_GammaCorrectionPass->addPass(
-                            fg, sceneColor.hdr, GammaCorrectionPass::GammaCorrectionMode::eGamma);
+                        // The graph is split into command buffers, only the per-pass GPU zones apply.
+                        execute();
                     }
                     else
                     {
-                        sceneColor.ldr = sceneColor.hdr;
+                        FG_GPU_ZONE(rc.commandBuffer);
+                        execute();
                     }
+                }
+                m_DynamicResolution->endMeasure(cb);
+                m_QueueScheduler->end(cb);
 
-                    // FXAA
-                    sceneColor.aa = m_FXAAPass->aa(fg, sceneColor.ldr);
+#if _DEBUG
+                if (m_FrameGraphBuildTracker->isTopologyChanged())
+                {
+                    std::ofstream ofs {"framegraph.dot"};
+                    ofs << fg;
+                }
+#endif
 
-                    if (dd::hasPendingDraws())
-                    {
-                        // Debug draw
-                        m_DebugDrawPass->addPass(fg, blackboard, dt, m_CameraInfo.viewProjection);
-                        auto& debugDrawData = blackboard.get<DebugDrawData>();
+                m_TransientResources.update();
+            }
+        }
 
-                        // Color blend
-                        sceneColor.aa = m_ColorBlendPass->blend(
-                            fg, debugDrawData.debugDraw, sceneColor.aa, BlendType::eAdditive, ColorRange::eLDR);
-                    }
+        void BuiltinRenderer::setupRayTracing(FrameGraph& fg, const rhi::Extent2D extent)
+        {
+            FrameGraphBlackboard blackboard;
+
+            ZoneScopedN("Setup");
+
+            const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", &m_BackBuffer);
+
+            // Import IBL textures
+            const auto brdfLUT           = framegraph::importTexture(fg, "BRDF LUT", &m_BrdfLUT);
+            const auto irradianceMap     = framegraph::importTexture(fg, "Irradiance Map", &m_IrradianceMap);
+            const auto prefilteredEnvMap = framegraph::importTexture(fg, "Prefiltered Env Map", &m_PrefilteredEnvMap);
+            auto& iblData             = blackboard.add<IBLData>();
+            iblData.brdfLUT           = brdfLUT;
+            iblData.irradianceMap     = irradianceMap;
+            iblData.prefilteredEnvMap = prefilteredEnvMap;
+
+            uploadCameraBlock(fg, blackboard, extent, m_CameraInfo);
+            uploadFrameBlock(fg, blackboard, m_FrameInfo);
+            uploadLightBlock(fg, blackboard, m_LightInfo);
+
+            // Ray Tracing Pass
+            auto raytracedResult = m_SimpleRaytracingPass->addPass(fg,
+                                                                   blackboard,
+                                                                   extent,
+                                                                   m_RenderableGroup,
+                                                                   m_Settings.maxRayRecursionDepth,
+                                                                   m_ClearColor,
+                                                                   static_cast<uint32_t>(m_Settings.outputMode),
+                                                                   m_Settings.enableNormalMapping,
+                                                                   m_Settings.enableAreaLights,
+                                                                   m_Settings.enableIBL,
+                                                                   m_Settings.exposure,
+                                                                   m_Settings.toneMappingMethod);
+
+            auto aaResult = m_FXAAPass->aa(fg, raytracedResult);
+
+            m_BlitPass->blit(fg, aaResult, backBuffer);
+        }
 
-                    // Final composition
-                    m_FinalPass->compose(fg, blackboard, m_Settings.outputMode, backBuffer);
-                }
+        void BuiltinRenderer::renderRayTracing(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec /*dt*/)
+        {
+            {
+                ZoneScopedN("Prepare Attachments");
 
-                {
-                    ZoneScopedN("FrameGraph::Compile");
-                    fg.compile();
-                }
+                rhi::prepareForAttachment(cb, *renderTarget, false);
+            }
+
+            {
+                ZoneScopedN("BultinRenderer");
+
+                // The back buffer import of the cached graphs is bound to it.
+                m_BackBuffer = renderTarget;
+
+                const auto extent = renderTarget->getExtent();
+                auto&      fg     = getFrameGraph(getTopologyKey(extent, *renderTarget),
+                                                  [&](FrameGraph& graph) { setupRayTracing(graph, extent); });
 
                 {
                     gfx::RendererRenderContext rc {cb, m_Samplers};
                     FG_GPU_ZONE(rc.commandBuffer);
+                    auto& storeTracker = m_TransientResources.getAttachmentStoreTracker();
+                    storeTracker.begin();
+                    m_PassProfiler->begin();
                     fg.execute(&rc, &m_TransientResources);
+                    m_PassProfiler->end();
+                    storeTracker.end();
                 }
 
 #if _DEBUG
+                if (m_FrameGraphBuildTracker->isTopologyChanged())
                 {
                     std::ofstream ofs {"framegraph.dot"};
                     ofs << fg;
@@ -652,73 +1499,170 @@ namespace vultra
             }
         }
 
-        void BuiltinRenderer::renderRayTracing(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec /*dt*/)
+        void BuiltinRenderer::setupMeshShading(FrameGraph&         fg,
+                                               const rhi::Extent2D sceneExtent,
+                                               const rhi::Extent2D targetExtent,
+                                               const fsec          dt)
         {
+            FrameGraphBlackboard blackboard;
+
+            ZoneScopedN("Setup");
+
+            const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", &m_BackBuffer);
+
+            // Import skybox cubemap (bound, a new environment does not change the topology)
+            const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", &m_Cubemap);
+
+            // Import IBL textures
+            const auto brdfLUT           = framegraph::importTexture(fg, "BRDF LUT", &m_BrdfLUT);
+            const auto irradianceMap     = framegraph::importTexture(fg, "Irradiance Map", &m_IrradianceMap);
+            const auto prefilteredEnvMap = framegraph::importTexture(fg, "Prefiltered Env Map", &m_PrefilteredEnvMap);
+            auto& iblData             = blackboard.add<IBLData>();
+            iblData.brdfLUT           = brdfLUT;
+            iblData.irradianceMap     = irradianceMap;
+            iblData.prefilteredEnvMap = prefilteredEnvMap;
+
+            uploadCameraBlock(fg, blackboard, sceneExtent, m_CameraInfo);
+            uploadFrameBlock(fg, blackboard, m_FrameInfo);
+            uploadLightBlock(fg, blackboard, m_LightInfo);
+
+            // Meshlet Depth Pre-pass
+            m_MeshletDepthPrePass->addPass(fg, blackboard, sceneExtent, m_RenderableGroup);
+
+            // Meshlet GBuffer Pass
+            m_MeshletGBufferPass->addPass(fg,
+                                          blackboard,
+                                          sceneExtent,
+                                          m_RenderableGroup,
+                                          m_Settings.enableNormalMapping,
+                                          m_Settings.meshletDebugMode);
+
+            // Cascaded shadow maps (directional light)
+            m_CascadedShadowMapPass->addPass(fg,
+                                             blackboard,
+                                             m_CameraInfo,
+                                             m_LightInfo,
+                                             m_RenderPrimitiveGroup,
+                                             m_RenderableGroupHash,
+                                             m_Settings.shadow,
+                                             m_Settings.enableShadows);
+
+            // Point light shadow atlas
+            m_PointShadowPass->addPass(fg,
+                                       blackboard,
+                                       m_CameraInfo,
+                                       m_LightInfo,
+                                       m_RenderPrimitiveGroup,
+                                       m_Settings.pointShadow,
+                                       m_Settings.enablePointShadows);
+
+            // Ray traced shadow mask (overrides the shadow maps for the traced lights)
+            m_RayTracedShadowPass->addPass(fg,
+                                           blackboard,
+                                           m_CameraInfo,
+                                           m_LightInfo,
+                                           m_RenderableGroup,
+                                           m_Settings.rayTracedShadow,
+                                           m_Settings.enableRayTracedShadows,
+                                           m_ViewId);
+
+            // Deferred lighting
+            m_DeferredLightingPass->addPass(fg,
+                                            blackboard,
+                                            m_Settings.enableAreaLights,
+                                            m_Settings.enableIBL,
+                                            color::sRGBToLinear(m_ClearColor));
+            auto& sceneColor = blackboard.get<SceneColorData>();
+
+            if (m_EnableSkybox)
             {
-                ZoneScopedN("Prepare Attachments");
+                // Skybox
+                sceneColor.hdr = m_SkyboxPass->addPass(fg, blackboard, skyboxCubemap, sceneColor.hdr);
+            }
 
-                rhi::prepareForAttachment(cb, *renderTarget, false);
+            if (m_Settings.enableSSR)
+            {
+                // Hi-Z screen space reflections
+                m_HiZPass->addPass(fg, blackboard);
+                sceneColor.hdr = m_SSRPass->addPass(
+                    fg, blackboard, sceneColor.hdr, m_CameraInfo.viewProjection, m_Settings.ssr, m_ViewId);
             }
 
+            // Tone mapping
+            sceneColor.hdr = m_ToneMappingPass->addPass(
+                fg, sceneColor.hdr, m_Settings.exposure, m_Settings.toneMappingMethod);
+
+            // Gamma correction if swapchain is not in sRGB format
+            if (m_SwapChainFormat != rhi::Swapchain::Format::esRGB)
             {
-                ZoneScopedN("BultinRenderer");
+                sceneColor.ldr = m_GammaCorrectionPass->addPass(
+                    fg, sceneColor.hdr, GammaCorrectionPass::GammaCorrectionMode::eGamma);
+            }
+            else
+            {
+                sceneColor.ldr = sceneColor.hdr;
+            }
 
-                FrameGraph fg;
-                {
-                    FrameGraphBlackboard blackboard;
+            // FXAA
+            sceneColor.aa = m_FXAAPass->aa(fg, sceneColor.ldr);
 
-                    ZoneScopedN("Setup");
+            if (dd::hasPendingDraws())
+            {
+                // Debug draw
+                m_DebugDrawPass->addPass(fg, blackboard, dt, m_CameraInfo.viewProjection);
+                auto& debugDrawData = blackboard.get<DebugDrawData>();
 
-                    const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", renderTarget);
+                // Color blend
+                sceneColor.aa = m_ColorBlendPass->blend(
+                    fg, debugDrawData.debugDraw, sceneColor.aa, BlendType::eAdditive, ColorRange::eLDR);
+            }
 
-                    // Import skybox cubemap
-                    const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", m_Cubemap.get());
+            // Upscale to the output resolution (dynamic resolution)
+            sceneColor.aa = m_UpscalePass->upscale(fg, sceneColor.aa, targetExtent);
 
-                    // Import IBL textures
-                    const auto brdfLUT       = framegraph::importTexture(fg, "BRDF LUT", m_BrdfLUT.get());
-                    const auto irradianceMap = framegraph::importTexture(fg, "Irradiance Map", m_IrradianceMap.get());
-                    const auto prefilteredEnvMap =
-                        framegraph::importTexture(fg, "Prefiltered Env Map", m_PrefilteredEnvMap.get());
-                    auto& iblData             = blackboard.add<IBLData>();
-                    iblData.brdfLUT           = brdfLUT;
-                    iblData.irradianceMap     = irradianceMap;
-                    iblData.prefilteredEnvMap = prefilteredEnvMap;
+            // Final composition
+            m_FinalPass->compose(fg, blackboard, m_Settings.outputMode, backBuffer);
+        }
 
-                    uploadCameraBlock(fg, blackboard, renderTarget->getExtent(), m_CameraInfo);
-                    uploadFrameBlock(fg, blackboard, m_FrameInfo);
-                    uploadLightBlock(fg, blackboard, m_LightInfo);
+        void BuiltinRenderer::renderMeshShading(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt)
+        {
+            {
+                ZoneScopedN("Prepare Attachments");
 
-                    // Ray Tracing Pass
-                    auto raytracedResult = m_SimpleRaytracingPass->addPass(fg,
-                                                                           blackboard,
-                                                                           renderTarget->getExtent(),
-                                                                           m_RenderableGroup,
-                                                                           m_Settings.maxRayRecursionDepth,
-                                                                           m_ClearColor,
-                                                                           static_cast<uint32_t>(m_Settings.outputMode),
-                                                                           m_Settings.enableNormalMapping,
-                                                                           m_Settings.enableAreaLights,
-                                                                           m_Settings.enableIBL,
-                                                                           m_Settings.exposure,
-                                                                           m_Settings.toneMappingMethod);
+                rhi::prepareForAttachment(cb, *renderTarget, false);
+            }
 
-                    auto aaResult = m_FXAAPass->aa(fg, raytracedResult);
+            // Scene passes render at a scale picked from the measured GPU time, upscaled before the final pass.
+            const auto targetExtent = renderTarget->getExtent();
+            const auto sceneExtent  = DynamicResolutionController::getScaledExtent(
+                targetExtent,
+                m_DynamicResolution->update(m_Settings.dynamicResolution, m_Settings.enableDynamicResolution));
 
-                    m_BlitPass->blit(fg, aaResult, backBuffer);
-                }
+            {
+                ZoneScopedN("BultinRenderer");
 
-                {
-                    ZoneScopedN("FrameGraph::Compile");
-                    fg.compile();
-                }
+                // The back buffer import of the cached graphs is bound to it.
+                m_BackBuffer = renderTarget;
 
+                auto& fg = getFrameGraph(getTopologyKey(sceneExtent, *renderTarget), [&](FrameGraph& graph) {
+                    setupMeshShading(graph, sceneExtent, targetExtent, dt);
+                });
+
+                m_DynamicResolution->beginMeasure(cb);
                 {
                     gfx::RendererRenderContext rc {cb, m_Samplers};
                     FG_GPU_ZONE(rc.commandBuffer);
+                    auto& storeTracker = m_TransientResources.getAttachmentStoreTracker();
+                    storeTracker.begin();
+                    m_PassProfiler->begin();
                     fg.execute(&rc, &m_TransientResources);
+                    m_PassProfiler->end();
+                    storeTracker.end();
                 }
+                m_DynamicResolution->endMeasure(cb);
 
 #if _DEBUG
+                if (m_FrameGraphBuildTracker->isTopologyChanged())
                 {
                     std::ofstream ofs {"framegraph.dot"};
                     ofs << fg;
@@ -729,112 +1673,199 @@ namespace vultra
             }
         }
 
-        void BuiltinRenderer::renderMeshShading(rhi::CommandBuffer& cb, rhi::Texture* renderTarget, const fsec dt)
+        void BuiltinRenderer::setupMultiview(FrameGraph& fg, const rhi::Extent2D extent, const fsec dt)
         {
+            constexpr uint32_t kStereoViewMask = 0b11;
+
+            FrameGraphBlackboard blackboard;
+
+            ZoneScopedN("Setup");
+
+            const std::array backBuffers {
+                framegraph::importTexture(fg, "Backbuffer - Left", &m_BackBuffer),
+                framegraph::importTexture(fg, "Backbuffer - Right", &m_RightEyeBackBuffer),
+            };
+
+            // Import skybox cubemap (bound, a new environment does not change the topology)
+            const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", &m_Cubemap);
+
+            // Import IBL textures
+            const auto brdfLUT           = framegraph::importTexture(fg, "BRDF LUT", &m_BrdfLUT);
+            const auto irradianceMap     = framegraph::importTexture(fg, "Irradiance Map", &m_IrradianceMap);
+            const auto prefilteredEnvMap = framegraph::importTexture(fg, "Prefiltered Env Map", &m_PrefilteredEnvMap);
+            auto& iblData             = blackboard.add<IBLData>();
+            iblData.brdfLUT           = brdfLUT;
+            iblData.irradianceMap     = irradianceMap;
+            iblData.prefilteredEnvMap = prefilteredEnvMap;
+
+            uploadStereoCameraBlock(fg, blackboard, extent, m_XrCameraLeft, m_XrCameraRight, m_XrCameraCulling);
+            uploadFrameBlock(fg, blackboard, m_FrameInfo);
+            uploadLightBlock(fg, blackboard, m_LightInfo);
+
+            // Depth pre-pass and G-Buffer record their draws once, gl_ViewIndex selects the eye
+            m_DepthPrePass->addPass(fg, blackboard, extent, m_RenderPrimitiveGroup, kStereoViewMask);
+            m_GBufferPass->addPass(fg,
+                                   blackboard,
+                                   extent,
+                                   m_RenderPrimitiveGroup,
+                                   m_Settings.enableAreaLights,
+                                   m_Settings.enableNormalMapping,
+                                   kStereoViewMask,
+                                   getParallelCommandRecorder());
+
+            // Shadow maps do not depend on the eye, fit them once to the frustum enclosing both
+            m_CascadedShadowMapPass->addPass(fg,
+                                             blackboard,
+                                             m_XrCameraCulling,
+                                             m_LightInfo,
+                                             m_RenderPrimitiveGroup,
+                                             m_RenderableGroupHash,
+                                             m_Settings.shadow,
+                                             m_Settings.enableShadows);
+            m_PointShadowPass->addPass(fg,
+                                       blackboard,
+                                       m_XrCameraCulling,
+                                       m_LightInfo,
+                                       m_RenderPrimitiveGroup,
+                                       m_Settings.pointShadow,
+                                       m_Settings.enablePointShadows);
+
+            const auto stereoDepth   = blackboard.get<DepthPreData>().depth;
+            const auto stereoGBuffer = blackboard.get<GBufferData>();
+
+            // Screen space passes run per eye on single layer copies of the stereo targets
+            const std::array eyeCameras {&m_XrCameraLeft, &m_XrCameraRight};
+            const std::array eyeViews {kLeftEyeView, kRightEyeView};
+            for (uint32_t eye = 0; eye < eyeCameras.size(); ++eye)
             {
-                ZoneScopedN("Prepare Attachments");
+                const auto& camera        = *eyeCameras[eye];
+                auto        eyeBlackboard = blackboard;
 
-                rhi::prepareForAttachment(cb, *renderTarget, false);
-            }
+                uploadCameraBlock(fg, eyeBlackboard, extent, camera);
 
-            {
-                ZoneScopedN("BultinRenderer");
+                eyeBlackboard.get<DepthPreData>().depth = m_StereoLayerPass->extract(fg, stereoDepth, eye);
 
-                FrameGraph fg;
+                auto& gBuffer = eyeBlackboard.get<GBufferData>();
+                for (const auto target : {&GBufferData::albedo,
+                                          &GBufferData::normal,
+                                          &GBufferData::emissive,
+                                          &GBufferData::metallicRoughnessAO,
+                                          &GBufferData::textureLodDebug})
                 {
-                    FrameGraphBlackboard blackboard;
-
-                    ZoneScopedN("Setup");
+                    gBuffer.*target = m_StereoLayerPass->extract(fg, stereoGBuffer.*target, eye);
+                }
 
-                    const auto backBuffer = framegraph::importTexture(fg, "Backbuffer", renderTarget);
+                // Ray traced shadow mask (overrides the shadow maps for the traced lights)
+                m_RayTracedShadowPass->addPass(fg,
+                                               eyeBlackboard,
+                                               camera,
+                                               m_LightInfo,
+                                               m_RenderableGroup,
+                                               m_Settings.rayTracedShadow,
+                                               m_Settings.enableRayTracedShadows,
+                                               eyeViews[eye]);
+
+                // Deferred lighting
+                m_DeferredLightingPass->addPass(fg,
+                                                eyeBlackboard,
+                                                m_Settings.enableAreaLights,
+                                                m_Settings.enableIBL,
+                                                color::sRGBToLinear(m_ClearColor));
+                auto& sceneColor = eyeBlackboard.get<SceneColorData>();
+
+                if (m_EnableSkybox)
+                {
+                    // Skybox
+                    sceneColor.hdr = m_SkyboxPass->addPass(fg, eyeBlackboard, skyboxCubemap, sceneColor.hdr);
+                }
 
-                    // Import skybox cubemap
-                    const auto skyboxCubemap = framegraph::importTexture(fg, "Skybox Cubemap", m_Cubemap.get());
+                if (m_Settings.enableSSR)
+                {
+                    // Hi-Z screen space reflections
+                    m_HiZPass->addPass(fg, eyeBlackboard);
+                    sceneColor.hdr = m_SSRPass->addPass(fg,
+                                                        eyeBlackboard,
+                                                        sceneColor.hdr,
+                                                        camera.viewProjection,
+                                                        m_Settings.ssr,
+                                                        eyeViews[eye]);
+                }
 
-                    // Import IBL textures
-                    const auto brdfLUT       = framegraph::importTexture(fg, "BRDF LUT", m_BrdfLUT.get());
-                    const auto irradianceMap = framegraph::importTexture(fg, "Irradiance Map", m_IrradianceMap.get());
-                    const auto prefilteredEnvMap =
-                        framegraph::importTexture(fg, "Prefiltered Env Map", m_PrefilteredEnvMap.get());
-                    auto& iblData             = blackboard.add<IBLData>();
-                    iblData.brdfLUT           = brdfLUT;
-                    iblData.irradianceMap     = irradianceMap;
-                    iblData.prefilteredEnvMap = prefilteredEnvMap;
+                // Tone mapping
+                sceneColor.hdr = m_ToneMappingPass->addPass(
+                    fg, sceneColor.hdr, m_Settings.exposure, m_Settings.toneMappingMethod);
 
-                    uploadCameraBlock(fg, blackboard, renderTarget->getExtent(), m_CameraInfo);
-                    uploadFrameBlock(fg, blackboard, m_FrameInfo);
-                    uploadLightBlock(fg, blackboard, m_LightInfo);
+                // Gamma correction if swapchain is not in sRGB format
+                if (m_SwapChainFormat != rhi::Swapchain::Format::esRGB)
+                {
+                    sceneColor.ldr = m_GammaCorrectionPass->addPass(
+                        fg, sceneColor.hdr, GammaCorrectionPass::GammaCorrectionMode::eGamma);
+                }
+                else
+                {
+                    sceneColor.ldr = sceneColor.hdr;
+                }
 
-                    // Meshlet Depth Pre-pass
-                    m_MeshletDepthPrePass->addPass(fg, blackboard, renderTarget->getExtent(), m_RenderableGroup);
+                // FXAA
+                sceneColor.aa = m_FXAAPass->aa(fg, sceneColor.ldr);
 
-                    // Meshlet GBuffer Pass
-                    m_MeshletGBufferPass->addPass(fg,
-                                                  blackboard,
-                                                  renderTarget->getExtent(),
-                                                  m_RenderableGroup,
-                                                  m_Settings.enableNormalMapping,
-                                                  m_Settings.meshletDebugMode);
+                if (dd::hasPendingDraws())
+                {
+                    // Debug draw
+                    m_DebugDrawPass->addPass(fg, eyeBlackboard, dt, camera.viewProjection);
+                    auto& debugDrawData = eyeBlackboard.get<DebugDrawData>();
 
-                    // Deferred lighting
-                    m_DeferredLightingPass->addPass(fg,
-                                                    blackboard,
-                                                    m_Settings.enableAreaLights,
-                                                    m_Settings.enableIBL,
-                                                    color::sRGBToLinear(m_ClearColor));
-                    auto& sceneColor = blackboard.get<SceneColorData>();
+                    // Color blend
+                    sceneColor.aa = m_ColorBlendPass->blend(
+                        fg, debugDrawData.debugDraw, sceneColor.aa, BlendType::eAdditive, ColorRange::eLDR);
+                }
 
-                    if (m_EnableSkybox)
-                    {
-                        // Skybox
-                        sceneColor.hdr = m_SkyboxPass->addPass(fg, blackboard, skyboxCubemap, sceneColor.hdr);
-                    }
+                // Final composition
+                m_FinalPass->compose(fg, eyeBlackboard, m_Settings.outputMode, backBuffers[eye]);
+            }
+        }
 
-                    // Tone mapping
-                    sceneColor.hdr = m_ToneMappingPass->addPass(
-                        fg, sceneColor.hdr, m_Settings.exposure, m_Settings.toneMappingMethod);
+        void BuiltinRenderer::renderMultiview(rhi::CommandBuffer& cb,
+                                              rhi::Texture*       leftEyeRenderTarget,
+                                              rhi::Texture*       rightEyeRenderTarget,
+                                              const fsec          dt)
+        {
+            {
+                ZoneScopedN("Prepare Attachments");
 
-                    // Gamma correction if swapchain is not in sRGB format
-                    if (m_SwapChainFormat != rhi::Swapchain::Format::esRGB)
-                    {
-                        sceneColor.ldr = m_GammaCorrectionPass->addPass(
-                            fg, sceneColor.hdr, GammaCorrectionPass::GammaCorrectionMode::eGamma);
-                    }
-                    else
-                    {
-                        sceneColor.ldr = sceneColor.hdr;
-                    }
+                rhi::prepareForAttachment(cb, *leftEyeRenderTarget, false);
+                rhi::prepareForAttachment(cb, *rightEyeRenderTarget, false);
+            }
 
-                    // FXAA
-                    sceneColor.aa = m_FXAAPass->aa(fg, sceneColor.ldr);
+            // Both eyes are layers of the same swapchain image, so they share one extent.
+            const auto extent = leftEyeRenderTarget->getExtent();
 
-                    if (dd::hasPendingDraws())
-                    {
-                        // Debug draw
-                        m_DebugDrawPass->addPass(fg, blackboard, dt, m_CameraInfo.viewProjection);
-                        auto& debugDrawData = blackboard.get<DebugDrawData>();
+            {
+                ZoneScopedN("BultinRenderer");
 
-                        // Color blend
-                        sceneColor.aa = m_ColorBlendPass->blend(
-                            fg, debugDrawData.debugDraw, sceneColor.aa, BlendType::eAdditive, ColorRange::eLDR);
-                    }
+                // The back buffer imports of the cached graph are bound to them.
+                m_BackBuffer         = leftEyeRenderTarget;
+                m_RightEyeBackBuffer = rightEyeRenderTarget;
 
-                    // Final composition
-                    m_FinalPass->compose(fg, blackboard, m_Settings.outputMode, backBuffer);
-                }
+                // Renders both eye views, unlike a single view graph of the same target.
+                auto topologyKey = getTopologyKey(extent, *leftEyeRenderTarget);
+                hashCombine(topologyKey, kLeftEyeView, kRightEyeView);
 
-                {
-                    ZoneScopedN("FrameGraph::Compile");
-                    fg.compile();
-                }
+                auto& fg = getFrameGraph(topologyKey, [&](FrameGraph& graph) { setupMultiview(graph, extent, dt); });
 
                 {
                     gfx::RendererRenderContext rc {cb, m_Samplers};
                     FG_GPU_ZONE(rc.commandBuffer);
+                    auto& storeTracker = m_TransientResources.getAttachmentStoreTracker();
+                    storeTracker.begin();
+                    m_PassProfiler->begin();
                     fg.execute(&rc, &m_TransientResources);
+                    m_PassProfiler->end();
+                    storeTracker.end();
                 }
 
 #if _DEBUG
+                if (m_FrameGraphBuildTracker->isTopologyChanged())
                 {
                     std::ofstream ofs {"framegraph.dot"};
                     ofs << fg;
@@ -0,0 +1,136 @@
+#include "vultra/function/renderer/builtin/dynamic_resolution_controller.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+#include <glm/common.hpp>
+#include <glm/exponential.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        namespace
+        {
+            constexpr float kGPUTimeSmoothing = 0.2f;
+        } // namespace
+
+        DynamicResolutionController::DynamicResolutionController(rhi::RenderDevice& rd) :
+            m_TimestampPeriod(rd.getTimestampPeriod())
+        {
+            if (isSupported())
+            {
+                m_QueryPool = rd.createQueryPool(vk::QueryType::eTimestamp, NUM_SLOTS * 2);
+            }
+        }
+
+        float DynamicResolutionController::update(const DynamicResolutionSettings& settings, const bool enabled)
+        {
+            collect();
+
+            auto scale = 1.0f;
+            if (enabled && isSupported())
+            {
+                const auto minScale = glm::clamp(glm::min(settings.minScale, settings.maxScale), 0.25f, 1.0f);
+                const auto maxScale = glm::clamp(glm::max(settings.minScale, settings.maxScale), minScale, 1.0f);
+
+                // Bounds may have been changed since the last frame.
+                scale = glm::clamp(m_Scale, minScale, maxScale);
+
+                if (m_NumSamples >= glm::max(settings.minSampleCount, 1u) && settings.targetFrameTime > 0.0f)
+                {
+                    const auto step   = glm::max(settings.scaleStep, 0.01f);
+                    const auto budget = settings.targetFrameTime * glm::clamp(settings.headroom, 0.1f, 1.0f);
+
+                    // Between budget and target the scale holds, so it does not oscillate around the target.
+                    const auto overBudget  = m_GPUTime > settings.targetFrameTime;
+                    const auto underBudget = m_GPUTime < budget;
+                    if (overBudget || underBudget)
+                    {
+                        const auto desired   = m_Scale * glm::sqrt(budget / glm::max(m_GPUTime, 1e-3f));
+                        const auto quantized = glm::floor(desired / step + 1e-3f) * step;
+                        scale = glm::clamp(overBudget ? glm::min(quantized, m_Scale) : glm::max(quantized, m_Scale),
+                                           minScale,
+                                           maxScale);
+                    }
+                }
+            }
+
+            if (scale != m_Scale)
+            {
+                m_Scale      = scale;
+                m_NumSamples = 0;
+            }
+            return m_Scale;
+        }
+
+        void DynamicResolutionController::beginMeasure(rhi::CommandBuffer& cb)
+        {
+            if (!isSupported())
+                return;
+
+            // An unfinished measurement in this slot is dropped.
+            m_Slots[m_CurrentSlot] = {.scale = m_Scale, .pending = false};
+
+            const auto firstQuery = m_CurrentSlot * 2;
+            cb.resetQueryPool(m_QueryPool, firstQuery, 2)
+                .writeTimestamp(m_QueryPool, firstQuery, rhi::PipelineStages::eTop);
+            m_Measuring = true;
+        }
+
+        void DynamicResolutionController::endMeasure(rhi::CommandBuffer& cb)
+        {
+            if (!m_Measuring)
+                return;
+
+            cb.writeTimestamp(m_QueryPool, m_CurrentSlot * 2 + 1, rhi::PipelineStages::eBottom);
+
+            m_Slots[m_CurrentSlot].pending = true;
+            m_CurrentSlot                  = (m_CurrentSlot + 1) % NUM_SLOTS;
+            m_Measuring                    = false;
+        }
+
+        void DynamicResolutionController::reset()
+        {
+            for (auto& slot : m_Slots)
+            {
+                slot.pending = false;
+            }
+            m_Scale      = 1.0f;
+            m_GPUTime    = 0.0f;
+            m_NumSamples = 0;
+        }
+
+        rhi::Extent2D DynamicResolutionController::getScaledExtent(const rhi::Extent2D& extent, const float scale)
+        {
+            return {
+                glm::max(static_cast<uint32_t>(static_cast<float>(extent.width) * scale + 0.5f), 1u),
+                glm::max(static_cast<uint32_t>(static_cast<float>(extent.height) * scale + 0.5f), 1u),
+            };
+        }
+
+        void DynamicResolutionController::collect()
+        {
+            // Oldest slot first; queries complete in submission order.
+            for (uint32_t i = 0; i < NUM_SLOTS; ++i)
+            {
+                const auto index = (m_CurrentSlot + i) % NUM_SLOTS;
+                auto&      slot  = m_Slots[index];
+                if (!slot.pending)
+                    continue;
+
+                uint64_t timestamps[2] {};
+                if (!m_QueryPool.getResults(index * 2, timestamps))
+                    break;
+
+                slot.pending = false;
+                if (slot.scale != m_Scale || timestamps[1] < timestamps[0])
+                    continue;
+
+                const auto gpuTime =
+                    static_cast<float>(static_cast<double>(timestamps[1] - timestamps[0]) * m_TimestampPeriod * 1e-6);
+                m_GPUTime = m_NumSamples == 0 ? gpuTime : glm::mix(m_GPUTime, gpuTime, kGPUTimeSmoothing);
+                ++m_NumSamples;
+            }
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,369 @@
+#include "vultra/function/renderer/builtin/passes/cascaded_shadow_map_pass.hpp"
+#include "vultra/core/math/math.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/framegraph/upload_struct.hpp"
+#include "vultra/function/renderer/builtin/framegraph_common.hpp"
+#include "vultra/function/renderer/builtin/resources/shadow_data.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+#include "vultra/function/renderer/vertex_format.hpp"
+
+#include <shader_headers/shadow_mapping.frag.spv.h>
+#include <shader_headers/shadow_mapping.vert.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <cmath>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "CascadedShadowMapPass";
+
+        namespace
+        {
+            struct alignas(16) GPUCascadesBlock
+            {
+                glm::vec4 splitDepths {0.0f};    // View-space far distance of each cascade
+                glm::vec4 texelSizes {0.0f};     // World-space texel size of each cascade
+                glm::mat4 viewProjections[CSM_MAX_CASCADES] {};
+                int       cascadeCount {0};
+                float     normalBias {0.0f};
+                float     padding0 {0.0f};
+                float     padding1 {0.0f};
+            };
+            static_assert(sizeof(GPUCascadesBlock) == 304, "GPUCascadesBlock unexpected size (std140 mismatch)");
+
+            struct ShadowConstants
+            {
+                glm::mat4 modelMatrix {1.0f};
+                glm::mat4 lightSpaceMatrix {1.0f};
+            };
+            static_assert(sizeof(ShadowConstants) == 128, "ShadowConstants must fit the minimum push constant size");
+
+            // Practical split scheme (Zhang et al.), blends logarithmic and uniform distributions.
+            [[nodiscard]] float calcSplitDepth(uint32_t i, uint32_t count, float zNear, float zFar, float lambda)
+            {
+                const auto p        = static_cast<float>(i) / static_cast<float>(count);
+                const auto logSplit = zNear * std::pow(zFar / zNear, p);
+                const auto uniform  = zNear + (zFar - zNear) * p;
+                return glm::mix(uniform, logSplit, lambda);
+            }
+
+            [[nodiscard]] bool isVisible(const std::array<math::Plane, 6>& planes, const AABB& aabb)
+            {
+                for (const auto& plane : planes)
+                {
+                    // Positive vertex of the box along the plane normal
+                    const glm::vec3 p {
+                        plane.normal.x >= 0.0f ? aabb.max.x : aabb.min.x,
+                        plane.normal.y >= 0.0f ? aabb.max.y : aabb.min.y,
+                        plane.normal.z >= 0.0f ? aabb.max.z : aabb.min.z,
+                    };
+                    if (plane.getDistanceToPoint(p) < 0.0f)
+                        return false;
+                }
+                return true;
+            }
+        } // namespace
+
+        CascadedShadowMapPass::CascadedShadowMapPass(rhi::RenderDevice& rd) :
+            rhi::RenderPass<CascadedShadowMapPass>(rd)
+        {}
+
+        void CascadedShadowMapPass::addPass(FrameGraph&                 fg,
+                                            FrameGraphBlackboard&       blackboard,
+                                            const CameraInfo&           cameraInfo,
+                                            const LightInfo&            lightInfo,
+                                            const RenderPrimitiveGroup& renderPrimitiveGroup,
+                                            const size_t&               geometryVersion,
+                                            const ShadowSettings&       settings,
+                                            const bool                  enabled)
+        {
+            ZoneScopedN("CascadedShadowMapPass::addPass");
+
+            // The import takes its descriptor from the current texture.
+            prepareShadowMaps(settings);
+
+            addUpdatePass(fg,
+                          "CascadedShadowMapPass Update",
+                          [this, &cameraInfo, &lightInfo, &renderPrimitiveGroup, &geometryVersion, &settings, enabled] {
+                              update(cameraInfo, lightInfo, renderPrimitiveGroup, geometryVersion, settings, enabled);
+                          });
+
+            auto shadowMaps = framegraph::importTexture(fg, "Cascaded Shadow Maps", &m_ShadowMaps);
+
+            const auto numCascades = enabled ? glm::clamp(settings.numCascades, 1u, CSM_MAX_CASCADES) : 0u;
+            for (uint32_t i = 0; i < numCascades; ++i)
+            {
+                struct CascadeData
+                {
+                    FrameGraphResource shadowMaps;
+                };
+                const auto& cascadeData = fg.addCallbackPass<CascadeData>(
+                    PASS_NAME,
+                    [shadowMaps, i](FrameGraph::Builder& builder, CascadeData& data) {
+                        PASS_SETUP_ZONE;
+
+                        data.shadowMaps = builder.write(shadowMaps,
+                                                        framegraph::Attachment {
+                                                            .imageAspect = rhi::ImageAspect::eDepth,
+                                                            .layer       = i,
+                                                            .clearValue  = framegraph::ClearValue::eOne,
+                                                        });
+                    },
+                    [this, i](const CascadeData&, FrameGraphPassResources&, void* ctx) {
+                        auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                        auto& [cb, framebufferInfo, sets, samplers] = rc;
+
+                        const auto& cascade = m_Cascades[i];
+                        if (!cascade.updated)
+                        {
+                            // Cached cascade, without a rendering scope the layer is neither cleared nor written.
+                            framebufferInfo.reset();
+                            sets.clear();
+                            return;
+                        }
+
+                        RHI_GPU_ZONE(cb, PASS_NAME);
+
+                        gfx::BaseGeometryPassInfo passInfo {
+                            .depthFormat  = rhi::getDepthFormat(*framebufferInfo),
+                            .colorFormats = {},
+                        };
+
+                        cb.beginRendering(*framebufferInfo);
+
+                        for (const auto* primitive : m_DrawLists[i])
+                        {
+                            passInfo.vertexFormat = primitive->mesh->vertexFormat.get();
+
+                            ShadowConstants shadowConstants {
+                                .modelMatrix      = primitive->modelMatrix,
+                                .lightSpaceMatrix = cascade.viewProjection,
+                            };
+                            const auto* pipeline = getPipeline(passInfo);
+
+                            cb.bindPipeline(*pipeline).pushConstants(
+                                rhi::ShaderStages::eVertex, 0, sizeof(ShadowConstants), &shadowConstants);
+
+                            rc.bindDescriptorSets(*pipeline);
+
+                            cb.draw(primitive->mesh->getGeometryInfo(primitive->renderSubMesh));
+                        }
+
+                        rc.endRendering();
+                    });
+                shadowMaps = cascadeData.shadowMaps;
+            }
+
+            ShadowData shadowData {};
+            shadowData.cascadedShadowMaps = shadowMaps;
+            shadowData.cascadesBlock      = framegraph::uploadStruct(
+                fg, "UploadCascadesBlock", "CascadesBlock", framegraph::BufferType::eUniformBuffer, [this, &settings] {
+                    GPUCascadesBlock cascadesBlock {};
+                    cascadesBlock.normalBias   = settings.normalBias;
+                    cascadesBlock.cascadeCount = static_cast<int>(m_NumActiveCascades);
+                    for (uint32_t i = 0; i < m_NumActiveCascades; ++i)
+                    {
+                        cascadesBlock.splitDepths[i]     = m_Cascades[i].splitDepth;
+                        cascadesBlock.texelSizes[i]      = m_Cascades[i].texelSize;
+                        cascadesBlock.viewProjections[i] = m_Cascades[i].viewProjection;
+                    }
+                    return cascadesBlock;
+                });
+            add(blackboard, shadowData);
+        }
+
+        void CascadedShadowMapPass::update(const CameraInfo&           cameraInfo,
+                                           const LightInfo&            lightInfo,
+                                           const RenderPrimitiveGroup& renderPrimitiveGroup,
+                                           const size_t                geometryVersion,
+                                           const ShadowSettings&       settings,
+                                           const bool                  enabled)
+        {
+            ZoneScopedN("CascadedShadowMapPass::update");
+
+            prepareShadowMaps(settings);
+
+            m_NumActiveCascades   = 0;
+            m_NumUpdatedCascades  = 0;
+            m_NumCulledPrimitives = 0;
+            for (auto& cascade : m_Cascades)
+            {
+                cascade.updated = false;
+            }
+
+            if (!enabled || lightInfo.useDirectionalLight == 0)
+                return;
+
+            const auto numCascades    = glm::clamp(settings.numCascades, 1u, CSM_MAX_CASCADES);
+            const auto lightDirection = glm::normalize(lightInfo.directionalLight.direction);
+
+            // Distant cascades are only valid for the light direction and geometry they were rendered with.
+            if (glm::dot(lightDirection, m_CachedLightDirection) < 0.99999f ||
+                geometryVersion != m_CachedGeometryVersion)
+            {
+                invalidate();
+                m_CachedLightDirection  = lightDirection;
+                m_CachedGeometryVersion = geometryVersion;
+            }
+
+            const auto lightUp = std::abs(lightDirection.y) > 0.99f ? glm::vec3 {0.0f, 0.0f, 1.0f} :
+                                                                      glm::vec3 {0.0f, 1.0f, 0.0f};
+            const auto lightView = glm::lookAt(glm::vec3 {0.0f}, lightDirection, lightUp);
+
+            const auto inversedView = glm::inverse(cameraInfo.view);
+            const auto tanHalfFovY  = 1.0f / std::abs(cameraInfo.projection[1][1]);
+            const auto aspect       = std::abs(cameraInfo.projection[1][1] / cameraInfo.projection[0][0]);
+            const auto zNear        = cameraInfo.zNear;
+            const auto zFar         = glm::max(glm::min(cameraInfo.zFar, settings.shadowDistance), zNear + 0.01f);
+            const auto resolution   = static_cast<float>(settings.resolution);
+
+            for (uint32_t i = 0; i < numCascades; ++i)
+            {
+                const auto sliceNear = calcSplitDepth(i, numCascades, zNear, zFar, settings.splitLambda);
+                const auto sliceFar  = calcSplitDepth(i + 1, numCascades, zNear, zFar, settings.splitLambda);
+                const bool isDynamic = i < settings.numDynamicCascades;
+
+                // Bounding sphere of the frustum slice, its size does not change with camera rotation.
+                glm::vec3 corners[8];
+                glm::vec3 center {0.0f};
+                for (uint32_t c = 0; c < 8; ++c)
+                {
+                    const auto d  = (c & 4) ? sliceFar : sliceNear;
+                    const auto x  = ((c & 1) ? 1.0f : -1.0f) * d * tanHalfFovY * aspect;
+                    const auto y  = ((c & 2) ? 1.0f : -1.0f) * d * tanHalfFovY;
+                    corners[c]    = glm::vec3(inversedView * glm::vec4(x, y, -d, 1.0f));
+                    center       += corners[c];
+                }
+                center /= 8.0f;
+
+                float radius = 0.0f;
+                for (const auto& corner : corners)
+                {
+                    radius = glm::max(radius, glm::length(corner - center));
+                }
+                radius = std::ceil(radius * 16.0f) / 16.0f;
+
+                // Cached cascades get a margin so that they keep covering their slice until the camera has moved
+                // cacheTexelThreshold texels away from where they were rendered.
+                if (!isDynamic)
+                {
+                    radius *= 1.0f + 2.0f * static_cast<float>(settings.cacheTexelThreshold) / resolution;
+                }
+                const auto texelSize = 2.0f * radius / resolution;
+
+                // Snap to whole texels in light space to avoid shimmering.
+                auto lightSpaceCenter = glm::vec3(lightView * glm::vec4(center, 1.0f));
+                lightSpaceCenter.x    = std::floor(lightSpaceCenter.x / texelSize) * texelSize;
+                lightSpaceCenter.y    = std::floor(lightSpaceCenter.y / texelSize) * texelSize;
+
+                auto& cascade = m_Cascades[i];
+
+                const bool needsUpdate =
+                    isDynamic || !cascade.valid || cascade.radius != radius ||
+                    glm::length(lightSpaceCenter - cascade.lightSpaceCenter) >
+                        static_cast<float>(settings.cacheTexelThreshold) * texelSize;
+
+                cascade.splitDepth = sliceFar;
+
+                if (needsUpdate)
+                {
+                    // Casters between the light and the slice must not be clipped, pull the near plane back.
+                    const auto projection = glm::orthoRH_ZO(lightSpaceCenter.x - radius,
+                                                            lightSpaceCenter.x + radius,
+                                                            lightSpaceCenter.y - radius,
+                                                            lightSpaceCenter.y + radius,
+                                                            -lightSpaceCenter.z - radius * 3.0f,
+                                                            -lightSpaceCenter.z + radius);
+
+                    cascade.viewProjection   = projection * lightView;
+                    cascade.lightSpaceCenter = lightSpaceCenter;
+                    cascade.radius           = radius;
+                    cascade.texelSize        = texelSize;
+                    cascade.valid            = true;
+
+                    // Per-cascade CPU culling
+                    auto& drawList = m_DrawLists[i];
+                    drawList.clear();
+
+                    const auto planes = math::extractFrustumPlanes(cascade.viewProjection);
+                    for (const auto& primitive : renderPrimitiveGroup.opaquePrimitives)
+                    {
+                        if (isVisible(planes, primitive.renderSubMesh.aabb.transform(primitive.modelMatrix)))
+                        {
+                            drawList.push_back(&primitive);
+                        }
+                        else
+                        {
+                            ++m_NumCulledPrimitives;
+                        }
+                    }
+
+                    cascade.updated = true;
+                    ++m_NumUpdatedCascades;
+                }
+            }
+
+            m_NumActiveCascades = numCascades;
+        }
+
+        void CascadedShadowMapPass::invalidate()
+        {
+            for (auto& cascade : m_Cascades)
+            {
+                cascade.valid = false;
+            }
+        }
+
+        rhi::GraphicsPipeline CascadedShadowMapPass::createPipeline(const gfx::BaseGeometryPassInfo& passInfo) const
+        {
+            return rhi::GraphicsPipeline::Builder {}
+                .setDepthFormat(passInfo.depthFormat)
+                .setColorFormats({})
+                .setInputAssembly(passInfo.vertexFormat->getAttributes())
+                .setTopology(passInfo.topology)
+                .addBuiltinShader(rhi::ShaderType::eVertex, shadow_mapping_vert_spv)
+                .addBuiltinShader(rhi::ShaderType::eFragment, shadow_mapping_frag_spv)
+                .setDepthStencil({
+                    .depthTest      = true,
+                    .depthWrite     = true,
+                    .depthCompareOp = rhi::CompareOp::eLessOrEqual,
+                })
+                .setDepthBias({.constantFactor = 1.25f, .slopeFactor = 1.75f})
+                .setRasterizer({.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eNone})
+                .build(getRenderDevice());
+        }
+
+        void CascadedShadowMapPass::prepareShadowMaps(const ShadowSettings& settings)
+        {
+            const auto extent    = rhi::Extent2D {settings.resolution, settings.resolution};
+            const auto numLayers = glm::clamp(settings.numCascades, 1u, CSM_MAX_CASCADES);
+
+            if (m_ShadowMaps && m_ShadowMaps->getExtent() == extent && m_ShadowMaps->getNumLayers() == numLayers)
+                return;
+
+            if (m_ShadowMaps)
+            {
+                // Might still be sampled by the frames in flight.
+                getRenderDevice().getDeletionQueue().push(std::move(m_ShadowMaps));
+            }
+            m_ShadowMaps = createRef<rhi::Texture>(
+                rhi::Texture::Builder {}
+                    .setExtent(extent)
+                    .setPixelFormat(rhi::PixelFormat::eDepth32F)
+                    .setNumMipLevels(1)
+                    .setNumLayers(numLayers)
+                    .setUsageFlags(rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled)
+                    .build(getRenderDevice()));
+            invalidate();
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -25,7 +25,7 @@ namespace vultra
 
         void DebugDrawPass::addPass(FrameGraph&           fg,
                                     FrameGraphBlackboard& blackboard,
-                                    const fsec            dt,
+                                    const fsec            /*dt*/,
                                     const glm::mat4&      viewProjectionMatrix)
         {
             const auto gBuffer = blackboard.get<GBufferData>();
@@ -66,7 +66,7 @@ namespace vultra
                                                        .clearValue  = framegraph::ClearValue::eTransparentBlack,
                                                    });
                 },
-                [this, dt, &viewProjectionMatrix](const auto&, FrameGraphPassResources& /*resources*/, void* ctx) {
+                [this, &viewProjectionMatrix](const auto&, FrameGraphPassResources& /*resources*/, void* ctx) {
                     auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
                     auto& [cb, framebufferInfo, sets, samplers] = rc;
 
@@ -9,6 +9,7 @@
 #include "vultra/function/renderer/builtin/resources/ibl_data.hpp"
 #include "vultra/function/renderer/builtin/resources/light_data.hpp"
 #include "vultra/function/renderer/builtin/resources/scene_color_data.hpp"
+#include "vultra/function/renderer/builtin/resources/shadow_data.hpp"
 #include "vultra/function/renderer/renderer_render_context.hpp"
 #include "vultra/function/resource/raw_resource_loader.hpp"
 
@@ -65,12 +66,21 @@ namespace vultra
                 enableAreaLight = false;
             }
 
-            const auto& iblData = blackboard.get<IBLData>();
+            const auto& iblData    = blackboard.get<IBLData>();
+            const auto  shadowData = blackboard.get<ShadowData>();
 
             const auto& sceneColorData = fg.addCallbackPass<SceneColorData>(
                 PASS_NAME,
-                [this, &blackboard, &fg, extent, gBuffer, depthResource, enableAreaLight, enableIBL, iblData](
-                    FrameGraph::Builder& builder, SceneColorData& data) {
+                [this,
+                 &blackboard,
+                 &fg,
+                 extent,
+                 gBuffer,
+                 depthResource,
+                 enableAreaLight,
+                 enableIBL,
+                 iblData,
+                 shadowData](FrameGraph::Builder& builder, SceneColorData& data) {
                     PASS_SETUP_ZONE;
 
                     read(builder, blackboard.get<CameraData>());
@@ -194,6 +204,57 @@ namespace vultra
                                      .imageAspect = rhi::ImageAspect::eColor,
                                  });
 
+                    // Cascaded shadow maps
+                    builder.read(shadowData.cascadesBlock,
+                                 framegraph::BindingInfo {
+                                     .location      = {.set = 1, .binding = 2},
+                                     .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                 });
+                    builder.read(shadowData.cascadedShadowMaps,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 10},
+                                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = rhi::ImageAspect::eDepth,
+                                 });
+
+                    // Point light shadow atlas
+                    builder.read(shadowData.pointShadowBlock,
+                                 framegraph::BindingInfo {
+                                     .location      = {.set = 1, .binding = 3},
+                                     .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                 });
+                    builder.read(shadowData.pointShadowMaps,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 11},
+                                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = rhi::ImageAspect::eDepth,
+                                 });
+
+                    // Ray traced shadow mask (white when ray traced shadows are inactive)
+                    builder.read(shadowData.rayTracedShadowBlock,
+                                 framegraph::BindingInfo {
+                                     .location      = {.set = 1, .binding = 4},
+                                     .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                 });
+                    builder.read(shadowData.rayTracedShadowMask,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 12},
+                                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = rhi::ImageAspect::eColor,
+                                 });
+
                     // HDR color output
                     data.hdr = builder.create<framegraph::FrameGraphTexture>(
                         "SceneColor - HDR",
@@ -245,18 +306,21 @@ namespace vultra
                     {
                         cb.bindPipeline(*pipeline);
                         assert(samplers.count("point") > 0);
-                        // assert(samplers.count("shadow_map") > 0);
+                        assert(samplers.count("shadow_map") > 0);
                         assert(samplers.count("bilinear") > 0);
-                        rc.overrideSampler(sets[3][0], samplers["point"]);    // Albedo
-                        rc.overrideSampler(sets[3][1], samplers["point"]);    // Normal
-                        rc.overrideSampler(sets[3][2], samplers["point"]);    // Emissive
-                        rc.overrideSampler(sets[3][3], samplers["point"]);    // MetallicRoughnessAO
-                        rc.overrideSampler(sets[3][4], samplers["point"]);    // Depth
-                        rc.overrideSampler(sets[3][5], samplers["bilinear"]); // LTCMat
-                        rc.overrideSampler(sets[3][6], samplers["bilinear"]); // LTCMag
-                        rc.overrideSampler(sets[3][7], samplers["bilinear"]); // BRDF LUT
-                        rc.overrideSampler(sets[3][8], samplers["bilinear"]); // Irradiance map
-                        rc.overrideSampler(sets[3][9], samplers["bilinear"]); // Prefiltered env map
+                        rc.overrideSampler(sets[3][0], samplers["point"]);       // Albedo
+                        rc.overrideSampler(sets[3][1], samplers["point"]);       // Normal
+                        rc.overrideSampler(sets[3][2], samplers["point"]);       // Emissive
+                        rc.overrideSampler(sets[3][3], samplers["point"]);       // MetallicRoughnessAO
+                        rc.overrideSampler(sets[3][4], samplers["point"]);       // Depth
+                        rc.overrideSampler(sets[3][5], samplers["bilinear"]);    // LTCMat
+                        rc.overrideSampler(sets[3][6], samplers["bilinear"]);    // LTCMag
+                        rc.overrideSampler(sets[3][7], samplers["bilinear"]);    // BRDF LUT
+                        rc.overrideSampler(sets[3][8], samplers["bilinear"]);    // Irradiance map
+                        rc.overrideSampler(sets[3][9], samplers["bilinear"]);    // Prefiltered env map
+                        rc.overrideSampler(sets[3][10], samplers["shadow_map"]); // Cascaded shadow maps
+                        rc.overrideSampler(sets[3][11], samplers["shadow_map"]); // Point shadow maps
+                        rc.overrideSampler(sets[3][12], samplers["point"]);      // Ray traced shadow mask
                         cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
                         rc.bindDescriptorSets(*pipeline);
                         cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
@@ -12,10 +12,13 @@
 
 #include <shader_headers/depth_pre.frag.spv.h>
 #include <shader_headers/geometry.vert.spv.h>
+#include <shader_headers/geometry_multiview.vert.spv.h>
 
 #include <fg/Blackboard.hpp>
 #include <fg/FrameGraph.hpp>
 
+#include <bit>
+
 namespace vultra
 {
     namespace gfx
@@ -27,11 +30,12 @@ namespace vultra
         void DepthPrePass::addPass(FrameGraph&                 fg,
                                    FrameGraphBlackboard&       blackboard,
                                    const rhi::Extent2D&        resolution,
-                                   const RenderPrimitiveGroup& renderPrimitiveGroup)
+                                   const RenderPrimitiveGroup& renderPrimitiveGroup,
+                                   uint32_t                    viewMask)
         {
             const auto& depthPreData = fg.addCallbackPass<DepthPreData>(
                 PASS_NAME,
-                [this, &fg, &blackboard, resolution](FrameGraph::Builder& builder, DepthPreData& data) {
+                [this, &fg, &blackboard, resolution, viewMask](FrameGraph::Builder& builder, DepthPreData& data) {
                     PASS_SETUP_ZONE;
 
                     read(builder, blackboard.get<CameraData>());
@@ -42,6 +46,7 @@ namespace vultra
                         {
                             .extent     = resolution,
                             .format     = rhi::PixelFormat::eDepth32F,
+                            .layers     = viewMask ? static_cast<uint32_t>(std::bit_width(viewMask)) : 0u,
                             .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled |
                                           rhi::ImageUsage::eTransferSrc,
                         });
@@ -51,7 +56,7 @@ namespace vultra
                                                    .clearValue  = framegraph::ClearValue::eOne,
                                                });
                 },
-                [this, &renderPrimitiveGroup](const DepthPreData&, auto&, void* ctx) {
+                [this, &renderPrimitiveGroup, viewMask](const DepthPreData&, auto&, void* ctx) {
                     auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
                     auto& [cb, framebufferInfo, sets, samplers] = rc;
                     RHI_GPU_ZONE(cb, PASS_NAME);
@@ -59,8 +64,10 @@ namespace vultra
                     gfx::BaseGeometryPassInfo passInfo {
                         .depthFormat  = rhi::getDepthFormat(*framebufferInfo),
                         .colorFormats = rhi::getColorFormats(*framebufferInfo),
+                        .viewMask     = viewMask,
                     };
 
+                    framebufferInfo->viewMask = viewMask;
                     cb.beginRendering(*framebufferInfo);
 
                     const auto& [opaquePrimitives, _, __] = renderPrimitiveGroup;
@@ -77,14 +84,7 @@ namespace vultra
 
                         rc.bindDescriptorSets(*pipeline);
 
-                        cb.draw({
-                            .vertexBuffer = primitive.mesh->vertexBuffer.get(),
-                            .vertexOffset = primitive.renderSubMesh.vertexOffset,
-                            .numVertices  = primitive.renderSubMesh.vertexCount,
-                            .indexBuffer  = primitive.mesh->indexBuffer.get(),
-                            .indexOffset  = primitive.renderSubMesh.indexOffset,
-                            .numIndices   = primitive.renderSubMesh.indexCount,
-                        });
+                        cb.draw(primitive.mesh->getGeometryInfo(primitive.renderSubMesh));
                     }
 
                     rc.endRendering();
@@ -101,7 +101,9 @@ namespace vultra
                 .setColorFormats(passInfo.colorFormats)
                 .setInputAssembly(passInfo.vertexFormat->getAttributes())
                 .setTopology(passInfo.topology)
-                .addBuiltinShader(rhi::ShaderType::eVertex, geometry_vert_spv)
+                .setViewMask(passInfo.viewMask)
+                .addBuiltinShader(rhi::ShaderType::eVertex,
+                                  passInfo.viewMask ? geometry_multiview_vert_spv : geometry_vert_spv)
                 .addBuiltinShader(rhi::ShaderType::eFragment, depth_pre_frag_spv)
                 .setDepthStencil({
                     .depthTest      = true,
@@ -0,0 +1,125 @@
+#include "vultra/function/renderer/builtin/passes/foveated_composite_pass.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/framegraph_resource_access.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/renderer/builtin/post_process_helper.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/foveated_composite.frag.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "Foveated Composite Pass";
+
+        namespace
+        {
+            [[nodiscard]] framegraph::TextureRead makeTextureRead(const uint32_t binding)
+            {
+                return framegraph::TextureRead {
+                    .binding =
+                        {
+                            .location      = {.set = 3, .binding = binding},
+                            .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                        },
+                    .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                    .imageAspect = rhi::ImageAspect::eColor,
+                };
+            }
+        } // namespace
+
+        FoveatedCompositePass::FoveatedCompositePass(rhi::RenderDevice& rd) :
+            rhi::RenderPass<FoveatedCompositePass>(rd)
+        {}
+
+        void FoveatedCompositePass::prepareTargets(const rhi::Extent2D& peripheryExtent,
+                                                   const rhi::Extent2D& insetExtent,
+                                                   const rhi::PixelFormat format)
+        {
+            const auto prepare = [this, format](Ref<rhi::Texture>& texture, const rhi::Extent2D& extent) {
+                if (texture && texture->getExtent() == extent && texture->getPixelFormat() == format)
+                    return;
+
+                if (texture)
+                {
+                    // Might still be sampled by the frames in flight.
+                    getRenderDevice().getDeletionQueue().push(std::move(texture));
+                }
+                texture = createRef<rhi::Texture>(
+                    rhi::Texture::Builder {}
+                        .setExtent(extent)
+                        .setPixelFormat(format)
+                        .setNumMipLevels(1)
+                        .setUsageFlags(rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled)
+                        .build(getRenderDevice()));
+            };
+
+            prepare(m_Periphery, peripheryExtent);
+            prepare(m_Inset, insetExtent);
+        }
+
+        void FoveatedCompositePass::compose(FrameGraph&        fg,
+                                            FrameGraphResource target,
+                                            const glm::vec4&   insetRect,
+                                            const float&       feather)
+        {
+            assert(m_Periphery && m_Inset);
+
+            const auto periphery = framegraph::importTexture(fg, "Foveated Periphery", &m_Periphery);
+            const auto inset     = framegraph::importTexture(fg, "Foveated Inset", &m_Inset);
+
+            fg.addCallbackPass(
+                PASS_NAME,
+                [periphery, inset, &target](FrameGraph::Builder& builder, auto&) {
+                    PASS_SETUP_ZONE;
+
+                    builder.read(periphery, makeTextureRead(0));
+                    builder.read(inset, makeTextureRead(1));
+
+                    target = builder.write(target,
+                                           framegraph::Attachment {
+                                               .index       = 0,
+                                               .imageAspect = rhi::ImageAspect::eColor,
+                                           });
+                },
+                [this, target, &insetRect, &feather](const auto&, FrameGraphPassResources& resources, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+
+                    RHI_GPU_ZONE(cb, PASS_NAME);
+
+                    struct PushConstants
+                    {
+                        glm::vec4 insetRect;
+                        float     feather;
+                    } pushConstants {insetRect, feather};
+
+                    const auto* pipeline = getPipeline(rhi::getColorFormat(*framebufferInfo, 0));
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline).pushConstants(
+                            rhi::ShaderStages::eFragment, 0, sizeof(PushConstants), &pushConstants);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["bilinear"]);
+                        rc.overrideSampler(sets[3][1], samplers["bilinear"]);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                    auto* targetTexture = resources.get<framegraph::FrameGraphTexture>(target).texture;
+                    rhi::prepareForReading(cb, *targetTexture);
+                });
+        }
+
+        rhi::GraphicsPipeline FoveatedCompositePass::createPipeline(const rhi::PixelFormat colorFormat) const
+        {
+            return createPostProcessPipelineFromSPV(getRenderDevice(), colorFormat, foveated_composite_frag_spv);
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -102,6 +102,7 @@ namespace vultra
                     .cullMode    = rhi::CullMode::eFront,
                 })
                 .setBlending(0, {.enabled = false})
+                .setPushDescriptorSet(3)
                 .build(getRenderDevice());
         }
     } // namespace gfx
@@ -9,6 +9,7 @@
 #include "vultra/function/renderer/builtin/resources/gbuffer_data.hpp"
 #include "vultra/function/renderer/builtin/resources/light_data.hpp"
 #include "vultra/function/renderer/builtin/upload_resources.hpp"
+#include "vultra/function/renderer/parallel_command_recorder.hpp"
 #include "vultra/function/renderer/renderer_render_context.hpp"
 #include "vultra/function/renderer/vertex_format.hpp"
 
@@ -19,16 +20,56 @@
 #include <shader_headers/gbuffer_alpha_masking.frag.spv.h>
 #include <shader_headers/gbuffer_earlyz.frag.spv.h>
 #include <shader_headers/geometry.vert.spv.h>
+#include <shader_headers/geometry_multiview.vert.spv.h>
 
 #include <fg/Blackboard.hpp>
 #include <fg/FrameGraph.hpp>
 
+#include <algorithm>
+#include <bit>
+
 namespace vultra
 {
     namespace gfx
     {
         constexpr auto PASS_NAME = "GBufferPass";
 
+        namespace
+        {
+            // Below that many draws per thread, a secondary command buffer costs more than it saves.
+            constexpr auto kMinDrawsPerTask = 64u;
+
+            void drawPrimitive(gfx::RendererRenderContext&             rc,
+                               const rhi::GraphicsPipeline&            pipeline,
+                               const RenderPrimitive&                  primitive,
+                               uint32_t                                enableNormalMapping,
+                               const std::vector<const rhi::Texture*>& textures)
+            {
+                auto& cb = rc.commandBuffer;
+
+                MeshConstants meshConstants(
+                    primitive.modelMatrix, primitive.renderSubMesh.materialIndex, enableNormalMapping);
+
+                cb.bindPipeline(pipeline).pushConstants(rhi::ShaderStages::eVertex | rhi::ShaderStages::eFragment,
+                                                        0,
+                                                        sizeof(MeshConstants),
+                                                        &meshConstants);
+
+                rc.resourceSet[3][0] = rhi::bindings::StorageBuffer {
+                     .buffer = primitive.mesh->materialBuffer.get(),
+                };
+
+                rc.resourceSet[3][1] = rhi::bindings::CombinedImageSamplerArray {
+                     .textures    = textures,
+                     .imageAspect = rhi::ImageAspect::eColor,
+                };
+
+                rc.bindDescriptorSets(pipeline);
+
+                cb.draw(primitive.mesh->getGeometryInfo(primitive.renderSubMesh));
+            }
+        } // namespace
+
         GBufferPass::GBufferPass(rhi::RenderDevice& rd) : rhi::RenderPass<GBufferPass>(rd) {}
 
         void GBufferPass::addPass(FrameGraph&                 fg,
@@ -36,13 +77,16 @@ namespace vultra
                                   const rhi::Extent2D&        resolution,
                                   const RenderPrimitiveGroup& renderPrimitiveGroup,
                                   bool                        enableAreaLight,
-                                  bool                        enableNormalMapping)
+                                  bool                        enableNormalMapping,
+                                  uint32_t                    viewMask,
+                                  ParallelCommandRecorder*    recorder)
         {
+            const auto  layers       = viewMask ? static_cast<uint32_t>(std::bit_width(viewMask)) : 0u;
             auto&       depthPreData = blackboard.get<DepthPreData>();
             const auto& gBufferData  = fg.addCallbackPass<GBufferData>(
                 PASS_NAME,
-                [this, &fg, &blackboard, &depthPreData, resolution, enableAreaLight](FrameGraph::Builder& builder,
-                                                                                     GBufferData&         data) {
+                [this, &fg, &blackboard, &depthPreData, resolution, layers](FrameGraph::Builder& builder,
+                                                                            GBufferData&         data) {
                     PASS_SETUP_ZONE;
 
                     read(builder, blackboard.get<CameraData>());
@@ -58,6 +102,7 @@ namespace vultra
                         {
                              .extent     = resolution,
                              .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                             .layers     = layers,
                              .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
                         });
                     data.albedo = builder.write(data.albedo,
@@ -72,6 +117,7 @@ namespace vultra
                         {
                              .extent     = resolution,
                              .format     = rhi::PixelFormat::eRGBA16F,
+                             .layers     = layers,
                              .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
                         });
                     data.normal = builder.write(data.normal,
@@ -86,6 +132,7 @@ namespace vultra
                         {
                              .extent     = resolution,
                              .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                             .layers     = layers,
                              .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
                         });
                     data.emissive = builder.write(data.emissive,
@@ -100,6 +147,7 @@ namespace vultra
                         {
                              .extent     = resolution,
                              .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                             .layers     = layers,
                              .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
                         });
                     data.metallicRoughnessAO = builder.write(data.metallicRoughnessAO,
@@ -114,6 +162,7 @@ namespace vultra
                         {
                              .extent     = resolution,
                              .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                             .layers     = layers,
                              .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
                         });
                     data.textureLodDebug = builder.write(data.textureLodDebug,
@@ -123,7 +172,7 @@ namespace vultra
                                                               .clearValue  = framegraph::ClearValue::eOpaqueBlack,
                                                          });
                 },
-                [this, &renderPrimitiveGroup, enableAreaLight, enableNormalMapping](
+                [this, &renderPrimitiveGroup, enableAreaLight, enableNormalMapping, viewMask, recorder](
                     const GBufferData&, auto&, void* ctx) {
                     auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
                     auto& [cb, framebufferInfo, sets, samplers] = rc;
@@ -132,184 +181,98 @@ namespace vultra
                     gfx::BaseGeometryPassInfo passInfo {
                          .depthFormat  = rhi::getDepthFormat(*framebufferInfo),
                          .colorFormats = rhi::getColorFormats(*framebufferInfo),
+                         .viewMask     = viewMask,
                     };
                     uint32_t meshEnableNormalMapping = enableNormalMapping ? 1 : 0;
 
-                    cb.beginRendering(*framebufferInfo);
+                    framebufferInfo->viewMask = viewMask;
 
                     const auto& [opaquePrimitives, alphaMaskingPrimitives, decalPrimitives] = renderPrimitiveGroup;
 
-                    // Phase 1: Draw opaque renderables
+                    // New permutations are compiled in the background. Until then a primitive is drawn with the
+                    // generic pipeline of its kind (double sided, no early-z), or skipped if that one is not ready
+                    // either.
+                    auto resolvePipeline = [this, &passInfo](bool doubleSided, bool alphaMasking, bool earlyZ) {
+                        if (auto* pipeline = getPipelineAsync(passInfo, doubleSided, alphaMasking, earlyZ))
+                            return pipeline;
+                        return getPipelineAsync(passInfo, true, alphaMasking, false);
+                    };
+
+                    // Phase 1 (opaque renderables) and 2 (alpha masking renderables), the pipelines are resolved
+                    // up front so that the draws can be recorded on any thread.
+                    std::vector<std::pair<const RenderPrimitive*, const rhi::GraphicsPipeline*>> draws;
+                    draws.reserve(opaquePrimitives.size() + alphaMaskingPrimitives.size());
                     for (const auto& primitive : opaquePrimitives)
                     {
                         passInfo.vertexFormat = primitive.mesh->vertexFormat.get();
 
-                        const auto&   material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
-                        MeshConstants meshConstants(
-                            primitive.modelMatrix, primitive.renderSubMesh.materialIndex, meshEnableNormalMapping);
-
+                        const auto& material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
                         // Enable earlyZ for opaque objects
-                        const auto* pipeline = getPipeline(passInfo, material.doubleSided, false, true);
-
-                        cb.bindPipeline(*pipeline).pushConstants(rhi::ShaderStages::eVertex |
-                                                                     rhi::ShaderStages::eFragment,
-                                                                 0,
-                                                                 sizeof(MeshConstants),
-                                                                 &meshConstants);
-
-                        rc.resourceSet[3][0] = rhi::bindings::StorageBuffer {
-                             .buffer = primitive.mesh->materialBuffer.get(),
-                        };
-
-                        rc.resourceSet[3][1] = rhi::bindings::CombinedImageSamplerArray {
-                             .textures    = getRenderDevice().getAllLoadedTextures(),
-                             .imageAspect = rhi::ImageAspect::eColor,
-                        };
-
-                        rc.bindDescriptorSets(*pipeline);
-
-                        cb.draw({
-                             .vertexBuffer = primitive.mesh->vertexBuffer.get(),
-                             .vertexOffset = primitive.renderSubMesh.vertexOffset,
-                             .numVertices  = primitive.renderSubMesh.vertexCount,
-                             .indexBuffer  = primitive.mesh->indexBuffer.get(),
-                             .indexOffset  = primitive.renderSubMesh.indexOffset,
-                             .numIndices   = primitive.renderSubMesh.indexCount,
-                        });
+                        if (const auto* pipeline = resolvePipeline(material.doubleSided, false, true))
+                            draws.emplace_back(&primitive, pipeline);
                     }
-
-                    // Phase 2: Draw alpha masking renderables
-                    rc.resourceSet.erase(3);
                     for (const auto& primitive : alphaMaskingPrimitives)
                     {
                         passInfo.vertexFormat = primitive.mesh->vertexFormat.get();
 
-                        const auto&   material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
-                        MeshConstants meshConstants(
-                            primitive.modelMatrix, primitive.renderSubMesh.materialIndex, meshEnableNormalMapping);
-
-                        const auto* pipeline = getPipeline(passInfo, material.doubleSided, true);
-
-                        cb.bindPipeline(*pipeline).pushConstants(rhi::ShaderStages::eVertex |
-                                                                     rhi::ShaderStages::eFragment,
-                                                                 0,
-                                                                 sizeof(MeshConstants),
-                                                                 &meshConstants);
-
-                        rc.resourceSet[3][0] = rhi::bindings::StorageBuffer {
-                             .buffer = primitive.mesh->materialBuffer.get(),
-                        };
-                        rc.resourceSet[3][1] = rhi::bindings::CombinedImageSamplerArray {
-                             .textures    = getRenderDevice().getAllLoadedTextures(),
-                             .imageAspect = rhi::ImageAspect::eColor,
-                        };
-
-                        rc.bindDescriptorSets(*pipeline);
-
-                        cb.draw({
-                             .vertexBuffer = primitive.mesh->vertexBuffer.get(),
-                             .vertexOffset = primitive.renderSubMesh.vertexOffset,
-                             .numVertices  = primitive.renderSubMesh.vertexCount,
-                             .indexBuffer  = primitive.mesh->indexBuffer.get(),
-                             .indexOffset  = primitive.renderSubMesh.indexOffset,
-                             .numIndices   = primitive.renderSubMesh.indexCount,
-                        });
+                        const auto& material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
+                        if (const auto* pipeline = resolvePipeline(material.doubleSided, true, false))
+                            draws.emplace_back(&primitive, pipeline);
                     }
+                    const auto textures = getRenderDevice().getAllLoadedTextures();
 
-                    // (Optional) Phase 3: Draw area lights if enabled
-                    if (enableAreaLight)
+                    const auto numTasks =
+                        recorder ? std::min(recorder->getNumThreads(),
+                                            static_cast<uint32_t>(draws.size() / kMinDrawsPerTask)) :
+                                   0u;
+                    if (numTasks > 1)
                     {
-                        if (!m_AreaLightDebugCreated)
+                        // Contiguous chunks, the draw order is the same as in the serial path.
+                        auto commandBuffers = recorder->record(
+                            *framebufferInfo, numTasks, [&](const uint32_t taskIndex, rhi::CommandBuffer& secondary) {
+                                gfx::RendererRenderContext taskRc {secondary, rc.samplers};
+                                taskRc.resourceSet = rc.resourceSet;
+
+                                const auto first = draws.size() * taskIndex / numTasks;
+                                const auto last  = draws.size() * (taskIndex + 1) / numTasks;
+                                for (auto i = first; i < last; ++i)
+                                {
+                                    const auto& [primitive, pipeline] = draws[i];
+                                    drawPrimitive(taskRc, *pipeline, *primitive, meshEnableNormalMapping, textures);
+                                }
+                            });
+
+                        // Area lights and decals have no multiview pipelines.
+                        if (viewMask == 0)
                         {
-                            auto builder = rhi::GraphicsPipeline::Builder {};
-                            builder.setDepthFormat(passInfo.depthFormat)
-                                .setColorFormats(passInfo.colorFormats)
-                                .setInputAssembly({})
-                                .setTopology(passInfo.topology)
-                                .addBuiltinShader(rhi::ShaderType::eVertex, area_light_debug_vert_spv)
-                                .addBuiltinShader(rhi::ShaderType::eFragment, area_light_debug_frag_spv)
-                                .setDepthStencil({.depthTest      = true,
-                                                   .depthWrite     = true,
-                                                   .depthCompareOp = rhi::CompareOp::eLessOrEqual})
-                                .setRasterizer(
-                                    {.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eNone});
-
-                            for (auto i = 0; i < passInfo.colorFormats.size(); ++i)
-                            {
-                                builder.setBlending(i, {.enabled = false});
-                            }
-
-                            m_AreaLightDebugPipeline = builder.build(getRenderDevice());
-                            m_AreaLightDebugCreated  = true;
+                            auto&                      secondary = recorder->acquire(*framebufferInfo);
+                            gfx::RendererRenderContext overlayRc {secondary, samplers};
+                            overlayRc.resourceSet = sets;
+                            drawOverlays(overlayRc,
+                                         passInfo,
+                                         decalPrimitives,
+                                         enableAreaLight,
+                                         meshEnableNormalMapping,
+                                         textures);
+                            secondary.end();
+                            commandBuffers.push_back(&secondary);
                         }
 
-                        rc.resourceSet.erase(3);
-
-                        cb.bindPipeline(m_AreaLightDebugPipeline);
-                        rc.bindDescriptorSets(m_AreaLightDebugPipeline);
-                        rhi::GeometryInfo gi {.numVertices = 6 * LIGHTINFO_MAX_AREA_LIGHTS};
-                        cb.draw(gi);
+                        cb.beginRendering(*framebufferInfo, true).executeCommands(commandBuffers);
+                        rc.endRendering();
+                        return;
                     }
 
-                    // Phase 4: Draw decal renderables
-                    rc.resourceSet.erase(3);
-                    for (const auto& primitive : decalPrimitives)
+                    cb.beginRendering(*framebufferInfo);
+                    for (const auto& [primitive, pipeline] : draws)
                     {
-                        passInfo.vertexFormat = primitive.mesh->vertexFormat.get();
-
-                        const auto&   material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
-                        MeshConstants meshConstants(
-                            primitive.modelMatrix, primitive.renderSubMesh.materialIndex, meshEnableNormalMapping);
-                        if (!m_DecalPipelineCreated)
-                        {
-                            auto builder = rhi::GraphicsPipeline::Builder {};
-                            builder.setDepthFormat(passInfo.depthFormat)
-                                .setColorFormats(passInfo.colorFormats)
-                                .setInputAssembly(passInfo.vertexFormat->getAttributes())
-                                .setTopology(passInfo.topology)
-                                .addBuiltinShader(rhi::ShaderType::eVertex, geometry_vert_spv)
-                                .addBuiltinShader(rhi::ShaderType::eFragment, decal_frag_spv)
-                                .setDepthStencil({
-                                     .depthTest      = true,
-                                     .depthWrite     = false,
-                                     .depthCompareOp = rhi::CompareOp::eLessOrEqual,
-                                })
-                                .setDepthBias({.constantFactor = 1.25f, .slopeFactor = 1.75f})
-                                .setRasterizer(
-                                    {.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eBack});
-                            for (auto i = 0; i < passInfo.colorFormats.size(); ++i)
-                            {
-                                builder.setBlending(i, material.blendState);
-                            }
-                            m_DecalPipeline        = builder.build(getRenderDevice());
-                            m_DecalPipelineCreated = true;
-                        }
+                        drawPrimitive(rc, *pipeline, *primitive, meshEnableNormalMapping, textures);
+                    }
 
-                        cb.bindPipeline(m_DecalPipeline)
-                            .pushConstants(rhi::ShaderStages::eVertex | rhi::ShaderStages::eFragment,
-                                           0,
-                                           sizeof(MeshConstants),
-                                           &meshConstants);
-
-                        rc.resourceSet[3][0] = rhi::bindings::StorageBuffer {
-                             .buffer = primitive.mesh->materialBuffer.get(),
-                        };
-
-                        rc.resourceSet[3][1] = rhi::bindings::CombinedImageSamplerArray {
-                             .textures    = getRenderDevice().getAllLoadedTextures(),
-                             .imageAspect = rhi::ImageAspect::eColor,
-                        };
-
-                        rc.bindDescriptorSets(m_DecalPipeline);
-
-                        cb.draw({
-                             .vertexBuffer = primitive.mesh->vertexBuffer.get(),
-                             .vertexOffset = primitive.renderSubMesh.vertexOffset,
-                             .numVertices  = primitive.renderSubMesh.vertexCount,
-                             .indexBuffer  = primitive.mesh->indexBuffer.get(),
-                             .indexOffset  = primitive.renderSubMesh.indexOffset,
-                             .numIndices   = primitive.renderSubMesh.indexCount,
-                        });
+                    // Area lights and decals have no multiview pipelines.
+                    if (viewMask == 0)
+                    {
+                        drawOverlays(rc, passInfo, decalPrimitives, enableAreaLight, meshEnableNormalMapping, textures);
                     }
 
                     rc.endRendering();
@@ -318,6 +281,83 @@ namespace vultra
             add(blackboard, gBufferData);
         }
 
+        void GBufferPass::drawOverlays(gfx::RendererRenderContext&             rc,
+                                       gfx::BaseGeometryPassInfo&              passInfo,
+                                       const std::vector<RenderPrimitive>&     decalPrimitives,
+                                       bool                                    enableAreaLight,
+                                       uint32_t                                enableNormalMapping,
+                                       const std::vector<const rhi::Texture*>& textures)
+        {
+            auto& cb = rc.commandBuffer;
+
+            // (Optional) Phase 3: Draw area lights if enabled
+            if (enableAreaLight)
+            {
+                if (!m_AreaLightDebugCreated)
+                {
+                    auto builder = rhi::GraphicsPipeline::Builder {};
+                    builder.setDepthFormat(passInfo.depthFormat)
+                        .setColorFormats(passInfo.colorFormats)
+                        .setInputAssembly({})
+                        .setTopology(passInfo.topology)
+                        .addBuiltinShader(rhi::ShaderType::eVertex, area_light_debug_vert_spv)
+                        .addBuiltinShader(rhi::ShaderType::eFragment, area_light_debug_frag_spv)
+                        .setDepthStencil(
+                            {.depthTest = true, .depthWrite = true, .depthCompareOp = rhi::CompareOp::eLessOrEqual})
+                        .setRasterizer({.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eNone});
+
+                    for (auto i = 0; i < passInfo.colorFormats.size(); ++i)
+                    {
+                        builder.setBlending(i, {.enabled = false});
+                    }
+
+                    m_AreaLightDebugPipeline = builder.build(getRenderDevice());
+                    m_AreaLightDebugCreated  = true;
+                }
+
+                rc.resourceSet.erase(3);
+
+                cb.bindPipeline(m_AreaLightDebugPipeline);
+                rc.bindDescriptorSets(m_AreaLightDebugPipeline);
+                rhi::GeometryInfo gi {.numVertices = 6 * LIGHTINFO_MAX_AREA_LIGHTS};
+                cb.draw(gi);
+            }
+
+            // Phase 4: Draw decal renderables
+            rc.resourceSet.erase(3);
+            for (const auto& primitive : decalPrimitives)
+            {
+                passInfo.vertexFormat = primitive.mesh->vertexFormat.get();
+
+                const auto& material = primitive.mesh->materials[primitive.renderSubMesh.materialIndex];
+                if (!m_DecalPipelineCreated)
+                {
+                    auto builder = rhi::GraphicsPipeline::Builder {};
+                    builder.setDepthFormat(passInfo.depthFormat)
+                        .setColorFormats(passInfo.colorFormats)
+                        .setInputAssembly(passInfo.vertexFormat->getAttributes())
+                        .setTopology(passInfo.topology)
+                        .addBuiltinShader(rhi::ShaderType::eVertex, geometry_vert_spv)
+                        .addBuiltinShader(rhi::ShaderType::eFragment, decal_frag_spv)
+                        .setDepthStencil({
+                            .depthTest      = true,
+                            .depthWrite     = false,
+                            .depthCompareOp = rhi::CompareOp::eLessOrEqual,
+                        })
+                        .setDepthBias({.constantFactor = 1.25f, .slopeFactor = 1.75f})
+                        .setRasterizer({.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eBack});
+                    for (auto i = 0; i < passInfo.colorFormats.size(); ++i)
+                    {
+                        builder.setBlending(i, material.blendState);
+                    }
+                    m_DecalPipeline        = builder.build(getRenderDevice());
+                    m_DecalPipelineCreated = true;
+                }
+
+                drawPrimitive(rc, m_DecalPipeline, primitive, enableNormalMapping, textures);
+            }
+        }
+
         rhi::GraphicsPipeline GBufferPass::createPipeline(const gfx::BaseGeometryPassInfo& passInfo,
                                                           bool                             doubleSided,
                                                           bool                             alphaMasking,
@@ -329,7 +369,9 @@ namespace vultra
                 .setColorFormats(passInfo.colorFormats)
                 .setInputAssembly(passInfo.vertexFormat->getAttributes())
                 .setTopology(passInfo.topology)
-                .addBuiltinShader(rhi::ShaderType::eVertex, geometry_vert_spv)
+                .setViewMask(passInfo.viewMask)
+                .addBuiltinShader(rhi::ShaderType::eVertex,
+                                  passInfo.viewMask ? geometry_multiview_vert_spv : geometry_vert_spv)
                 .addBuiltinShader(rhi::ShaderType::eFragment,
                                   alphaMasking ? gbuffer_alpha_masking_frag_spv :
                                                  (earlyZ ? gbuffer_earlyz_frag_spv : gbuffer_frag_spv))
@@ -0,0 +1,144 @@
+#include "vultra/function/renderer/builtin/passes/hiz_pass.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/core/rhi/texture.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/framegraph/queue_scheduler.hpp"
+#include "vultra/function/renderer/builtin/framegraph_common.hpp"
+#include "vultra/function/renderer/builtin/resources/depth_pre_data.hpp"
+#include "vultra/function/renderer/builtin/resources/gbuffer_data.hpp"
+#include "vultra/function/renderer/builtin/resources/hiz_data.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/hiz_build.comp.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "HiZPass";
+
+        HiZPass::HiZPass(rhi::RenderDevice& rd) : rhi::ComputePass<HiZPass>(rd) {}
+
+        void HiZPass::addPass(FrameGraph& fg, FrameGraphBlackboard& blackboard, framegraph::QueueScheduler* scheduler)
+        {
+            FrameGraphResource depthResource;
+            if (blackboard.has<DepthPreData>())
+            {
+                depthResource = blackboard.get<DepthPreData>().depth;
+            }
+            else
+            {
+                depthResource = blackboard.get<GBufferData>().depth;
+            }
+
+            const auto depthExtent = fg.getDescriptor<framegraph::FrameGraphTexture>(depthResource).extent;
+            const auto extent      = rhi::Extent2D {
+                std::max(depthExtent.width / 2u, 1u),
+                std::max(depthExtent.height / 2u, 1u),
+            };
+            const auto numMipLevels = rhi::calcMipLevels(extent);
+
+            const auto& hiZData = framegraph::addAsyncComputePass<HiZData>(
+                fg,
+                scheduler,
+                PASS_NAME,
+                [depthResource, extent, numMipLevels](FrameGraph::Builder& builder, HiZData& data) {
+                    PASS_SETUP_ZONE;
+
+                    builder.read(depthResource,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 0},
+                                             .pipelineStage = framegraph::PipelineStage::eComputeShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = rhi::ImageAspect::eDepth,
+                                 });
+
+                    data.minDepth = builder.create<framegraph::FrameGraphTexture>(
+                        "HiZ - MinDepth",
+                        {
+                            .extent       = extent,
+                            .format       = rhi::PixelFormat::eR32F,
+                            .numMipLevels = numMipLevels,
+                            .usageFlags   = rhi::ImageUsage::eStorage | rhi::ImageUsage::eSampled,
+                        });
+                    data.minDepth = builder.write(data.minDepth,
+                                                  framegraph::ImageWrite {
+                                                      .binding =
+                                                          {
+                                                              .location      = {.set = 3, .binding = 2},
+                                                              .pipelineStage = framegraph::PipelineStage::eComputeShader,
+                                                          },
+                                                      .imageAspect = rhi::ImageAspect::eColor,
+                                                  });
+                },
+                [this, extent, numMipLevels](const HiZData& data, FrameGraphPassResources& resources, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, PASS_NAME);
+
+                    const auto* minDepth = resources.get<framegraph::FrameGraphTexture>(data.minDepth).texture;
+
+                    const auto* pipeline = getPipeline();
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]); // Scene depth
+
+                        for (uint32_t level = 0; level < numMipLevels; ++level)
+                        {
+                            // Mip 0 reduces the scene depth, every other level reduces its predecessor.
+                            sets[3][1] = rhi::bindings::StorageImage {
+                                .texture     = minDepth,
+                                .imageAspect = rhi::ImageAspect::eColor,
+                                .mipLevel    = level > 0 ? level - 1 : 0,
+                            };
+                            sets[3][2] = rhi::bindings::StorageImage {
+                                .texture     = minDepth,
+                                .imageAspect = rhi::ImageAspect::eColor,
+                                .mipLevel    = level,
+                            };
+
+                            if (level > 0)
+                            {
+                                cb.getBarrierBuilder().memoryBarrier(
+                                    {
+                                        .stageMask  = rhi::PipelineStages::eComputeShader,
+                                        .accessMask = rhi::Access::eShaderStorageWrite,
+                                    },
+                                    {
+                                        .stageMask  = rhi::PipelineStages::eComputeShader,
+                                        .accessMask = rhi::Access::eShaderStorageRead,
+                                    });
+                            }
+
+                            const auto mipSize =
+                                rhi::calcMipSize(glm::uvec3 {extent.width, extent.height, 1u}, level);
+                            const auto numGroups =
+                                rhi::calcNumWorkGroups(glm::uvec2 {mipSize}, pipeline->getWorkGroupSize().x);
+
+                            rc.bindDescriptorSets(*pipeline);
+                            cb.pushConstants(rhi::ShaderStages::eCompute, 0, &level);
+                            cb.dispatch({numGroups, 1u});
+                        }
+
+                        rc.endCompute();
+                    }
+                });
+
+            add(blackboard, hiZData);
+        }
+
+        rhi::ComputePipeline HiZPass::createPipeline() const
+        {
+            return getRenderDevice().createComputePipelineBuiltin(hiz_build_comp_spv);
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
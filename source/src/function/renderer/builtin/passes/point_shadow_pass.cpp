@@ -0,0 +1,522 @@
+#include "vultra/function/renderer/builtin/passes/point_shadow_pass.hpp"
+#include "vultra/core/base/hash.hpp"
+#include "vultra/core/math/math.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/framegraph/upload_struct.hpp"
+#include "vultra/function/renderer/builtin/framegraph_common.hpp"
+#include "vultra/function/renderer/builtin/resources/shadow_data.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+#include "vultra/function/renderer/vertex_format.hpp"
+
+#include <shader_headers/point_shadow_mapping.vert.spv.h>
+#include <shader_headers/shadow_mapping.frag.spv.h>
+#include <shader_headers/shadow_mapping.vert.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "PointShadowPass";
+
+        namespace
+        {
+            static_assert(LIGHTINFO_MAX_POINT_LIGHTS % 4 == 0, "Light to slot mapping is packed in ivec4");
+
+            struct alignas(16) GPUPointShadowBlock
+            {
+                glm::mat4  faceViewProjections[POINT_SHADOW_MAX_LIGHTS * 6] {};
+                glm::vec4  slotPositions[POINT_SHADOW_MAX_LIGHTS] {};
+                glm::ivec4 lightSlots[LIGHTINFO_MAX_POINT_LIGHTS / 4] {};
+                float      texelScale {0.0f};
+                float      normalBias {0.0f};
+                float      padding0 {0.0f};
+                float      padding1 {0.0f};
+            };
+            static_assert(sizeof(GPUPointShadowBlock) == 3344, "GPUPointShadowBlock unexpected size (std140 mismatch)");
+
+            // Layered path, the face matrices come from the point shadow block.
+            struct PointShadowConstants
+            {
+                glm::mat4 modelMatrix {1.0f};
+                uint32_t  slot {0};
+            };
+
+            // Per-face fallback, same layout as the cascaded shadow map constants.
+            struct ShadowConstants
+            {
+                glm::mat4 modelMatrix {1.0f};
+                glm::mat4 lightSpaceMatrix {1.0f};
+            };
+
+            // +X, -X, +Y, -Y, +Z, -Z, must match selectCubeFace in point_shadow_block.glsl.
+            constexpr glm::vec3 kFaceDirections[6] = {
+                {1.0f, 0.0f, 0.0f},
+                {-1.0f, 0.0f, 0.0f},
+                {0.0f, 1.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, -1.0f},
+            };
+            constexpr glm::vec3 kFaceUps[6] = {
+                {0.0f, -1.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f},
+                {0.0f, 0.0f, 1.0f},
+                {0.0f, 0.0f, -1.0f},
+                {0.0f, -1.0f, 0.0f},
+                {0.0f, -1.0f, 0.0f},
+            };
+
+            // Faces are slightly wider than 90 degrees so that 3x3 PCF near a face edge stays inside the face.
+            constexpr float kGuardBandTexels = 2.0f;
+
+            [[nodiscard]] bool intersectsSphere(const AABB& aabb, const glm::vec3& center, float radius)
+            {
+                const auto closest = glm::clamp(center, aabb.min, aabb.max);
+                const auto d       = closest - center;
+                return glm::dot(d, d) <= radius * radius;
+            }
+
+            [[nodiscard]] bool
+            intersectsFrustum(const std::array<math::Plane, 6>& planes, const glm::vec3& center, float radius)
+            {
+                return std::ranges::all_of(
+                    planes, [&](const math::Plane& plane) { return plane.getDistanceToPoint(center) >= -radius; });
+            }
+        } // namespace
+
+        PointShadowPass::PointShadowPass(rhi::RenderDevice& rd) :
+            rhi::RenderPass<PointShadowPass>(rd),
+            m_Layered(
+                HasFlagValues(rd.getFeatureReport().flags, rhi::RenderDeviceFeatureReportFlagBits::eShaderOutputLayer))
+        {}
+
+        void PointShadowPass::addPass(FrameGraph&                 fg,
+                                      FrameGraphBlackboard&       blackboard,
+                                      const CameraInfo&           cameraInfo,
+                                      const LightInfo&            lightInfo,
+                                      const RenderPrimitiveGroup& renderPrimitiveGroup,
+                                      const PointShadowSettings&  settings,
+                                      const bool                  enabled)
+        {
+            ZoneScopedN("PointShadowPass::addPass");
+
+            // The import takes its descriptor from the current texture.
+            prepareShadowMaps(settings);
+
+            addUpdatePass(fg,
+                          "PointShadowPass Update",
+                          [this, &cameraInfo, &lightInfo, &renderPrimitiveGroup, &settings, enabled] {
+                              update(cameraInfo, lightInfo, renderPrimitiveGroup, settings, enabled);
+                          });
+
+            auto shadowMaps = framegraph::importTexture(fg, "Point Shadow Maps", &m_ShadowMaps);
+
+            auto pointShadowBlockResource = framegraph::uploadStruct(
+                fg,
+                "UploadPointShadowBlock",
+                "PointShadowBlock",
+                framegraph::BufferType::eUniformBuffer,
+                [this, &settings] {
+                    GPUPointShadowBlock pointShadowBlock {};
+                    pointShadowBlock.texelScale = m_TexelScale;
+                    pointShadowBlock.normalBias = settings.normalBias;
+                    for (auto& lightSlots : pointShadowBlock.lightSlots)
+                    {
+                        lightSlots = glm::ivec4 {-1};
+                    }
+
+                    // Publish every slot that holds a rendered (possibly stale) shadow.
+                    for (uint32_t s = 0; s < m_NumActiveSlots; ++s)
+                    {
+                        const auto& slot = m_Slots[s];
+                        if (slot.lightIndex < 0 || !slot.valid)
+                            continue;
+
+                        for (uint32_t face = 0; face < 6; ++face)
+                        {
+                            pointShadowBlock.faceViewProjections[s * 6 + face] = slot.faceViewProjections[face];
+                        }
+                        pointShadowBlock.slotPositions[s] = glm::vec4(slot.position, slot.radius);
+                        pointShadowBlock.lightSlots[slot.lightIndex / 4][slot.lightIndex % 4] = static_cast<int>(s);
+                    }
+                    return pointShadowBlock;
+                });
+
+            if (enabled)
+            {
+                struct Data
+                {
+                    FrameGraphResource shadowMaps;
+                };
+                const auto& data = fg.addCallbackPass<Data>(
+                    PASS_NAME,
+                    [this, shadowMaps, pointShadowBlockResource](FrameGraph::Builder& builder, Data& data) {
+                        PASS_SETUP_ZONE;
+
+                        if (m_Layered)
+                        {
+                            builder.read(pointShadowBlockResource,
+                                         framegraph::BindingInfo {
+                                             .location      = {.set = 1, .binding = 3},
+                                             .pipelineStage = framegraph::PipelineStage::eVertexShader,
+                                         });
+                        }
+
+                        // Whole atlas, refreshed slots are cleared in the pass, the others are preserved.
+                        data.shadowMaps = builder.write(shadowMaps,
+                                                        framegraph::Attachment {
+                                                            .imageAspect = rhi::ImageAspect::eDepth,
+                                                        });
+                    },
+                    [this](const Data&, FrameGraphPassResources&, void* ctx) {
+                        auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                        auto& [cb, framebufferInfo, sets, samplers] = rc;
+                        if (m_NumUpdatedSlots == 0)
+                        {
+                            // Every slot is up to date, without a rendering scope the atlas is left untouched.
+                            framebufferInfo.reset();
+                            sets.clear();
+                            return;
+                        }
+
+                        RHI_GPU_ZONE(cb, PASS_NAME);
+
+                        gfx::BaseGeometryPassInfo passInfo {
+                            .depthFormat  = rhi::getDepthFormat(*framebufferInfo),
+                            .colorFormats = {},
+                        };
+
+                        const auto getCasterPipeline = [&](const RenderPrimitive& primitive) -> decltype(auto) {
+                            passInfo.vertexFormat = primitive.mesh->vertexFormat.get();
+                            return *getPipeline(passInfo);
+                        };
+                        const auto drawPrimitive = [&](const RenderPrimitive& primitive, uint32_t numInstances) {
+                            cb.draw(primitive.mesh->getGeometryInfo(primitive.renderSubMesh), numInstances);
+                        };
+
+                        if (m_Layered)
+                        {
+                            // One rendering scope over every layer, each instance writes one face (gl_Layer).
+                            framebufferInfo->layers = m_ShadowMaps->getNumLayers();
+                            cb.beginRendering(*framebufferInfo);
+
+                            for (uint32_t u = 0; u < m_NumUpdatedSlots; ++u)
+                            {
+                                const auto s = m_UpdatedSlots[u];
+                                cb.clearDepthAttachment(framebufferInfo->area, 1.0f, s * 6, 6);
+
+                                for (const auto* primitive : m_DrawLists[s])
+                                {
+                                    const auto& pipeline = getCasterPipeline(*primitive);
+
+                                    PointShadowConstants pointShadowConstants {
+                                        .modelMatrix = primitive->modelMatrix,
+                                        .slot        = s,
+                                    };
+                                    cb.bindPipeline(pipeline).pushConstants(rhi::ShaderStages::eVertex,
+                                                                            0,
+                                                                            sizeof(PointShadowConstants),
+                                                                            &pointShadowConstants);
+                                    rc.bindDescriptorSets(pipeline);
+                                    drawPrimitive(*primitive, 6);
+                                }
+                            }
+
+                            rc.endRendering();
+                        }
+                        else
+                        {
+                            // One rendering scope per face, each clearing its own layer.
+                            auto faceFramebufferInfo = *framebufferInfo;
+                            faceFramebufferInfo.depthAttachment->clearValue = 1.0f;
+
+                            for (uint32_t u = 0; u < m_NumUpdatedSlots; ++u)
+                            {
+                                const auto  s    = m_UpdatedSlots[u];
+                                const auto& slot = m_Slots[s];
+                                for (uint32_t face = 0; face < 6; ++face)
+                                {
+                                    faceFramebufferInfo.depthAttachment->layer = s * 6 + face;
+                                    cb.beginRendering(faceFramebufferInfo);
+
+                                    for (const auto* primitive : m_DrawLists[s])
+                                    {
+                                        const auto& pipeline = getCasterPipeline(*primitive);
+
+                                        ShadowConstants shadowConstants {
+                                            .modelMatrix      = primitive->modelMatrix,
+                                            .lightSpaceMatrix = slot.faceViewProjections[face],
+                                        };
+                                        cb.bindPipeline(pipeline).pushConstants(
+                                            rhi::ShaderStages::eVertex, 0, sizeof(ShadowConstants), &shadowConstants);
+                                        rc.bindDescriptorSets(pipeline);
+                                        drawPrimitive(*primitive, 1);
+                                    }
+
+                                    cb.endRendering();
+                                }
+                            }
+
+                            // Same cleanup as rc.endRendering(), the scopes above were closed on the command buffer.
+                            framebufferInfo.reset();
+                            sets.clear();
+                        }
+                    });
+                shadowMaps = data.shadowMaps;
+            }
+
+            auto& shadowData            = blackboard.get<ShadowData>();
+            shadowData.pointShadowMaps  = shadowMaps;
+            shadowData.pointShadowBlock = pointShadowBlockResource;
+        }
+
+        void PointShadowPass::update(const CameraInfo&           cameraInfo,
+                                     const LightInfo&            lightInfo,
+                                     const RenderPrimitiveGroup& renderPrimitiveGroup,
+                                     const PointShadowSettings&  settings,
+                                     const bool                  enabled)
+        {
+            ZoneScopedN("PointShadowPass::update");
+
+            prepareShadowMaps(settings);
+
+            m_NumActiveSlots    = 0;
+            m_NumUpdatedSlots   = 0;
+            m_NumShadowedLights = 0;
+            m_NumPendingLights  = 0;
+
+            const auto numSlots   = glm::clamp(settings.maxShadowedLights, 1u, POINT_SHADOW_MAX_LIGHTS);
+            const auto numLights  = glm::clamp(lightInfo.pointLightCount, 0, LIGHTINFO_MAX_POINT_LIGHTS);
+            const auto tanHalfFov = 1.0f + 2.0f * kGuardBandTexels / static_cast<float>(settings.resolution);
+            const auto fov        = 2.0f * std::atan(tanHalfFov);
+            m_TexelScale          = 2.0f * tanHalfFov / static_cast<float>(settings.resolution);
+
+            if (!enabled || numLights == 0)
+                return;
+
+            // -- Rank the lights, only those affecting the view frustum are candidates.
+
+            struct Candidate
+            {
+                int   lightIndex {-1};
+                float importance {0.0f};
+            };
+            Candidate candidates[LIGHTINFO_MAX_POINT_LIGHTS];
+            uint32_t  numCandidates = 0;
+
+            const auto planes         = math::extractFrustumPlanes(cameraInfo.viewProjection);
+            const auto cameraPosition = glm::vec3(glm::inverse(cameraInfo.view)[3]);
+            for (int i = 0; i < numLights; ++i)
+            {
+                const auto& light = lightInfo.pointLights[i];
+                if (light.radius <= 0.0f || light.intensity <= 0.0f ||
+                    !intersectsFrustum(planes, light.position, light.radius))
+                    continue;
+
+                const auto distance = glm::max(glm::length(light.position - cameraPosition) - light.radius, 0.0f);
+                candidates[numCandidates++] = {
+                    .lightIndex = i,
+                    .importance = light.intensity * light.radius * light.radius / (1.0f + distance * distance),
+                };
+            }
+            std::sort(candidates, candidates + numCandidates, [](const Candidate& a, const Candidate& b) {
+                return a.importance > b.importance;
+            });
+            numCandidates = glm::min(numCandidates, numSlots);
+
+            // -- Keep the slots of lights that are still selected, release the others, then assign newcomers.
+
+            float importances[LIGHTINFO_MAX_POINT_LIGHTS] {};
+            for (uint32_t c = 0; c < numCandidates; ++c)
+            {
+                importances[candidates[c].lightIndex] = candidates[c].importance;
+            }
+
+            int lightToSlot[LIGHTINFO_MAX_POINT_LIGHTS];
+            std::fill(std::begin(lightToSlot), std::end(lightToSlot), -1);
+            for (uint32_t s = 0; s < POINT_SHADOW_MAX_LIGHTS; ++s)
+            {
+                auto& slot = m_Slots[s];
+                if (slot.lightIndex < 0)
+                    continue;
+
+                if (s >= numSlots || slot.lightIndex >= numLights || importances[slot.lightIndex] <= 0.0f)
+                {
+                    slot = Slot {};
+                    continue;
+                }
+                lightToSlot[slot.lightIndex] = static_cast<int>(s);
+            }
+            for (uint32_t c = 0; c < numCandidates; ++c)
+            {
+                const auto lightIndex = candidates[c].lightIndex;
+                if (lightToSlot[lightIndex] >= 0)
+                    continue;
+
+                for (uint32_t s = 0; s < numSlots; ++s)
+                {
+                    if (m_Slots[s].lightIndex < 0)
+                    {
+                        m_Slots[s]              = Slot {.lightIndex = lightIndex};
+                        lightToSlot[lightIndex] = static_cast<int>(s);
+                        break;
+                    }
+                }
+            }
+
+            // -- Gather casters and find the slots whose content is out of date.
+
+            size_t   casterHashes[POINT_SHADOW_MAX_LIGHTS] {};
+            uint32_t dirtySlots[POINT_SHADOW_MAX_LIGHTS];
+            uint32_t numDirtySlots = 0;
+            for (uint32_t s = 0; s < numSlots; ++s)
+            {
+                auto& slot = m_Slots[s];
+                if (slot.lightIndex < 0)
+                    continue;
+
+                const auto& light = lightInfo.pointLights[slot.lightIndex];
+                slot.importance   = importances[slot.lightIndex];
+
+                auto& drawList = m_DrawLists[s];
+                drawList.clear();
+
+                auto& casterHash = casterHashes[s];
+                for (const auto& primitive : renderPrimitiveGroup.opaquePrimitives)
+                {
+                    if (!intersectsSphere(primitive.renderSubMesh.aabb.transform(primitive.modelMatrix),
+                                          light.position,
+                                          light.radius))
+                        continue;
+
+                    drawList.push_back(&primitive);
+                    hashCombine(casterHash, primitive.mesh.get(), primitive.renderSubMeshIndex);
+                    const auto* m = glm::value_ptr(primitive.modelMatrix);
+                    for (int k = 0; k < 16; ++k)
+                    {
+                        hashCombine(casterHash, m[k]);
+                    }
+                }
+
+                const bool dirty = !slot.valid || glm::length(light.position - slot.position) > 1e-3f ||
+                                   light.radius != slot.radius || casterHash != slot.casterHash;
+                if (dirty)
+                {
+                    dirtySlots[numDirtySlots++] = s;
+                }
+            }
+
+            // -- Spend the update budget: slots never rendered first, then by importance and waiting time.
+
+            std::sort(dirtySlots, dirtySlots + numDirtySlots, [this](uint32_t a, uint32_t b) {
+                const auto& sa = m_Slots[a];
+                const auto& sb = m_Slots[b];
+                if (sa.valid != sb.valid)
+                    return !sa.valid;
+                return sa.importance * static_cast<float>(1 + sa.staleFrames) >
+                       sb.importance * static_cast<float>(1 + sb.staleFrames);
+            });
+
+            const auto budget = glm::min(numDirtySlots, glm::max(settings.updateBudget, 1u));
+
+            for (uint32_t d = 0; d < numDirtySlots; ++d)
+            {
+                auto& slot = m_Slots[dirtySlots[d]];
+                if (d >= budget)
+                {
+                    ++slot.staleFrames;
+                    ++m_NumPendingLights;
+                    continue;
+                }
+
+                const auto& light      = lightInfo.pointLights[slot.lightIndex];
+                const auto  zNear      = glm::max(light.radius * 0.005f, 0.01f);
+                const auto  projection = glm::perspectiveRH_ZO(fov, 1.0f, zNear, light.radius);
+                for (uint32_t face = 0; face < 6; ++face)
+                {
+                    const auto view =
+                        glm::lookAt(light.position, light.position + kFaceDirections[face], kFaceUps[face]);
+                    slot.faceViewProjections[face] = projection * view;
+                }
+                slot.position    = light.position;
+                slot.radius      = light.radius;
+                slot.casterHash  = casterHashes[dirtySlots[d]];
+                slot.staleFrames = 0;
+                slot.valid       = true;
+
+                m_UpdatedSlots[m_NumUpdatedSlots++] = dirtySlots[d];
+            }
+
+            for (uint32_t s = 0; s < numSlots; ++s)
+            {
+                if (m_Slots[s].lightIndex >= 0 && m_Slots[s].valid)
+                    ++m_NumShadowedLights;
+            }
+            m_NumActiveSlots = numSlots;
+        }
+
+        void PointShadowPass::invalidate()
+        {
+            for (auto& slot : m_Slots)
+            {
+                slot.valid = false;
+            }
+        }
+
+        rhi::GraphicsPipeline PointShadowPass::createPipeline(const gfx::BaseGeometryPassInfo& passInfo) const
+        {
+            return rhi::GraphicsPipeline::Builder {}
+                .setDepthFormat(passInfo.depthFormat)
+                .setColorFormats({})
+                .setInputAssembly(passInfo.vertexFormat->getAttributes())
+                .setTopology(passInfo.topology)
+                .addBuiltinShader(rhi::ShaderType::eVertex,
+                                  m_Layered ? point_shadow_mapping_vert_spv : shadow_mapping_vert_spv)
+                .addBuiltinShader(rhi::ShaderType::eFragment, shadow_mapping_frag_spv)
+                .setDepthStencil({
+                    .depthTest      = true,
+                    .depthWrite     = true,
+                    .depthCompareOp = rhi::CompareOp::eLessOrEqual,
+                })
+                .setDepthBias({.constantFactor = 1.25f, .slopeFactor = 1.75f})
+                .setRasterizer({.polygonMode = rhi::PolygonMode::eFill, .cullMode = rhi::CullMode::eNone})
+                .build(getRenderDevice());
+        }
+
+        void PointShadowPass::prepareShadowMaps(const PointShadowSettings& settings)
+        {
+            const auto extent    = rhi::Extent2D {settings.resolution, settings.resolution};
+            const auto numLayers = glm::clamp(settings.maxShadowedLights, 1u, POINT_SHADOW_MAX_LIGHTS) * 6;
+
+            if (m_ShadowMaps && m_ShadowMaps->getExtent() == extent && m_ShadowMaps->getNumLayers() == numLayers)
+                return;
+
+            if (m_ShadowMaps)
+            {
+                // Might still be sampled by the frames in flight.
+                getRenderDevice().getDeletionQueue().push(std::move(m_ShadowMaps));
+            }
+            m_ShadowMaps = createRef<rhi::Texture>(
+                rhi::Texture::Builder {}
+                    .setExtent(extent)
+                    .setPixelFormat(rhi::PixelFormat::eDepth32F)
+                    .setNumMipLevels(1)
+                    .setNumLayers(numLayers)
+                    .setUsageFlags(rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled)
+                    .build(getRenderDevice()));
+            invalidate();
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -0,0 +1,530 @@
+#include "vultra/function/renderer/builtin/passes/raytraced_shadow_pass.hpp"
+#include "vultra/core/math/math.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/framegraph/upload_struct.hpp"
+#include "vultra/function/renderer/builtin/framegraph_common.hpp"
+#include "vultra/function/renderer/builtin/post_process_helper.hpp"
+#include "vultra/function/renderer/builtin/resources/camera_data.hpp"
+#include "vultra/function/renderer/builtin/resources/depth_pre_data.hpp"
+#include "vultra/function/renderer/builtin/resources/gbuffer_data.hpp"
+#include "vultra/function/renderer/builtin/resources/light_data.hpp"
+#include "vultra/function/renderer/builtin/resources/raytraced_shadow_data.hpp"
+#include "vultra/function/renderer/builtin/resources/shadow_data.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/fullscreen_triangle.vert.spv.h>
+#include <shader_headers/raytraced_shadows.frag.spv.h>
+#include <shader_headers/raytraced_shadows_filter.frag.spv.h>
+#include <shader_headers/raytraced_shadows_temporal.frag.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+#include <algorithm>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        namespace
+        {
+            struct alignas(16) GPURayTracedShadowBlock
+            {
+                glm::ivec4 pointLights {-1}; // Point light index stored in mask channels g, b, a
+                int        directional {0};
+                int        padding0 {0};
+                int        padding1 {0};
+                int        padding2 {0};
+            };
+            static_assert(sizeof(GPURayTracedShadowBlock) == 32, "GPURayTracedShadowBlock unexpected size");
+
+            [[nodiscard]] auto makeTextureRead(const uint32_t         binding,
+                                               const rhi::ImageAspect imageAspect = rhi::ImageAspect::eColor)
+            {
+                return framegraph::TextureRead {
+                    .binding =
+                        {
+                            .location      = {.set = 3, .binding = binding},
+                            .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                        },
+                    .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                    .imageAspect = imageAspect,
+                };
+            }
+
+            // The count most important point lights affecting the view frustum (intensity * radius^2 falling off
+            // with the distance to the camera), -1 for unused entries.
+            [[nodiscard]] glm::ivec4
+            selectPointLights(const CameraInfo& cameraInfo, const LightInfo& lightInfo, const int count)
+            {
+                struct Candidate
+                {
+                    int   lightIndex {-1};
+                    float importance {0.0f};
+                };
+                Candidate candidates[LIGHTINFO_MAX_POINT_LIGHTS];
+                int       numCandidates = 0;
+
+                const auto planes         = math::extractFrustumPlanes(cameraInfo.viewProjection);
+                const auto cameraPosition = glm::vec3(glm::inverse(cameraInfo.view)[3]);
+                const auto numLights      = glm::clamp(lightInfo.pointLightCount, 0, LIGHTINFO_MAX_POINT_LIGHTS);
+                for (int i = 0; i < numLights; ++i)
+                {
+                    const auto& light = lightInfo.pointLights[i];
+                    if (light.radius <= 0.0f || light.intensity <= 0.0f)
+                        continue;
+
+                    const bool visible = std::ranges::all_of(planes, [&](const math::Plane& plane) {
+                        return plane.getDistanceToPoint(light.position) >= -light.radius;
+                    });
+                    if (!visible)
+                        continue;
+
+                    const auto distance = glm::max(glm::length(light.position - cameraPosition) - light.radius, 0.0f);
+                    candidates[numCandidates++] = {
+                        .lightIndex = i,
+                        .importance = light.intensity * light.radius * light.radius / (1.0f + distance * distance),
+                    };
+                }
+                std::sort(candidates, candidates + numCandidates, [](const Candidate& a, const Candidate& b) {
+                    return a.importance > b.importance;
+                });
+
+                glm::ivec4 pointLights {-1};
+                for (int c = 0; c < glm::min(numCandidates, count); ++c)
+                {
+                    pointLights[c] = candidates[c].lightIndex;
+                }
+                return pointLights;
+            }
+        } // namespace
+
+        RayTracedShadowPass::RayTracedShadowPass(rhi::RenderDevice& rd) : rhi::RenderPass<RayTracedShadowPass>(rd)
+        {
+            m_WhiteMask = rhi::createDefaultTexture(255, 255, 255, 255, rd);
+        }
+
+        void RayTracedShadowPass::addPass(FrameGraph&                    fg,
+                                          FrameGraphBlackboard&          blackboard,
+                                          const CameraInfo&              cameraInfo,
+                                          const LightInfo&               lightInfo,
+                                          const RenderableGroup&         renderableGroup,
+                                          const RayTracedShadowSettings& settings,
+                                          const bool                     enabled,
+                                          const uint32_t                 viewId)
+        {
+            ZoneScopedN("RayTracedShadowPass::addPass");
+
+            auto& shadowData = blackboard.get<ShadowData>();
+
+            m_Active = enabled && isSupported() && static_cast<bool>(renderableGroup.tlas);
+            if (!m_Active)
+            {
+                addUpdatePass(fg, "RayTracedShadowPass Reset", [this] { resetHistory(); });
+
+                shadowData.rayTracedShadowMask =
+                    framegraph::importTexture(fg, "Ray Traced Shadow Mask (White)", m_WhiteMask.get());
+                shadowData.rayTracedShadowBlock = framegraph::uploadStruct(fg,
+                                                                           "UploadRayTracedShadowBlock",
+                                                                           "RayTracedShadowBlock",
+                                                                           framegraph::BufferType::eUniformBuffer,
+                                                                           [] { return GPURayTracedShadowBlock {}; });
+                return;
+            }
+
+            const auto gBuffer = blackboard.get<GBufferData>();
+
+            FrameGraphResource depthResource;
+            if (blackboard.has<DepthPreData>())
+            {
+                depthResource = blackboard.get<DepthPreData>().depth;
+            }
+            else
+            {
+                depthResource = gBuffer.depth;
+            }
+
+            const auto fullExtent = fg.getDescriptor<framegraph::FrameGraphTexture>(depthResource).extent;
+            const auto halfExtent = rhi::Extent2D {
+                std::max(fullExtent.width / 2u, 1u),
+                std::max(fullExtent.height / 2u, 1u),
+            };
+
+            // The imports take their descriptors from the current textures.
+            auto& viewHistory = prepareHistory(viewId, halfExtent);
+
+            addUpdatePass(fg,
+                          "RayTracedShadowPass Update",
+                          [this, &viewHistory, &cameraInfo, &lightInfo, &settings, viewId, halfExtent] {
+                              prepareHistory(viewId, halfExtent);
+
+                              const auto numPointLights =
+                                  static_cast<int>(glm::min(settings.numPointLights, RT_SHADOW_MAX_POINT_LIGHTS));
+                              const auto pointLights = selectPointLights(cameraInfo, lightInfo, numPointLights);
+                              const bool directional = lightInfo.useDirectionalLight != 0;
+
+                              // A channel only keeps its history while it traces the same light.
+                              viewHistory.historyMask = {
+                                  directional == viewHistory.prevDirectional ? 1.0f : 0.0f,
+                                  pointLights.x == viewHistory.prevPointLights.x ? 1.0f : 0.0f,
+                                  pointLights.y == viewHistory.prevPointLights.y ? 1.0f : 0.0f,
+                                  pointLights.z == viewHistory.prevPointLights.z ? 1.0f : 0.0f,
+                              };
+                              viewHistory.pointLights = pointLights;
+                              viewHistory.directional = directional;
+                          });
+
+            const auto& bindings = viewHistory.bindings;
+
+            const auto history = framegraph::importTexture(fg, "Ray Traced Shadow History", &bindings.history);
+            const auto historyGeometry =
+                framegraph::importTexture(fg, "Ray Traced Shadow History Geometry", &bindings.historyGeometry);
+            const auto accumulated =
+                framegraph::importTexture(fg, "Ray Traced Shadow Accumulated", &bindings.accumulated);
+            const auto geometry = framegraph::importTexture(fg, "Ray Traced Shadow Geometry", &bindings.geometry);
+
+            RayTracedShadowData rayTracedShadowData {};
+
+            // -- Trace
+
+            struct TraceData
+            {
+                FrameGraphResource trace;
+            };
+            const auto& trace = fg.addCallbackPass<TraceData>(
+                "Ray Traced Shadows Trace",
+                [&blackboard, gBuffer, depthResource, halfExtent](FrameGraph::Builder& builder, TraceData& data) {
+                    PASS_SETUP_ZONE;
+
+                    read(builder, blackboard.get<CameraData>());
+                    read(builder, blackboard.get<LightData>());
+
+                    builder.read(depthResource, makeTextureRead(1, rhi::ImageAspect::eDepth));
+                    builder.read(gBuffer.normal, makeTextureRead(2));
+
+                    data.trace = builder.create<framegraph::FrameGraphTexture>(
+                        "Ray Traced Shadows - Trace",
+                        {
+                            .extent     = halfExtent,
+                            .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+                        });
+                    data.trace = builder.write(data.trace,
+                                               framegraph::Attachment {
+                                                   .index       = 0,
+                                                   .imageAspect = rhi::ImageAspect::eColor,
+                                                   .clearValue  = framegraph::ClearValue::eOpaqueWhite,
+                                               });
+                },
+                [this, &renderableGroup, &settings, &viewHistory](
+                    const TraceData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "Ray Traced Shadows Trace");
+
+                    struct PushConstants
+                    {
+                        glm::ivec4 pointLights;
+                        float      sunAngularRadius;
+                        float      pointLightSourceRadius;
+                        uint32_t   frameIndex;
+                        int        traceDirectional;
+                    };
+
+                    PushConstants pushConstants {
+                        .pointLights            = viewHistory.pointLights,
+                        .sunAngularRadius       = glm::radians(settings.sunAngularRadius),
+                        .pointLightSourceRadius = settings.pointLightSourceRadius,
+                        .frameIndex             = m_FrameIndex,
+                        .traceDirectional       = viewHistory.directional ? 1 : 0,
+                    };
+
+                    const auto* pipeline = getPipeline(Stage::eTrace);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        rc.resourceSet[3][0] = rhi::bindings::AccelerationStructureKHR {.as = &renderableGroup.tlas};
+                        rc.overrideSampler(sets[3][1], samplers["point"]); // Depth
+                        rc.overrideSampler(sets[3][2], samplers["point"]); // Normal
+                        cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+            rayTracedShadowData.trace = trace.trace;
+
+            // -- Temporal accumulation (writes into the history textures of this frame)
+
+            struct TemporalData
+            {
+                FrameGraphResource accumulated;
+                FrameGraphResource geometry;
+            };
+            const auto& temporal = fg.addCallbackPass<TemporalData>(
+                "Ray Traced Shadows Temporal",
+                [&blackboard,
+                 trace = rayTracedShadowData.trace,
+                 history,
+                 historyGeometry,
+                 accumulated,
+                 geometry,
+                 gBuffer,
+                 depthResource](FrameGraph::Builder& builder, TemporalData& data) {
+                    PASS_SETUP_ZONE;
+
+                    read(builder, blackboard.get<CameraData>());
+
+                    builder.read(trace, makeTextureRead(0));
+                    builder.read(history, makeTextureRead(1));
+                    builder.read(historyGeometry, makeTextureRead(2));
+                    builder.read(depthResource, makeTextureRead(3, rhi::ImageAspect::eDepth));
+                    builder.read(gBuffer.normal, makeTextureRead(4));
+
+                    data.accumulated = builder.write(accumulated,
+                                                     framegraph::Attachment {
+                                                         .index       = 0,
+                                                         .imageAspect = rhi::ImageAspect::eColor,
+                                                     });
+                    data.geometry    = builder.write(geometry,
+                                                  framegraph::Attachment {
+                                                      .index       = 1,
+                                                      .imageAspect = rhi::ImageAspect::eColor,
+                                                  });
+                },
+                [this, &settings, &viewHistory](const TemporalData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "Ray Traced Shadows Temporal");
+
+                    struct PushConstants
+                    {
+                        glm::mat4 prevViewProjection;
+                        glm::vec4 historyMask;
+                        float     temporalWeight;
+                        float     depthThreshold;
+                        float     normalThreshold;
+                        uint32_t  historyValid;
+                    };
+
+                    PushConstants pushConstants {
+                        .prevViewProjection = viewHistory.prevViewProjection,
+                        .historyMask        = viewHistory.historyMask,
+                        .temporalWeight     = settings.temporalWeight,
+                        .depthThreshold     = settings.depthThreshold,
+                        .normalThreshold    = settings.normalThreshold,
+                        .historyValid       = viewHistory.valid ? 1u : 0u,
+                    };
+
+                    const auto* pipeline = getPipeline(Stage::eTemporal);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]);    // Trace
+                        rc.overrideSampler(sets[3][1], samplers["bilinear"]); // History
+                        rc.overrideSampler(sets[3][2], samplers["point"]);    // History geometry
+                        rc.overrideSampler(sets[3][3], samplers["point"]);    // Depth
+                        rc.overrideSampler(sets[3][4], samplers["point"]);    // Normal
+                        cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+            rayTracedShadowData.accumulated = temporal.accumulated;
+            rayTracedShadowData.geometry    = temporal.geometry;
+
+            // -- Spatial filter + upsample to full resolution
+
+            struct FilterData
+            {
+                FrameGraphResource mask;
+            };
+            const auto& filter = fg.addCallbackPass<FilterData>(
+                "Ray Traced Shadows Filter",
+                [&blackboard,
+                 accumulated = rayTracedShadowData.accumulated,
+                 geometry    = rayTracedShadowData.geometry,
+                 gBuffer,
+                 depthResource,
+                 fullExtent](FrameGraph::Builder& builder, FilterData& data) {
+                    PASS_SETUP_ZONE;
+
+                    read(builder, blackboard.get<CameraData>());
+
+                    builder.read(accumulated, makeTextureRead(0));
+                    builder.read(geometry, makeTextureRead(1));
+                    builder.read(depthResource, makeTextureRead(2, rhi::ImageAspect::eDepth));
+                    builder.read(gBuffer.normal, makeTextureRead(3));
+
+                    data.mask = builder.create<framegraph::FrameGraphTexture>(
+                        "Ray Traced Shadows - Mask",
+                        {
+                            .extent     = fullExtent,
+                            .format     = rhi::PixelFormat::eRGBA8_UNorm,
+                            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+                        });
+                    data.mask = builder.write(data.mask,
+                                              framegraph::Attachment {
+                                                  .index       = 0,
+                                                  .imageAspect = rhi::ImageAspect::eColor,
+                                              });
+                },
+                [this, &settings](const FilterData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "Ray Traced Shadows Filter");
+
+                    struct PushConstants
+                    {
+                        int   radius;
+                        float depthThreshold;
+                        float normalThreshold;
+                    };
+
+                    PushConstants pushConstants {
+                        .radius          = static_cast<int>(settings.filterRadius),
+                        .depthThreshold  = settings.depthThreshold,
+                        .normalThreshold = settings.normalThreshold,
+                    };
+
+                    const auto* pipeline = getPipeline(Stage::eFilter);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]); // Accumulated
+                        rc.overrideSampler(sets[3][1], samplers["point"]); // Geometry
+                        rc.overrideSampler(sets[3][2], samplers["point"]); // Depth
+                        rc.overrideSampler(sets[3][3], samplers["point"]); // Normal
+                        cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+            rayTracedShadowData.mask = filter.mask;
+
+            add(blackboard, rayTracedShadowData);
+
+            shadowData.rayTracedShadowMask  = rayTracedShadowData.mask;
+            shadowData.rayTracedShadowBlock = framegraph::uploadStruct(
+                fg,
+                "UploadRayTracedShadowBlock",
+                "RayTracedShadowBlock",
+                framegraph::BufferType::eUniformBuffer,
+                [&viewHistory] {
+                    return GPURayTracedShadowBlock {
+                        .pointLights = viewHistory.pointLights,
+                        .directional = viewHistory.directional ? 1 : 0,
+                    };
+                });
+
+            // Last, the passes above read the state of this frame.
+            addUpdatePass(fg, "RayTracedShadowPass Advance", [this, &viewHistory, &cameraInfo] {
+                viewHistory.prevViewProjection = cameraInfo.viewProjection;
+                viewHistory.prevPointLights    = viewHistory.pointLights;
+                viewHistory.prevDirectional    = viewHistory.directional;
+                viewHistory.valid              = true;
+                viewHistory.index ^= 1;
+                ++m_FrameIndex;
+            });
+        }
+
+        bool RayTracedShadowPass::isSupported() const
+        {
+            return HasFlagValues(getRenderDevice().getFeatureFlag(), rhi::RenderDeviceFeatureFlagBits::eRayQuery);
+        }
+
+        rhi::GraphicsPipeline RayTracedShadowPass::createPipeline(const Stage stage) const
+        {
+            switch (stage)
+            {
+                case Stage::eTrace:
+                    return createPostProcessPipelineFromSPV(
+                        getRenderDevice(), rhi::PixelFormat::eRGBA8_UNorm, raytraced_shadows_frag_spv);
+                case Stage::eTemporal:
+                    // Two targets: accumulated visibility and the geometry used for rejection next frame.
+                    return rhi::GraphicsPipeline::Builder {}
+                        .setColorFormats({rhi::PixelFormat::eRGBA8_UNorm, rhi::PixelFormat::eRGBA16F})
+                        .setInputAssembly({})
+                        .addBuiltinShader(rhi::ShaderType::eVertex, fullscreen_triangle_vert_spv)
+                        .addBuiltinShader(rhi::ShaderType::eFragment, raytraced_shadows_temporal_frag_spv)
+                        .setDepthStencil({
+                            .depthTest  = false,
+                            .depthWrite = false,
+                        })
+                        .setRasterizer({
+                            .polygonMode = rhi::PolygonMode::eFill,
+                            .cullMode    = rhi::CullMode::eFront,
+                        })
+                        .setBlending(0, {.enabled = false})
+                        .setBlending(1, {.enabled = false})
+                        .build(getRenderDevice());
+                case Stage::eFilter:
+                    return createPostProcessPipelineFromSPV(
+                        getRenderDevice(), rhi::PixelFormat::eRGBA8_UNorm, raytraced_shadows_filter_frag_spv);
+
+                default:
+                    assert(0);
+                    return {};
+            }
+        }
+
+        void RayTracedShadowPass::resetHistory()
+        {
+            for (auto& [_, history] : m_Histories)
+                history.valid = false;
+        }
+
+        RayTracedShadowPass::History& RayTracedShadowPass::prepareHistory(const uint32_t       viewId,
+                                                                         const rhi::Extent2D& extent)
+        {
+            const auto prepare = [this, &extent](Ref<rhi::Texture>& texture, const rhi::PixelFormat format) {
+                if (texture && texture->getExtent() == extent)
+                    return;
+
+                if (texture)
+                {
+                    // Might still be used by the frames in flight.
+                    getRenderDevice().getDeletionQueue().push(std::move(texture));
+                }
+                texture = createRef<rhi::Texture>(
+                    rhi::Texture::Builder {}
+                        .setExtent(extent)
+                        .setPixelFormat(format)
+                        .setNumMipLevels(1)
+                        .setUsageFlags(rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled)
+                        .build(getRenderDevice()));
+            };
+
+            auto&      viewHistory = m_Histories[viewId];
+            const auto previous    = viewHistory.index ^ 1;
+            if (!viewHistory.visibility[previous])
+            {
+                // First frame of the view, nothing to accumulate with yet.
+                prepare(viewHistory.visibility[previous], rhi::PixelFormat::eRGBA8_UNorm);
+                prepare(viewHistory.geometry[previous], rhi::PixelFormat::eRGBA16F);
+                viewHistory.valid = false;
+            }
+            // Only the targets of this frame follow the extent. Last frame's visibility and geometry are sampled
+            // through reprojected UVs, so the history survives a resolution change (dynamic resolution).
+            prepare(viewHistory.visibility[viewHistory.index], rhi::PixelFormat::eRGBA8_UNorm);
+            prepare(viewHistory.geometry[viewHistory.index], rhi::PixelFormat::eRGBA16F);
+
+            viewHistory.bindings = {
+                .history         = viewHistory.visibility[previous].get(),
+                .historyGeometry = viewHistory.geometry[previous].get(),
+                .accumulated     = viewHistory.visibility[viewHistory.index].get(),
+                .geometry        = viewHistory.geometry[viewHistory.index].get(),
+            };
+            return viewHistory;
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -50,7 +50,7 @@ namespace vultra
                                                          bool                   enableNormalMapping,
                                                          bool                   enableAreaLights,
                                                          bool                   enableIBL,
-                                                         float                  exposure,
+                                                         const float&           exposure,
                                                          ToneMappingMethod      toneMappingMethod)
         {
             // Disable area lights if LUTs missing
@@ -133,7 +133,7 @@ namespace vultra
                  enableNormalMapping,
                  enableAreaLights,
                  enableIBL,
-                 exposure,
+                 &exposure,
                  toneMappingMethod](const SimpleRaytracingData&, auto&, void* ctx) {
                     auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
                     auto& [cb, framebufferInfo, sets, samplers] = rc;
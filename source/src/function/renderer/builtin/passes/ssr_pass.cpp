@@ -0,0 +1,345 @@
+#include "vultra/function/renderer/builtin/passes/ssr_pass.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+#include "vultra/function/framegraph/framegraph_import.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/renderer/builtin/framegraph_common.hpp"
+#include "vultra/function/renderer/builtin/post_process_helper.hpp"
+#include "vultra/function/renderer/builtin/resources/camera_data.hpp"
+#include "vultra/function/renderer/builtin/resources/depth_pre_data.hpp"
+#include "vultra/function/renderer/builtin/resources/gbuffer_data.hpp"
+#include "vultra/function/renderer/builtin/resources/hiz_data.hpp"
+#include "vultra/function/renderer/builtin/resources/ssr_data.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/color_blend_additive.frag.spv.h>
+#include <shader_headers/ssr.frag.spv.h>
+#include <shader_headers/ssr_resolve.frag.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        namespace
+        {
+            [[nodiscard]] auto makeTextureRead(const uint32_t         binding,
+                                               const rhi::ImageAspect imageAspect = rhi::ImageAspect::eColor)
+            {
+                return framegraph::TextureRead {
+                    .binding =
+                        {
+                            .location      = {.set = 3, .binding = binding},
+                            .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                        },
+                    .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                    .imageAspect = imageAspect,
+                };
+            }
+        } // namespace
+
+        SSRPass::SSRPass(rhi::RenderDevice& rd) : rhi::RenderPass<SSRPass>(rd) {}
+
+        FrameGraphResource SSRPass::addPass(FrameGraph&           fg,
+                                            FrameGraphBlackboard& blackboard,
+                                            FrameGraphResource    sceneColorHDR,
+                                            const glm::mat4&      viewProjection,
+                                            const SSRSettings&    settings,
+                                            const uint32_t        viewId)
+        {
+            const auto gBuffer = blackboard.get<GBufferData>();
+            const auto hiZ     = blackboard.get<HiZData>().minDepth;
+
+            FrameGraphResource depthResource;
+            if (blackboard.has<DepthPreData>())
+            {
+                depthResource = blackboard.get<DepthPreData>().depth;
+            }
+            else
+            {
+                depthResource = gBuffer.depth;
+            }
+
+            const auto fullExtent = fg.getDescriptor<framegraph::FrameGraphTexture>(sceneColorHDR).extent;
+            const auto halfExtent = rhi::Extent2D {
+                std::max(fullExtent.width / 2u, 1u),
+                std::max(fullExtent.height / 2u, 1u),
+            };
+
+            // The imports take their descriptors from the current textures.
+            auto& viewHistory = prepareHistory(viewId, halfExtent);
+
+            addUpdatePass(fg, "SSRPass Update", [this, viewId, halfExtent] { prepareHistory(viewId, halfExtent); });
+
+            const auto history  = framegraph::importTexture(fg, "SSR History", &viewHistory.bindings.history);
+            const auto resolved = framegraph::importTexture(fg, "SSR Resolved", &viewHistory.bindings.resolved);
+
+            SSRData ssrData {};
+
+            // -- Trace
+
+            struct TraceData
+            {
+                FrameGraphResource trace;
+            };
+            const auto& trace = fg.addCallbackPass<TraceData>(
+                "SSR Trace",
+                [&blackboard, gBuffer, hiZ, depthResource, sceneColorHDR, halfExtent](
+                    FrameGraph::Builder& builder, TraceData& data) {
+                    PASS_SETUP_ZONE;
+
+                    read(builder, blackboard.get<CameraData>());
+
+                    builder.read(hiZ, makeTextureRead(0));
+                    builder.read(depthResource, makeTextureRead(1, rhi::ImageAspect::eDepth));
+                    builder.read(gBuffer.normal, makeTextureRead(2));
+                    builder.read(gBuffer.albedo, makeTextureRead(3));
+                    builder.read(gBuffer.metallicRoughnessAO, makeTextureRead(4));
+                    builder.read(sceneColorHDR, makeTextureRead(5));
+
+                    data.trace = builder.create<framegraph::FrameGraphTexture>(
+                        "SSR - Trace",
+                        {
+                            .extent     = halfExtent,
+                            .format     = rhi::PixelFormat::eRGBA16F,
+                            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+                        });
+                    data.trace = builder.write(data.trace,
+                                               framegraph::Attachment {
+                                                   .index       = 0,
+                                                   .imageAspect = rhi::ImageAspect::eColor,
+                                                   .clearValue  = framegraph::ClearValue::eTransparentBlack,
+                                               });
+                },
+                [this, &settings](const TraceData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "SSR Trace");
+
+                    struct PushConstants
+                    {
+                        float    intensity;
+                        float    maxRoughness;
+                        float    thickness;
+                        float    maxDistance;
+                        uint32_t maxRayCount;
+                        uint32_t maxIterations;
+                        uint32_t frameIndex;
+                    };
+
+                    PushConstants pushConstants {
+                        .intensity     = settings.intensity,
+                        .maxRoughness  = settings.maxRoughness,
+                        .thickness     = settings.thickness,
+                        .maxDistance   = settings.maxDistance,
+                        .maxRayCount   = std::max(settings.maxRayCount, 1u),
+                        .maxIterations = settings.maxIterations,
+                        .frameIndex    = m_FrameIndex,
+                    };
+
+                    const auto* pipeline = getPipeline(Stage::eTrace);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]);    // HiZ
+                        rc.overrideSampler(sets[3][1], samplers["point"]);    // Depth
+                        rc.overrideSampler(sets[3][2], samplers["point"]);    // Normal
+                        rc.overrideSampler(sets[3][3], samplers["point"]);    // Albedo
+                        rc.overrideSampler(sets[3][4], samplers["point"]);    // MetallicRoughnessAO
+                        rc.overrideSampler(sets[3][5], samplers["bilinear"]); // Scene color
+                        cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+            ssrData.trace = trace.trace;
+
+            // -- Temporal resolve (writes into the history texture of this frame)
+
+            struct ResolveData
+            {
+                FrameGraphResource resolved;
+            };
+            const auto& resolve = fg.addCallbackPass<ResolveData>(
+                "SSR Resolve",
+                [&blackboard, trace = ssrData.trace, history, resolved, depthResource](
+                    FrameGraph::Builder& builder, ResolveData& data) {
+                    PASS_SETUP_ZONE;
+
+                    read(builder, blackboard.get<CameraData>());
+
+                    builder.read(trace, makeTextureRead(0));
+                    builder.read(history, makeTextureRead(1));
+                    builder.read(depthResource, makeTextureRead(2, rhi::ImageAspect::eDepth));
+
+                    data.resolved = builder.write(resolved,
+                                                  framegraph::Attachment {
+                                                      .index       = 0,
+                                                      .imageAspect = rhi::ImageAspect::eColor,
+                                                  });
+                },
+                [this, &settings, &viewHistory](const ResolveData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "SSR Resolve");
+
+                    struct PushConstants
+                    {
+                        glm::mat4 prevViewProjection;
+                        float     temporalWeight;
+                        uint32_t  historyValid;
+                    };
+
+                    PushConstants pushConstants {
+                        .prevViewProjection = viewHistory.prevViewProjection,
+                        .temporalWeight     = settings.temporalWeight,
+                        .historyValid       = viewHistory.valid ? 1u : 0u,
+                    };
+
+                    const auto* pipeline = getPipeline(Stage::eResolve);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]);    // Trace
+                        rc.overrideSampler(sets[3][1], samplers["bilinear"]); // History
+                        rc.overrideSampler(sets[3][2], samplers["point"]);    // Depth
+                        cb.pushConstants(rhi::ShaderStages::eFragment, 0, &pushConstants);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+            ssrData.reflection = resolve.resolved;
+
+            // -- Composite (bilinear upsample, additive)
+
+            struct CompositeData
+            {
+                FrameGraphResource output;
+            };
+            const auto& composite = fg.addCallbackPass<CompositeData>(
+                "SSR Composite",
+                [reflection = ssrData.reflection, sceneColorHDR, fullExtent](FrameGraph::Builder& builder,
+                                                                             CompositeData&       data) {
+                    PASS_SETUP_ZONE;
+
+                    builder.read(reflection, makeTextureRead(0));
+                    builder.read(sceneColorHDR, makeTextureRead(1));
+
+                    data.output = builder.create<framegraph::FrameGraphTexture>(
+                        "SceneColor - HDR (SSR)",
+                        {
+                            .extent     = fullExtent,
+                            .format     = rhi::PixelFormat::eRGBA16F,
+                            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+                        });
+                    data.output = builder.write(data.output,
+                                                framegraph::Attachment {
+                                                    .index       = 0,
+                                                    .imageAspect = rhi::ImageAspect::eColor,
+                                                });
+                },
+                [this](const CompositeData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+                    RHI_GPU_ZONE(cb, "SSR Composite");
+
+                    const auto* pipeline = getPipeline(Stage::eComposite);
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("point") > 0);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["bilinear"]); // Reflection
+                        rc.overrideSampler(sets[3][1], samplers["point"]);    // Scene color
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+
+            add(blackboard, ssrData);
+
+            // Last, the passes above read the state of this frame.
+            addUpdatePass(fg, "SSRPass Advance", [this, &viewHistory, &viewProjection] {
+                viewHistory.prevViewProjection = viewProjection;
+                viewHistory.valid              = true;
+                viewHistory.index ^= 1;
+                ++m_FrameIndex;
+            });
+
+            return composite.output;
+        }
+
+        rhi::GraphicsPipeline SSRPass::createPipeline(const Stage stage) const
+        {
+            switch (stage)
+            {
+                case Stage::eTrace:
+                    return createPostProcessPipelineFromSPV(
+                        getRenderDevice(), rhi::PixelFormat::eRGBA16F, ssr_frag_spv);
+                case Stage::eResolve:
+                    return createPostProcessPipelineFromSPV(
+                        getRenderDevice(), rhi::PixelFormat::eRGBA16F, ssr_resolve_frag_spv);
+                case Stage::eComposite:
+                    return createPostProcessPipelineFromSPV(
+                        getRenderDevice(), rhi::PixelFormat::eRGBA16F, color_blend_additive_frag_spv);
+
+                default:
+                    assert(0);
+                    return {};
+            }
+        }
+
+        void SSRPass::resetHistory()
+        {
+            for (auto& [_, history] : m_Histories)
+                history.valid = false;
+        }
+
+        SSRPass::History& SSRPass::prepareHistory(const uint32_t viewId, const rhi::Extent2D& extent)
+        {
+            const auto prepare = [this, &extent](Ref<rhi::Texture>& texture) {
+                if (texture && texture->getExtent() == extent)
+                    return;
+
+                if (texture)
+                {
+                    // Might still be used by the frames in flight.
+                    getRenderDevice().getDeletionQueue().push(std::move(texture));
+                }
+                texture = createRef<rhi::Texture>(
+                    rhi::Texture::Builder {}
+                        .setExtent(extent)
+                        .setPixelFormat(rhi::PixelFormat::eRGBA16F)
+                        .setNumMipLevels(1)
+                        .setUsageFlags(rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled)
+                        .build(getRenderDevice()));
+            };
+
+            auto& viewHistory = m_Histories[viewId];
+            if (auto& previous = viewHistory.textures[viewHistory.index ^ 1]; !previous)
+            {
+                // First frame of the view, nothing to resolve against yet.
+                prepare(previous);
+                viewHistory.valid = false;
+            }
+            // Only the target of this frame follows the extent. The resolve samples last frame's result through
+            // reprojected UVs, so the history survives a resolution change (dynamic resolution) at any size.
+            prepare(viewHistory.textures[viewHistory.index]);
+
+            viewHistory.bindings = {
+                .history  = viewHistory.textures[viewHistory.index ^ 1].get(),
+                .resolved = viewHistory.textures[viewHistory.index].get(),
+            };
+            return viewHistory;
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
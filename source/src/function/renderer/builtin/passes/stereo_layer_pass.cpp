@@ -0,0 +1,119 @@
+#include "vultra/function/renderer/builtin/passes/stereo_layer_pass.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/function/framegraph/framegraph_resource_access.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/renderer/builtin/post_process_helper.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/fullscreen_triangle.vert.spv.h>
+#include <shader_headers/stereo_layer.frag.spv.h>
+#include <shader_headers/stereo_layer_depth.frag.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "Stereo Layer Pass";
+
+        namespace
+        {
+            [[nodiscard]] bool isDepthFormat(const rhi::PixelFormat format)
+            {
+                return static_cast<bool>(rhi::getAspectMask(format) & vk::ImageAspectFlagBits::eDepth);
+            }
+        } // namespace
+
+        StereoLayerPass::StereoLayerPass(rhi::RenderDevice& rd) : rhi::RenderPass<StereoLayerPass>(rd) {}
+
+        FrameGraphResource StereoLayerPass::extract(FrameGraph& fg, FrameGraphResource src, const uint32_t layer)
+        {
+            const auto& srcDesc = fg.getDescriptor<framegraph::FrameGraphTexture>(src);
+            const auto  extent  = srcDesc.extent;
+            const auto  format  = srcDesc.format;
+            const auto  usage   = srcDesc.usageFlags | rhi::ImageUsage::eRenderTarget;
+            const auto  aspect  = isDepthFormat(format) ? rhi::ImageAspect::eDepth : rhi::ImageAspect::eColor;
+
+            struct StereoLayerData
+            {
+                FrameGraphResource output;
+            };
+            const auto& pass = fg.addCallbackPass<StereoLayerData>(
+                PASS_NAME,
+                [src, extent, format, usage, aspect](FrameGraph::Builder& builder, StereoLayerData& data) {
+                    PASS_SETUP_ZONE;
+
+                    builder.read(src,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 0},
+                                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = aspect,
+                                 });
+
+                    data.output = builder.create<framegraph::FrameGraphTexture>(
+                        "Stereo Layer",
+                        {
+                            .extent     = extent,
+                            .format     = format,
+                            .usageFlags = usage,
+                        });
+                    data.output = builder.write(data.output,
+                                                framegraph::Attachment {
+                                                    .index       = 0,
+                                                    .imageAspect = aspect,
+                                                });
+                },
+                [this, layer, aspect](const StereoLayerData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+
+                    RHI_GPU_ZONE(cb, PASS_NAME);
+
+                    const auto* pipeline = getPipeline(aspect == rhi::ImageAspect::eDepth ?
+                                                           rhi::getDepthFormat(*framebufferInfo) :
+                                                           rhi::getColorFormat(*framebufferInfo, 0));
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline).pushConstants(
+                            rhi::ShaderStages::eFragment, 0, sizeof(uint32_t), &layer);
+                        assert(samplers.count("point") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["point"]);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+
+            return pass.output;
+        }
+
+        rhi::GraphicsPipeline StereoLayerPass::createPipeline(const rhi::PixelFormat format) const
+        {
+            if (!isDepthFormat(format))
+                return createPostProcessPipelineFromSPV(getRenderDevice(), format, stereo_layer_frag_spv);
+
+            return rhi::GraphicsPipeline::Builder {}
+                .setDepthFormat(format)
+                .setColorFormats({})
+                .setInputAssembly({})
+                .addBuiltinShader(rhi::ShaderType::eVertex, fullscreen_triangle_vert_spv)
+                .addBuiltinShader(rhi::ShaderType::eFragment, stereo_layer_depth_frag_spv)
+                .setDepthStencil({
+                    .depthTest      = true,
+                    .depthWrite     = true,
+                    .depthCompareOp = rhi::CompareOp::eAlways,
+                })
+                .setRasterizer({
+                    .polygonMode = rhi::PolygonMode::eFill,
+                    .cullMode    = rhi::CullMode::eFront,
+                })
+                .build(getRenderDevice());
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
@@ -18,8 +18,10 @@ namespace vultra
 
         ToneMappingPass::ToneMappingPass(rhi::RenderDevice& rd) : rhi::RenderPass<ToneMappingPass>(rd) {}
 
-        FrameGraphResource
-        ToneMappingPass::addPass(FrameGraph& fg, FrameGraphResource target, float exposure, ToneMappingMethod method)
+        FrameGraphResource ToneMappingPass::addPass(FrameGraph&        fg,
+                                                    FrameGraphResource target,
+                                                    const float&       exposure,
+                                                    ToneMappingMethod  method)
         {
             auto extent = fg.getDescriptor<framegraph::FrameGraphTexture>(target).extent;
 
@@ -57,7 +59,7 @@ namespace vultra
                                                         .clearValue  = framegraph::ClearValue::eOpaqueBlack,
                                                     });
                 },
-                [this, exposure, method](const auto&, FrameGraphPassResources&, void* ctx) {
+                [this, &exposure, method](const auto&, FrameGraphPassResources&, void* ctx) {
                     auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
                     auto& [cb, framebufferInfo, sets, samplers] = rc;
 
@@ -101,6 +103,7 @@ namespace vultra
                     .cullMode    = rhi::CullMode::eFront,
                 })
                 .setBlending(0, {.enabled = false})
+                .setPushDescriptorSet(3)
                 .build(getRenderDevice());
         }
     } // namespace gfx
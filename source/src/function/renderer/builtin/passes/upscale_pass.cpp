@@ -0,0 +1,88 @@
+#include "vultra/function/renderer/builtin/passes/upscale_pass.hpp"
+#include "vultra/core/rhi/command_buffer.hpp"
+#include "vultra/function/framegraph/framegraph_resource_access.hpp"
+#include "vultra/function/framegraph/framegraph_texture.hpp"
+#include "vultra/function/renderer/builtin/post_process_helper.hpp"
+#include "vultra/function/renderer/renderer_render_context.hpp"
+
+#include <shader_headers/upscale.frag.spv.h>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+namespace vultra
+{
+    namespace gfx
+    {
+        constexpr auto PASS_NAME = "Upscale Pass";
+
+        UpscalePass::UpscalePass(rhi::RenderDevice& rd) : rhi::RenderPass<UpscalePass>(rd) {}
+
+        FrameGraphResource UpscalePass::upscale(FrameGraph& fg, FrameGraphResource src, const rhi::Extent2D& extent)
+        {
+            const auto& srcDesc = fg.getDescriptor<framegraph::FrameGraphTexture>(src);
+            if (srcDesc.extent == extent)
+                return src;
+
+            const auto format = srcDesc.format;
+
+            struct UpscaleData
+            {
+                FrameGraphResource output;
+            };
+            const auto& pass = fg.addCallbackPass<UpscaleData>(
+                PASS_NAME,
+                [src, extent, format](FrameGraph::Builder& builder, UpscaleData& data) {
+                    PASS_SETUP_ZONE;
+
+                    builder.read(src,
+                                 framegraph::TextureRead {
+                                     .binding =
+                                         {
+                                             .location      = {.set = 3, .binding = 0},
+                                             .pipelineStage = framegraph::PipelineStage::eFragmentShader,
+                                         },
+                                     .type        = framegraph::TextureRead::Type::eCombinedImageSampler,
+                                     .imageAspect = rhi::ImageAspect::eColor,
+                                 });
+
+                    data.output = builder.create<framegraph::FrameGraphTexture>(
+                        "Upscale Output",
+                        {
+                            .extent     = extent,
+                            .format     = format,
+                            .usageFlags = rhi::ImageUsage::eRenderTarget | rhi::ImageUsage::eSampled,
+                        });
+                    data.output = builder.write(data.output,
+                                                framegraph::Attachment {
+                                                    .index       = 0,
+                                                    .imageAspect = rhi::ImageAspect::eColor,
+                                                });
+                },
+                [this](const UpscaleData&, FrameGraphPassResources&, void* ctx) {
+                    auto& rc                                    = *static_cast<gfx::RendererRenderContext*>(ctx);
+                    auto& [cb, framebufferInfo, sets, samplers] = rc;
+
+                    RHI_GPU_ZONE(cb, PASS_NAME);
+
+                    const auto* pipeline = getPipeline(rhi::getColorFormat(*framebufferInfo, 0));
+                    if (pipeline)
+                    {
+                        cb.bindPipeline(*pipeline);
+                        assert(samplers.count("bilinear") > 0);
+                        rc.overrideSampler(sets[3][0], samplers["bilinear"]);
+                        rc.bindDescriptorSets(*pipeline);
+                        cb.beginRendering(*framebufferInfo).drawFullScreenTriangle();
+                        rc.endRendering();
+                    }
+                });
+
+            return pass.output;
+        }
+
+        rhi::GraphicsPipeline UpscalePass::createPipeline(const rhi::PixelFormat colorFormat) const
+        {
+            return createPostProcessPipelineFromSPV(getRenderDevice(), colorFormat, upscale_frag_spv);
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
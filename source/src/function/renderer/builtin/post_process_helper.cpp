@@ -24,6 +24,7 @@ namespace vultra
                     .cullMode    = rhi::CullMode::eFront,
                 })
                 .setBlending(0, {.enabled = false})
+                .setPushDescriptorSet(3)
                 .build(rd);
         }
     } // namespace gfx
@@ -11,6 +11,8 @@
 #include <glm/gtc/constants.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <array>
+
 namespace vultra
 {
     namespace gfx
@@ -28,11 +30,9 @@ namespace vultra
         {
             const auto buffer = framegraph::uploadStruct(fg,
                                                          "UploadFrameBlock",
-                                                         framegraph::TransientBuffer {
-                                                             .name = "FrameBlock",
-                                                             .type = framegraph::BufferType::eUniformBuffer,
-                                                             .data = GPUFrameBlock {frameInfo},
-                                                         });
+                                                         "FrameBlock",
+                                                         framegraph::BufferType::eUniformBuffer,
+                                                         [&frameInfo] { return GPUFrameBlock {frameInfo}; });
             if (!blackboard.has<FrameData>())
             {
                 blackboard.add<FrameData>(buffer);
@@ -76,23 +76,8 @@ namespace vultra
         };
         static_assert(sizeof(GPUCameraBlock) == 512, "GPUCameraBlock unexpected size (std140 mismatch)");
 
-        [[nodiscard]] auto uploadCameraBlock(FrameGraph& fg, GPUCameraBlock&& cameraBlock)
-        {
-            return framegraph::uploadStruct(fg,
-                                            "UploadCameraBlock",
-                                            framegraph::TransientBuffer {
-                                                .name = "CameraBlock",
-                                                .type = framegraph::BufferType::eUniformBuffer,
-                                                .data = std::move(cameraBlock),
-                                            });
-        }
-
-        void uploadCameraBlock(FrameGraph&           fg,
-                               FrameGraphBlackboard& blackboard,
-                               const rhi::Extent2D   resolution,
-                               const CameraInfo&     cameraInfo)
+        void setCameraBlock(FrameGraphBlackboard& blackboard, FrameGraphResource buffer)
         {
-            auto buffer = uploadCameraBlock(fg, GPUCameraBlock {resolution, cameraInfo});
             if (!blackboard.has<CameraData>())
             {
                 blackboard.add<CameraData>(buffer);
@@ -103,6 +88,49 @@ namespace vultra
             }
         }
 
+        void uploadCameraBlock(FrameGraph&           fg,
+                               FrameGraphBlackboard& blackboard,
+                               const rhi::Extent2D   resolution,
+                               const CameraInfo&     cameraInfo)
+        {
+            setCameraBlock(blackboard,
+                           framegraph::uploadStruct(fg,
+                                                    "UploadCameraBlock",
+                                                    "CameraBlock",
+                                                    framegraph::BufferType::eUniformBuffer,
+                                                    [resolution, &cameraInfo] {
+                                                        return GPUCameraBlock {resolution, cameraInfo};
+                                                    }));
+        }
+
+        void uploadStereoCameraBlock(FrameGraph&           fg,
+                                     FrameGraphBlackboard& blackboard,
+                                     const rhi::Extent2D   resolution,
+                                     const CameraInfo&     left,
+                                     const CameraInfo&     right,
+                                     const CameraInfo&     culling)
+        {
+            const auto makeCameraBlocks = [resolution, &left, &right, &culling] {
+                std::array<GPUCameraBlock, 2> cameraBlocks {GPUCameraBlock {resolution, left},
+                                                            GPUCameraBlock {resolution, right}};
+                for (auto& cameraBlock : cameraBlocks)
+                {
+                    for (int i = 0; i < 6; ++i)
+                    {
+                        cameraBlock.frustumPlanes[i] = culling.frustumPlanes[i];
+                    }
+                }
+                return cameraBlocks;
+            };
+
+            setCameraBlock(blackboard,
+                           framegraph::uploadStruct(fg,
+                                                    "UploadStereoCameraBlock",
+                                                    "StereoCameraBlock",
+                                                    framegraph::BufferType::eUniformBuffer,
+                                                    makeCameraBlocks));
+        }
+
         struct alignas(16) GPUDirectionalLight
         {
             glm::vec3 direction;
@@ -189,11 +217,9 @@ namespace vultra
         {
             auto buffer = framegraph::uploadStruct(fg,
                                                    "UploadLightBlock",
-                                                   framegraph::TransientBuffer {
-                                                       .name = "LightBlock",
-                                                       .type = framegraph::BufferType::eUniformBuffer,
-                                                       .data = GPULightBlock {lightInfo},
-                                                   });
+                                                   "LightBlock",
+                                                   framegraph::BufferType::eUniformBuffer,
+                                                   [&lightInfo] { return GPULightBlock {lightInfo}; });
 
             if (!blackboard.has<LightData>())
             {
@@ -0,0 +1,73 @@
+#include "vultra/function/renderer/parallel_command_recorder.hpp"
+#include "vultra/core/rhi/render_device.hpp"
+
+namespace vultra
+{
+    namespace gfx
+    {
+        ParallelCommandRecorder::ParallelCommandRecorder(rhi::RenderDevice& rd,
+                                                         const uint32_t     numFramesInFlight,
+                                                         const uint32_t     numWorkers) :
+            m_ThreadPool(numWorkers), m_Pools(numFramesInFlight)
+        {
+            assert(numFramesInFlight > 0);
+            for (auto& pools : m_Pools)
+            {
+                pools.reserve(m_ThreadPool.getNumThreads());
+                for (auto i = 0u; i < m_ThreadPool.getNumThreads(); ++i)
+                {
+                    pools.push_back(rd.createCommandPool());
+                }
+            }
+        }
+
+        uint32_t ParallelCommandRecorder::getNumThreads() const { return m_ThreadPool.getNumThreads(); }
+
+        uint32_t ParallelCommandRecorder::getNumRecorded() const { return m_NumRecorded; }
+
+        void ParallelCommandRecorder::nextFrame()
+        {
+            ZoneScopedN("ParallelCommandRecorder::NextFrame");
+
+            m_NumRecorded = 0;
+            for (const auto& pool : m_Pools[m_FrameIndex])
+            {
+                m_NumRecorded += pool.getNumAcquired();
+            }
+
+            m_FrameIndex = (m_FrameIndex + 1) % static_cast<uint32_t>(m_Pools.size());
+            for (auto& pool : m_Pools[m_FrameIndex])
+            {
+                pool.reset();
+            }
+        }
+
+        std::vector<rhi::CommandBuffer*> ParallelCommandRecorder::record(const rhi::FramebufferInfo& framebufferInfo,
+                                                                         const uint32_t              numTasks,
+                                                                         const RecordFn&             fn)
+        {
+            ZoneScopedN("ParallelCommandRecorder::Record");
+
+            std::vector<rhi::CommandBuffer*> commandBuffers(numTasks, nullptr);
+
+            auto& pools = m_Pools[m_FrameIndex];
+            m_ThreadPool.parallelFor(numTasks, [&](const uint32_t taskIndex, const uint32_t threadIndex) {
+                ZoneScopedN("RecordSecondary");
+
+                auto& cb = pools[threadIndex].acquireSecondary();
+                cb.begin(framebufferInfo);
+                fn(taskIndex, cb);
+                cb.end();
+
+                commandBuffers[taskIndex] = &cb;
+            });
+
+            return commandBuffers;
+        }
+
+        rhi::CommandBuffer& ParallelCommandRecorder::acquire(const rhi::FramebufferInfo& framebufferInfo)
+        {
+            return m_Pools[m_FrameIndex].front().acquireSecondary().begin(framebufferInfo);
+        }
+    } // namespace gfx
+} // namespace vultra
\ No newline at end of file
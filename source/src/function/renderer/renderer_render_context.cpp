@@ -40,6 +40,11 @@ namespace vultra
                     {
                         descriptorSetBuilder.bind(index, info);
                     }
+                    if (pipeline.getLayout().isPushDescriptorSet(set))
+                    {
+                        descriptorSetBuilder.push(cb, set);
+                        continue;
+                    }
                     const auto descriptors = descriptorSetBuilder.build(pipeline.getDescriptorSetLayout(set));
                     cb.bindDescriptorSet(set, descriptors);
                 }
@@ -94,6 +99,8 @@ namespace vultra
 
         void RendererRenderContext::endRayTracing() { resourceSet.clear(); }
 
+        void RendererRenderContext::endCompute() { resourceSet.clear(); }
+
         std::string RendererRenderContext::toString(const framegraph::ResourceSet& sets)
         {
             std::ostringstream oss;
@@ -1340,41 +1340,12 @@ namespace vultra
             // Generate meshlets
             generateMeshlets(mesh);
 
-            mesh.vertexBuffer = createRef<rhi::VertexBuffer>(
-                std::move(rd.createVertexBuffer(mesh.getVertexStride(), mesh.getVertexCount())));
-            auto stagingVertexBuffer =
-                rd.createStagingBuffer(mesh.getVertexStride() * mesh.getVertexCount(), mesh.vertices.data());
-
-            rhi::Buffer stagingIndexBuffer {};
-            if (mesh.indices.size() > 0)
-            {
-                mesh.indexBuffer = createRef<rhi::IndexBuffer>(std::move(
-                    rd.createIndexBuffer(static_cast<rhi::IndexType>(mesh.getIndexStride()), mesh.getIndexCount())));
-                stagingIndexBuffer =
-                    rd.createStagingBuffer(mesh.getIndexStride() * mesh.getIndexCount(), mesh.indices.data());
-            }
-
-            rd.execute(
-                [&](rhi::CommandBuffer& cb) {
-                    cb.copyBuffer(
-                        stagingVertexBuffer, *mesh.vertexBuffer, vk::BufferCopy {0, 0, stagingVertexBuffer.getSize()});
-                    if (stagingIndexBuffer)
-                    {
-                        cb.copyBuffer(
-                            stagingIndexBuffer, *mesh.indexBuffer, vk::BufferCopy {0, 0, stagingIndexBuffer.getSize()});
-                    }
-                },
-                true);
+            // Vertices, indices and meshlets, sub-allocated from the shared geometry buffers
+            mesh.buildGeometry(rd);
 
             // Build material buffer (for bindless descriptors)
             mesh.buildMaterialBuffer(rd);
 
-            // Build meshlet buffers for each sub-mesh
-            for (auto& sm : mesh.subMeshes)
-            {
-                sm.buildMeshletBuffers(rd);
-            }
-
             mesh.buildRenderMesh(rd);
 
             // Find light meshes (meshes with emissive materials)
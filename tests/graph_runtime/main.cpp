@@ -0,0 +1,261 @@
+#include <vultra/core/rhi/render_device.hpp>
+#include <vultra/function/framegraph/graph_runtime.hpp>
+
+#include <fg/Blackboard.hpp>
+#include <fg/FrameGraph.hpp>
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace vultra;
+
+namespace
+{
+    int g_NumFailures = 0;
+
+    void check(const bool condition, const char* expression, const int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED (line " << line << "): " << expression << "\n";
+            ++g_NumFailures;
+        }
+    }
+
+    // What the stub passes saw during GraphRuntime::addToGraph.
+    std::vector<std::string> g_AddedPasses;
+    FrameGraphResource       g_PresentedInput {-1};
+    FrameGraphResource       g_PresentedBackBuffer {-1};
+    int                      g_NumCreatedPasses {0};
+
+    // Source writes a resource, each Filter increments it, Present records its inputs.
+    class StubPass final : public framegraph::GraphPass
+    {
+    public:
+        explicit StubPass(std::string type) : m_Type {std::move(type)} {}
+
+        void addToGraph(framegraph::GraphPassContext& ctx) override
+        {
+            g_AddedPasses.push_back(m_Type);
+            if (m_Type == "Source")
+            {
+                ctx.setOutput("Color", 1);
+            }
+            else if (m_Type == "Filter")
+            {
+                ctx.setOutput("Output", ctx.getInput("Input").value_or(-1) + 1);
+            }
+            else if (m_Type == "Present")
+            {
+                g_PresentedInput      = ctx.getInput("Input").value_or(-1);
+                g_PresentedBackBuffer = ctx.getInput("Backbuffer").value_or(-1);
+            }
+        }
+
+    private:
+        std::string m_Type;
+    };
+
+    framegraph::GraphPassRegistry createStubRegistry()
+    {
+        framegraph::GraphPassRegistry registry;
+        const auto registerStub = [&registry](const std::string& type, framegraph::GraphPassReflection reflection) {
+            registry.registerPass(type, std::move(reflection), [type](rhi::RenderDevice&) {
+                ++g_NumCreatedPasses;
+                return std::make_unique<StubPass>(type);
+            });
+        };
+        registerStub("Source", {{}, {{"Color", "Texture"}}});
+        registerStub("Filter", {{{"Input", "Texture"}}, {{"Output", "Texture"}}});
+        registerStub("Present", {{{"Input", "Texture"}, {"Backbuffer", "Texture"}}, {}});
+        registerStub("BufferSource", {{}, {{"Data", "Buffer"}}});
+        return registry;
+    }
+
+    // Source(1) -> Filter(2) -> Present(3), listed in reverse.
+    framegraph::GraphDescription createChain()
+    {
+        return {
+            .passes =
+                {
+                    {.id = 3, .type = "Present", .name = "Present"},
+                    {.id = 2, .type = "Filter", .name = "Filter"},
+                    {.id = 1, .type = "Source", .name = "Source"},
+                },
+            .links =
+                {
+                    {.fromNode = 1, .fromPin = "Color", .toNode = 2, .toPin = "Input"},
+                    {.fromNode = 2, .fromPin = "Output", .toNode = 3, .toPin = "Input"},
+                },
+        };
+    }
+
+    bool hasError(const framegraph::GraphRuntime& runtime, const std::string_view message)
+    {
+        return runtime.getError().find(message) != std::string::npos;
+    }
+
+    void addToGraph(const framegraph::GraphRuntime& runtime)
+    {
+        g_AddedPasses.clear();
+        g_PresentedInput      = -1;
+        g_PresentedBackBuffer = -1;
+
+        FrameGraph           fg;
+        FrameGraphBlackboard blackboard;
+        runtime.addToGraph(fg, blackboard, {{"Backbuffer", 42}});
+    }
+} // namespace
+
+#define CHECK(expression) check((expression), #expression, __LINE__)
+
+void testLoad(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+    CHECK(!runtime.isValid());
+
+    CHECK(runtime.load(createChain()));
+    CHECK(runtime.isValid());
+    CHECK(runtime.getVersion() == 1);
+    CHECK(runtime.getError().empty());
+
+    // Sorted topologically, the unlinked back buffer is bound from the imports.
+    addToGraph(runtime);
+    CHECK((g_AddedPasses == std::vector<std::string> {"Source", "Filter", "Present"}));
+    CHECK(g_PresentedInput == 2);
+    CHECK(g_PresentedBackBuffer == 42);
+}
+
+void testDuplicateId(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    auto description = createChain();
+    description.passes.push_back({.id = 1, .type = "Filter", .name = "Filter 2"});
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "Duplicate pass id"));
+    CHECK(!runtime.isValid());
+}
+
+void testUnknownType(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    auto description = createChain();
+    description.passes.push_back({.id = 4, .type = "Blur", .name = "Blur"});
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "Unknown pass type"));
+}
+
+void testUnknownPins(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    auto description             = createChain();
+    description.links[0].fromPin = "Depth";
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "has no output 'Depth'"));
+
+    description                = createChain();
+    description.links[1].toPin = "Color";
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "has no input 'Color'"));
+
+    description                 = createChain();
+    description.links[1].toNode = 7;
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "missing pass"));
+}
+
+void testTypeMismatch(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    auto description = createChain();
+    description.passes.push_back({.id = 4, .type = "BufferSource", .name = "BufferSource"});
+    description.links[0] = {.fromNode = 4, .fromPin = "Data", .toNode = 2, .toPin = "Input"};
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "Type mismatch"));
+}
+
+void testInputLinkedTwice(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    auto description = createChain();
+    description.passes.push_back({.id = 4, .type = "Source", .name = "Source 2"});
+    description.links.push_back({.fromNode = 4, .fromPin = "Color", .toNode = 2, .toPin = "Input"});
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "linked more than once"));
+}
+
+void testCycle(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+
+    const framegraph::GraphDescription description {
+        .passes =
+            {
+                {.id = 1, .type = "Filter", .name = "A"},
+                {.id = 2, .type = "Filter", .name = "B"},
+            },
+        .links =
+            {
+                {.fromNode = 1, .fromPin = "Output", .toNode = 2, .toPin = "Input"},
+                {.fromNode = 2, .fromPin = "Output", .toNode = 1, .toPin = "Input"},
+            },
+    };
+    CHECK(!runtime.load(description));
+    CHECK(hasError(runtime, "cycle"));
+}
+
+void testFailedReload(rhi::RenderDevice& rd, const framegraph::GraphPassRegistry& registry)
+{
+    framegraph::GraphRuntime runtime {rd, registry};
+    CHECK(runtime.load(createChain()));
+
+    // A broken graph keeps the previous one.
+    auto broken = createChain();
+    broken.links.push_back(broken.links[1]);
+    CHECK(!runtime.load(broken));
+    CHECK(!runtime.getError().empty());
+    CHECK(runtime.isValid());
+    CHECK(runtime.getVersion() == 1);
+
+    addToGraph(runtime);
+    CHECK((g_AddedPasses == std::vector<std::string> {"Source", "Filter", "Present"}));
+    CHECK(g_PresentedInput == 2);
+
+    // Fixing it loads a new version that keeps the instances of the unchanged nodes.
+    const auto numCreatedPasses = g_NumCreatedPasses;
+    CHECK(runtime.load(createChain()));
+    CHECK(runtime.getError().empty());
+    CHECK(runtime.getVersion() == 2);
+    CHECK(g_NumCreatedPasses == numCreatedPasses);
+}
+
+int main()
+{
+    // Only needed to create the passes, the stub passes do not use it.
+    rhi::RenderDevice rd {rhi::RenderDeviceFeatureFlagBits::eHeadless, "GraphRuntime Test"};
+
+    const auto registry = createStubRegistry();
+
+    testLoad(rd, registry);
+    testDuplicateId(rd, registry);
+    testUnknownType(rd, registry);
+    testUnknownPins(rd, registry);
+    testTypeMismatch(rd, registry);
+    testInputLinkedTwice(rd, registry);
+    testCycle(rd, registry);
+    testFailedReload(rd, registry);
+
+    if (g_NumFailures > 0)
+    {
+        std::cerr << g_NumFailures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "GraphRuntime: all checks passed\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+target("test-graph-runtime")
+    set_kind("binary")
+    add_files("main.cpp")
+    add_deps("vultra")
+
+    -- set target directory
+    set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/test-graph-runtime")
\ No newline at end of file
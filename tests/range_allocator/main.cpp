@@ -0,0 +1,163 @@
+#include <vultra/core/base/range_allocator.hpp>
+
+#include <iostream>
+
+using namespace vultra;
+
+namespace
+{
+    int g_NumFailures = 0;
+
+    void check(const bool condition, const char* expression, const int line)
+    {
+        if (!condition)
+        {
+            std::cerr << "FAILED (line " << line << "): " << expression << "\n";
+            ++g_NumFailures;
+        }
+    }
+} // namespace
+
+#define CHECK(expression) check((expression), #expression, __LINE__)
+
+void testAllocate()
+{
+    RangeAllocator allocator {100};
+    CHECK(allocator.empty());
+    CHECK(allocator.getLargestFreeRange() == 100);
+
+    CHECK(allocator.allocate(10) == 0u);
+    CHECK(allocator.allocate(20) == 10u);
+    CHECK(allocator.getUsedSize() == 30);
+    CHECK(allocator.getNumFreeRanges() == 1);
+    CHECK(allocator.getLargestFreeRange() == 70);
+
+    CHECK(allocator.allocate(71) == std::nullopt);
+    CHECK(allocator.allocate(70) == 30u);
+    CHECK(allocator.getNumFreeRanges() == 0);
+    CHECK(allocator.getLargestFreeRange() == 0);
+    CHECK(allocator.allocate(1) == std::nullopt);
+}
+
+void testAlignment()
+{
+    RangeAllocator allocator {100};
+    CHECK(allocator.allocate(5) == 0u);
+
+    // Not a power of two (vertex stride), the padding [5, 12) stays free.
+    CHECK(allocator.allocate(12, 12) == 12u);
+    CHECK(allocator.getUsedSize() == 17);
+    CHECK(allocator.getNumFreeRanges() == 2);
+    CHECK(allocator.getLargestFreeRange() == 76);
+
+    // Fits in the padding range.
+    CHECK(allocator.allocate(7) == 5u);
+    CHECK(allocator.getNumFreeRanges() == 1);
+
+    CHECK(allocator.allocate(10, 24) == 24u);
+    CHECK(allocator.getNumFreeRanges() == 1);
+    CHECK(allocator.allocate(10, 36) == 36u);
+    CHECK(allocator.getNumFreeRanges() == 2); // [34, 36) and [46, 100)
+}
+
+void testPaddingTooLarge()
+{
+    RangeAllocator allocator {30};
+    CHECK(allocator.allocate(1) == 0u);
+
+    // [1, 30): the size fits, but not once aligned to 16.
+    CHECK(allocator.allocate(20, 16) == std::nullopt);
+    CHECK(allocator.getUsedSize() == 1);
+    CHECK(allocator.getNumFreeRanges() == 1);
+
+    CHECK(allocator.allocate(13, 16) == 16u);
+    CHECK(allocator.getNumFreeRanges() == 2); // [1, 16) and [29, 30)
+    CHECK(allocator.getLargestFreeRange() == 15);
+}
+
+void testBestFit()
+{
+    RangeAllocator allocator {100};
+    const auto     a = allocator.allocate(30);
+    const auto     b = allocator.allocate(10);
+    const auto     c = allocator.allocate(10);
+    const auto     d = allocator.allocate(10);
+    CHECK(a == 0u && b == 30u && c == 40u && d == 50u);
+
+    allocator.free(*a, 30);
+    allocator.free(*c, 10);
+    CHECK(allocator.getNumFreeRanges() == 3); // [0, 30), [40, 50) and [60, 100)
+
+    // The smallest range that fits.
+    CHECK(allocator.allocate(8) == 40u);
+    CHECK(allocator.allocate(25) == 0u);
+    CHECK(allocator.allocate(35) == 60u);
+}
+
+void testMerge()
+{
+    RangeAllocator allocator {100};
+    const auto     a = allocator.allocate(10);
+    const auto     b = allocator.allocate(10);
+    const auto     c = allocator.allocate(10);
+    CHECK(a == 0u && b == 10u && c == 20u);
+
+    allocator.free(*a, 10);
+    CHECK(allocator.getNumFreeRanges() == 2);
+    CHECK(allocator.getLargestFreeRange() == 70);
+
+    // With the next one.
+    allocator.free(*c, 10);
+    CHECK(allocator.getNumFreeRanges() == 2);
+    CHECK(allocator.getLargestFreeRange() == 80);
+
+    // With both.
+    allocator.free(*b, 10);
+    CHECK(allocator.getNumFreeRanges() == 1);
+    CHECK(allocator.getLargestFreeRange() == 100);
+    CHECK(allocator.empty());
+
+    // With the previous one only.
+    const auto d = allocator.allocate(40);
+    const auto e = allocator.allocate(60);
+    CHECK(d == 0u && e == 40u);
+    allocator.free(*d, 40);
+    allocator.free(*e, 60);
+    CHECK(allocator.getNumFreeRanges() == 1);
+    CHECK(allocator.getLargestFreeRange() == 100);
+    CHECK(allocator.allocate(100) == 0u);
+}
+
+void testMergePadding()
+{
+    RangeAllocator allocator {64};
+    CHECK(allocator.allocate(3) == 0u);
+    CHECK(allocator.allocate(16, 16) == 16u); // Padding [3, 16)
+
+    allocator.free(0, 3);
+    CHECK(allocator.getNumFreeRanges() == 2); // [0, 16) and [32, 64)
+    CHECK(allocator.getLargestFreeRange() == 32);
+
+    allocator.free(16, 16);
+    CHECK(allocator.getNumFreeRanges() == 1);
+    CHECK(allocator.getLargestFreeRange() == 64);
+    CHECK(allocator.empty());
+}
+
+int main()
+{
+    testAllocate();
+    testAlignment();
+    testPaddingTooLarge();
+    testBestFit();
+    testMerge();
+    testMergePadding();
+
+    if (g_NumFailures > 0)
+    {
+        std::cerr << g_NumFailures << " check(s) failed\n";
+        return 1;
+    }
+    std::cout << "RangeAllocator: all checks passed\n";
+    return 0;
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+target("test-range-allocator")
+    set_kind("binary")
+    add_files("main.cpp")
+    add_deps("vultra")
+
+    -- set target directory
+    set_targetdir("$(builddir)/$(plat)/$(arch)/$(mode)/test-range-allocator")
\ No newline at end of file
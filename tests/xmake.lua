@@ -1,3 +1,5 @@
 includes("imgui_remote_package")
 includes("scene_serialization")
-includes("event_center")
\ No newline at end of file
+includes("event_center")
+includes("range_allocator")
+includes("graph_runtime")
\ No newline at end of file